@@ -4,7 +4,23 @@
       "target_name": "gamelord_libretro",
       "sources": [
         "src/addon.cc",
-        "src/libretro_core.cc"
+        "src/bios_verifier.cc",
+        "src/content_cache.cc",
+        "src/dat_index.cc",
+        "src/image_resize.cc",
+        "src/input_queue.cc",
+        "src/libretro_core.cc",
+        "src/library_scanner.cc",
+        "src/library_store.cc",
+        "src/library_watcher.cc",
+        "src/memory_stats.cc",
+        "src/perf_hud.cc",
+        "src/rom_header.cc",
+        "src/screen_layout.cc",
+        "src/search_index.cc",
+        "src/stall_watchdog.cc",
+        "src/state_summary.cc",
+        "src/zip_reader.cc"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
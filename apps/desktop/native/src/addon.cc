@@ -1,8 +1,27 @@
 #include <napi.h>
+#include "bios_verifier.h"
+#include "dat_index.h"
+#include "image_resize.h"
 #include "libretro_core.h"
+#include "library_scanner.h"
+#include "library_store.h"
+#include "search_index.h"
+#include "state_summary.h"
+#include "library_watcher.h"
+#include "zip_reader.h"
 
 Napi::Object InitAll(Napi::Env env, Napi::Object exports) {
-  return LibretroCore::Init(env, exports);
+  LibretroCore::Init(env, exports);
+  LibraryScanner::Init(env, exports);
+  LibraryStore::Init(env, exports);
+  SearchIndex::Init(env, exports);
+  LibraryWatcher::Init(env, exports);
+  DatIndex::Init(env, exports);
+  ZipReader::Init(env, exports);
+  ImageResizer::Init(env, exports);
+  StateSummaryReader::Init(env, exports);
+  BiosVerifier::Init(env, exports);
+  return exports;
 }
 
 NODE_API_MODULE(gamelord_libretro, InitAll)
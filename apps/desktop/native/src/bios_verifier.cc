@@ -0,0 +1,428 @@
+#include "bios_verifier.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#include "fs_util.h"
+#include "thread_pool.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bios_verifier {
+
+namespace {
+
+// MD5 (RFC 1321), streaming. BIOS images are at most a few MiB, and the DAT
+// and BIOS lists everyone publishes are keyed by MD5.
+class Md5Hasher {
+public:
+  void Update(const uint8_t *data, size_t length) {
+    total_ += length;
+    if (buffered_ > 0) {
+      size_t take = std::min(length, sizeof(block_) - buffered_);
+      memcpy(block_ + buffered_, data, take);
+      buffered_ += take;
+      data += take;
+      length -= take;
+      if (buffered_ < sizeof(block_)) return;
+      Transform(block_);
+      buffered_ = 0;
+    }
+    for (; length >= sizeof(block_); data += sizeof(block_), length -= sizeof(block_)) {
+      Transform(data);
+    }
+    memcpy(block_, data, length);
+    buffered_ = length;
+  }
+
+  Md5 Finish() {
+    uint64_t bits = total_ * 8;
+    static const uint8_t kPad[64] = {0x80};
+    size_t pad = buffered_ < 56 ? 56 - buffered_ : 120 - buffered_;
+    Update(kPad, pad);
+    uint8_t length[8];
+    for (int i = 0; i < 8; i++) length[i] = static_cast<uint8_t>(bits >> (8 * i));
+    Update(length, 8);
+
+    Md5 digest;
+    for (int i = 0; i < 4; i++) {
+      for (int j = 0; j < 4; j++) digest[i * 4 + j] = static_cast<uint8_t>(state_[i] >> (8 * j));
+    }
+    return digest;
+  }
+
+private:
+  static uint32_t Rotl(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+  void Transform(const uint8_t *p) {
+    static const uint32_t kK[64] = {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613,
+        0xfd469501, 0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193,
+        0xa679438e, 0x49b40821, 0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d,
+        0x02441453, 0xd8a1e681, 0xe7d3fbc8, 0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+        0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a, 0xfffa3942, 0x8771f681, 0x6d9d6122,
+        0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70, 0x289b7ec6, 0xeaa127fa,
+        0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665, 0xf4292244,
+        0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb,
+        0xeb86d391};
+    static const int kShift[64] = {7,  12, 17, 22, 7,  12, 17, 22, 7,  12, 17, 22, 7,  12, 17, 22,
+                                   5,  9,  14, 20, 5,  9,  14, 20, 5,  9,  14, 20, 5,  9,  14, 20,
+                                   4,  11, 16, 23, 4,  11, 16, 23, 4,  11, 16, 23, 4,  11, 16, 23,
+                                   6,  10, 15, 21, 6,  10, 15, 21, 6,  10, 15, 21, 6,  10, 15, 21};
+    uint32_t m[16];
+    for (int i = 0; i < 16; i++) {
+      m[i] = static_cast<uint32_t>(p[i * 4]) | (static_cast<uint32_t>(p[i * 4 + 1]) << 8) |
+             (static_cast<uint32_t>(p[i * 4 + 2]) << 16) |
+             (static_cast<uint32_t>(p[i * 4 + 3]) << 24);
+    }
+    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+    for (int i = 0; i < 64; i++) {
+      uint32_t f;
+      int g;
+      if (i < 16) {
+        f = (b & c) | (~b & d);
+        g = i;
+      } else if (i < 32) {
+        f = (d & b) | (~d & c);
+        g = (5 * i + 1) % 16;
+      } else if (i < 48) {
+        f = b ^ c ^ d;
+        g = (3 * i + 5) % 16;
+      } else {
+        f = c ^ (b | ~d);
+        g = (7 * i) % 16;
+      }
+      uint32_t next = d;
+      d = c;
+      c = b;
+      b = b + Rotl(a + f + kK[i] + m[g], kShift[i]);
+      a = next;
+    }
+    state_[0] += a;
+    state_[1] += b;
+    state_[2] += c;
+    state_[3] += d;
+  }
+
+  uint32_t state_[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+  uint8_t block_[64];
+  size_t buffered_ = 0;
+  uint64_t total_ = 0;
+};
+
+constexpr char kCacheHeader[] = "gamelord-bios-cache 1";
+
+#ifndef _WIN32
+
+bool HashFile(int fd, Md5 *md5) {
+  Md5Hasher hasher;
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[1 << 20]);
+  for (;;) {
+    ssize_t n = read(fd, buffer.get(), 1 << 20);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    if (n == 0) break;
+    hasher.Update(buffer.get(), static_cast<size_t>(n));
+  }
+  *md5 = hasher.Finish();
+  return true;
+}
+
+// Ask the kernel to read the file ahead; the core opens it next.
+void Prefetch(int fd, uint64_t size) {
+#if defined(POSIX_FADV_WILLNEED)
+  posix_fadvise(fd, 0, static_cast<off_t>(size), POSIX_FADV_WILLNEED);
+#elif defined(F_RDADVISE)
+  struct radvisory advice;
+  advice.ra_offset = 0;
+  advice.ra_count = static_cast<int>(std::min<uint64_t>(size, INT32_MAX));
+  fcntl(fd, F_RDADVISE, &advice);
+#else
+  (void)fd;
+  (void)size;
+#endif
+}
+
+#endif // !_WIN32
+
+} // namespace
+
+Md5 Md5Of(const uint8_t *data, size_t length) {
+  Md5Hasher hasher;
+  hasher.Update(data, length);
+  return hasher.Finish();
+}
+
+std::string ToHex(const Md5 &md5) {
+  static const char kDigits[] = "0123456789abcdef";
+  std::string hex(32, '0');
+  for (size_t i = 0; i < md5.size(); i++) {
+    hex[i * 2] = kDigits[md5[i] >> 4];
+    hex[i * 2 + 1] = kDigits[md5[i] & 0xf];
+  }
+  return hex;
+}
+
+// One entry per line: `<md5> <size> <mtimeMs> <path>`. The path is last so
+// it may contain spaces.
+Cache ReadCache(const std::string &path) {
+  Cache cache;
+  FILE *f = fopen(path.c_str(), "r");
+  if (!f) return cache;
+  char line[4096];
+  if (!fgets(line, sizeof(line), f) ||
+      strncmp(line, kCacheHeader, sizeof(kCacheHeader) - 1) != 0) {
+    fclose(f);
+    return cache;
+  }
+  while (fgets(line, sizeof(line), f)) {
+    char md5[33];
+    unsigned long long size;
+    double mtime;
+    int consumed = 0;
+    if (sscanf(line, "%32s %llu %lf %n", md5, &size, &mtime, &consumed) != 3 || consumed == 0) {
+      continue;
+    }
+    std::string file = line + consumed;
+    while (!file.empty() && (file.back() == '\n' || file.back() == '\r')) file.pop_back();
+    if (file.empty() || strlen(md5) != 32) continue;
+    cache[file] = CacheEntry{static_cast<uint64_t>(size), mtime, md5};
+  }
+  fclose(f);
+  return cache;
+}
+
+bool WriteCache(const std::string &path, const Cache &cache, std::string *error) {
+  std::string tmp = path + ".tmp";
+  FILE *f = fopen(tmp.c_str(), "w");
+  if (!f) {
+    *error = std::string("cannot write BIOS cache: ") + strerror(errno);
+    return false;
+  }
+  bool ok = fprintf(f, "%s\n", kCacheHeader) > 0;
+  for (const auto &pair : cache) {
+    ok = ok && fprintf(f, "%s %llu %.17g %s\n", pair.second.md5.c_str(),
+                       static_cast<unsigned long long>(pair.second.size), pair.second.mtime_ms,
+                       pair.first.c_str()) > 0;
+  }
+  ok = fclose(f) == 0 && ok;
+#ifdef _WIN32
+  if (ok) std::remove(path.c_str());
+#endif
+  if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+    *error = std::string("cannot write BIOS cache: ") + strerror(errno);
+    std::remove(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+#ifndef _WIN32
+
+Report Verify(const std::string &dir, const Expected &expected, const Cache &cache) {
+  Report report;
+  report.file = expected.file;
+
+  std::string path = fs_util::JoinPath(dir, expected.file);
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return report; // Missing
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return report;
+  }
+  report.size = static_cast<uint64_t>(st.st_size);
+  report.mtime_ms = fs_util::MtimeMs(st);
+
+  auto hit = cache.find(path);
+  if (hit != cache.end() && hit->second.size == report.size &&
+      hit->second.mtime_ms == report.mtime_ms) {
+    report.md5 = hit->second.md5;
+    report.cached = true;
+  } else {
+    Md5 md5;
+    if (!HashFile(fd, &md5)) {
+      close(fd);
+      report.status = Status::Bad;
+      return report;
+    }
+    report.md5 = ToHex(md5);
+  }
+
+  bool size_ok = expected.size == 0 || expected.size == report.size;
+  const auto &known = expected.md5;
+  bool md5_ok = known.empty() || std::find(known.begin(), known.end(), report.md5) != known.end();
+  report.status = size_ok && md5_ok ? Status::Verified : Status::Bad;
+  if (report.status == Status::Verified && report.cached) {
+    Prefetch(fd, report.size);
+  }
+  close(fd);
+  return report;
+}
+
+#else
+
+Report Verify(const std::string &, const Expected &expected, const Cache &) {
+  Report report;
+  report.file = expected.file;
+  return report;
+}
+
+#endif // !_WIN32
+
+} // namespace bios_verifier
+
+// ---------------------------------------------------------------------------
+// N-API
+// ---------------------------------------------------------------------------
+
+namespace {
+
+const char *StatusName(bios_verifier::Status status) {
+  switch (status) {
+  case bios_verifier::Status::Verified:
+    return "verified";
+  case bios_verifier::Status::Bad:
+    return "bad";
+  case bios_verifier::Status::Missing:
+    break;
+  }
+  return "missing";
+}
+
+class VerifyWorker : public Napi::AsyncWorker {
+public:
+  VerifyWorker(Napi::Env env, std::string dir, std::vector<bios_verifier::Expected> files,
+               std::string cache_path)
+      : Napi::AsyncWorker(env),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        dir_(std::move(dir)),
+        files_(std::move(files)),
+        cache_path_(std::move(cache_path)) {}
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+protected:
+  void Execute() override {
+#ifndef _WIN32
+    bios_verifier::Cache cache;
+    if (!cache_path_.empty()) cache = bios_verifier::ReadCache(cache_path_);
+
+    reports_.resize(files_.size());
+    if (!files_.empty()) {
+      ThreadPool pool(std::min(ThreadPool::DefaultThreadCount(), files_.size()));
+      for (size_t i = 0; i < files_.size(); i++) {
+        pool.Submit([this, i, &cache] {
+          reports_[i] = bios_verifier::Verify(dir_, files_[i], cache);
+        });
+      }
+      pool.Wait();
+    }
+
+    bool dirty = false;
+    for (const auto &report : reports_) {
+      if (report.cached || report.md5.empty()) continue;
+      cache[fs_util::JoinPath(dir_, report.file)] =
+          bios_verifier::CacheEntry{report.size, report.mtime_ms, report.md5};
+      dirty = true;
+    }
+    // A stale cache only costs a re-hash next time, so a write failure
+    // doesn't fail the check.
+    std::string error;
+    if (dirty && !cache_path_.empty()) bios_verifier::WriteCache(cache_path_, cache, &error);
+#else
+    SetError("Native BIOS verification is not supported on this platform");
+#endif
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::Array result = Napi::Array::New(env, reports_.size());
+    for (size_t i = 0; i < reports_.size(); i++) {
+      const auto &report = reports_[i];
+      Napi::Object o = Napi::Object::New(env);
+      o.Set("file", Napi::String::New(env, report.file));
+      o.Set("status", Napi::String::New(env, StatusName(report.status)));
+      o.Set("size", Napi::Number::New(env, static_cast<double>(report.size)));
+      o.Set("md5", report.md5.empty() ? env.Null() : Napi::String::New(env, report.md5));
+      o.Set("cached", Napi::Boolean::New(env, report.cached));
+      result.Set(static_cast<uint32_t>(i), o);
+    }
+    deferred_.Resolve(result);
+  }
+
+  void OnError(const Napi::Error &error) override { deferred_.Reject(error.Value()); }
+
+private:
+  Napi::Promise::Deferred deferred_;
+  std::string dir_;
+  std::vector<bios_verifier::Expected> files_;
+  std::string cache_path_;
+  std::vector<bios_verifier::Report> reports_;
+};
+
+} // namespace
+
+void BiosVerifier::Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("verifyBiosFiles", Napi::Function::New(env, VerifyBiosFiles, "verifyBiosFiles"));
+}
+
+Napi::Value BiosVerifier::VerifyBiosFiles(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsArray()) {
+    Napi::TypeError::New(env, "Expected (dir: string, files: Array, cachePath?: string)")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Array list = info[1].As<Napi::Array>();
+  std::vector<bios_verifier::Expected> files;
+  files.reserve(list.Length());
+  for (uint32_t i = 0; i < list.Length(); i++) {
+    Napi::Value item = list.Get(i);
+    Napi::Value file = item.IsObject() ? item.As<Napi::Object>().Get("file") : env.Undefined();
+    if (!file.IsString()) {
+      Napi::TypeError::New(env, "Expected { file: string } entries").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    Napi::Object o = item.As<Napi::Object>();
+    bios_verifier::Expected expected;
+    expected.file = file.As<Napi::String>().Utf8Value();
+    Napi::Value md5 = o.Get("md5");
+    if (md5.IsArray()) {
+      Napi::Array hashes = md5.As<Napi::Array>();
+      for (uint32_t j = 0; j < hashes.Length(); j++) {
+        Napi::Value hash = hashes.Get(j);
+        if (hash.IsString()) {
+          expected.md5.push_back(fs_util::Lowercase(hash.As<Napi::String>().Utf8Value()));
+        }
+      }
+    }
+    Napi::Value size = o.Get("size");
+    if (size.IsNumber()) {
+      expected.size = static_cast<uint64_t>(size.As<Napi::Number>().Int64Value());
+    }
+    files.push_back(std::move(expected));
+  }
+
+  std::string cache_path;
+  if (info.Length() >= 3 && info[2].IsString()) {
+    cache_path = info[2].As<Napi::String>().Utf8Value();
+  }
+
+  auto *worker = new VerifyWorker(env, info[0].As<Napi::String>().Utf8Value(), std::move(files),
+                                  std::move(cache_path));
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
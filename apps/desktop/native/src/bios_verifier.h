@@ -0,0 +1,79 @@
+#ifndef BIOS_VERIFIER_H
+#define BIOS_VERIFIER_H
+
+#include <napi.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// BIOS / system-file verification ahead of LoadCore.
+//
+// Each expected file in the system directory is MD5-hashed off the JS thread
+// and compared with its known-good dumps, so a missing or bad BIOS shows up
+// before the core is loaded instead of as a failed boot in the log. Hashes
+// are cached by path, size and mtime in a small text file, so after the first
+// run a check is a stat() per file. Verified files found in the cache are
+// prefetched into the page cache (the hash read already did that for the
+// others), since the core is about to read them.
+namespace bios_verifier {
+
+using Md5 = std::array<uint8_t, 16>;
+
+Md5 Md5Of(const uint8_t *data, size_t length);
+std::string ToHex(const Md5 &md5);
+
+struct CacheEntry {
+  uint64_t size = 0;
+  double mtime_ms = 0;
+  std::string md5; // lowercase hex
+};
+
+using Cache = std::unordered_map<std::string, CacheEntry>;
+
+// Missing or malformed caches load as empty.
+Cache ReadCache(const std::string &path);
+bool WriteCache(const std::string &path, const Cache &cache, std::string *error);
+
+struct Expected {
+  std::string file;            // name within the system directory
+  std::vector<std::string> md5; // known-good dumps, lowercase hex; empty = any
+  uint64_t size = 0;           // 0 = any
+};
+
+enum class Status { Verified, Missing, Bad };
+
+struct Report {
+  std::string file;
+  Status status = Status::Missing;
+  uint64_t size = 0;
+  double mtime_ms = 0;
+  std::string md5;
+  bool cached = false; // md5 came from the cache rather than a fresh hash
+};
+
+// Check one file against `cache` (keyed by full path). Safe to call
+// concurrently; fold the uncached reports back into the cache afterwards.
+Report Verify(const std::string &dir, const Expected &expected, const Cache &cache);
+
+} // namespace bios_verifier
+
+// N-API wrapper:
+//
+//   verifyBiosFiles(dir, files: Array<{ file, md5: string[], size? }>, cachePath?)
+//     → Promise<Array<{ file, status: "verified" | "missing" | "bad",
+//                       size, md5: string | null, cached }>>
+//
+// Results are in input order. Files are checked in parallel; the cache file
+// is rewritten only when a hash was computed.
+class BiosVerifier {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+
+private:
+  static Napi::Value VerifyBiosFiles(const Napi::CallbackInfo &info);
+};
+
+#endif // BIOS_VERIFIER_H
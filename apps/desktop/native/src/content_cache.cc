@@ -0,0 +1,254 @@
+#include "content_cache.h"
+
+#include <cerrno>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <fstream>
+#include <sys/stat.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __APPLE__
+#include <sys/clonefile.h>
+#elif defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+#include "fs_util.h"
+#endif
+
+namespace content_cache {
+
+namespace {
+
+std::mutex g_mutex;
+// Weak, so an entry never keeps its content alive; expired ones are pruned
+// on the next Acquire.
+std::unordered_map<std::string, std::weak_ptr<const Content>> g_contents;
+uint64_t g_hits = 0;
+uint64_t g_misses = 0;
+std::string g_snapshot_dir;
+
+#ifndef _WIN32
+// Copy `from` to a new file `to`, cloning the extents where the filesystem
+// can (APFS, btrfs, XFS) so even disc images cost no I/O or space.
+bool CloneOrCopy(const std::string &from, const std::string &to) {
+#ifdef __APPLE__
+  if (clonefile(from.c_str(), to.c_str(), 0) == 0) return true;
+#endif
+  int in = open(from.c_str(), O_RDONLY | O_CLOEXEC);
+  if (in < 0) return false;
+  int out = open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (out < 0) {
+    close(in);
+    return false;
+  }
+  bool ok = false;
+#ifdef FICLONE
+  ok = ioctl(out, FICLONE, in) == 0;
+#endif
+  if (!ok) {
+    ok = true;
+    char buf[64 * 1024];
+    while (ok) {
+      ssize_t n = read(in, buf, sizeof(buf));
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) {
+        ok = n == 0;
+        break;
+      }
+      for (ssize_t done = 0; done < n;) {
+        ssize_t w = write(out, buf + done, static_cast<size_t>(n - done));
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) {
+          ok = false;
+          break;
+        }
+        done += w;
+      }
+    }
+  }
+  close(in);
+  if (close(out) != 0) ok = false;
+  return ok;
+}
+
+// Path of a read-only snapshot of `path` as `st` describes it, made on
+// first use. Snapshots are only ever created by rename and never written
+// again, so mapping one can't fault the way mapping the user's file can.
+// Empty when there's no snapshot directory or the copy failed.
+std::string Snapshot(const std::string &path, const struct stat &st) {
+  if (g_snapshot_dir.empty()) return "";
+
+  uint64_t path_hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : path) path_hash = (path_hash ^ c) * 0x100000001b3ULL;
+  char prefix[24];
+  snprintf(prefix, sizeof(prefix), "%016" PRIx64 "-", path_hash);
+  char name[96];
+  snprintf(name, sizeof(name), "%s%" PRIx64 "-%" PRIx64 ".rom", prefix,
+           static_cast<uint64_t>(st.st_size),
+           static_cast<uint64_t>(std::llround(fs_util::MtimeMs(st) * 1000)));
+  std::string snapshot = fs_util::JoinPath(g_snapshot_dir, name);
+
+  struct stat existing;
+  if (stat(snapshot.c_str(), &existing) == 0 && existing.st_size == st.st_size) return snapshot;
+
+  mkdir(g_snapshot_dir.c_str(), 0700);
+  std::string tmp = snapshot + ".tmp" + std::to_string(getpid());
+  unlink(tmp.c_str());
+  // A source rewritten mid-copy would give a snapshot that matches neither
+  // version, so check it is still the file `st` describes.
+  struct stat after;
+  bool ok = CloneOrCopy(path, tmp) && stat(path.c_str(), &after) == 0 &&
+            after.st_size == st.st_size && fs_util::MtimeMs(after) == fs_util::MtimeMs(st) &&
+            chmod(tmp.c_str(), 0444) == 0 && rename(tmp.c_str(), snapshot.c_str()) == 0;
+  if (!ok) {
+    unlink(tmp.c_str());
+    return "";
+  }
+
+  // Drop snapshots of earlier versions of the same file. Unlinking is safe
+  // for processes that still map them; other processes' temp files stay.
+  if (DIR *dir = opendir(g_snapshot_dir.c_str())) {
+    size_t prefix_len = strlen(prefix);
+    while (dirent *entry = readdir(dir)) {
+      if (strncmp(entry->d_name, prefix, prefix_len) == 0 && strcmp(entry->d_name, name) != 0 &&
+          !strstr(entry->d_name, ".tmp")) {
+        unlink(fs_util::JoinPath(g_snapshot_dir, entry->d_name).c_str());
+      }
+    }
+    closedir(dir);
+  }
+  return snapshot;
+}
+#endif
+
+} // namespace
+
+Content::~Content() {
+  if (!data_) return;
+#ifndef _WIN32
+  if (mapped_) {
+    munmap(data_, size_);
+    return;
+  }
+#endif
+  delete[] data_;
+}
+
+void SetSnapshotDirectory(const std::string &dir) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_snapshot_dir = dir;
+}
+
+std::shared_ptr<const Content> Acquire(const std::string &path, std::string *error) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+
+  for (auto it = g_contents.begin(); it != g_contents.end();) {
+    it = it->second.expired() ? g_contents.erase(it) : std::next(it);
+  }
+
+#ifdef _WIN32
+  struct _stat64 st;
+  if (_stat64(path.c_str(), &st) != 0) {
+    *error = "Failed to open ROM: " + path;
+    return nullptr;
+  }
+  double mtime_ms = static_cast<double>(st.st_mtime) * 1000;
+#else
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    *error = "Failed to open ROM: " + path;
+    return nullptr;
+  }
+  double mtime_ms = fs_util::MtimeMs(st);
+#endif
+  size_t size = static_cast<size_t>(st.st_size);
+
+  auto found = g_contents.find(path);
+  if (found != g_contents.end()) {
+    std::shared_ptr<const Content> live = found->second.lock();
+    if (live && live->size_ == size && live->mtime_ms_ == mtime_ms) {
+      g_hits++;
+      return live;
+    }
+  }
+
+  std::shared_ptr<Content> content(new Content());
+  content->size_ = size;
+  content->mtime_ms_ = mtime_ms;
+
+  if (size > 0) {
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    content->data_ = new uint8_t[size];
+    if (!file.read(reinterpret_cast<char *>(content->data_), size)) {
+      *error = "Failed to read ROM: " + path;
+      return nullptr;
+    }
+#else
+    // Only map what can't be truncated under us (see the header): the
+    // file itself when we can't write it, otherwise our snapshot of it.
+    std::string source = access(path.c_str(), W_OK) != 0 ? path : Snapshot(path, st);
+    int fd = open((source.empty() ? path : source).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      *error = "Failed to open ROM: " + path + " (" + strerror(errno) + ")";
+      return nullptr;
+    }
+    if (!source.empty()) {
+      void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      close(fd);
+      if (mapping == MAP_FAILED) {
+        *error = "Failed to map ROM: " + path + " (" + strerror(errno) + ")";
+        return nullptr;
+      }
+      content->data_ = static_cast<uint8_t *>(mapping);
+      content->mapped_ = true;
+    } else {
+      content->data_ = new uint8_t[size];
+      size_t done = 0;
+      while (done < size) {
+        ssize_t n = read(fd, content->data_ + done, size - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += static_cast<size_t>(n);
+      }
+      close(fd);
+      if (done != size) {
+        *error = "Failed to read ROM: " + path;
+        return nullptr;
+      }
+    }
+#endif
+  }
+
+  g_misses++;
+  g_contents[path] = content;
+  return content;
+}
+
+Stats GetStats() {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  Stats stats;
+  stats.hits = g_hits;
+  stats.misses = g_misses;
+  for (const auto &entry : g_contents) {
+    if (std::shared_ptr<const Content> live = entry.second.lock()) {
+      stats.entries++;
+      stats.bytes += live->size();
+    }
+  }
+  return stats;
+}
+
+} // namespace content_cache
@@ -0,0 +1,75 @@
+#ifndef CONTENT_CACHE_H
+#define CONTENT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Process-wide cache of loaded content (no N-API surface of its own;
+// LibretroCore acquires through it in loadGame).
+//
+// Content is shared by every holder of the same path while its size and
+// mtime are unchanged: each Acquire is a reference, and the content goes
+// away with the last one. A file whose size or mtime changed since the
+// live copy was opened is opened afresh rather than reused.
+//
+// Content is mapped rather than read into the heap. Across processes the
+// pages come from the OS page cache, so N workers with the same 64 MB ROM
+// cost 64 MB, not N x 64 MB. A mapped file that is truncated in place (a
+// re-extract, an overwrite, a sync tool) raises SIGBUS on the next access
+// past its new end and would take the worker down, so writable files are
+// never mapped directly: the mapping is of an app-owned, read-only snapshot
+// in the snapshot directory, keyed by path, size and mtime. Snapshots are
+// cloned where the filesystem supports it (APFS, btrfs, XFS) and copied
+// otherwise; a snapshot is replaced when its source changes. Files this
+// process can't write are mapped as they are. Without a snapshot directory,
+// or if the snapshot can't be made, writable files are read into memory.
+//
+// Mappings are private and writable: pages stay shared until a core writes
+// through the (nominally const) data pointer, which then copies just that
+// page for that process instead of faulting. On Windows content is always
+// read into memory, still shared within the process.
+namespace content_cache {
+
+class Content {
+public:
+  ~Content();
+  Content(const Content &) = delete;
+  Content &operator=(const Content &) = delete;
+
+  const uint8_t *data() const { return data_; }
+  size_t size() const { return size_; }
+  // True when backed by a file mapping rather than a heap copy.
+  bool mapped() const { return mapped_; }
+
+private:
+  friend std::shared_ptr<const Content> Acquire(const std::string &, std::string *);
+  Content() = default;
+
+  uint8_t *data_ = nullptr;
+  size_t size_ = 0;
+  double mtime_ms_ = 0;
+  bool mapped_ = false;
+};
+
+// Where snapshots of writable content are kept (process-wide; empty
+// disables them). Set before the first Acquire.
+void SetSnapshotDirectory(const std::string &dir);
+
+// Shared view of `path`, opening it only when no live view matches its
+// current size and mtime. Null (with `error` set) when it can't be read.
+std::shared_ptr<const Content> Acquire(const std::string &path, std::string *error);
+
+struct Stats {
+  size_t entries = 0;      // distinct live contents
+  uint64_t bytes = 0;      // their total size
+  uint64_t hits = 0;       // acquires served by a live content
+  uint64_t misses = 0;     // acquires that opened the file
+};
+
+Stats GetStats();
+
+} // namespace content_cache
+
+#endif // CONTENT_CACHE_H
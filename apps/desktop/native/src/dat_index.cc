@@ -0,0 +1,816 @@
+#include "dat_index.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <utility>
+
+namespace dat_index {
+
+namespace {
+
+constexpr char kCacheMagic[8] = {'G', 'L', 'D', 'A', 'T', '\0', '\0', '\1'};
+constexpr uint32_t kCacheVersion = 1;
+
+struct CacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t key_size;
+  uint32_t dat_count;
+  uint32_t game_count;
+  uint32_t rom_count;
+  uint32_t sha1_count;
+  uint32_t md5_count;
+  uint32_t crc_count;
+  uint64_t strings_size;
+};
+
+static_assert(sizeof(Dat) == 4, "Dat layout changed");
+static_assert(sizeof(Game) == 16, "Game layout changed");
+static_assert(sizeof(Rom) == 64, "Rom layout changed");
+
+bool ReadFile(const std::string &path, std::string *out) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  out->clear();
+  char buf[64 * 1024];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out->append(buf, n);
+  fclose(f);
+  return true;
+}
+
+int HexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Case-insensitive; `bytes` is the expected decoded length.
+bool ParseHex(const std::string &hex, uint8_t *out, size_t bytes) {
+  if (hex.size() != bytes * 2) return false;
+  for (size_t i = 0; i < bytes; i++) {
+    int hi = HexDigit(hex[i * 2]);
+    int lo = HexDigit(hex[i * 2 + 1]);
+    if (hi < 0 || lo < 0) return false;
+    out[i] = static_cast<uint8_t>((hi << 4) | lo);
+  }
+  return true;
+}
+
+bool ParseCrc(const std::string &hex, uint32_t *out) {
+  uint8_t bytes[4];
+  if (!ParseHex(hex, bytes, 4)) return false;
+  *out = (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+         (static_cast<uint32_t>(bytes[2]) << 8) | bytes[3];
+  return true;
+}
+
+std::string Basename(const std::string &path) {
+  size_t slash = path.find_last_of("/\\");
+  std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+  size_t dot = name.rfind('.');
+  return dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+}
+
+// Shared by both formats: one <rom>/<disk> or rom ( ... ) entry.
+void AddRom(Data *data, uint32_t game, const std::string &name, const std::string &size,
+            const std::string &crc, const std::string &md5, const std::string &sha1) {
+  Rom rom;
+  memset(&rom, 0, sizeof(rom));
+  rom.game = game;
+  rom.name = data->Intern(name);
+  if (!size.empty()) {
+    char *end = nullptr;
+    unsigned long long value = strtoull(size.c_str(), &end, 10);
+    if (end && *end == '\0') {
+      rom.size = value;
+      rom.flags |= kHasSize;
+    }
+  }
+  if (ParseCrc(crc, &rom.crc32)) rom.flags |= kHasCrc;
+  if (ParseHex(md5, rom.md5.data(), 16)) rom.flags |= kHasMd5;
+  if (ParseHex(sha1, rom.sha1.data(), 20)) rom.flags |= kHasSha1;
+  if (rom.flags & (kHasCrc | kHasMd5 | kHasSha1)) data->roms.push_back(rom);
+}
+
+uint32_t AddGame(Data *data, uint32_t dat, const std::string &name) {
+  Game game;
+  memset(&game, 0, sizeof(game));
+  game.name = data->Intern(name);
+  game.description = game.name;
+  game.dat = dat;
+  data->games.push_back(game);
+  return static_cast<uint32_t>(data->games.size() - 1);
+}
+
+// ---------------------------------------------------------------------------
+// Logiqx XML
+// ---------------------------------------------------------------------------
+
+std::string DecodeEntities(const std::string &s) {
+  if (s.find('&') == std::string::npos) return s;
+  std::string out;
+  out.reserve(s.size());
+  for (size_t i = 0; i < s.size(); i++) {
+    if (s[i] != '&') {
+      out.push_back(s[i]);
+      continue;
+    }
+    size_t semi = s.find(';', i);
+    if (semi == std::string::npos || semi - i > 10) {
+      out.push_back('&');
+      continue;
+    }
+    std::string entity = s.substr(i + 1, semi - i - 1);
+    uint32_t cp = 0;
+    if (entity == "amp") cp = '&';
+    else if (entity == "lt") cp = '<';
+    else if (entity == "gt") cp = '>';
+    else if (entity == "quot") cp = '"';
+    else if (entity == "apos") cp = '\'';
+    else if (entity.size() > 1 && entity[0] == '#') {
+      bool hex = entity[1] == 'x' || entity[1] == 'X';
+      cp = static_cast<uint32_t>(strtoul(entity.c_str() + (hex ? 2 : 1), nullptr, hex ? 16 : 10));
+    }
+    if (cp == 0) {
+      out.push_back('&');
+      continue;
+    }
+    // Encode as UTF-8.
+    if (cp < 0x80) {
+      out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+      out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+      out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+      out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    i = semi;
+  }
+  return out;
+}
+
+struct Tag {
+  std::string name;
+  std::map<std::string, std::string> attrs;
+  bool closing = false;
+  bool self_closing = false;
+};
+
+// Parse the tag starting at text[pos] == '<'. Returns the position after '>'
+// or npos on malformed input.
+size_t ParseTag(const std::string &text, size_t pos, Tag *tag) {
+  size_t i = pos + 1;
+  tag->closing = i < text.size() && text[i] == '/';
+  if (tag->closing) i++;
+  size_t name_start = i;
+  while (i < text.size() && !isspace(static_cast<unsigned char>(text[i])) && text[i] != '>' &&
+         text[i] != '/') {
+    i++;
+  }
+  tag->name = text.substr(name_start, i - name_start);
+  tag->attrs.clear();
+  tag->self_closing = false;
+
+  while (i < text.size()) {
+    while (i < text.size() && isspace(static_cast<unsigned char>(text[i]))) i++;
+    if (i >= text.size()) return std::string::npos;
+    if (text[i] == '>') return i + 1;
+    if (text[i] == '/') {
+      tag->self_closing = true;
+      i++;
+      continue;
+    }
+    size_t key_start = i;
+    while (i < text.size() && text[i] != '=' && text[i] != '>' &&
+           !isspace(static_cast<unsigned char>(text[i]))) {
+      i++;
+    }
+    std::string key = text.substr(key_start, i - key_start);
+    while (i < text.size() && isspace(static_cast<unsigned char>(text[i]))) i++;
+    if (i >= text.size() || text[i] != '=') continue;
+    i++;
+    while (i < text.size() && isspace(static_cast<unsigned char>(text[i]))) i++;
+    if (i >= text.size() || (text[i] != '"' && text[i] != '\'')) return std::string::npos;
+    char quote = text[i++];
+    size_t end = text.find(quote, i);
+    if (end == std::string::npos) return std::string::npos;
+    tag->attrs[key] = DecodeEntities(text.substr(i, end - i));
+    i = end + 1;
+  }
+  return std::string::npos;
+}
+
+bool ParseXml(const std::string &text, Data *data, uint32_t dat, std::string *error) {
+  bool in_header = false;
+  int64_t game = -1;
+  std::string *capture = nullptr;
+  std::string header_name, description, captured;
+
+  Tag tag;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t lt = text.find('<', pos);
+    if (lt == std::string::npos) break;
+    if (capture) captured.append(text, pos, lt - pos);
+
+    if (text.compare(lt, 4, "<!--") == 0) {
+      size_t end = text.find("-->", lt);
+      pos = end == std::string::npos ? text.size() : end + 3;
+      continue;
+    }
+    if (text.compare(lt, 2, "<?") == 0 || text.compare(lt, 2, "<!") == 0) {
+      size_t end = text.find('>', lt);
+      pos = end == std::string::npos ? text.size() : end + 1;
+      continue;
+    }
+
+    size_t next = ParseTag(text, lt, &tag);
+    if (next == std::string::npos) {
+      *error = "malformed XML near offset " + std::to_string(lt);
+      return false;
+    }
+    pos = next;
+
+    bool is_game = tag.name == "game" || tag.name == "machine";
+    if (tag.closing) {
+      if (capture && (tag.name == "name" || tag.name == "description")) {
+        *capture = DecodeEntities(captured);
+        capture = nullptr;
+        if (game >= 0 && !description.empty()) {
+          data->games[static_cast<size_t>(game)].description = data->Intern(description);
+        }
+      } else if (tag.name == "header") {
+        in_header = false;
+      } else if (is_game) {
+        game = -1;
+      }
+      continue;
+    }
+
+    if (tag.name == "header") {
+      in_header = !tag.self_closing;
+    } else if (tag.name == "name" && in_header && game < 0 && !tag.self_closing) {
+      capture = &header_name;
+      captured.clear();
+    } else if (is_game && !tag.self_closing) {
+      game = AddGame(data, dat, tag.attrs["name"]);
+      description.clear();
+    } else if (tag.name == "description" && game >= 0 && !tag.self_closing) {
+      capture = &description;
+      captured.clear();
+    } else if ((tag.name == "rom" || tag.name == "disk") && game >= 0) {
+      AddRom(data, static_cast<uint32_t>(game), tag.attrs["name"], tag.attrs["size"],
+             tag.attrs["crc"], tag.attrs["md5"], tag.attrs["sha1"]);
+    }
+  }
+
+  if (!header_name.empty()) data->dats[dat].name = data->Intern(header_name);
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// clrmamepro
+// ---------------------------------------------------------------------------
+
+class CmpTokenizer {
+public:
+  explicit CmpTokenizer(const std::string &text) : text_(text) {}
+
+  // Returns false at end of input. `quoted` distinguishes "(" from '('.
+  bool Next(std::string *token, bool *quoted) {
+    while (pos_ < text_.size() && isspace(static_cast<unsigned char>(text_[pos_]))) pos_++;
+    if (pos_ >= text_.size()) return false;
+    *quoted = false;
+    char c = text_[pos_];
+    if (c == '(' || c == ')') {
+      token->assign(1, c);
+      pos_++;
+      return true;
+    }
+    if (c == '"') {
+      size_t end = text_.find('"', pos_ + 1);
+      if (end == std::string::npos) end = text_.size();
+      token->assign(text_, pos_ + 1, end - pos_ - 1);
+      *quoted = true;
+      pos_ = end + 1;
+      return true;
+    }
+    size_t start = pos_;
+    while (pos_ < text_.size() && !isspace(static_cast<unsigned char>(text_[pos_])) &&
+           text_[pos_] != '(' && text_[pos_] != ')') {
+      pos_++;
+    }
+    token->assign(text_, start, pos_ - start);
+    return true;
+  }
+
+private:
+  const std::string &text_;
+  size_t pos_ = 0;
+};
+
+bool IsOpen(const std::string &token, bool quoted) {
+  return !quoted && token == "(";
+}
+bool IsClose(const std::string &token, bool quoted) {
+  return !quoted && token == ")";
+}
+
+// Read `key value` pairs up to the matching ')'. Nested blocks are handed to
+// `on_block(key)`, which must consume through their closing ')'.
+template <typename OnValue, typename OnBlock>
+bool ReadBlock(CmpTokenizer &tok, OnValue on_value, OnBlock on_block) {
+  std::string key, value;
+  bool quoted;
+  while (tok.Next(&key, &quoted)) {
+    if (IsClose(key, quoted)) return true;
+    if (!tok.Next(&value, &quoted)) return false;
+    if (IsOpen(value, quoted)) {
+      if (!on_block(key)) return false;
+    } else {
+      on_value(key, value);
+    }
+  }
+  return false;
+}
+
+bool SkipBlock(CmpTokenizer &tok) {
+  return ReadBlock(
+      tok, [](const std::string &, const std::string &) {},
+      [&tok](const std::string &) { return SkipBlock(tok); });
+}
+
+bool ParseClrmamepro(const std::string &text, Data *data, uint32_t dat, std::string *error) {
+  CmpTokenizer tok(text);
+  std::string word, open;
+  bool quoted;
+  while (tok.Next(&word, &quoted)) {
+    if (!tok.Next(&open, &quoted) || !IsOpen(open, quoted)) {
+      *error = "expected '(' after \"" + word + "\"";
+      return false;
+    }
+
+    bool ok;
+    if (word == "clrmamepro" || word == "header") {
+      ok = ReadBlock(
+          tok,
+          [&](const std::string &key, const std::string &value) {
+            if (key == "name") data->dats[dat].name = data->Intern(value);
+          },
+          [&tok](const std::string &) { return SkipBlock(tok); });
+    } else if (word == "game" || word == "machine" || word == "resource") {
+      uint32_t game = AddGame(data, dat, "");
+      ok = ReadBlock(
+          tok,
+          [&](const std::string &key, const std::string &value) {
+            if (key == "name") {
+              bool had_description = data->games[game].description != data->games[game].name;
+              data->games[game].name = data->Intern(value);
+              if (!had_description) data->games[game].description = data->games[game].name;
+            } else if (key == "description") {
+              data->games[game].description = data->Intern(value);
+            }
+          },
+          [&](const std::string &key) {
+            if (key != "rom" && key != "disk") return SkipBlock(tok);
+            std::string name, size, crc, md5, sha1;
+            bool read = ReadBlock(
+                tok,
+                [&](const std::string &k, const std::string &v) {
+                  if (k == "name") name = v;
+                  else if (k == "size") size = v;
+                  else if (k == "crc") crc = v;
+                  else if (k == "md5") md5 = v;
+                  else if (k == "sha1") sha1 = v;
+                },
+                [&tok](const std::string &) { return SkipBlock(tok); });
+            AddRom(data, game, name, size, crc, md5, sha1);
+            return read;
+          });
+    } else {
+      ok = SkipBlock(tok);
+    }
+
+    if (!ok) {
+      *error = "unterminated \"" + word + "\" block";
+      return false;
+    }
+  }
+  return true;
+}
+
+// "(Disc 2)" → 2, with the tag (and one preceding space) cut from `base`.
+uint16_t ParseDisc(const std::string &name, std::string *base) {
+  size_t at = name.find("(Disc ");
+  if (at == std::string::npos) return 0;
+  size_t i = at + 6;
+  unsigned value = 0;
+  size_t digits = 0;
+  while (i < name.size() && name[i] >= '0' && name[i] <= '9' && digits < 4) {
+    value = value * 10 + static_cast<unsigned>(name[i++] - '0');
+    digits++;
+  }
+  if (digits == 0 || i >= name.size() || name[i] != ')') return 0;
+  size_t cut_from = at > 0 && name[at - 1] == ' ' ? at - 1 : at;
+  *base = name.substr(0, cut_from) + name.substr(i + 1);
+  return static_cast<uint16_t>(value);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Data
+// ---------------------------------------------------------------------------
+
+std::string Data::String(uint32_t offset) const {
+  if (static_cast<uint64_t>(offset) + 4 > strings.size()) return "";
+  uint32_t len;
+  memcpy(&len, strings.data() + offset, sizeof(len));
+  if (static_cast<uint64_t>(offset) + 4 + len > strings.size()) return "";
+  return strings.substr(offset + 4, len);
+}
+
+uint32_t Data::Intern(const std::string &s) {
+  uint32_t offset = static_cast<uint32_t>(strings.size());
+  uint32_t len = static_cast<uint32_t>(s.size());
+  strings.append(reinterpret_cast<const char *>(&len), sizeof(len));
+  strings += s;
+  return offset;
+}
+
+void Data::Finish() {
+  // Disc sets: games sharing a DAT and a name once "(Disc N)" is removed.
+  std::map<std::pair<uint32_t, std::string>, uint16_t> set_sizes;
+  std::vector<std::string> bases(games.size());
+  for (size_t g = 0; g < games.size(); g++) {
+    games[g].disc_number = ParseDisc(String(games[g].name), &bases[g]);
+    if (games[g].disc_number == 0) continue;
+    uint16_t &total = set_sizes[{games[g].dat, bases[g]}];
+    total = std::max<uint16_t>(static_cast<uint16_t>(total + 1), games[g].disc_number);
+  }
+  for (size_t g = 0; g < games.size(); g++) {
+    if (games[g].disc_number != 0) games[g].disc_total = set_sizes[{games[g].dat, bases[g]}];
+  }
+
+  by_sha1.clear();
+  by_md5.clear();
+  by_crc.clear();
+  for (uint32_t r = 0; r < roms.size(); r++) {
+    if (roms[r].flags & kHasSha1) by_sha1.push_back(r);
+    if (roms[r].flags & kHasMd5) by_md5.push_back(r);
+    if (roms[r].flags & kHasCrc) by_crc.push_back(r);
+  }
+  std::sort(by_sha1.begin(), by_sha1.end(), [this](uint32_t a, uint32_t b) {
+    return memcmp(roms[a].sha1.data(), roms[b].sha1.data(), 20) < 0;
+  });
+  std::sort(by_md5.begin(), by_md5.end(), [this](uint32_t a, uint32_t b) {
+    return memcmp(roms[a].md5.data(), roms[b].md5.data(), 16) < 0;
+  });
+  std::sort(by_crc.begin(), by_crc.end(),
+            [this](uint32_t a, uint32_t b) { return roms[a].crc32 < roms[b].crc32; });
+}
+
+bool Data::WriteCache(const std::string &path, const std::string &key, std::string *error) const {
+  CacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+  header.version = kCacheVersion;
+  header.key_size = static_cast<uint32_t>(key.size());
+  header.dat_count = static_cast<uint32_t>(dats.size());
+  header.game_count = static_cast<uint32_t>(games.size());
+  header.rom_count = static_cast<uint32_t>(roms.size());
+  header.sha1_count = static_cast<uint32_t>(by_sha1.size());
+  header.md5_count = static_cast<uint32_t>(by_md5.size());
+  header.crc_count = static_cast<uint32_t>(by_crc.size());
+  header.strings_size = strings.size();
+
+  std::string tmp = path + ".tmp";
+  FILE *f = fopen(tmp.c_str(), "wb");
+  if (!f) {
+    *error = std::string("cannot write DAT cache: ") + strerror(errno);
+    return false;
+  }
+  auto put = [f](const void *p, size_t n) { return n == 0 || fwrite(p, 1, n, f) == n; };
+  bool ok = put(&header, sizeof(header)) && put(key.data(), key.size()) &&
+            put(dats.data(), dats.size() * sizeof(Dat)) &&
+            put(games.data(), games.size() * sizeof(Game)) &&
+            put(roms.data(), roms.size() * sizeof(Rom)) &&
+            put(by_sha1.data(), by_sha1.size() * 4) && put(by_md5.data(), by_md5.size() * 4) &&
+            put(by_crc.data(), by_crc.size() * 4) && put(strings.data(), strings.size());
+  ok = fclose(f) == 0 && ok;
+#ifdef _WIN32
+  if (ok) std::remove(path.c_str());
+#endif
+  if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+    *error = std::string("cannot write DAT cache: ") + strerror(errno);
+    std::remove(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool Data::ReadCache(const std::string &path, const std::string &key, std::string *error) {
+  std::string bytes;
+  if (!ReadFile(path, &bytes)) return false;
+
+  CacheHeader header;
+  if (bytes.size() < sizeof(header)) return false;
+  memcpy(&header, bytes.data(), sizeof(header));
+  if (memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+      header.version != kCacheVersion || header.key_size != key.size() ||
+      bytes.compare(sizeof(header), key.size(), key) != 0) {
+    return false;
+  }
+
+  uint64_t expected = sizeof(header) + static_cast<uint64_t>(header.key_size) +
+                      static_cast<uint64_t>(header.dat_count) * sizeof(Dat) +
+                      static_cast<uint64_t>(header.game_count) * sizeof(Game) +
+                      static_cast<uint64_t>(header.rom_count) * sizeof(Rom) +
+                      (static_cast<uint64_t>(header.sha1_count) + header.md5_count +
+                       header.crc_count) * 4 +
+                      header.strings_size;
+  if (expected != bytes.size() || header.sha1_count > header.rom_count ||
+      header.md5_count > header.rom_count || header.crc_count > header.rom_count) {
+    *error = "DAT cache is corrupt";
+    return false;
+  }
+
+  size_t pos = sizeof(header) + header.key_size;
+  auto take = [&bytes, &pos](auto &vec, uint32_t count) {
+    vec.resize(count);
+    size_t n = count * sizeof(vec[0]);
+    if (n) memcpy(vec.data(), bytes.data() + pos, n);
+    pos += n;
+  };
+  take(dats, header.dat_count);
+  take(games, header.game_count);
+  take(roms, header.rom_count);
+  take(by_sha1, header.sha1_count);
+  take(by_md5, header.md5_count);
+  take(by_crc, header.crc_count);
+  strings.assign(bytes, pos, static_cast<size_t>(header.strings_size));
+
+  for (uint32_t index : by_sha1) {
+    if (index >= roms.size()) return (*error = "DAT cache is corrupt", false);
+  }
+  for (uint32_t index : by_md5) {
+    if (index >= roms.size()) return (*error = "DAT cache is corrupt", false);
+  }
+  for (uint32_t index : by_crc) {
+    if (index >= roms.size()) return (*error = "DAT cache is corrupt", false);
+  }
+  for (const auto &rom : roms) {
+    if (rom.game >= games.size()) return (*error = "DAT cache is corrupt", false);
+  }
+  for (const auto &game : games) {
+    if (game.dat >= dats.size()) return (*error = "DAT cache is corrupt", false);
+  }
+  return true;
+}
+
+bool ParseDatFile(const std::string &path, Data *data, std::string *error) {
+  std::string text;
+  if (!ReadFile(path, &text)) {
+    *error = std::string("cannot read: ") + strerror(errno);
+    return false;
+  }
+
+  uint32_t dat = static_cast<uint32_t>(data->dats.size());
+  data->dats.push_back({data->Intern(Basename(path))});
+
+  size_t first = text.find_first_not_of(" \t\r\n\xEF\xBB\xBF");
+  bool xml = first != std::string::npos && text[first] == '<';
+  return xml ? ParseXml(text, data, dat, error) : ParseClrmamepro(text, data, dat, error);
+}
+
+int64_t Match(const Data &data, const Query &query, MatchKind *kind) {
+  const auto &roms = data.roms;
+  if (query.has_sha1) {
+    auto it = std::lower_bound(data.by_sha1.begin(), data.by_sha1.end(), query.sha1,
+                               [&roms](uint32_t r, const std::array<uint8_t, 20> &h) {
+                                 return memcmp(roms[r].sha1.data(), h.data(), 20) < 0;
+                               });
+    if (it != data.by_sha1.end() && roms[*it].sha1 == query.sha1) {
+      *kind = MatchKind::Sha1;
+      return *it;
+    }
+  }
+  if (query.has_md5) {
+    auto it = std::lower_bound(data.by_md5.begin(), data.by_md5.end(), query.md5,
+                               [&roms](uint32_t r, const std::array<uint8_t, 16> &h) {
+                                 return memcmp(roms[r].md5.data(), h.data(), 16) < 0;
+                               });
+    if (it != data.by_md5.end() && roms[*it].md5 == query.md5) {
+      *kind = MatchKind::Md5;
+      return *it;
+    }
+  }
+  if (query.has_crc) {
+    // CRC32 alone collides across large sets, so the size must agree when
+    // both sides know it.
+    auto it = std::lower_bound(data.by_crc.begin(), data.by_crc.end(), query.crc32,
+                               [&roms](uint32_t r, uint32_t crc) { return roms[r].crc32 < crc; });
+    for (; it != data.by_crc.end() && roms[*it].crc32 == query.crc32; ++it) {
+      const Rom &rom = roms[*it];
+      if (query.has_size && (rom.flags & kHasSize) && rom.size != query.size) continue;
+      *kind = MatchKind::Crc32;
+      return *it;
+    }
+  }
+  *kind = MatchKind::None;
+  return -1;
+}
+
+} // namespace dat_index
+
+// ---------------------------------------------------------------------------
+// N-API binding
+// ---------------------------------------------------------------------------
+
+class DatLoadWorker : public Napi::AsyncWorker {
+public:
+  DatLoadWorker(Napi::Env env, DatIndex *owner, std::vector<std::string> files,
+                std::string cache_path, std::string cache_key)
+      : Napi::AsyncWorker(env),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        owner_(owner),
+        files_(std::move(files)),
+        cache_path_(std::move(cache_path)),
+        cache_key_(std::move(cache_key)),
+        data_(std::make_shared<dat_index::Data>()) {
+    owner_->Ref();
+  }
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+protected:
+  void Execute() override {
+    bool use_cache = !cache_path_.empty() && !cache_key_.empty();
+    if (use_cache) {
+      std::string error;
+      if (data_->ReadCache(cache_path_, cache_key_, &error)) {
+        from_cache_ = true;
+        return;
+      }
+      if (!error.empty()) errors_.emplace_back(cache_path_, error);
+      *data_ = dat_index::Data();
+    }
+
+    for (const auto &file : files_) {
+      std::string error;
+      if (!dat_index::ParseDatFile(file, data_.get(), &error)) errors_.emplace_back(file, error);
+    }
+    data_->Finish();
+
+    if (use_cache) {
+      std::string error;
+      if (!data_->WriteCache(cache_path_, cache_key_, &error)) {
+        errors_.emplace_back(cache_path_, error);
+      }
+    }
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    owner_->data_ = data_;
+    owner_->Unref();
+
+    Napi::Object summary = Napi::Object::New(env);
+    summary.Set("dats", Napi::Number::New(env, static_cast<double>(data_->dats.size())));
+    summary.Set("games", Napi::Number::New(env, static_cast<double>(data_->games.size())));
+    summary.Set("roms", Napi::Number::New(env, static_cast<double>(data_->roms.size())));
+    summary.Set("fromCache", Napi::Boolean::New(env, from_cache_));
+    Napi::Array errors = Napi::Array::New(env, errors_.size());
+    for (uint32_t i = 0; i < errors_.size(); i++) {
+      Napi::Object entry = Napi::Object::New(env);
+      entry.Set("path", Napi::String::New(env, errors_[i].first));
+      entry.Set("message", Napi::String::New(env, errors_[i].second));
+      errors.Set(i, entry);
+    }
+    summary.Set("errors", errors);
+    deferred_.Resolve(summary);
+  }
+
+  void OnError(const Napi::Error &error) override {
+    owner_->Unref();
+    deferred_.Reject(error.Value());
+  }
+
+private:
+  Napi::Promise::Deferred deferred_;
+  DatIndex *owner_;
+  std::vector<std::string> files_;
+  std::string cache_path_;
+  std::string cache_key_;
+  std::shared_ptr<dat_index::Data> data_;
+  bool from_cache_ = false;
+  std::vector<std::pair<std::string, std::string>> errors_;
+};
+
+void DatIndex::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "DatIndex", {
+    InstanceMethod("load", &DatIndex::Load),
+    InstanceMethod("match", &DatIndex::MatchHashes),
+  });
+  exports.Set("DatIndex", func);
+}
+
+DatIndex::DatIndex(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<DatIndex>(info), data_(std::make_shared<dat_index::Data>()) {}
+
+Napi::Value DatIndex::Load(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsObject()) {
+    Napi::TypeError::New(env, "Expected options object").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  Napi::Object options = info[0].As<Napi::Object>();
+  Napi::Value files_value = options.Get("files");
+  if (!files_value.IsArray()) {
+    Napi::TypeError::New(env, "options.files must be an array").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Array arr = files_value.As<Napi::Array>();
+  std::vector<std::string> files;
+  for (uint32_t i = 0; i < arr.Length(); i++) {
+    Napi::Value v = arr.Get(i);
+    if (v.IsString()) files.push_back(v.As<Napi::String>().Utf8Value());
+  }
+  Napi::Value cache_path = options.Get("cachePath");
+  Napi::Value cache_key = options.Get("cacheKey");
+
+  auto *worker = new DatLoadWorker(
+      env, this, std::move(files),
+      cache_path.IsString() ? cache_path.As<Napi::String>().Utf8Value() : "",
+      cache_key.IsString() ? cache_key.As<Napi::String>().Utf8Value() : "");
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
+
+Napi::Value DatIndex::MatchHashes(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected array of hashes").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  const dat_index::Data &data = *data_;
+  Napi::Array input = info[0].As<Napi::Array>();
+  Napi::Array result = Napi::Array::New(env, input.Length());
+  for (uint32_t i = 0; i < input.Length(); i++) {
+    Napi::Value v = input.Get(i);
+    result.Set(i, env.Null());
+    if (!v.IsObject()) continue;
+
+    Napi::Object entry = v.As<Napi::Object>();
+    dat_index::Query query;
+    Napi::Value crc = entry.Get("crc32");
+    Napi::Value md5 = entry.Get("md5");
+    Napi::Value sha1 = entry.Get("sha1");
+    Napi::Value size = entry.Get("size");
+    query.has_crc = crc.IsString() && dat_index::ParseCrc(crc.As<Napi::String>().Utf8Value(), &query.crc32);
+    query.has_md5 = md5.IsString() && dat_index::ParseHex(md5.As<Napi::String>().Utf8Value(), query.md5.data(), 16);
+    query.has_sha1 = sha1.IsString() && dat_index::ParseHex(sha1.As<Napi::String>().Utf8Value(), query.sha1.data(), 20);
+    if (size.IsNumber()) {
+      query.has_size = true;
+      query.size = static_cast<uint64_t>(size.As<Napi::Number>().Int64Value());
+    }
+
+    dat_index::MatchKind kind;
+    int64_t rom_index = dat_index::Match(data, query, &kind);
+    if (rom_index < 0) continue;
+
+    const dat_index::Rom &rom = data.roms[static_cast<size_t>(rom_index)];
+    const dat_index::Game &game = data.games[rom.game];
+    Napi::Object match = Napi::Object::New(env);
+    match.Set("dat", Napi::String::New(env, data.String(data.dats[game.dat].name)));
+    match.Set("name", Napi::String::New(env, data.String(game.name)));
+    match.Set("description", Napi::String::New(env, data.String(game.description)));
+    match.Set("romName", Napi::String::New(env, data.String(rom.name)));
+    match.Set("matchedBy", Napi::String::New(env, kind == dat_index::MatchKind::Sha1  ? "sha1"
+                                                  : kind == dat_index::MatchKind::Md5 ? "md5"
+                                                                                      : "crc32"));
+    if (game.disc_number != 0) {
+      match.Set("discNumber", Napi::Number::New(env, game.disc_number));
+      match.Set("discTotal", Napi::Number::New(env, game.disc_total));
+    }
+    result.Set(i, match);
+  }
+  return result;
+}
@@ -0,0 +1,116 @@
+#ifndef DAT_INDEX_H
+#define DAT_INDEX_H
+
+#include <napi.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ROM verification index built from No-Intro / Redump DAT files.
+//
+// Both Logiqx XML (<datafile><game><rom .../>) and clrmamepro text
+// (`game ( name "..." rom ( ... ) )`) are parsed into flat tables: one row
+// per DAT, per game and per ROM, plus ROM indexes sorted by SHA-1, MD5 and
+// CRC32. Games named "... (Disc N)" get their disc number and the size of
+// their disc set within the DAT.
+//
+// The tables are written to a cache file tagged with a caller-supplied key
+// (paths + sizes + mtimes of the DATs); a later load with the same key reads
+// the cache instead of re-parsing. Lookups are binary searches, so matching
+// tens of thousands of ROMs takes milliseconds.
+namespace dat_index {
+
+struct Dat {
+  uint32_t name; // string table offsets
+};
+
+struct Game {
+  uint32_t name;
+  uint32_t description;
+  uint32_t dat;
+  uint16_t disc_number; // 0 = not part of a disc set
+  uint16_t disc_total;
+};
+
+enum RomFlags : uint32_t {
+  kHasSize = 1u << 0,
+  kHasCrc = 1u << 1,
+  kHasMd5 = 1u << 2,
+  kHasSha1 = 1u << 3,
+};
+
+struct Rom {
+  uint32_t game;
+  uint32_t name;
+  uint64_t size;
+  uint32_t crc32;
+  uint32_t flags;
+  std::array<uint8_t, 16> md5;
+  std::array<uint8_t, 20> sha1;
+  uint32_t reserved;
+};
+
+struct Data {
+  std::vector<Dat> dats;
+  std::vector<Game> games;
+  std::vector<Rom> roms;
+  std::vector<uint32_t> by_sha1; // indexes into roms, sorted by hash
+  std::vector<uint32_t> by_md5;
+  std::vector<uint32_t> by_crc;
+  std::string strings; // u32 length + bytes per entry
+
+  std::string String(uint32_t offset) const;
+  uint32_t Intern(const std::string &s);
+  // Disc totals and hash indexes, after all DATs are parsed.
+  void Finish();
+
+  bool WriteCache(const std::string &path, const std::string &key, std::string *error) const;
+  // Returns false (with an empty error) when the cache is missing or stale.
+  bool ReadCache(const std::string &path, const std::string &key, std::string *error);
+};
+
+// Parse one DAT file into `data`.
+bool ParseDatFile(const std::string &path, Data *data, std::string *error);
+
+enum class MatchKind { None, Sha1, Md5, Crc32 };
+
+struct Query {
+  bool has_crc = false, has_md5 = false, has_sha1 = false, has_size = false;
+  uint32_t crc32 = 0;
+  std::array<uint8_t, 16> md5{};
+  std::array<uint8_t, 20> sha1{};
+  uint64_t size = 0;
+};
+
+// Best match for `query` (SHA-1, then MD5, then CRC32 + size), or -1.
+int64_t Match(const Data &data, const Query &query, MatchKind *kind);
+
+} // namespace dat_index
+
+// N-API wrapper:
+//
+//   const index = new DatIndex();
+//   await index.load({ files, cachePath?, cacheKey? })
+//     → { dats, games, roms, fromCache, errors: [{ path, message }] }
+//   index.match([{ crc32?, md5?, sha1?, size? }]) → Array<match | null>
+//
+// where match = { dat, name, description, romName, matchedBy,
+//                 discNumber?, discTotal? }.
+class DatIndex : public Napi::ObjectWrap<DatIndex> {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+  DatIndex(const Napi::CallbackInfo &info);
+
+private:
+  Napi::Value Load(const Napi::CallbackInfo &info);
+  Napi::Value MatchHashes(const Napi::CallbackInfo &info);
+
+  friend class DatLoadWorker;
+
+  std::shared_ptr<const dat_index::Data> data_;
+};
+
+#endif // DAT_INDEX_H
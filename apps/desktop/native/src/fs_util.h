@@ -0,0 +1,50 @@
+#ifndef FS_UTIL_H
+#define FS_UTIL_H
+
+#include <string>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+// Small path / stat helpers shared by the library scanner and watcher. Kept
+// header-only; the semantics deliberately mirror Node's `path` and `fs.Stats`
+// so values produced natively compare equal to those computed in JS.
+namespace fs_util {
+
+inline std::string Lowercase(std::string s) {
+  for (auto &c : s) {
+    if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+  }
+  return s;
+}
+
+// Matches Node's path.extname: a leading dot alone is not an extension.
+inline std::string ExtensionOf(const std::string &name) {
+  size_t dot = name.rfind('.');
+  if (dot == std::string::npos || dot == 0) return "";
+  return Lowercase(name.substr(dot));
+}
+
+inline std::string JoinPath(const std::string &dir, const std::string &name) {
+  if (!dir.empty() && dir.back() == '/') return dir + name;
+  return dir + "/" + name;
+}
+
+#ifndef _WIN32
+// Same arithmetic as Node's fs.Stats#mtimeMs (sec * 1e3 + nsec / 1e6) so the
+// values compare equal to romMtime stored by the JS scan path.
+inline double MtimeMs(const struct stat &st) {
+#ifdef __APPLE__
+  return static_cast<double>(st.st_mtimespec.tv_sec) * 1000 +
+         static_cast<double>(st.st_mtimespec.tv_nsec) / 1000000;
+#else
+  return static_cast<double>(st.st_mtim.tv_sec) * 1000 +
+         static_cast<double>(st.st_mtim.tv_nsec) / 1000000;
+#endif
+}
+#endif
+
+} // namespace fs_util
+
+#endif // FS_UTIL_H
@@ -0,0 +1,324 @@
+#include "image_resize.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "thread_pool.h"
+
+namespace image_resize {
+
+namespace {
+
+constexpr int kWeightBits = 14;
+constexpr int32_t kWeightOne = 1 << kWeightBits;
+constexpr int32_t kRound = 1 << (kWeightBits - 1);
+constexpr double kLanczosSupport = 3.0;
+constexpr double kPi = 3.14159265358979323846;
+
+double Sinc(double x) {
+  if (x == 0.0) return 1.0;
+  x *= kPi;
+  return std::sin(x) / x;
+}
+
+double Lanczos3(double x) {
+  if (x <= -kLanczosSupport || x >= kLanczosSupport) return 0.0;
+  return Sinc(x) * Sinc(x / kLanczosSupport);
+}
+
+// Per-output-sample filter taps along one axis.
+struct Kernel {
+  std::vector<int32_t> start; // first input sample per output sample
+  std::vector<int32_t> count; // taps per output sample
+  std::vector<int16_t> weights; // `taps` slots per output sample
+  int32_t taps = 0;
+};
+
+Kernel BuildKernel(uint32_t in_size, uint32_t out_size) {
+  Kernel k;
+  double scale = static_cast<double>(in_size) / out_size;
+  double filter_scale = std::max(scale, 1.0);
+  double support = kLanczosSupport * filter_scale;
+  k.taps = static_cast<int32_t>(std::ceil(support)) * 2 + 1;
+  k.start.resize(out_size);
+  k.count.resize(out_size);
+  k.weights.assign(static_cast<size_t>(out_size) * k.taps, 0);
+
+  std::vector<double> w(static_cast<size_t>(k.taps));
+  for (uint32_t i = 0; i < out_size; i++) {
+    double center = (i + 0.5) * scale;
+    int32_t lo = std::max(0, static_cast<int32_t>(std::floor(center - support)));
+    int32_t hi = std::min(static_cast<int32_t>(in_size), static_cast<int32_t>(std::ceil(center + support)));
+    int32_t n = std::min(hi - lo, k.taps);
+
+    double total = 0;
+    for (int32_t j = 0; j < n; j++) {
+      w[j] = Lanczos3((lo + j + 0.5 - center) / filter_scale);
+      total += w[j];
+    }
+
+    // Quantize, then push the rounding error onto the largest tap so every
+    // row of weights sums to exactly 1.0 and flat regions stay flat.
+    int16_t *out = &k.weights[static_cast<size_t>(i) * k.taps];
+    int32_t sum = 0, largest = 0;
+    for (int32_t j = 0; j < n; j++) {
+      out[j] = static_cast<int16_t>(std::lround(w[j] / total * kWeightOne));
+      sum += out[j];
+      if (out[j] > out[largest]) largest = j;
+    }
+    out[largest] = static_cast<int16_t>(out[largest] + (kWeightOne - sum));
+    k.start[i] = lo;
+    k.count[i] = n;
+  }
+  return k;
+}
+
+uint8_t Clamp(int32_t v) {
+  v >>= kWeightBits;
+  return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+// Premultiplied colour can't exceed alpha; Lanczos overshoot can push it
+// there at hard edges.
+void ClampToAlpha(uint8_t *px, size_t pixels) {
+  for (size_t i = 0; i < pixels; i++, px += 4) {
+    uint8_t a = px[3];
+    px[0] = std::min(px[0], a);
+    px[1] = std::min(px[1], a);
+    px[2] = std::min(px[2], a);
+  }
+}
+
+// Average `factor` x `factor` blocks. Cheap first stage for large reductions
+// so the Lanczos kernels stay short.
+std::vector<uint8_t> BoxReduce(const uint8_t *src, uint32_t width, uint32_t height,
+                               uint32_t factor, uint32_t *out_width, uint32_t *out_height) {
+  uint32_t ow = width / factor, oh = height / factor;
+  std::vector<uint8_t> dst(static_cast<size_t>(ow) * oh * 4);
+  std::vector<uint32_t> acc(static_cast<size_t>(ow) * 4);
+  uint32_t area = factor * factor;
+  for (uint32_t y = 0; y < oh; y++) {
+    std::fill(acc.begin(), acc.end(), area / 2);
+    for (uint32_t dy = 0; dy < factor; dy++) {
+      const uint8_t *row = src + (static_cast<size_t>(y) * factor + dy) * width * 4;
+      for (uint32_t x = 0; x < ow; x++) {
+        const uint8_t *p = row + static_cast<size_t>(x) * factor * 4;
+        for (uint32_t dx = 0; dx < factor; dx++, p += 4) {
+          acc[x * 4 + 0] += p[0];
+          acc[x * 4 + 1] += p[1];
+          acc[x * 4 + 2] += p[2];
+          acc[x * 4 + 3] += p[3];
+        }
+      }
+    }
+    uint8_t *out = &dst[static_cast<size_t>(y) * ow * 4];
+    for (size_t i = 0; i < acc.size(); i++) out[i] = static_cast<uint8_t>(acc[i] / area);
+  }
+  *out_width = ow;
+  *out_height = oh;
+  return dst;
+}
+
+} // namespace
+
+void Resize(const uint8_t *src, uint32_t src_width, uint32_t src_height, uint8_t *dst,
+            uint32_t dst_width, uint32_t dst_height) {
+  // Box-reduce while at least 2x of headroom remains for the Lanczos stage.
+  std::vector<uint8_t> reduced;
+  uint32_t factor = std::min(src_width / dst_width, src_height / dst_height) / 2;
+  if (factor >= 2) {
+    reduced = BoxReduce(src, src_width, src_height, factor, &src_width, &src_height);
+    src = reduced.data();
+  }
+
+  Kernel kx = BuildKernel(src_width, dst_width);
+  Kernel ky = BuildKernel(src_height, dst_height);
+
+  // Horizontal pass: src_height rows of dst_width pixels.
+  std::vector<uint8_t> tmp(static_cast<size_t>(dst_width) * src_height * 4);
+  for (uint32_t y = 0; y < src_height; y++) {
+    const uint8_t *row = src + static_cast<size_t>(y) * src_width * 4;
+    uint8_t *out = &tmp[static_cast<size_t>(y) * dst_width * 4];
+    for (uint32_t x = 0; x < dst_width; x++) {
+      const uint8_t *p = row + static_cast<size_t>(kx.start[x]) * 4;
+      const int16_t *w = &kx.weights[static_cast<size_t>(x) * kx.taps];
+      int32_t c0 = kRound, c1 = kRound, c2 = kRound, c3 = kRound;
+      for (int32_t j = 0; j < kx.count[x]; j++, p += 4) {
+        c0 += p[0] * w[j];
+        c1 += p[1] * w[j];
+        c2 += p[2] * w[j];
+        c3 += p[3] * w[j];
+      }
+      out[x * 4 + 0] = Clamp(c0);
+      out[x * 4 + 1] = Clamp(c1);
+      out[x * 4 + 2] = Clamp(c2);
+      out[x * 4 + 3] = Clamp(c3);
+    }
+  }
+
+  // Vertical pass: each output row is a weighted sum of whole input rows,
+  // one contiguous multiply-accumulate per tap.
+  size_t row_bytes = static_cast<size_t>(dst_width) * 4;
+  std::vector<int32_t> acc(row_bytes);
+  for (uint32_t y = 0; y < dst_height; y++) {
+    std::fill(acc.begin(), acc.end(), kRound);
+    const int16_t *w = &ky.weights[static_cast<size_t>(y) * ky.taps];
+    for (int32_t j = 0; j < ky.count[y]; j++) {
+      const uint8_t *row = &tmp[static_cast<size_t>(ky.start[y] + j) * row_bytes];
+      int32_t weight = w[j];
+      int32_t *a = acc.data();
+      for (size_t i = 0; i < row_bytes; i++) a[i] += row[i] * weight;
+    }
+    uint8_t *out = dst + static_cast<size_t>(y) * row_bytes;
+    for (size_t i = 0; i < row_bytes; i++) out[i] = Clamp(acc[i]);
+  }
+
+  ClampToAlpha(dst, static_cast<size_t>(dst_width) * dst_height);
+}
+
+} // namespace image_resize
+
+// ---------------------------------------------------------------------------
+// N-API
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct ResizeJob {
+  Napi::ObjectReference input; // keeps `pixels` alive
+  const uint8_t *pixels = nullptr;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::vector<std::pair<uint32_t, uint32_t>> targets;
+  std::vector<std::vector<uint8_t>> outputs;
+};
+
+class ResizeWorker : public Napi::AsyncWorker {
+public:
+  ResizeWorker(Napi::Env env, std::vector<std::unique_ptr<ResizeJob>> jobs)
+      : Napi::AsyncWorker(env),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        jobs_(std::move(jobs)) {}
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+protected:
+  void Execute() override {
+    size_t tasks = 0;
+    for (const auto &job : jobs_) tasks += job->targets.size();
+    if (tasks == 0) return;
+
+    ThreadPool pool(std::min(ThreadPool::DefaultThreadCount(), tasks));
+    for (auto &job : jobs_) {
+      job->outputs.resize(job->targets.size());
+      for (size_t t = 0; t < job->targets.size(); t++) {
+        ResizeJob *j = job.get();
+        pool.Submit([j, t] {
+          uint32_t w = j->targets[t].first, h = j->targets[t].second;
+          j->outputs[t].resize(static_cast<size_t>(w) * h * 4);
+          image_resize::Resize(j->pixels, j->width, j->height, j->outputs[t].data(), w, h);
+        });
+      }
+    }
+    pool.Wait();
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::Array result = Napi::Array::New(env, jobs_.size());
+    for (size_t i = 0; i < jobs_.size(); i++) {
+      const auto &outputs = jobs_[i]->outputs;
+      Napi::Array images = Napi::Array::New(env, outputs.size());
+      for (size_t t = 0; t < outputs.size(); t++) {
+        images.Set(static_cast<uint32_t>(t),
+                   Napi::Buffer<uint8_t>::Copy(env, outputs[t].data(), outputs[t].size()));
+      }
+      result.Set(static_cast<uint32_t>(i), images);
+    }
+    deferred_.Resolve(result);
+  }
+
+  void OnError(const Napi::Error &error) override { deferred_.Reject(error.Value()); }
+
+private:
+  Napi::Promise::Deferred deferred_;
+  std::vector<std::unique_ptr<ResizeJob>> jobs_;
+};
+
+} // namespace
+
+void ImageResizer::Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("resizeImages", Napi::Function::New(env, ResizeImages, "resizeImages"));
+}
+
+Napi::Value ImageResizer::ResizeImages(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected array of resize jobs").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Array arr = info[0].As<Napi::Array>();
+  std::vector<std::unique_ptr<ResizeJob>> jobs;
+  jobs.reserve(arr.Length());
+  for (uint32_t i = 0; i < arr.Length(); i++) {
+    Napi::Value v = arr.Get(i);
+    if (!v.IsObject()) {
+      Napi::TypeError::New(env, "Each job must be an object").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    Napi::Object o = v.As<Napi::Object>();
+    Napi::Value pixels = o.Get("pixels");
+    Napi::Value width = o.Get("width");
+    Napi::Value height = o.Get("height");
+    Napi::Value targets = o.Get("targets");
+    if (!pixels.IsBuffer() || !width.IsNumber() || !height.IsNumber() || !targets.IsArray()) {
+      Napi::TypeError::New(env, "Each job needs pixels (Buffer), width, height and targets")
+        .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    auto job = std::make_unique<ResizeJob>();
+    Napi::Buffer<uint8_t> bytes = pixels.As<Napi::Buffer<uint8_t>>();
+    job->width = width.As<Napi::Number>().Uint32Value();
+    job->height = height.As<Napi::Number>().Uint32Value();
+    if (job->width == 0 || job->height == 0 ||
+        bytes.Length() < static_cast<size_t>(job->width) * job->height * 4) {
+      Napi::RangeError::New(env, "pixels is smaller than width * height * 4")
+        .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    job->pixels = bytes.Data();
+    job->input = Napi::Persistent(bytes.As<Napi::Object>());
+
+    Napi::Array list = targets.As<Napi::Array>();
+    for (uint32_t t = 0; t < list.Length(); t++) {
+      Napi::Value target = list.Get(t);
+      if (!target.IsObject()) {
+        Napi::TypeError::New(env, "Each target must be an object").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      Napi::Value tw = target.As<Napi::Object>().Get("width");
+      Napi::Value th = target.As<Napi::Object>().Get("height");
+      if (!tw.IsNumber() || !th.IsNumber()) {
+        Napi::TypeError::New(env, "Each target needs a numeric width and height")
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      uint32_t w = tw.As<Napi::Number>().Uint32Value();
+      uint32_t h = th.As<Napi::Number>().Uint32Value();
+      if (w == 0 || h == 0 || w > 8192 || h > 8192) {
+        Napi::RangeError::New(env, "target size out of range").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      job->targets.emplace_back(w, h);
+    }
+    jobs.push_back(std::move(job));
+  }
+
+  auto *worker = new ResizeWorker(env, std::move(jobs));
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
@@ -0,0 +1,42 @@
+#ifndef IMAGE_RESIZE_H
+#define IMAGE_RESIZE_H
+
+#include <napi.h>
+
+#include <cstdint>
+#include <vector>
+
+// Cover-art thumbnail resampling.
+//
+// Images are 4 bytes per pixel, alpha last and premultiplied (the layout of
+// Electron's nativeImage.toBitmap(), BGRA on every platform we ship). Large
+// reductions are first box-filtered by an integer factor, then resampled with
+// a separable Lanczos-3 filter using 14-bit fixed-point weights. The inner
+// loops run over contiguous bytes with no branches so the compiler
+// vectorizes them (SSE2/NEON at -O2).
+namespace image_resize {
+
+// `dst` must hold dst_width * dst_height * 4 bytes. Rows are tightly packed.
+void Resize(const uint8_t *src, uint32_t src_width, uint32_t src_height, uint8_t *dst,
+            uint32_t dst_width, uint32_t dst_height);
+
+} // namespace image_resize
+
+// N-API wrapper:
+//
+//   resizeImages([{ pixels, width, height, targets: [{ width, height }] }])
+//     → Promise<Array<Array<Buffer>>>
+//
+// One output per target, in order, same pixel layout as the input. A
+// malformed job or target throws rather than being skipped, so outputs always
+// line up with targets. Jobs run on the shared thread pool; input buffers
+// must not be mutated until it resolves.
+class ImageResizer {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+
+private:
+  static Napi::Value ResizeImages(const Napi::CallbackInfo &info);
+};
+
+#endif // IMAGE_RESIZE_H
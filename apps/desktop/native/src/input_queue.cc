@@ -0,0 +1,107 @@
+#include "input_queue.h"
+
+#include <chrono>
+
+namespace input_queue {
+
+namespace {
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace
+
+void InputQueue::PushButton(unsigned port, unsigned id, int16_t value) {
+  latest_buttons_[port][id].store(value, std::memory_order_relaxed);
+  Push({NowUs(), value, kButton, static_cast<uint8_t>(port), 0, static_cast<uint8_t>(id)});
+}
+
+void InputQueue::PushAnalog(unsigned port, unsigned index, unsigned axis, int16_t value) {
+  latest_analog_[port][index][axis].store(value, std::memory_order_relaxed);
+  Push({NowUs(), value, kAnalog, static_cast<uint8_t>(port), static_cast<uint8_t>(index),
+        static_cast<uint8_t>(axis)});
+}
+
+void InputQueue::Push(const Event &event) {
+  uint32_t head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) == kCapacity) {
+    overflowed_.store(true, std::memory_order_release);
+    overflows_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  ring_[head & (kCapacity - 1)] = event;
+  head_.store(head + 1, std::memory_order_release);
+}
+
+void InputQueue::FoldButton(unsigned port, unsigned id, bool pressed) {
+  if (pressed == level_[port][id]) return;
+  level_[port][id] = pressed;
+  uint8_t &pending = pending_[port][id];
+  if (pending == kMaxPendingEdges) pending -= 2;
+  pending++;
+}
+
+void InputQueue::Poll() {
+  int64_t now = NowUs();
+  uint32_t tail = tail_.load(std::memory_order_relaxed);
+  uint32_t head = head_.load(std::memory_order_acquire);
+  events_.fetch_add(head - tail, std::memory_order_relaxed);
+  uint64_t max_latency = max_latency_us_.load(std::memory_order_relaxed);
+
+  for (; tail != head; tail++) {
+    const Event &event = ring_[tail & (kCapacity - 1)];
+    if (event.kind == kButton) {
+      FoldButton(event.port, event.id, event.value != 0);
+    } else {
+      analog_[event.port][event.index][event.id] = event.value;
+    }
+    uint64_t latency = now > event.timestamp_us ? now - event.timestamp_us : 0;
+    if (latency > max_latency) max_latency = latency;
+  }
+  tail_.store(tail, std::memory_order_release);
+  max_latency_us_.store(max_latency, std::memory_order_relaxed);
+
+  if (overflowed_.exchange(false, std::memory_order_acq_rel)) {
+    for (unsigned port = 0; port < kPorts; port++) {
+      for (unsigned id = 0; id < kButtons; id++) {
+        FoldButton(port, id, latest_buttons_[port][id].load(std::memory_order_relaxed) != 0);
+      }
+      for (unsigned index = 0; index < kAnalogIndices; index++) {
+        for (unsigned axis = 0; axis < kAnalogAxes; axis++) {
+          analog_[port][index][axis] =
+              latest_analog_[port][index][axis].load(std::memory_order_relaxed);
+        }
+      }
+    }
+  }
+
+  for (unsigned port = 0; port < kPorts; port++) {
+    for (unsigned id = 0; id < kButtons; id++) {
+      if (pending_[port][id] > 0) {
+        pending_[port][id]--;
+        shown_[port][id] = shown_[port][id] ? 0 : 1;
+      }
+    }
+  }
+}
+
+int16_t InputQueue::ButtonMask(unsigned port) const {
+  int16_t mask = 0;
+  for (unsigned i = 0; i < kButtons; i++) {
+    if (shown_[port][i]) mask |= (1 << i);
+  }
+  return mask;
+}
+
+Stats InputQueue::TakeStats() {
+  Stats stats;
+  stats.events = events_.load(std::memory_order_relaxed);
+  stats.overflows = overflows_.load(std::memory_order_relaxed);
+  stats.max_latency_us = max_latency_us_.exchange(0, std::memory_order_relaxed);
+  return stats;
+}
+
+} // namespace input_queue
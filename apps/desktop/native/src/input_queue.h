@@ -0,0 +1,95 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+
+// Sub-frame input for the libretro input callbacks.
+//
+// setInputState used to overwrite a level array, so a press and release that
+// both arrived between two retro_run calls never reached the core. Events now
+// go through a lock-free single-producer/single-consumer ring (setInputState
+// in, the core's input_poll out) and are folded into per-poll state:
+//
+// - Every digital edge is shown to the core for at least one poll, so a short
+//   tap reads as pressed on one poll and released on the next.
+// - Rapid taps (turbo) each keep their own press/release pair, but at most
+//   kMaxPendingEdges are held back so a burst can't add more than a few polls
+//   of latency; older whole taps are dropped first.
+// - Analog axes stay level-triggered: the newest value wins.
+//
+// If the ring ever fills, the producer keeps recording the newest value per
+// input and the consumer resyncs from those, so a lost release can't leave a
+// button stuck.
+namespace input_queue {
+
+constexpr unsigned kPorts = 2;
+constexpr unsigned kButtons = 16;
+constexpr unsigned kAnalogIndices = 3; // left stick, right stick, analog buttons
+constexpr unsigned kAnalogAxes = 2;
+
+struct Stats {
+  uint64_t events = 0;
+  uint64_t overflows = 0;
+  // Longest time an event waited between setInputState and the poll that
+  // folded it in, since the last TakeStats().
+  uint64_t max_latency_us = 0;
+};
+
+class InputQueue {
+public:
+  // Producer side. Never blocks; callers bounds-check first.
+  void PushButton(unsigned port, unsigned id, int16_t value);
+  void PushAnalog(unsigned port, unsigned index, unsigned axis, int16_t value);
+
+  // Consumer side (input_poll): fold queued events and advance each button
+  // by at most one edge.
+  void Poll();
+
+  int16_t Button(unsigned port, unsigned id) const { return shown_[port][id]; }
+  int16_t ButtonMask(unsigned port) const;
+  int16_t Analog(unsigned port, unsigned index, unsigned axis) const {
+    return analog_[port][index][axis];
+  }
+
+  Stats TakeStats();
+
+private:
+  static constexpr uint32_t kCapacity = 256; // power of 2
+  static constexpr uint8_t kMaxPendingEdges = 6; // even: whole taps only
+
+  enum Kind : uint8_t { kButton, kAnalog };
+
+  struct Event {
+    int64_t timestamp_us;
+    int16_t value;
+    uint8_t kind;
+    uint8_t port;
+    uint8_t index;
+    uint8_t id;
+  };
+
+  void Push(const Event &event);
+  void FoldButton(unsigned port, unsigned id, bool pressed);
+
+  Event ring_[kCapacity];
+  std::atomic<uint32_t> head_{0}; // next write (producer)
+  std::atomic<uint32_t> tail_{0}; // next read (consumer)
+  std::atomic<bool> overflowed_{false};
+  std::atomic<int16_t> latest_buttons_[kPorts][kButtons] = {};
+  std::atomic<int16_t> latest_analog_[kPorts][kAnalogIndices][kAnalogAxes] = {};
+
+  // Consumer-owned. Invariant: level_ == shown_ when pending_ is even.
+  bool level_[kPorts][kButtons] = {};
+  uint8_t pending_[kPorts][kButtons] = {};
+  int16_t shown_[kPorts][kButtons] = {};
+  int16_t analog_[kPorts][kAnalogIndices][kAnalogAxes] = {};
+
+  std::atomic<uint64_t> events_{0};
+  std::atomic<uint64_t> overflows_{0};
+  std::atomic<uint64_t> max_latency_us_{0};
+};
+
+} // namespace input_queue
+
+#endif // INPUT_QUEUE_H
@@ -0,0 +1,526 @@
+#include "library_scanner.h"
+#include "fs_util.h"
+#include "rom_header.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Scan job state
+// ---------------------------------------------------------------------------
+
+struct ScanSystem {
+  std::string id;
+  // Directory names that select this system when scanning without a filter
+  // (lowercased shortName/name, plus the id) — mirrors collectCandidates.
+  std::vector<std::string> dir_names;
+};
+
+struct ScanFile {
+  std::string name;
+  std::string ext;            // lowercase, leading dot
+  std::string sniffed;        // system ID from header sniffing, or empty
+  std::vector<std::string> refs; // .cue FILE / .m3u entries (unresolved)
+  bool has_refs = false;
+  double mtime_ms = 0;
+  uint64_t size = 0;
+};
+
+struct ScanDirectory {
+  std::string path;
+  std::string system_id; // inherited or resolved from the directory name
+  std::vector<ScanFile> files;
+};
+
+struct ScanError {
+  std::string path;
+  std::string message;
+};
+
+struct ScanJob;
+
+// Unit of work posted to the JS thread: either a batch of directories or the
+// completion marker (done == true).
+struct ScanMessage {
+  ScanJob *job = nullptr;
+  std::vector<ScanDirectory> batch;
+  bool done = false;
+};
+
+struct ScanJob {
+  explicit ScanJob(Napi::Env env) : deferred(Napi::Promise::Deferred::New(env)) {}
+
+  // Options
+  std::vector<std::pair<std::string, std::string>> roots; // (path, systemId)
+  std::vector<ScanSystem> systems;
+  std::unordered_set<std::string> wanted_exts;
+  std::unordered_map<std::string, int> ext_system_count;
+  bool recursive = true;
+  size_t batch_size = 256;
+  size_t threads = 0;
+
+  Napi::ThreadSafeFunction tsfn;
+  Napi::Promise::Deferred deferred;
+  std::thread coordinator;
+
+  // Batching (worker threads → JS)
+  std::mutex batch_mutex;
+  std::vector<ScanDirectory> pending;
+  size_t pending_files = 0;
+
+  // Counters for the summary
+  std::atomic<uint64_t> directories{0};
+  std::atomic<uint64_t> files_seen{0};
+  std::atomic<uint64_t> files_matched{0};
+  std::atomic<uint64_t> files_sniffed{0};
+  std::mutex error_mutex;
+  std::vector<ScanError> errors;
+  double elapsed_ms = 0;
+
+  static constexpr size_t MAX_REPORTED_ERRORS = 100;
+
+  void AddError(const std::string &path, const std::string &message) {
+    std::lock_guard<std::mutex> lock(error_mutex);
+    if (errors.size() < MAX_REPORTED_ERRORS) errors.push_back({path, message});
+  }
+};
+
+using fs_util::ExtensionOf;
+using fs_util::JoinPath;
+using fs_util::Lowercase;
+#ifndef _WIN32
+using fs_util::MtimeMs;
+#endif
+
+// ---------------------------------------------------------------------------
+// Directory walking
+// ---------------------------------------------------------------------------
+
+#ifndef _WIN32
+
+enum class EntryKind { File, Directory, Other, Unknown };
+
+struct RawEntry {
+  std::string name;
+  EntryKind kind;
+};
+
+EntryKind KindFromDType(unsigned char type) {
+  switch (type) {
+    case DT_REG: return EntryKind::File;
+    case DT_DIR: return EntryKind::Directory;
+    case DT_UNKNOWN: return EntryKind::Unknown;
+    // Symlinks are skipped like fs.Dirent does (isFile/isDirectory are false).
+    default: return EntryKind::Other;
+  }
+}
+
+#ifdef __linux__
+// getdents64 returns many entries per syscall without libc's per-entry
+// buffering, which matters on directories with tens of thousands of ROMs.
+struct LinuxDirent64 {
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+};
+
+bool ListDirectory(int fd, std::vector<RawEntry> &out) {
+  alignas(8) char buf[32 * 1024];
+  for (;;) {
+    long nread = syscall(SYS_getdents64, fd, buf, sizeof(buf));
+    if (nread < 0) return false;
+    if (nread == 0) return true;
+    for (long pos = 0; pos < nread;) {
+      auto *d = reinterpret_cast<LinuxDirent64 *>(buf + pos);
+      pos += d->d_reclen;
+      if (std::strcmp(d->d_name, ".") == 0 || std::strcmp(d->d_name, "..") == 0) continue;
+      out.push_back({d->d_name, KindFromDType(d->d_type)});
+    }
+  }
+}
+#else
+bool ListDirectory(int fd, std::vector<RawEntry> &out) {
+  // fdopendir takes ownership of its descriptor, so hand it a duplicate and
+  // keep `fd` usable for fstatat.
+  int dup_fd = dup(fd);
+  if (dup_fd < 0) return false;
+  DIR *dir = fdopendir(dup_fd);
+  if (!dir) {
+    close(dup_fd);
+    return false;
+  }
+  while (struct dirent *d = readdir(dir)) {
+    if (std::strcmp(d->d_name, ".") == 0 || std::strcmp(d->d_name, "..") == 0) continue;
+    out.push_back({d->d_name, KindFromDType(d->d_type)});
+  }
+  closedir(dir);
+  return true;
+}
+#endif
+
+void PostMessage(ScanJob *job, ScanMessage *msg);
+
+// Queue a finished directory and hand a batch to JS once enough files have
+// accumulated.
+void FlushIfFull(ScanJob *job, ScanDirectory &&result) {
+  std::vector<ScanDirectory> to_send;
+  {
+    std::lock_guard<std::mutex> lock(job->batch_mutex);
+    job->pending_files += result.files.size();
+    job->pending.push_back(std::move(result));
+    if (job->pending_files < job->batch_size) return;
+    to_send.swap(job->pending);
+    job->pending_files = 0;
+  }
+  auto *msg = new ScanMessage();
+  msg->job = job;
+  msg->batch = std::move(to_send);
+  PostMessage(job, msg);
+}
+
+std::string ResolveDirectorySystem(const ScanJob *job, const std::string &dir_name) {
+  std::string lower = Lowercase(dir_name);
+  for (const auto &system : job->systems) {
+    for (const auto &candidate : system.dir_names) {
+      if (candidate == lower) return system.id;
+    }
+  }
+  return "";
+}
+
+void ScanOne(ScanJob *job, ThreadPool *pool, std::string dir_path, std::string system_id) {
+  int fd = open(dir_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    job->AddError(dir_path, std::strerror(errno));
+    return;
+  }
+
+  std::vector<RawEntry> entries;
+  if (!ListDirectory(fd, entries)) {
+    job->AddError(dir_path, std::strerror(errno));
+    close(fd);
+    return;
+  }
+  job->directories++;
+
+  ScanDirectory result;
+  result.path = dir_path;
+  result.system_id = system_id;
+
+  for (auto &entry : entries) {
+    EntryKind kind = entry.kind;
+    struct stat st = {};
+    bool have_stat = false;
+
+    if (kind == EntryKind::Unknown) {
+      if (fstatat(fd, entry.name.c_str(), &st, AT_SYMLINK_NOFOLLOW) != 0) continue;
+      have_stat = true;
+      kind = S_ISDIR(st.st_mode) ? EntryKind::Directory
+           : S_ISREG(st.st_mode) ? EntryKind::File
+                                 : EntryKind::Other;
+    }
+
+    if (kind == EntryKind::Directory) {
+      if (!job->recursive) continue;
+      std::string child_system = system_id.empty()
+        ? ResolveDirectorySystem(job, entry.name)
+        : system_id;
+      std::string child_path = JoinPath(dir_path, entry.name);
+      pool->Submit([job, pool, child_path, child_system] {
+        ScanOne(job, pool, child_path, child_system);
+      });
+      continue;
+    }
+    if (kind != EntryKind::File) continue;
+
+    job->files_seen++;
+    std::string ext = ExtensionOf(entry.name);
+    if (job->wanted_exts.find(ext) == job->wanted_exts.end()) continue;
+
+    if (!have_stat && fstatat(fd, entry.name.c_str(), &st, AT_SYMLINK_NOFOLLOW) != 0) continue;
+    job->files_matched++;
+
+    ScanFile file;
+    file.name = entry.name;
+    file.ext = ext;
+    file.mtime_ms = MtimeMs(st);
+    file.size = static_cast<uint64_t>(st.st_size);
+
+    std::string full_path = JoinPath(dir_path, entry.name);
+
+    if (ext == ".cue" || ext == ".m3u") {
+      std::string content;
+      if (rom_header::ReadSmallFile(full_path, 256 * 1024, content)) {
+        file.refs = ext == ".cue" ? rom_header::ParseCueFiles(content)
+                                  : rom_header::ParseM3uEntries(content);
+        file.has_refs = true;
+      }
+    }
+
+    // Only sniff when the extension alone can't decide: the directory has no
+    // system yet and more than one configured system claims the extension.
+    auto count = job->ext_system_count.find(ext);
+    if (system_id.empty() && ext != ".m3u" && count != job->ext_system_count.end() &&
+        count->second > 1) {
+      file.sniffed = rom_header::SniffSystem(full_path, ext);
+      if (!file.sniffed.empty()) job->files_sniffed++;
+    }
+
+    result.files.push_back(std::move(file));
+  }
+  close(fd);
+
+  FlushIfFull(job, std::move(result));
+}
+
+#endif // !_WIN32
+
+// ---------------------------------------------------------------------------
+// JS conversion (runs on the JS thread)
+// ---------------------------------------------------------------------------
+
+Napi::Value ToJS(Napi::Env env, const std::string &s) {
+  return s.empty() ? env.Null() : Napi::String::New(env, s);
+}
+
+Napi::Array BatchToJS(Napi::Env env, const std::vector<ScanDirectory> &batch) {
+  Napi::Array dirs = Napi::Array::New(env, batch.size());
+  for (size_t i = 0; i < batch.size(); i++) {
+    const ScanDirectory &dir = batch[i];
+    Napi::Object d = Napi::Object::New(env);
+    d.Set("path", Napi::String::New(env, dir.path));
+    d.Set("systemId", ToJS(env, dir.system_id));
+
+    Napi::Array files = Napi::Array::New(env, dir.files.size());
+    for (size_t j = 0; j < dir.files.size(); j++) {
+      const ScanFile &f = dir.files[j];
+      Napi::Object o = Napi::Object::New(env);
+      o.Set("name", Napi::String::New(env, f.name));
+      o.Set("ext", Napi::String::New(env, f.ext));
+      o.Set("mtimeMs", Napi::Number::New(env, f.mtime_ms));
+      o.Set("size", Napi::Number::New(env, static_cast<double>(f.size)));
+      o.Set("sniffedSystemId", ToJS(env, f.sniffed));
+      if (f.has_refs) {
+        Napi::Array refs = Napi::Array::New(env, f.refs.size());
+        for (size_t k = 0; k < f.refs.size(); k++) {
+          refs.Set(static_cast<uint32_t>(k), Napi::String::New(env, f.refs[k]));
+        }
+        o.Set("refs", refs);
+      } else {
+        o.Set("refs", env.Null());
+      }
+      files.Set(static_cast<uint32_t>(j), o);
+    }
+    d.Set("files", files);
+    dirs.Set(static_cast<uint32_t>(i), d);
+  }
+  return dirs;
+}
+
+void DeliverMessage(Napi::Env env, Napi::Function callback, ScanMessage *msg) {
+  ScanJob *job = msg->job;
+  if (!msg->done) {
+    if (env != nullptr && !msg->batch.empty()) {
+      callback.Call({BatchToJS(env, msg->batch)});
+    }
+    delete msg;
+    return;
+  }
+
+  if (env != nullptr) {
+    Napi::Object summary = Napi::Object::New(env);
+    summary.Set("directories", Napi::Number::New(env, static_cast<double>(job->directories.load())));
+    summary.Set("filesSeen", Napi::Number::New(env, static_cast<double>(job->files_seen.load())));
+    summary.Set("filesMatched", Napi::Number::New(env, static_cast<double>(job->files_matched.load())));
+    summary.Set("filesSniffed", Napi::Number::New(env, static_cast<double>(job->files_sniffed.load())));
+    summary.Set("elapsedMs", Napi::Number::New(env, job->elapsed_ms));
+
+    Napi::Array errors = Napi::Array::New(env, job->errors.size());
+    for (size_t i = 0; i < job->errors.size(); i++) {
+      Napi::Object e = Napi::Object::New(env);
+      e.Set("path", Napi::String::New(env, job->errors[i].path));
+      e.Set("message", Napi::String::New(env, job->errors[i].message));
+      errors.Set(static_cast<uint32_t>(i), e);
+    }
+    summary.Set("errors", errors);
+    job->deferred.Resolve(summary);
+  }
+  delete msg;
+}
+
+void PostMessage(ScanJob *job, ScanMessage *msg) {
+  job->tsfn.BlockingCall(msg, DeliverMessage);
+}
+
+void RunScan(ScanJob *job) {
+  auto start = std::chrono::steady_clock::now();
+
+#ifndef _WIN32
+  {
+    ThreadPool pool(job->threads);
+    for (const auto &root : job->roots) {
+      std::string path = root.first;
+      while (path.size() > 1 && path.back() == '/') path.pop_back();
+      std::string system_id = root.second;
+      ThreadPool *p = &pool;
+      pool.Submit([job, p, path, system_id] { ScanOne(job, p, path, system_id); });
+    }
+    pool.Wait();
+  }
+#endif
+
+  job->elapsed_ms = std::chrono::duration<double, std::milli>(
+    std::chrono::steady_clock::now() - start).count();
+
+  // Remaining partial batch, then the completion marker. TSFN calls are
+  // delivered in order, so the promise resolves after the last batch.
+  std::vector<ScanDirectory> rest;
+  {
+    std::lock_guard<std::mutex> lock(job->batch_mutex);
+    rest.swap(job->pending);
+    job->pending_files = 0;
+  }
+  if (!rest.empty()) {
+    auto *msg = new ScanMessage();
+    msg->job = job;
+    msg->batch = std::move(rest);
+    PostMessage(job, msg);
+  }
+  auto *done = new ScanMessage();
+  done->job = job;
+  done->done = true;
+  PostMessage(job, done);
+
+  job->tsfn.Release();
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// N-API
+// ---------------------------------------------------------------------------
+
+void LibraryScanner::Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("scanLibrary", Napi::Function::New(env, ScanLibrary, "scanLibrary"));
+}
+
+Napi::Value LibraryScanner::ScanLibrary(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsObject() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (options: object, onBatch: function)")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+#ifdef _WIN32
+  Napi::Error::New(env, "Native library scanning is not supported on this platform")
+    .ThrowAsJavaScriptException();
+  return env.Undefined();
+#else
+  Napi::Object options = info[0].As<Napi::Object>();
+  Napi::Value roots_val = options.Get("roots");
+  Napi::Value systems_val = options.Get("systems");
+  if (!roots_val.IsArray() || !systems_val.IsArray()) {
+    Napi::TypeError::New(env, "Expected options.roots and options.systems arrays")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  auto *job = new ScanJob(env);
+
+  Napi::Array roots = roots_val.As<Napi::Array>();
+  for (uint32_t i = 0; i < roots.Length(); i++) {
+    Napi::Value root_val = roots.Get(i);
+    if (!root_val.IsObject()) continue;
+    Napi::Object root = root_val.As<Napi::Object>();
+    Napi::Value path = root.Get("path");
+    if (!path.IsString()) continue;
+    Napi::Value system_id = root.Get("systemId");
+    job->roots.emplace_back(path.As<Napi::String>().Utf8Value(),
+                            system_id.IsString() ? system_id.As<Napi::String>().Utf8Value() : "");
+  }
+
+  Napi::Array systems = systems_val.As<Napi::Array>();
+  for (uint32_t i = 0; i < systems.Length(); i++) {
+    Napi::Value system_val = systems.Get(i);
+    if (!system_val.IsObject()) continue;
+    Napi::Object obj = system_val.As<Napi::Object>();
+    Napi::Value id = obj.Get("id");
+    if (!id.IsString()) continue;
+
+    ScanSystem system;
+    system.id = id.As<Napi::String>().Utf8Value();
+    system.dir_names.push_back(system.id);
+    for (const char *key : {"name", "shortName"}) {
+      Napi::Value v = obj.Get(key);
+      if (v.IsString()) system.dir_names.push_back(Lowercase(v.As<Napi::String>().Utf8Value()));
+    }
+
+    Napi::Value exts_val = obj.Get("extensions");
+    if (exts_val.IsArray()) {
+      Napi::Array exts = exts_val.As<Napi::Array>();
+      std::unordered_set<std::string> seen;
+      for (uint32_t j = 0; j < exts.Length(); j++) {
+        Napi::Value ext = exts.Get(j);
+        if (!ext.IsString()) continue;
+        std::string e = Lowercase(ext.As<Napi::String>().Utf8Value());
+        if (!seen.insert(e).second) continue;
+        job->wanted_exts.insert(e);
+        job->ext_system_count[e]++;
+      }
+    }
+    job->systems.push_back(std::move(system));
+  }
+
+  // Archives and playlists are always reported: the JS side extracts zips and
+  // uses .cue/.m3u references for de-duplication and disc grouping.
+  job->wanted_exts.insert(".zip");
+  job->wanted_exts.insert(".cue");
+  job->wanted_exts.insert(".m3u");
+
+  Napi::Value recursive = options.Get("recursive");
+  if (recursive.IsBoolean()) job->recursive = recursive.As<Napi::Boolean>().Value();
+  Napi::Value batch_size = options.Get("batchSize");
+  if (batch_size.IsNumber()) {
+    job->batch_size = std::max<uint32_t>(1, batch_size.As<Napi::Number>().Uint32Value());
+  }
+  Napi::Value threads = options.Get("threads");
+  if (threads.IsNumber()) job->threads = threads.As<Napi::Number>().Uint32Value();
+
+  job->tsfn = Napi::ThreadSafeFunction::New(
+    env, info[1].As<Napi::Function>(), "LibraryScanner", 0, 1,
+    [job](Napi::Env) {
+      job->coordinator.join();
+      delete job;
+    });
+
+  Napi::Promise promise = job->deferred.Promise();
+  job->coordinator = std::thread(RunScan, job);
+  return promise;
+#endif
+}
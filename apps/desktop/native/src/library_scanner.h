@@ -0,0 +1,24 @@
+#ifndef LIBRARY_SCANNER_H
+#define LIBRARY_SCANNER_H
+
+#include <napi.h>
+
+// Parallel ROM directory scanner.
+//
+// Walks one or more library roots on a thread pool (getdents64 on Linux,
+// readdir elsewhere), keeps only files whose extension belongs to a
+// configured system, sniffs headers for extensions shared by several systems
+// (see rom_header.h) and parses .cue/.m3u references. Results are streamed to
+// a JS callback in per-directory batches; the returned promise resolves with
+// a summary once every batch has been delivered.
+//
+//   scanLibrary(options, onBatch) → Promise<summary>
+class LibraryScanner {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+
+private:
+  static Napi::Value ScanLibrary(const Napi::CallbackInfo &info);
+};
+
+#endif // LIBRARY_SCANNER_H
@@ -0,0 +1,946 @@
+#include "library_store.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <unordered_set>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace library_store {
+
+// ---------------------------------------------------------------------------
+// On-disk format
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr char kMagic[8] = {'G', 'L', 'L', 'I', 'B', '\0', '\0', '\1'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kNoString = 0xFFFFFFFFu;
+
+constexpr uint32_t kLogMagic = 0x474C4F47; // "GLOG"
+constexpr uint8_t kOpPut = 1;
+constexpr uint8_t kOpRemove = 2;
+// magic + payload length + op, then payload, then checksum
+constexpr size_t kLogEntryOverhead = 4 + 4 + 1 + 4;
+
+constexpr uint32_t kFlagHasHashes = 1u << 0;
+constexpr uint32_t kFlagHasFavorite = 1u << 1;
+constexpr uint32_t kFlagFavorite = 1u << 2;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  uint32_t record_count;
+  uint32_t index_capacity; // slots in the id hash index (power of two)
+  uint64_t records_offset;
+  uint64_t index_offset;
+  uint64_t strings_offset;
+  uint64_t strings_size;
+  uint64_t reserved;
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout changed");
+
+// String columns are offsets into the string table (u32 length + bytes);
+// number columns use NaN for "absent".
+struct DiskRecord {
+  double numbers[kNumberFieldCount];
+  uint32_t strings[kStringFieldCount];
+  uint32_t crc32;
+  uint8_t md5[16];
+  uint8_t sha1[20];
+  uint32_t flags;
+};
+static_assert(sizeof(DiskRecord) == 136, "DiskRecord layout changed");
+
+uint64_t Fnv1a64(const char *data, size_t len) {
+  uint64_t h = 1469598103934665603ull;
+  for (size_t i = 0; i < len; i++) {
+    h ^= static_cast<uint8_t>(data[i]);
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+uint32_t Fnv1a32(const uint8_t *data, size_t len) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    h ^= data[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+void AppendU32(std::string &out, uint32_t v) {
+  out.append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+uint32_t ReadU32(const uint8_t *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+bool ReadString(const uint8_t *table, uint64_t table_size, uint32_t offset, std::string *out) {
+  if (static_cast<uint64_t>(offset) + 4 > table_size) return false;
+  uint32_t len = ReadU32(table + offset);
+  if (static_cast<uint64_t>(offset) + 4 + len > table_size) return false;
+  out->assign(reinterpret_cast<const char *>(table + offset + 4), len);
+  return true;
+}
+
+std::string_view ViewString(const uint8_t *table, uint64_t table_size, uint32_t offset) {
+  if (static_cast<uint64_t>(offset) + 4 > table_size) return {};
+  uint32_t len = ReadU32(table + offset);
+  if (static_cast<uint64_t>(offset) + 4 + len > table_size) return {};
+  return {reinterpret_cast<const char *>(table + offset + 4), len};
+}
+
+template <typename Intern>
+DiskRecord Encode(const Record &r, Intern intern) {
+  DiskRecord d;
+  memset(&d, 0, sizeof(d));
+  for (int f = 0; f < kNumberFieldCount; f++) d.numbers[f] = r.numbers[f];
+  for (int f = 0; f < kStringFieldCount; f++) {
+    d.strings[f] = r.Has(static_cast<StringField>(f)) ? intern(r.strings[f]) : kNoString;
+  }
+  if (r.has_hashes) {
+    d.flags |= kFlagHasHashes;
+    d.crc32 = r.crc32;
+    memcpy(d.md5, r.md5.data(), sizeof(d.md5));
+    memcpy(d.sha1, r.sha1.data(), sizeof(d.sha1));
+  }
+  if (r.favorite >= 0) {
+    d.flags |= kFlagHasFavorite;
+    if (r.favorite) d.flags |= kFlagFavorite;
+  }
+  return d;
+}
+
+void Decode(const DiskRecord &d, const uint8_t *table, uint64_t table_size, Record *r) {
+  *r = Record();
+  for (int f = 0; f < kNumberFieldCount; f++) r->numbers[f] = d.numbers[f];
+  for (int f = 0; f < kStringFieldCount; f++) {
+    if (d.strings[f] == kNoString) continue;
+    std::string value;
+    if (ReadString(table, table_size, d.strings[f], &value)) {
+      r->Set(static_cast<StringField>(f), std::move(value));
+    }
+  }
+  if (d.flags & kFlagHasHashes) {
+    r->has_hashes = true;
+    r->crc32 = d.crc32;
+    memcpy(r->md5.data(), d.md5, sizeof(d.md5));
+    memcpy(r->sha1.data(), d.sha1, sizeof(d.sha1));
+  }
+  if (d.flags & kFlagHasFavorite) r->favorite = (d.flags & kFlagFavorite) ? 1 : 0;
+}
+
+bool SyncAndClose(FILE *f) {
+  bool ok = fflush(f) == 0;
+#ifdef _WIN32
+  ok = ok && _commit(_fileno(f)) == 0;
+#else
+  ok = ok && fsync(fileno(f)) == 0;
+#endif
+  return fclose(f) == 0 && ok;
+}
+
+bool ReplaceFileAtomic(const std::string &from, const std::string &to) {
+#ifdef _WIN32
+  return MoveFileExA(from.c_str(), to.c_str(),
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+  return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+bool ReadWholeFile(const std::string &path, std::vector<uint8_t> *out) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  out->clear();
+  uint8_t buf[64 * 1024];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out->insert(out->end(), buf, buf + n);
+  fclose(f);
+  return true;
+}
+
+bool WriteWholeFile(const std::string &path, const uint8_t *data, size_t size) {
+  std::string tmp = path + ".tmp";
+  FILE *f = fopen(tmp.c_str(), "wb");
+  if (!f) return false;
+  bool ok = size == 0 || fwrite(data, 1, size, f) == size;
+  ok = SyncAndClose(f) && ok;
+  return ok && ReplaceFileAtomic(tmp, path);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Base image mapping
+// ---------------------------------------------------------------------------
+
+struct Mapping {
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+#ifdef _WIN32
+  std::vector<uint8_t> owned;
+#else
+  void *addr = nullptr;
+#endif
+
+  ~Mapping() {
+#ifndef _WIN32
+    if (addr) munmap(addr, size);
+#endif
+  }
+
+  const FileHeader &Header() const { return *reinterpret_cast<const FileHeader *>(data); }
+  uint32_t Count() const { return Header().record_count; }
+
+  const DiskRecord &At(uint32_t i) const {
+    return *reinterpret_cast<const DiskRecord *>(data + Header().records_offset +
+                                                 static_cast<uint64_t>(i) * sizeof(DiskRecord));
+  }
+  const uint8_t *Strings() const { return data + Header().strings_offset; }
+  uint64_t StringsSize() const { return Header().strings_size; }
+
+  std::string_view IdAt(uint32_t i) const {
+    return ViewString(Strings(), StringsSize(), At(i).strings[kId]);
+  }
+
+  void DecodeAt(uint32_t i, Record *out) const { Decode(At(i), Strings(), StringsSize(), out); }
+
+  // Open-addressing lookup in the id index. Returns the record index or -1.
+  int64_t Find(const std::string &id) const {
+    const FileHeader &h = Header();
+    if (h.index_capacity == 0) return -1;
+    const uint8_t *index = data + h.index_offset;
+    uint32_t mask = h.index_capacity - 1;
+    uint32_t slot = static_cast<uint32_t>(Fnv1a64(id.data(), id.size())) & mask;
+    for (uint32_t probes = 0; probes < h.index_capacity; probes++) {
+      uint32_t entry = ReadU32(index + static_cast<uint64_t>(slot) * 4);
+      if (entry == 0) return -1;
+      // Entries are record index + 1; anything past the records is corrupt.
+      if (entry > h.record_count) return -1;
+      if (IdAt(entry - 1) == id) return entry - 1;
+      slot = (slot + 1) & mask;
+    }
+    return -1;
+  }
+
+  bool Validate(std::string *error) const {
+    if (size < sizeof(FileHeader) || memcmp(Header().magic, kMagic, sizeof(kMagic)) != 0) {
+      *error = "not a library store file";
+      return false;
+    }
+    const FileHeader &h = Header();
+    if (h.version != kVersion || h.record_size != sizeof(DiskRecord)) {
+      *error = "unsupported library store version";
+      return false;
+    }
+    // Offset first, then length against what's left, so nothing can wrap.
+    auto fits = [this](uint64_t offset, uint64_t length) {
+      return offset <= size && length <= size - offset;
+    };
+    bool in_bounds =
+        h.records_offset % 8 == 0 &&
+        fits(h.records_offset, static_cast<uint64_t>(h.record_count) * sizeof(DiskRecord)) &&
+        fits(h.index_offset, static_cast<uint64_t>(h.index_capacity) * 4) &&
+        fits(h.strings_offset, h.strings_size) &&
+        (h.index_capacity & (h.index_capacity - 1)) == 0 && h.index_capacity >= h.record_count;
+    if (!in_bounds) {
+      *error = "library store file is truncated or corrupt";
+      return false;
+    }
+    return true;
+  }
+};
+
+namespace {
+
+// Returns null with an empty error when the file doesn't exist.
+std::shared_ptr<Mapping> MapFile(const std::string &path, std::string *error) {
+  auto mapping = std::make_shared<Mapping>();
+#ifdef _WIN32
+  if (!ReadWholeFile(path, &mapping->owned)) return nullptr;
+  mapping->data = mapping->owned.data();
+  mapping->size = mapping->owned.size();
+#else
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    if (errno != ENOENT) *error = std::string("cannot open library store: ") + strerror(errno);
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+    close(fd);
+    *error = "library store file is truncated or corrupt";
+    return nullptr;
+  }
+  void *addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    *error = std::string("cannot map library store: ") + strerror(errno);
+    return nullptr;
+  }
+  mapping->addr = addr;
+  mapping->data = static_cast<const uint8_t *>(addr);
+  mapping->size = static_cast<size_t>(st.st_size);
+#endif
+  if (!mapping->Validate(error)) return nullptr;
+  return mapping;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Store
+// ---------------------------------------------------------------------------
+
+Record::Record() {
+  numbers.fill(std::numeric_limits<double>::quiet_NaN());
+}
+
+Store::Store(std::string path) : base_path_(std::move(path)) {
+  log_path_ = base_path_ + ".log";
+}
+
+Store::~Store() {
+  Close();
+}
+
+void Store::Close() {
+  if (log_file_) fclose(log_file_);
+  log_file_ = nullptr;
+  base_.reset();
+  overlay_.clear();
+  count_ = 0;
+  log_bytes_ = 0;
+}
+
+uint64_t Store::BaseBytes() const {
+  return base_ ? base_->size : 0;
+}
+
+bool Store::LoadBase(std::string *error) {
+  error->clear();
+  base_ = MapFile(base_path_, error);
+  return base_ != nullptr || error->empty();
+}
+
+bool Store::Open(std::string *error) {
+  Close();
+  if (!LoadBase(error)) return false;
+
+  std::vector<uint8_t> log;
+  if (ReadWholeFile(log_path_, &log)) {
+    uint64_t valid = 0;
+    ReplayLog(log, &valid);
+    if (valid < log.size()) {
+      // Torn tail from a crash mid-append — drop it so new entries aren't
+      // written after garbage.
+      WriteWholeFile(log_path_, log.data(), static_cast<size_t>(valid));
+    }
+    log_bytes_ = valid;
+  }
+
+  if (!OpenLogForAppend(error)) return false;
+  RecountRecords();
+  return base_ != nullptr || log_bytes_ > 0;
+}
+
+bool Store::OpenLogForAppend(std::string *error) {
+  if (log_file_) fclose(log_file_);
+  log_file_ = fopen(log_path_.c_str(), "ab");
+  if (!log_file_) {
+    *error = std::string("cannot open library log: ") + strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+bool Store::ReplayLog(const std::vector<uint8_t> &bytes, uint64_t *valid_bytes) {
+  size_t pos = 0;
+  while (pos + kLogEntryOverhead <= bytes.size()) {
+    const uint8_t *p = bytes.data() + pos;
+    if (ReadU32(p) != kLogMagic) break;
+    uint32_t payload_len = ReadU32(p + 4);
+    if (pos + kLogEntryOverhead + payload_len > bytes.size()) break;
+    const uint8_t *op_and_payload = p + 8;
+    if (Fnv1a32(op_and_payload, 1 + payload_len) != ReadU32(op_and_payload + 1 + payload_len)) break;
+
+    uint8_t op = op_and_payload[0];
+    const uint8_t *payload = op_and_payload + 1;
+    if (op == kOpPut && payload_len >= sizeof(DiskRecord)) {
+      DiskRecord d;
+      memcpy(&d, payload, sizeof(d));
+      Record record;
+      Decode(d, payload + sizeof(d), payload_len - sizeof(d), &record);
+      if (record.Has(kId)) {
+        std::string id = record.Id();
+        overlay_[id] = std::move(record);
+      }
+    } else if (op == kOpRemove) {
+      overlay_[std::string(reinterpret_cast<const char *>(payload), payload_len)] = std::nullopt;
+    } else {
+      break;
+    }
+    pos += kLogEntryOverhead + payload_len;
+  }
+  *valid_bytes = pos;
+  return pos == bytes.size();
+}
+
+void Store::RecountRecords() {
+  size_t n = base_ ? base_->Count() : 0;
+  for (const auto &entry : overlay_) {
+    if (base_ && base_->Find(entry.first) >= 0) n--;
+    if (entry.second) n++;
+  }
+  count_ = n;
+}
+
+bool Store::Exists(const std::string &id) const {
+  auto it = overlay_.find(id);
+  if (it != overlay_.end()) return it->second.has_value();
+  return base_ && base_->Find(id) >= 0;
+}
+
+void Store::ForEach(const std::function<void(const Record &)> &fn) const {
+  Record record;
+  if (base_) {
+    for (uint32_t i = 0; i < base_->Count(); i++) {
+      std::string_view id = base_->IdAt(i);
+      if (!overlay_.empty() && overlay_.count(std::string(id))) continue;
+      base_->DecodeAt(i, &record);
+      fn(record);
+    }
+  }
+  for (const auto &entry : overlay_) {
+    if (entry.second) fn(*entry.second);
+  }
+}
+
+bool Store::Get(const std::string &id, Record *out) const {
+  auto it = overlay_.find(id);
+  if (it != overlay_.end()) {
+    if (!it->second) return false;
+    *out = *it->second;
+    return true;
+  }
+  if (!base_) return false;
+  int64_t index = base_->Find(id);
+  if (index < 0) return false;
+  base_->DecodeAt(static_cast<uint32_t>(index), out);
+  return true;
+}
+
+bool Store::Append(const std::vector<Record> &puts, const std::vector<std::string> &removes,
+                   std::string *error) {
+  if (!log_file_) {
+    *error = "library store is not open";
+    return false;
+  }
+
+  std::string buf;
+  auto write_entry = [&buf](uint8_t op, const std::string &payload) {
+    AppendU32(buf, kLogMagic);
+    AppendU32(buf, static_cast<uint32_t>(payload.size()));
+    size_t checked_from = buf.size();
+    buf.push_back(static_cast<char>(op));
+    buf += payload;
+    AppendU32(buf, Fnv1a32(reinterpret_cast<const uint8_t *>(buf.data() + checked_from),
+                           1 + payload.size()));
+  };
+
+  for (const auto &record : puts) {
+    // Each put carries its own small string area; offsets are relative to it.
+    std::string strings;
+    DiskRecord d = Encode(record, [&strings](const std::string &s) {
+      uint32_t offset = static_cast<uint32_t>(strings.size());
+      AppendU32(strings, static_cast<uint32_t>(s.size()));
+      strings += s;
+      return offset;
+    });
+    std::string payload(reinterpret_cast<const char *>(&d), sizeof(d));
+    payload += strings;
+    write_entry(kOpPut, payload);
+  }
+  for (const auto &id : removes) write_entry(kOpRemove, id);
+
+  if (buf.empty()) return true;
+  if (fwrite(buf.data(), 1, buf.size(), log_file_) != buf.size() || fflush(log_file_) != 0) {
+    *error = std::string("cannot append to library log: ") + strerror(errno);
+    return false;
+  }
+  log_bytes_ += buf.size();
+
+  for (const auto &record : puts) {
+    if (!Exists(record.Id())) count_++;
+    overlay_[record.Id()] = record;
+  }
+  for (const auto &id : removes) {
+    if (Exists(id)) count_--;
+    overlay_[id] = std::nullopt;
+  }
+  return true;
+}
+
+Store::Snapshot Store::TakeSnapshot() const {
+  Snapshot snapshot;
+  snapshot.base = base_;
+  snapshot.overlay = overlay_;
+  snapshot.log_offset = log_bytes_;
+  return snapshot;
+}
+
+bool Store::WriteBase(const Snapshot &snapshot, std::string *error) const {
+  std::vector<Record> records;
+  if (snapshot.base) {
+    records.reserve(snapshot.base->Count() + snapshot.overlay.size());
+    Record record;
+    for (uint32_t i = 0; i < snapshot.base->Count(); i++) {
+      if (!snapshot.overlay.empty() &&
+          snapshot.overlay.count(std::string(snapshot.base->IdAt(i)))) {
+        continue;
+      }
+      snapshot.base->DecodeAt(i, &record);
+      records.push_back(record);
+    }
+  }
+  for (const auto &entry : snapshot.overlay) {
+    if (entry.second) records.push_back(*entry.second);
+  }
+  return WriteBase(records, error);
+}
+
+bool Store::WriteBase(const std::vector<Record> &input, std::string *error) const {
+  // Last occurrence of an id wins.
+  std::vector<const Record *> records;
+  {
+    std::unordered_set<std::string> seen;
+    for (auto it = input.rbegin(); it != input.rend(); ++it) {
+      if (it->Has(kId) && seen.insert(it->Id()).second) records.push_back(&*it);
+    }
+    std::reverse(records.begin(), records.end());
+  }
+
+  std::string table;
+  std::unordered_map<std::string, uint32_t> interned;
+  auto intern = [&table, &interned](const std::string &s) {
+    auto it = interned.find(s);
+    if (it != interned.end()) return it->second;
+    uint32_t offset = static_cast<uint32_t>(table.size());
+    AppendU32(table, static_cast<uint32_t>(s.size()));
+    table += s;
+    interned.emplace(s, offset);
+    return offset;
+  };
+
+  std::vector<DiskRecord> disk;
+  disk.reserve(records.size());
+  for (const Record *r : records) disk.push_back(Encode(*r, intern));
+  if (table.size() >= kNoString) {
+    *error = "library string table exceeds 4 GiB";
+    return false;
+  }
+
+  uint32_t capacity = 16;
+  while (capacity < records.size() * 2) capacity <<= 1;
+  std::vector<uint32_t> index(capacity, 0);
+  for (uint32_t i = 0; i < records.size(); i++) {
+    const std::string &id = records[i]->Id();
+    uint32_t slot = static_cast<uint32_t>(Fnv1a64(id.data(), id.size())) & (capacity - 1);
+    while (index[slot] != 0) slot = (slot + 1) & (capacity - 1);
+    index[slot] = i + 1;
+  }
+
+  FileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.record_size = sizeof(DiskRecord);
+  header.record_count = static_cast<uint32_t>(records.size());
+  header.index_capacity = capacity;
+  header.records_offset = sizeof(FileHeader);
+  header.index_offset = header.records_offset + disk.size() * sizeof(DiskRecord);
+  header.strings_offset = (header.index_offset + static_cast<uint64_t>(capacity) * 4 + 7) & ~7ull;
+  header.strings_size = table.size();
+  size_t padding = static_cast<size_t>(header.strings_offset - header.index_offset - capacity * 4ull);
+
+  std::string tmp = base_path_ + ".tmp";
+  FILE *f = fopen(tmp.c_str(), "wb");
+  if (!f) {
+    *error = std::string("cannot write library store: ") + strerror(errno);
+    return false;
+  }
+  static const char kZeros[8] = {};
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+  ok = ok && (disk.empty() || fwrite(disk.data(), sizeof(DiskRecord), disk.size(), f) == disk.size());
+  ok = ok && fwrite(index.data(), 4, index.size(), f) == index.size();
+  ok = ok && (padding == 0 || fwrite(kZeros, 1, padding, f) == padding);
+  ok = ok && (table.empty() || fwrite(table.data(), 1, table.size(), f) == table.size());
+  ok = SyncAndClose(f) && ok;
+  if (!ok || !ReplaceFileAtomic(tmp, base_path_)) {
+    *error = std::string("cannot write library store: ") + strerror(errno);
+    std::remove(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool Store::FinishCompaction(uint64_t log_offset, std::string *error) {
+  // Entries up to `log_offset` are now part of the base image; anything
+  // appended after it happened while the worker ran and must be kept.
+  std::vector<uint8_t> log;
+  ReadWholeFile(log_path_, &log);
+  std::vector<uint8_t> tail;
+  if (log_offset < log.size()) tail.assign(log.begin() + static_cast<ptrdiff_t>(log_offset), log.end());
+
+  if (log_file_) fclose(log_file_);
+  log_file_ = nullptr;
+  if (!WriteWholeFile(log_path_, tail.data(), tail.size())) {
+    *error = std::string("cannot rewrite library log: ") + strerror(errno);
+    OpenLogForAppend(error);
+    return false;
+  }
+
+  std::shared_ptr<const Mapping> previous = base_;
+  if (!LoadBase(error) || !base_) {
+    if (error->empty()) *error = "library store disappeared during compaction";
+    base_ = previous;
+    OpenLogForAppend(error);
+    return false;
+  }
+
+  overlay_.clear();
+  uint64_t valid = 0;
+  ReplayLog(tail, &valid);
+  log_bytes_ = valid;
+  if (!OpenLogForAppend(error)) return false;
+  RecountRecords();
+  return true;
+}
+
+} // namespace library_store
+
+// ---------------------------------------------------------------------------
+// N-API binding
+// ---------------------------------------------------------------------------
+
+using library_store::NumberField;
+using library_store::Record;
+using library_store::StringField;
+
+namespace {
+
+const char *const kStringFieldNames[library_store::kStringFieldCount] = {
+  "id", "title", "romPath", "system", "systemId", "coverArt",
+  "sourceArchivePath", "m3uPath", "discGroup", "serial", "extra",
+};
+
+const char *const kNumberFieldNames[library_store::kNumberFieldCount] = {
+  "romMtime", "playTime", "artworkNotFound", "coverArtAspectRatio", "discNumber", "discTotal",
+};
+
+bool ParseHex(const std::string &hex, uint8_t *out, size_t bytes) {
+  if (hex.size() != bytes * 2) return false;
+  for (size_t i = 0; i < bytes; i++) {
+    unsigned value = 0;
+    for (size_t j = 0; j < 2; j++) {
+      char c = hex[i * 2 + j];
+      value <<= 4;
+      if (c >= '0' && c <= '9') value |= static_cast<unsigned>(c - '0');
+      else if (c >= 'a' && c <= 'f') value |= static_cast<unsigned>(c - 'a' + 10);
+      else return false;
+    }
+    out[i] = static_cast<uint8_t>(value);
+  }
+  return true;
+}
+
+std::string ToHex(const uint8_t *data, size_t bytes) {
+  static const char kDigits[] = "0123456789abcdef";
+  std::string hex(bytes * 2, '0');
+  for (size_t i = 0; i < bytes; i++) {
+    hex[i * 2] = kDigits[data[i] >> 4];
+    hex[i * 2 + 1] = kDigits[data[i] & 0xF];
+  }
+  return hex;
+}
+
+bool RecordFromJS(const Napi::Object &obj, Record *r) {
+  for (int f = 0; f < library_store::kStringFieldCount; f++) {
+    Napi::Value v = obj.Get(kStringFieldNames[f]);
+    if (v.IsString()) r->Set(static_cast<StringField>(f), v.As<Napi::String>().Utf8Value());
+  }
+  if (!r->Has(library_store::kId)) return false;
+
+  for (int f = 0; f < library_store::kNumberFieldCount; f++) {
+    Napi::Value v = obj.Get(kNumberFieldNames[f]);
+    if (v.IsNumber()) r->numbers[f] = v.As<Napi::Number>().DoubleValue();
+  }
+
+  Napi::Value favorite = obj.Get("favorite");
+  if (favorite.IsBoolean()) r->favorite = favorite.As<Napi::Boolean>().Value() ? 1 : 0;
+
+  Napi::Value crc = obj.Get("crc32");
+  Napi::Value md5 = obj.Get("md5");
+  Napi::Value sha1 = obj.Get("sha1");
+  if (crc.IsString() && md5.IsString() && sha1.IsString()) {
+    uint8_t crc_bytes[4];
+    if (ParseHex(crc.As<Napi::String>().Utf8Value(), crc_bytes, 4) &&
+        ParseHex(md5.As<Napi::String>().Utf8Value(), r->md5.data(), 16) &&
+        ParseHex(sha1.As<Napi::String>().Utf8Value(), r->sha1.data(), 20)) {
+      r->crc32 = (static_cast<uint32_t>(crc_bytes[0]) << 24) |
+                 (static_cast<uint32_t>(crc_bytes[1]) << 16) |
+                 (static_cast<uint32_t>(crc_bytes[2]) << 8) | crc_bytes[3];
+      r->has_hashes = true;
+    }
+  }
+  return true;
+}
+
+Napi::Object RecordToJS(Napi::Env env, const Record &r) {
+  Napi::Object obj = Napi::Object::New(env);
+  for (int f = 0; f < library_store::kStringFieldCount; f++) {
+    if (r.Has(static_cast<StringField>(f))) {
+      obj.Set(kStringFieldNames[f], Napi::String::New(env, r.strings[f]));
+    }
+  }
+  for (int f = 0; f < library_store::kNumberFieldCount; f++) {
+    if (!std::isnan(r.numbers[f])) obj.Set(kNumberFieldNames[f], Napi::Number::New(env, r.numbers[f]));
+  }
+  if (r.favorite >= 0) obj.Set("favorite", Napi::Boolean::New(env, r.favorite == 1));
+  if (r.has_hashes) {
+    uint8_t crc_bytes[4] = {
+      static_cast<uint8_t>(r.crc32 >> 24), static_cast<uint8_t>(r.crc32 >> 16),
+      static_cast<uint8_t>(r.crc32 >> 8), static_cast<uint8_t>(r.crc32),
+    };
+    obj.Set("crc32", Napi::String::New(env, ToHex(crc_bytes, 4)));
+    obj.Set("md5", Napi::String::New(env, ToHex(r.md5.data(), 16)));
+    obj.Set("sha1", Napi::String::New(env, ToHex(r.sha1.data(), 20)));
+  }
+  return obj;
+}
+
+} // namespace
+
+// Builds a new base image off the main thread, then swaps it in.
+class StoreCompactWorker : public Napi::AsyncWorker {
+public:
+  StoreCompactWorker(Napi::Env env, LibraryStore *owner, library_store::Store::Snapshot snapshot,
+                     std::vector<Record> records, bool replace)
+      : Napi::AsyncWorker(env),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        owner_(owner),
+        snapshot_(std::move(snapshot)),
+        records_(std::move(records)),
+        replace_(replace) {
+    owner_->Ref();
+  }
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+protected:
+  void Execute() override {
+    std::string error;
+    bool ok = replace_ ? owner_->store_->WriteBase(records_, &error)
+                       : owner_->store_->WriteBase(snapshot_, &error);
+    if (!ok) SetError(error);
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    owner_->busy_ = false;
+    std::string error;
+    bool ok = owner_->store_->FinishCompaction(snapshot_.log_offset, &error);
+    owner_->Unref();
+    if (ok) {
+      deferred_.Resolve(env.Undefined());
+    } else {
+      deferred_.Reject(Napi::Error::New(env, error).Value());
+    }
+  }
+
+  void OnError(const Napi::Error &error) override {
+    owner_->busy_ = false;
+    owner_->Unref();
+    deferred_.Reject(error.Value());
+  }
+
+private:
+  Napi::Promise::Deferred deferred_;
+  LibraryStore *owner_;
+  library_store::Store::Snapshot snapshot_;
+  std::vector<Record> records_;
+  bool replace_;
+};
+
+void LibraryStore::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "LibraryStore", {
+    InstanceMethod("open", &LibraryStore::Open),
+    InstanceMethod("readAll", &LibraryStore::ReadAll),
+    InstanceMethod("put", &LibraryStore::Put),
+    InstanceMethod("remove", &LibraryStore::Remove),
+    InstanceMethod("stats", &LibraryStore::Stats),
+    InstanceMethod("compact", &LibraryStore::Compact),
+    InstanceMethod("replaceAll", &LibraryStore::ReplaceAll),
+    InstanceMethod("close", &LibraryStore::Close),
+  });
+  exports.Set("LibraryStore", func);
+}
+
+LibraryStore::LibraryStore(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<LibraryStore>(info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected store path string").ThrowAsJavaScriptException();
+    return;
+  }
+  store_ = std::make_unique<library_store::Store>(info[0].As<Napi::String>().Utf8Value());
+}
+
+Napi::Value LibraryStore::Open(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  std::string error;
+  bool exists = store_->Open(&error);
+  if (!exists && !error.empty()) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  return Napi::Boolean::New(env, exists);
+}
+
+Napi::Value LibraryStore::ReadAll(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  Napi::Array result = Napi::Array::New(env, store_->Count());
+  uint32_t i = 0;
+  store_->ForEach([&](const Record &record) {
+    result.Set(i++, RecordToJS(env, record));
+  });
+  return result;
+}
+
+void LibraryStore::Put(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected array of records").ThrowAsJavaScriptException();
+    return;
+  }
+
+  Napi::Array arr = info[0].As<Napi::Array>();
+  std::vector<Record> records;
+  records.reserve(arr.Length());
+  for (uint32_t i = 0; i < arr.Length(); i++) {
+    Napi::Value v = arr.Get(i);
+    Record record;
+    if (!v.IsObject() || !RecordFromJS(v.As<Napi::Object>(), &record)) {
+      Napi::TypeError::New(env, "Each record needs a string id").ThrowAsJavaScriptException();
+      return;
+    }
+    records.push_back(std::move(record));
+  }
+
+  std::string error;
+  if (!store_->Append(records, {}, &error)) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+  }
+}
+
+void LibraryStore::Remove(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected array of ids").ThrowAsJavaScriptException();
+    return;
+  }
+
+  Napi::Array arr = info[0].As<Napi::Array>();
+  std::vector<std::string> ids;
+  for (uint32_t i = 0; i < arr.Length(); i++) {
+    Napi::Value v = arr.Get(i);
+    if (v.IsString()) ids.push_back(v.As<Napi::String>().Utf8Value());
+  }
+
+  std::string error;
+  if (!store_->Append({}, ids, &error)) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+  }
+}
+
+Napi::Value LibraryStore::Stats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  Napi::Object stats = Napi::Object::New(env);
+  stats.Set("records", Napi::Number::New(env, static_cast<double>(store_->Count())));
+  stats.Set("baseBytes", Napi::Number::New(env, static_cast<double>(store_->BaseBytes())));
+  stats.Set("logBytes", Napi::Number::New(env, static_cast<double>(store_->LogBytes())));
+  return stats;
+}
+
+Napi::Value LibraryStore::Compact(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (busy_) {
+    // A compaction is already folding the log; later edits stay in the log.
+    auto deferred = Napi::Promise::Deferred::New(env);
+    deferred.Resolve(env.Undefined());
+    return deferred.Promise();
+  }
+  busy_ = true;
+  auto *worker = new StoreCompactWorker(env, this, store_->TakeSnapshot(), {}, false);
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
+
+Napi::Value LibraryStore::ReplaceAll(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected array of records").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (busy_) {
+    Napi::Error::New(env, "Library store compaction in progress").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Array arr = info[0].As<Napi::Array>();
+  std::vector<Record> records;
+  records.reserve(arr.Length());
+  for (uint32_t i = 0; i < arr.Length(); i++) {
+    Napi::Value v = arr.Get(i);
+    Record record;
+    if (v.IsObject() && RecordFromJS(v.As<Napi::Object>(), &record)) records.push_back(std::move(record));
+  }
+
+  busy_ = true;
+  // The snapshot's log offset marks everything logged so far as superseded.
+  // If the store never opened (corrupt base), the whole log is stale.
+  library_store::Store::Snapshot snapshot = store_->TakeSnapshot();
+  if (!store_->IsOpen()) snapshot.log_offset = std::numeric_limits<uint64_t>::max();
+  auto *worker = new StoreCompactWorker(env, this, std::move(snapshot), std::move(records), true);
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
+
+void LibraryStore::Close(const Napi::CallbackInfo &info) {
+  // A running compaction still owns a snapshot of the base mapping; the
+  // store itself is only torn down when this object is collected.
+  if (!busy_) store_->Close();
+}
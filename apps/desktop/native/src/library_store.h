@@ -0,0 +1,170 @@
+#ifndef LIBRARY_STORE_H
+#define LIBRARY_STORE_H
+
+#include <napi.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Binary library store.
+//
+// The library lives in two files:
+//
+//   library.bin      Immutable base image, memory-mapped on open:
+//                    header | fixed-width records | id hash index | string table
+//   library.bin.log  Append-only change log of record puts / removals,
+//                    replayed over the base on open.
+//
+// Edits append to the log (O(changed records)); compaction folds the log into
+// a fresh base image on a worker thread and atomically swaps it in. Strings
+// are interned in the string table, ROM hashes are stored as raw bytes.
+//
+// Fields with no fixed column (nested metadata, region lists, anything added
+// to `Game` later) travel as an opaque `extra` JSON string owned by JS.
+namespace library_store {
+
+enum StringField {
+  kId,
+  kTitle,
+  kRomPath,
+  kSystem,
+  kSystemId,
+  kCoverArt,
+  kSourceArchivePath,
+  kM3uPath,
+  kDiscGroup,
+  kSerial,
+  kExtra,
+  kStringFieldCount,
+};
+
+enum NumberField {
+  kRomMtime,
+  kPlayTime,
+  kArtworkNotFound,
+  kCoverArtAspectRatio,
+  kDiscNumber,
+  kDiscTotal,
+  kNumberFieldCount,
+};
+
+struct Record {
+  std::array<std::string, kStringFieldCount> strings;
+  uint32_t string_mask = 0; // bit per StringField that is present
+  std::array<double, kNumberFieldCount> numbers; // NaN = absent
+  bool has_hashes = false;
+  uint32_t crc32 = 0;
+  std::array<uint8_t, 16> md5{};
+  std::array<uint8_t, 20> sha1{};
+  int8_t favorite = -1; // -1 absent, 0 false, 1 true
+
+  Record();
+  bool Has(StringField f) const { return (string_mask >> f) & 1u; }
+  void Set(StringField f, std::string value) {
+    strings[f] = std::move(value);
+    string_mask |= 1u << f;
+  }
+  const std::string &Id() const { return strings[kId]; }
+};
+
+// Read-only view of the base file (mmap on POSIX, read into memory on Windows).
+struct Mapping;
+
+class Store {
+public:
+  explicit Store(std::string path);
+  ~Store();
+
+  Store(const Store &) = delete;
+  Store &operator=(const Store &) = delete;
+
+  // Map the base file and replay the change log. Returns false with an empty
+  // `error` when neither file exists yet, or false with `error` set when the
+  // base image is unreadable.
+  bool Open(std::string *error);
+  void Close();
+  bool IsOpen() const { return log_file_ != nullptr; }
+
+  size_t Count() const { return count_; }
+  uint64_t BaseBytes() const;
+  uint64_t LogBytes() const { return log_bytes_; }
+
+  void ForEach(const std::function<void(const Record &)> &fn) const;
+  bool Get(const std::string &id, Record *out) const;
+
+  // Append puts and removals to the change log in a single write.
+  bool Append(const std::vector<Record> &puts, const std::vector<std::string> &removes,
+              std::string *error);
+
+  // Everything a worker thread needs to build a new base image without
+  // touching the live store.
+  struct Snapshot {
+    std::shared_ptr<const Mapping> base;
+    std::unordered_map<std::string, std::optional<Record>> overlay;
+    uint64_t log_offset = 0;
+  };
+  Snapshot TakeSnapshot() const;
+
+  // Worker-thread half of compaction: write the merged snapshot (or an
+  // explicit record list) as the new base image via tmp file + rename.
+  bool WriteBase(const Snapshot &snapshot, std::string *error) const;
+  bool WriteBase(const std::vector<Record> &records, std::string *error) const;
+
+  // Main-thread half: re-map the new base and keep only log entries appended
+  // after `log_offset` (edits made while the worker ran).
+  bool FinishCompaction(uint64_t log_offset, std::string *error);
+
+private:
+  bool LoadBase(std::string *error);
+  bool ReplayLog(const std::vector<uint8_t> &bytes, uint64_t *valid_bytes);
+  bool Exists(const std::string &id) const;
+  bool OpenLogForAppend(std::string *error);
+  void RecountRecords();
+
+  std::string base_path_;
+  std::string log_path_;
+  std::shared_ptr<const Mapping> base_;
+  std::unordered_map<std::string, std::optional<Record>> overlay_;
+  size_t count_ = 0;
+  uint64_t log_bytes_ = 0;
+  FILE *log_file_ = nullptr;
+};
+
+} // namespace library_store
+
+// N-API wrapper:
+//
+//   const store = new LibraryStore(path);
+//   store.open() → boolean           // false: no store on disk yet
+//   store.readAll() → Array<record>
+//   store.put(records); store.remove(ids);
+//   store.stats() → { records, baseBytes, logBytes }
+//   store.compact() / store.replaceAll(records) → Promise<void>
+class LibraryStore : public Napi::ObjectWrap<LibraryStore> {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+  LibraryStore(const Napi::CallbackInfo &info);
+
+private:
+  Napi::Value Open(const Napi::CallbackInfo &info);
+  Napi::Value ReadAll(const Napi::CallbackInfo &info);
+  void Put(const Napi::CallbackInfo &info);
+  void Remove(const Napi::CallbackInfo &info);
+  Napi::Value Stats(const Napi::CallbackInfo &info);
+  Napi::Value Compact(const Napi::CallbackInfo &info);
+  Napi::Value ReplaceAll(const Napi::CallbackInfo &info);
+  void Close(const Napi::CallbackInfo &info);
+
+  friend class StoreCompactWorker;
+
+  std::unique_ptr<library_store::Store> store_;
+  bool busy_ = false;
+};
+
+#endif // LIBRARY_STORE_H
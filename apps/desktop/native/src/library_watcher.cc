@@ -0,0 +1,515 @@
+#include "library_watcher.h"
+#include "fs_util.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using fs_util::ExtensionOf;
+using fs_util::JoinPath;
+
+namespace {
+
+#ifdef __linux__
+// CLOSE_WRITE rather than MODIFY: a ROM being copied in produces thousands of
+// MODIFY events but exactly one CLOSE_WRITE once the data is complete.
+constexpr uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM |
+                                IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR |
+                                IN_DONT_FOLLOW;
+#endif
+
+const char *KindName(LibraryWatcher::ChangeKind kind) {
+  switch (kind) {
+    case LibraryWatcher::ChangeKind::Add: return "add";
+    case LibraryWatcher::ChangeKind::Change: return "change";
+    case LibraryWatcher::ChangeKind::Remove: return "remove";
+    case LibraryWatcher::ChangeKind::Rename: return "rename";
+    case LibraryWatcher::ChangeKind::Overflow: return "overflow";
+  }
+  return "change";
+}
+
+void DeliverChanges(Napi::Env env, Napi::Function callback,
+                    std::vector<LibraryWatcher::Change> *changes) {
+  if (env != nullptr) {
+    Napi::Array arr = Napi::Array::New(env, changes->size());
+    for (size_t i = 0; i < changes->size(); i++) {
+      const auto &change = (*changes)[i];
+      Napi::Object obj = Napi::Object::New(env);
+      obj.Set("type", Napi::String::New(env, KindName(change.kind)));
+      obj.Set("path", Napi::String::New(env, change.path));
+      obj.Set("isDirectory", Napi::Boolean::New(env, change.is_directory));
+      if (change.kind == LibraryWatcher::ChangeKind::Rename) {
+        obj.Set("oldPath", Napi::String::New(env, change.old_path));
+      }
+      arr.Set(static_cast<uint32_t>(i), obj);
+    }
+    callback.Call({arr});
+  }
+  delete changes;
+}
+
+bool IsUnder(const std::string &path, const std::string &prefix) {
+  return path == prefix ||
+         (path.size() > prefix.size() && path.compare(0, prefix.size(), prefix) == 0 &&
+          path[prefix.size()] == '/');
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Lifecycle
+// ---------------------------------------------------------------------------
+
+void LibraryWatcher::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "LibraryWatcher", {
+    InstanceMethod("start", &LibraryWatcher::Start),
+    InstanceMethod("close", &LibraryWatcher::Close),
+  });
+  exports.Set("LibraryWatcher", func);
+}
+
+LibraryWatcher::LibraryWatcher(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<LibraryWatcher>(info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsObject() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (options, onChanges)").ThrowAsJavaScriptException();
+    return;
+  }
+
+  Napi::Object options = info[0].As<Napi::Object>();
+  if (!options.Get("roots").IsArray()) {
+    Napi::TypeError::New(env, "options.roots must be an array of paths").ThrowAsJavaScriptException();
+    return;
+  }
+
+  Napi::Array roots = options.Get("roots").As<Napi::Array>();
+  for (uint32_t i = 0; i < roots.Length(); i++) {
+    Napi::Value v = roots.Get(i);
+    if (!v.IsString()) continue;
+    std::string root = v.As<Napi::String>().Utf8Value();
+    while (root.size() > 1 && root.back() == '/') root.pop_back();
+    roots_.push_back(root);
+  }
+
+  if (options.Get("extensions").IsArray()) {
+    Napi::Array exts = options.Get("extensions").As<Napi::Array>();
+    for (uint32_t i = 0; i < exts.Length(); i++) {
+      Napi::Value v = exts.Get(i);
+      if (v.IsString()) extensions_.insert(fs_util::Lowercase(v.As<Napi::String>().Utf8Value()));
+    }
+  }
+
+  if (options.Get("coalesceMs").IsNumber()) {
+    coalesce_ms_ = std::max(10, options.Get("coalesceMs").As<Napi::Number>().Int32Value());
+  }
+
+  callback_ = Napi::Persistent(info[1].As<Napi::Function>());
+}
+
+LibraryWatcher::~LibraryWatcher() {
+  Stop();
+}
+
+void LibraryWatcher::Close(const Napi::CallbackInfo &info) {
+  Stop();
+}
+
+void LibraryWatcher::Stop() {
+  if (running_.exchange(false)) {
+#ifdef __linux__
+    uint64_t one = 1;
+    ssize_t written = write(wake_fd_, &one, sizeof(one));
+    (void)written;
+#endif
+    if (thread_.joinable()) thread_.join();
+  }
+
+#ifdef __linux__
+  if (inotify_fd_ >= 0) close(inotify_fd_);
+  if (wake_fd_ >= 0) close(wake_fd_);
+  inotify_fd_ = -1;
+  wake_fd_ = -1;
+  wd_paths_.clear();
+  path_wds_.clear();
+#endif
+
+  if (has_tsfn_) {
+    tsfn_.Release();
+    has_tsfn_ = false;
+  }
+}
+
+Napi::Value LibraryWatcher::Start(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+#ifndef __linux__
+  Napi::Error::New(env, "LibraryWatcher requires inotify (Linux only)").ThrowAsJavaScriptException();
+  return env.Undefined();
+#else
+  if (running_) {
+    Napi::Error::New(env, "LibraryWatcher already started").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (inotify_fd_ < 0 || wake_fd_ < 0) {
+    std::string message = std::string("inotify init failed: ") + strerror(errno);
+    Stop();
+    Napi::Error::New(env, message).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::vector<DirSnapshot> snapshot;
+  std::vector<std::pair<std::string, std::string>> errors;
+  for (const auto &root : roots_) {
+    AddWatchTree(root, &snapshot, &errors);
+  }
+
+  tsfn_ = Napi::ThreadSafeFunction::New(env, callback_.Value(), "LibraryWatcher", 0, 1);
+  // Never keep the process alive just because the library is being watched.
+  tsfn_.Unref(env);
+  has_tsfn_ = true;
+
+  running_ = true;
+  thread_ = std::thread(&LibraryWatcher::EventLoop, this);
+
+  Napi::Object result = Napi::Object::New(env);
+  Napi::Array dirs = Napi::Array::New(env, snapshot.size());
+  for (size_t i = 0; i < snapshot.size(); i++) {
+    Napi::Object dir = Napi::Object::New(env);
+    dir.Set("path", Napi::String::New(env, snapshot[i].path));
+    dir.Set("mtimeMs", Napi::Number::New(env, snapshot[i].mtime_ms));
+    dirs.Set(static_cast<uint32_t>(i), dir);
+  }
+  result.Set("directories", dirs);
+
+  Napi::Array errs = Napi::Array::New(env, errors.size());
+  for (size_t i = 0; i < errors.size(); i++) {
+    Napi::Object err = Napi::Object::New(env);
+    err.Set("path", Napi::String::New(env, errors[i].first));
+    err.Set("message", Napi::String::New(env, errors[i].second));
+    errs.Set(static_cast<uint32_t>(i), err);
+  }
+  result.Set("errors", errs);
+  return result;
+#endif
+}
+
+#ifdef __linux__
+
+// ---------------------------------------------------------------------------
+// Watch set maintenance
+// ---------------------------------------------------------------------------
+
+void LibraryWatcher::AddWatchTree(const std::string &root, std::vector<DirSnapshot> *snapshot,
+                                  std::vector<std::pair<std::string, std::string>> *errors) {
+  std::vector<std::string> stack{root};
+
+  while (!stack.empty()) {
+    std::string dir = std::move(stack.back());
+    stack.pop_back();
+
+    struct stat st;
+    if (lstat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) continue;
+
+    int wd = inotify_add_watch(inotify_fd_, dir.c_str(), kWatchMask);
+    if (wd < 0) {
+      if (errors) {
+        errors->push_back({dir, errno == ENOSPC
+                                    ? "inotify watch limit reached (fs.inotify.max_user_watches)"
+                                    : strerror(errno)});
+      }
+    } else {
+      // The kernel hands back the existing descriptor when an inode is
+      // already watched (e.g. a directory moved back in) — drop its old path.
+      auto existing = wd_paths_.find(wd);
+      if (existing != wd_paths_.end() && existing->second != dir) {
+        path_wds_.erase(existing->second);
+      }
+      wd_paths_[wd] = dir;
+      path_wds_[dir] = wd;
+    }
+
+    if (snapshot) snapshot->push_back({dir, fs_util::MtimeMs(st)});
+
+    DIR *d = opendir(dir.c_str());
+    if (!d) continue;
+    while (struct dirent *entry = readdir(d)) {
+      if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+      bool is_dir = entry->d_type == DT_DIR;
+      if (entry->d_type == DT_UNKNOWN) {
+        struct stat child;
+        std::string child_path = JoinPath(dir, entry->d_name);
+        is_dir = lstat(child_path.c_str(), &child) == 0 && S_ISDIR(child.st_mode);
+      }
+      if (is_dir) stack.push_back(JoinPath(dir, entry->d_name));
+    }
+    closedir(d);
+  }
+}
+
+void LibraryWatcher::ForgetWatchTree(const std::string &prefix, bool remove_watches) {
+  for (auto it = path_wds_.begin(); it != path_wds_.end();) {
+    if (IsUnder(it->first, prefix)) {
+      if (remove_watches) inotify_rm_watch(inotify_fd_, it->second);
+      wd_paths_.erase(it->second);
+      it = path_wds_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void LibraryWatcher::RenameWatchTree(const std::string &old_prefix, const std::string &new_prefix) {
+  std::vector<std::pair<std::string, int>> moved;
+  for (const auto &entry : path_wds_) {
+    if (IsUnder(entry.first, old_prefix)) moved.push_back(entry);
+  }
+  for (const auto &entry : moved) {
+    std::string renamed = new_prefix + entry.first.substr(old_prefix.size());
+    path_wds_.erase(entry.first);
+    path_wds_[renamed] = entry.second;
+    wd_paths_[entry.second] = renamed;
+  }
+}
+
+bool LibraryWatcher::WantsFile(const std::string &path) const {
+  if (extensions_.empty()) return true;
+  size_t slash = path.rfind('/');
+  return extensions_.count(ExtensionOf(slash == std::string::npos ? path : path.substr(slash + 1))) > 0;
+}
+
+// ---------------------------------------------------------------------------
+// Event handling and coalescing
+// ---------------------------------------------------------------------------
+
+void LibraryWatcher::EventLoop() {
+  alignas(struct inotify_event) char buf[64 * 1024];
+
+  while (running_) {
+    int timeout_ms = -1;
+    if (!pending_.empty() || !pending_moves_.empty()) {
+      // Flush once the tree has been quiet for the coalescing window, but
+      // never hold changes back for longer than 4 windows during a long copy.
+      auto now = std::chrono::steady_clock::now();
+      auto deadline = std::min(last_event_ + std::chrono::milliseconds(coalesce_ms_),
+                               first_pending_ + std::chrono::milliseconds(coalesce_ms_ * 4));
+      if (now >= deadline) {
+        Flush();
+        continue;
+      }
+      timeout_ms = static_cast<int>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count()) + 1;
+    }
+
+    struct pollfd fds[2] = {{inotify_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+    int ready = poll(fds, 2, timeout_ms);
+    if (ready < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    if (fds[1].revents & POLLIN) break;
+    if (!(fds[0].revents & POLLIN)) continue;
+
+    ssize_t len = read(inotify_fd_, buf, sizeof(buf));
+    if (len <= 0) {
+      if (len < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+      break;
+    }
+
+    for (char *p = buf; p < buf + len;) {
+      auto *event = reinterpret_cast<struct inotify_event *>(p);
+      HandleEvent(event->mask, event->wd, event->cookie, event->len ? event->name : "");
+      p += sizeof(struct inotify_event) + event->len;
+    }
+  }
+}
+
+void LibraryWatcher::HandleEvent(uint32_t mask, int wd, uint32_t cookie, const char *name) {
+  auto now = std::chrono::steady_clock::now();
+  if (pending_.empty() && pending_moves_.empty()) first_pending_ = now;
+  last_event_ = now;
+
+  if (mask & IN_Q_OVERFLOW) {
+    // Events were dropped — nothing queued so far can be trusted to be
+    // complete. Tell JS to fall back to a full reconcile.
+    pending_.clear();
+    pending_index_.clear();
+    pending_moves_.clear();
+    Queue(ChangeKind::Overflow, "", false);
+    return;
+  }
+
+  auto it = wd_paths_.find(wd);
+  if (it == wd_paths_.end()) return;
+  const std::string dir = it->second;
+
+  if (mask & IN_IGNORED) {
+    path_wds_.erase(dir);
+    wd_paths_.erase(it);
+    return;
+  }
+
+  if (mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+    // Subdirectories are reported through their parent's DELETE/MOVED_FROM;
+    // only a vanished root needs reporting here.
+    if (std::find(roots_.begin(), roots_.end(), dir) != roots_.end()) {
+      Queue(ChangeKind::Remove, dir, true);
+    }
+    return;
+  }
+
+  bool is_dir = (mask & IN_ISDIR) != 0;
+  std::string path = JoinPath(dir, name);
+
+  if (mask & IN_MOVED_FROM) {
+    pending_moves_[cookie] = {path, is_dir};
+    return;
+  }
+
+  if (mask & IN_MOVED_TO) {
+    auto from = pending_moves_.find(cookie);
+    if (from != pending_moves_.end()) {
+      PendingMove move = std::move(from->second);
+      pending_moves_.erase(from);
+      if (is_dir) {
+        RenameWatchTree(move.path, path);
+        Queue(ChangeKind::Rename, path, true, move.path);
+      } else {
+        bool wanted_old = WantsFile(move.path);
+        bool wanted_new = WantsFile(name);
+        if (wanted_old && wanted_new) Queue(ChangeKind::Rename, path, false, move.path);
+        else if (wanted_new) Queue(ChangeKind::Add, path, false);
+        else if (wanted_old) Queue(ChangeKind::Remove, move.path, false);
+      }
+    } else if (is_dir) {
+      // Moved in from outside the watched tree.
+      AddWatchTree(path, nullptr, nullptr);
+      Queue(ChangeKind::Add, path, true);
+    } else if (WantsFile(name)) {
+      Queue(ChangeKind::Add, path, false);
+    }
+    return;
+  }
+
+  if (mask & IN_CREATE) {
+    // New files are reported on CLOSE_WRITE, once their contents are complete.
+    if (is_dir) {
+      AddWatchTree(path, nullptr, nullptr);
+      Queue(ChangeKind::Add, path, true);
+    }
+    return;
+  }
+
+  if (mask & IN_CLOSE_WRITE) {
+    if (WantsFile(name)) Queue(ChangeKind::Change, path, false);
+    return;
+  }
+
+  if (mask & IN_DELETE) {
+    if (is_dir || WantsFile(name)) Queue(ChangeKind::Remove, path, is_dir);
+  }
+}
+
+void LibraryWatcher::Queue(ChangeKind kind, const std::string &path, bool is_directory,
+                           const std::string &old_path) {
+  if (kind == ChangeKind::Overflow) {
+    pending_.push_back({kind, path, "", false});
+    return;
+  }
+
+  if (kind == ChangeKind::Rename) {
+    // A file created and renamed inside one window is simply an add.
+    auto created = pending_index_.find(old_path);
+    if (created != pending_index_.end()) {
+      Change &prior = pending_[created->second];
+      bool was_add = prior.kind == ChangeKind::Add;
+      prior.path.clear();
+      pending_index_.erase(created);
+      if (was_add) kind = ChangeKind::Add;
+    }
+  }
+
+  auto existing = pending_index_.find(path);
+  if (existing == pending_index_.end()) {
+    pending_index_[path] = pending_.size();
+    pending_.push_back({kind, path, old_path, is_directory});
+    return;
+  }
+
+  Change &prior = pending_[existing->second];
+  switch (kind) {
+    case ChangeKind::Change:
+      // add + change = add, rename + change = rename, remove + change = change
+      if (prior.kind == ChangeKind::Remove) prior.kind = ChangeKind::Change;
+      break;
+    case ChangeKind::Add:
+      if (prior.kind == ChangeKind::Remove) prior.kind = ChangeKind::Change;
+      break;
+    case ChangeKind::Remove:
+      if (prior.kind == ChangeKind::Add) {
+        // Created and deleted inside one window — nothing happened.
+        prior.path.clear();
+        pending_index_.erase(existing);
+      } else if (prior.kind == ChangeKind::Rename) {
+        // Renamed then deleted: the original path is what disappeared.
+        std::string original = prior.old_path;
+        prior.path.clear();
+        pending_index_.erase(existing);
+        Queue(ChangeKind::Remove, original, is_directory);
+        return;
+      } else {
+        prior.kind = ChangeKind::Remove;
+      }
+      break;
+    case ChangeKind::Rename:
+      prior.kind = ChangeKind::Rename;
+      prior.old_path = old_path;
+      break;
+    case ChangeKind::Overflow:
+      break;
+  }
+  prior.is_directory = is_directory;
+}
+
+void LibraryWatcher::Flush() {
+  // A MOVED_FROM without a matching MOVED_TO left the watched tree.
+  for (auto &entry : pending_moves_) {
+    const PendingMove &move = entry.second;
+    if (move.is_directory) {
+      ForgetWatchTree(move.path, true);
+      Queue(ChangeKind::Remove, move.path, true);
+    } else if (WantsFile(move.path)) {
+      Queue(ChangeKind::Remove, move.path, false);
+    }
+  }
+  pending_moves_.clear();
+
+  auto *changes = new std::vector<Change>();
+  changes->reserve(pending_.size());
+  for (auto &change : pending_) {
+    if (change.kind == ChangeKind::Overflow || !change.path.empty()) {
+      changes->push_back(std::move(change));
+    }
+  }
+  pending_.clear();
+  pending_index_.clear();
+
+  if (changes->empty() || tsfn_.NonBlockingCall(changes, DeliverChanges) != napi_ok) {
+    delete changes;
+  }
+}
+
+#endif // __linux__
@@ -0,0 +1,93 @@
+#ifndef LIBRARY_WATCHER_H
+#define LIBRARY_WATCHER_H
+
+#include <napi.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Recursive ROM directory watcher (inotify, Linux only).
+//
+// Watches every directory below the configured roots, pairs rename halves by
+// cookie, and coalesces bursts of events (a copy produces CREATE + many
+// MODIFY + CLOSE_WRITE) into one change per path. Changes are delivered to a
+// JS callback once the tree has been quiet for `coalesceMs`.
+//
+//   const watcher = new LibraryWatcher({ roots, extensions, coalesceMs }, onChanges);
+//   const { directories, errors } = watcher.start(); // snapshot of watched dirs
+//   watcher.close();
+//
+// On other platforms `start()` throws and callers fall back to fs.watch.
+class LibraryWatcher : public Napi::ObjectWrap<LibraryWatcher> {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+  LibraryWatcher(const Napi::CallbackInfo &info);
+  ~LibraryWatcher();
+
+  enum class ChangeKind { Add, Change, Remove, Rename, Overflow };
+
+  struct Change {
+    ChangeKind kind;
+    std::string path;
+    std::string old_path; // Rename only
+    bool is_directory = false;
+  };
+
+private:
+  Napi::Value Start(const Napi::CallbackInfo &info);
+  void Close(const Napi::CallbackInfo &info);
+  void Stop();
+
+#ifdef __linux__
+  struct DirSnapshot {
+    std::string path;
+    double mtime_ms;
+  };
+
+  struct PendingMove {
+    std::string path;
+    bool is_directory;
+  };
+
+  void AddWatchTree(const std::string &root, std::vector<DirSnapshot> *snapshot,
+                    std::vector<std::pair<std::string, std::string>> *errors);
+  void ForgetWatchTree(const std::string &prefix, bool remove_watches);
+  void RenameWatchTree(const std::string &old_prefix, const std::string &new_prefix);
+  void EventLoop();
+  void HandleEvent(uint32_t mask, int wd, uint32_t cookie, const char *name);
+  void Queue(ChangeKind kind, const std::string &path, bool is_directory,
+             const std::string &old_path = "");
+  void Flush();
+  bool WantsFile(const std::string &path) const;
+
+  int inotify_fd_ = -1;
+  int wake_fd_ = -1;
+
+  // Only touched by the event thread once Start() returns.
+  std::unordered_map<int, std::string> wd_paths_;
+  std::unordered_map<std::string, int> path_wds_;
+  std::unordered_map<uint32_t, PendingMove> pending_moves_;
+  std::vector<Change> pending_;
+  std::unordered_map<std::string, size_t> pending_index_;
+  std::chrono::steady_clock::time_point first_pending_;
+  std::chrono::steady_clock::time_point last_event_;
+#endif
+
+  std::vector<std::string> roots_;
+  std::unordered_set<std::string> extensions_;
+  int coalesce_ms_ = 250;
+
+  Napi::FunctionReference callback_;
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+  Napi::ThreadSafeFunction tsfn_;
+  bool has_tsfn_ = false;
+};
+
+#endif // LIBRARY_WATCHER_H
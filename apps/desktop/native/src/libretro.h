@@ -63,9 +63,13 @@ extern "C" {
 #define RETRO_ENVIRONMENT_SET_CORE_OPTIONS_UPDATE_DISPLAY_CALLBACK 69
 #define RETRO_ENVIRONMENT_SET_DISK_CONTROL_EXT_INTERFACE 64
 #define RETRO_ENVIRONMENT_SET_HW_RENDER 14
+#define RETRO_ENVIRONMENT_SET_AUDIO_CALLBACK 22
 /* SET_HW_SHARED_CONTEXT uses the experimental flag (0x10000) to avoid
    colliding with SET_SERIALIZATION_QUIRKS which is also 44. */
 #define RETRO_ENVIRONMENT_SET_HW_SHARED_CONTEXT (44 | 0x10000)
+/* Bit 0: render video, bit 1: produce audio. Lets cores skip work while the
+   frontend fast-runs without presenting anything. */
+#define RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE (47 | 0x10000)
 
 /* Special pointer value passed to video_refresh when the core rendered to
    the hardware framebuffer instead of a software buffer. */
@@ -142,6 +146,13 @@ struct retro_hw_render_callback {
 #define RETRO_DEVICE_ID_ANALOG_X         0
 #define RETRO_DEVICE_ID_ANALOG_Y         1
 
+/* Pointer (touch screen); X/Y span [-0x7fff, 0x7fff] across the frame */
+#define RETRO_DEVICE_ID_POINTER_X            0
+#define RETRO_DEVICE_ID_POINTER_Y            1
+#define RETRO_DEVICE_ID_POINTER_PRESSED      2
+#define RETRO_DEVICE_ID_POINTER_COUNT        3
+#define RETRO_DEVICE_ID_POINTER_IS_OFFSCREEN 15
+
 /* Memory regions */
 #define RETRO_MEMORY_SAVE_RAM 0
 #define RETRO_MEMORY_RTC      1
@@ -284,6 +295,17 @@ struct retro_core_options_v2_intl {
   struct retro_core_options_v2 *local;
 };
 
+/* Pull-mode audio: the frontend calls `callback` whenever it wants more
+   samples (written through the usual audio_sample(_batch) callbacks), and
+   `set_state` to tell the core whether audio output is running. */
+typedef void (RETRO_CALLCONV *retro_audio_callback_t)(void);
+typedef void (RETRO_CALLCONV *retro_audio_set_state_callback_t)(bool enabled);
+
+struct retro_audio_callback {
+  retro_audio_callback_t callback;
+  retro_audio_set_state_callback_t set_state;
+};
+
 struct retro_core_option_display {
   const char *key;
   bool visible;
@@ -323,6 +345,9 @@ struct retro_game_info_ext {
   const void *data;
   size_t size;
   bool file_in_archive;
+  /* True when `data` stays valid until retro_unload_game, so the core may
+     use it in place instead of copying it. */
+  bool persistent_data;
 };
 
 #ifdef __cplusplus
@@ -2,8 +2,24 @@
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
-#include <fstream>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+// A JS number as a memory address: rejects negatives, fractions and values
+// past 2^53 before they can wrap around in a size_t.
+bool ToMemoryAddress(const Napi::Value &value, size_t *out) {
+  if (!value.IsNumber()) return false;
+  double d = value.As<Napi::Number>().DoubleValue();
+  if (!(d >= 0) || d > 9007199254740991.0 || std::floor(d) != d) return false;
+  *out = static_cast<size_t>(d);
+  return true;
+}
+
+} // namespace
 
 // Singleton for static callbacks
 LibretroCore *LibretroCore::s_instance = nullptr;
@@ -100,6 +116,13 @@ void LibretroCore::HWRenderState::CreateFBO(
   pbo_first_frame = true;
 }
 
+size_t LibretroCore::HWRenderState::AllocatedBytes() const {
+  if (!fbo) return 0;
+  size_t pixels = static_cast<size_t>(fb_width) * fb_height;
+  size_t per_pixel = 4 + (depth_stencil_rbo ? 4 : 0) + 2 * 4; // color, depth, 2 PBOs
+  return pixels * per_pixel;
+}
+
 void LibretroCore::HWRenderState::DestroyFBO() {
   if (fbo) {
     glDeleteFramebuffers(1, &fbo);
@@ -150,9 +173,12 @@ Napi::Object LibretroCore::Init(Napi::Env env, Napi::Object exports) {
     InstanceMethod("isLoaded", &LibretroCore::IsLoaded),
     InstanceMethod("setSystemDirectory", &LibretroCore::SetSystemDirectory),
     InstanceMethod("setSaveDirectory", &LibretroCore::SetSaveDirectory),
+    InstanceMethod("setContentSnapshotDirectory", &LibretroCore::SetContentSnapshotDirectory),
     InstanceMethod("getMemoryData", &LibretroCore::GetMemoryData),
     InstanceMethod("getMemorySize", &LibretroCore::GetMemorySize),
     InstanceMethod("setMemoryData", &LibretroCore::SetMemoryData),
+    InstanceMethod("peekMemory", &LibretroCore::PeekMemory),
+    InstanceMethod("pokeMemory", &LibretroCore::PokeMemory),
     InstanceMethod("getLogMessages", &LibretroCore::GetLogMessages),
     InstanceMethod("getCoreOptions", &LibretroCore::GetCoreOptions),
     InstanceMethod("setCoreOption", &LibretroCore::SetCoreOption),
@@ -165,6 +191,21 @@ Napi::Object LibretroCore::Init(Napi::Env env, Napi::Object exports) {
     InstanceMethod("getDiscLabel", &LibretroCore::GetDiscLabel),
     InstanceMethod("replaceDiscImage", &LibretroCore::ReplaceDiscImage),
     InstanceMethod("addDiscImage", &LibretroCore::AddDiscImage),
+    InstanceMethod("runUntil", &LibretroCore::RunUntil),
+    InstanceMethod("startWatchdog", &LibretroCore::StartWatchdog),
+    InstanceMethod("stopWatchdog", &LibretroCore::StopWatchdog),
+    InstanceMethod("takeStallReports", &LibretroCore::TakeStallReports),
+    InstanceMethod("getMemoryStats", &LibretroCore::GetMemoryStats),
+    InstanceMethod("getInputStats", &LibretroCore::GetInputStats),
+    InstanceMethod("trackCoreHeap", &LibretroCore::TrackCoreHeap),
+    InstanceMethod("hasAudioCallback", &LibretroCore::HasAudioCallback),
+    InstanceMethod("pullAudio", &LibretroCore::PullAudio),
+    InstanceMethod("setAudioState", &LibretroCore::SetAudioState),
+    InstanceMethod("setScreenLayout", &LibretroCore::SetScreenLayout),
+    InstanceMethod("setPointerState", &LibretroCore::SetPointerState),
+    InstanceMethod("setPerfHud", &LibretroCore::SetPerfHud),
+    InstanceMethod("setPerfHudInputs", &LibretroCore::SetPerfHudInputs),
+    InstanceMethod("drawPerfHud", &LibretroCore::DrawPerfHud),
   });
 
   Napi::FunctionReference *constructor = new Napi::FunctionReference();
@@ -181,6 +222,7 @@ LibretroCore::LibretroCore(const Napi::CallbackInfo &info)
 }
 
 LibretroCore::~LibretroCore() {
+  watchdog_.reset();
   CloseCore();
   if (s_instance == this) {
     s_instance = nullptr;
@@ -265,29 +307,28 @@ Napi::Value LibretroCore::LoadGame(const Napi::CallbackInfo &info) {
   struct retro_game_info gameinfo = {};
   gameinfo.path = romPath.c_str();
 
-  // Always load ROM into memory — some cores report need_fullpath but
+  // Always provide the ROM data — some cores report need_fullpath but
   // still benefit from having data available, and it ensures the core
-  // can access the ROM even if it can't open the path itself.
-  std::vector<uint8_t> rom_data;
+  // can access the ROM even if it can't open the path itself. The data is
+  // shared through content_cache, so concurrent instances of the same ROM
+  // (even in other processes) cost one copy.
   {
-    std::ifstream file(romPath, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
-      Napi::Error::New(env, "Failed to open ROM: " + romPath).ThrowAsJavaScriptException();
+    std::string error;
+    content_ = content_cache::Acquire(romPath, &error);
+    if (!content_) {
+      Napi::Error::New(env, error).ThrowAsJavaScriptException();
       return Napi::Boolean::New(env, false);
     }
+    memory_.Set(memory_stats::kRom, content_->size());
 
-    size_t size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    rom_data.resize(size);
-    file.read(reinterpret_cast<char *>(rom_data.data()), size);
-
-    gameinfo.data = rom_data.data();
-    gameinfo.size = size;
+    gameinfo.data = content_->data();
+    gameinfo.size = content_->size();
   }
 
   // Prepare extended game info for GET_GAME_INFO_EXT
   {
-    std::string fullPath = romPath;
+    game_path_ = romPath;
+    const std::string &fullPath = game_path_;
     // Extract directory
     size_t lastSlash = fullPath.rfind('/');
     if (lastSlash == std::string::npos) lastSlash = fullPath.rfind('\\');
@@ -306,7 +347,7 @@ Napi::Value LibretroCore::LoadGame(const Napi::CallbackInfo &info) {
     }
 
     game_info_ext_ = {};
-    game_info_ext_.full_path = romPath.c_str();
+    game_info_ext_.full_path = game_path_.c_str();
     game_info_ext_.archive_path = nullptr;
     game_info_ext_.archive_file = nullptr;
     game_info_ext_.dir = game_dir_.c_str();
@@ -316,9 +357,18 @@ Napi::Value LibretroCore::LoadGame(const Napi::CallbackInfo &info) {
     game_info_ext_.data = gameinfo.data;
     game_info_ext_.size = gameinfo.size;
     game_info_ext_.file_in_archive = false;
+    game_info_ext_.persistent_data = true;
   }
 
-  if (!fn_load_game_(&gameinfo)) {
+  bool loaded;
+  {
+    stall_watchdog::ScopedSpan span(watchdog_.get(), "retro_load_game");
+    loaded = fn_load_game_(&gameinfo);
+  }
+  AccountCaches();
+  if (!loaded) {
+    content_.reset();
+    memory_.Set(memory_stats::kRom, 0);
     Napi::Error::New(env, "Core rejected the game").ThrowAsJavaScriptException();
     return Napi::Boolean::New(env, false);
   }
@@ -348,6 +398,7 @@ Napi::Value LibretroCore::LoadGame(const Napi::CallbackInfo &info) {
 
     if (w != hw_render_.fb_width || h != hw_render_.fb_height) {
       hw_render_.ResizeFBO(w, h);
+      AccountHWRender();
     }
 
     if (hw_render_.hw_render_cb.context_reset) {
@@ -360,10 +411,13 @@ Napi::Value LibretroCore::LoadGame(const Napi::CallbackInfo &info) {
 }
 
 void LibretroCore::UnloadGame(const Napi::CallbackInfo &info) {
+  SetAudioCallbackState(false);
   if (game_loaded_ && fn_unload_game_) {
     fn_unload_game_();
     game_loaded_ = false;
   }
+  content_.reset();
+  memory_.Set(memory_stats::kRom, 0);
 }
 
 void LibretroCore::Run(const Napi::CallbackInfo &info) {
@@ -376,7 +430,30 @@ void LibretroCore::Run(const Napi::CallbackInfo &info) {
   }
 #endif
 
+  if (hud_enabled_) {
+    hud_.RecordFrame(std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now().time_since_epoch())
+                         .count());
+  }
+  RunCoreFrame();
+}
+
+void LibretroCore::RunCoreFrame() {
+  uint64_t heap_before = 0;
+  bool measure = track_core_heap_ && memory_stats::HeapInUse(&heap_before);
+
+  input_folded_ = false;
+  if (watchdog_) watchdog_->BeginFrame();
   fn_run_();
+  if (watchdog_) watchdog_->EndFrame();
+
+  uint64_t heap_after = 0;
+  if (measure && memory_stats::HeapInUse(&heap_after)) {
+    // Includes our own per-frame allocations (video resize, log strings),
+    // which the ledger reports separately.
+    core_heap_growth_ += static_cast<int64_t>(heap_after) - static_cast<int64_t>(heap_before);
+    core_heap_frames_++;
+  }
 }
 
 void LibretroCore::Reset(const Napi::CallbackInfo &info) {
@@ -467,6 +544,8 @@ Napi::Value LibretroCore::GetVideoFrame(const Napi::CallbackInfo &info) {
   Napi::Object frame = Napi::Object::New(env);
   frame.Set("width", Napi::Number::New(env, video_width_));
   frame.Set("height", Napi::Number::New(env, video_height_));
+  // The HUD changes every frame, so don't let static screens be throttled.
+  frame.Set("staticFrames", Napi::Number::New(env, hud_enabled_ ? 0 : static_frames_));
 
   // Copy video buffer to a new ArrayBuffer for JS
   Napi::ArrayBuffer ab = Napi::ArrayBuffer::New(env, video_buffer_.size());
@@ -515,9 +594,8 @@ void LibretroCore::SetInputState(const Napi::CallbackInfo &info) {
   unsigned id = info[1].As<Napi::Number>().Uint32Value();
   int16_t value = static_cast<int16_t>(info[2].As<Napi::Number>().Int32Value());
 
-  if (port < 2 && id < 16) {
-    std::lock_guard<std::mutex> lock(input_mutex_);
-    input_state_[port][id] = value;
+  if (port < input_queue::kPorts && id < input_queue::kButtons) {
+    input_.PushButton(port, id, value);
   }
 }
 
@@ -534,9 +612,9 @@ void LibretroCore::SetInputAnalog(const Napi::CallbackInfo &info) {
   unsigned id = info[2].As<Napi::Number>().Uint32Value();     // 0=X, 1=Y
   int16_t value = static_cast<int16_t>(info[3].As<Napi::Number>().Int32Value());
 
-  if (port < 2 && index < 3 && id < 2) {
-    std::lock_guard<std::mutex> lock(input_mutex_);
-    analog_state_[port][index][id] = value;
+  if (port < input_queue::kPorts && index < input_queue::kAnalogIndices &&
+      id < input_queue::kAnalogAxes) {
+    input_.PushAnalog(port, index, id, value);
   }
 }
 
@@ -576,14 +654,23 @@ Napi::Value LibretroCore::SerializeState(const Napi::CallbackInfo &info) {
   if (size == 0) return env.Null();
 
   std::vector<uint8_t> buf(size);
-  bool ok = fn_serialize_(buf.data(), size);
+  memory_.Set(memory_stats::kState, size);
+  bool ok;
+  {
+    stall_watchdog::ScopedSpan span(watchdog_.get(), "retro_serialize");
+    ok = fn_serialize_(buf.data(), size);
+  }
 
   if (!ok) {
+    memory_.Set(memory_stats::kState, 0);
     return env.Null();
   }
 
+  // Briefly both the staging buffer and the copy handed to JS are live.
+  memory_.Set(memory_stats::kState, size * 2);
   Napi::ArrayBuffer ab = Napi::ArrayBuffer::New(env, size);
   memcpy(ab.Data(), buf.data(), size);
+  memory_.Set(memory_stats::kState, 0);
   return Napi::Uint8Array::New(env, size, ab, 0);
 }
 
@@ -606,7 +693,11 @@ Napi::Value LibretroCore::UnserializeState(const Napi::CallbackInfo &info) {
 #endif
 
   Napi::Uint8Array arr = info[0].As<Napi::Uint8Array>();
-  bool ok = fn_unserialize_(arr.Data(), arr.ByteLength());
+  bool ok;
+  {
+    stall_watchdog::ScopedSpan span(watchdog_.get(), "retro_unserialize");
+    ok = fn_unserialize_(arr.Data(), arr.ByteLength());
+  }
 
   if (ok && hw_render_.active) {
 #ifdef __APPLE__
@@ -628,6 +719,7 @@ Napi::Value LibretroCore::UnserializeState(const Napi::CallbackInfo &info) {
 }
 
 void LibretroCore::Destroy(const Napi::CallbackInfo &info) {
+  watchdog_.reset();
   CloseCore();
 }
 
@@ -653,6 +745,13 @@ void LibretroCore::SetSaveDirectory(const Napi::CallbackInfo &info) {
   }
 }
 
+// Where loadGame keeps the read-only snapshots it maps (see content_cache.h).
+void LibretroCore::SetContentSnapshotDirectory(const Napi::CallbackInfo &info) {
+  if (info.Length() >= 1 && info[0].IsString()) {
+    content_cache::SetSnapshotDirectory(info[0].As<Napi::String>().Utf8Value());
+  }
+}
+
 Napi::Value LibretroCore::GetMemoryData(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
@@ -721,6 +820,57 @@ void LibretroCore::SetMemoryData(const Napi::CallbackInfo &info) {
   memcpy(dest, arr.Data(), copySize);
 }
 
+// Scalar access for frame scripts: peekMemory(memType, address, size) reads
+// a 1-4 byte little-endian value, pokeMemory(..., value) writes one. Avoids
+// copying the whole region per access the way getMemoryData does.
+Napi::Value LibretroCore::PeekMemory(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!game_loaded_ || info.Length() < 3) {
+    return env.Null();
+  }
+
+  RunCondition cond;
+  cond.mem_type = info[0].As<Napi::Number>().Uint32Value();
+  cond.size = info[2].As<Napi::Number>().Uint32Value();
+  if (!ToMemoryAddress(info[1], &cond.address) || cond.size < 1 || cond.size > 4) {
+    return env.Null();
+  }
+
+  uint32_t value = 0;
+  if (!ReadRunMemory(cond, &value)) {
+    return env.Null();
+  }
+  return Napi::Number::New(env, value);
+}
+
+Napi::Value LibretroCore::PokeMemory(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!game_loaded_ || !fn_get_memory_data_ || !fn_get_memory_size_ || info.Length() < 4) {
+    return Napi::Boolean::New(env, false);
+  }
+
+  unsigned memType = info[0].As<Napi::Number>().Uint32Value();
+  size_t address = 0;
+  if (!ToMemoryAddress(info[1], &address)) {
+    return Napi::Boolean::New(env, false);
+  }
+  unsigned size = info[2].As<Napi::Number>().Uint32Value();
+  uint32_t value = info[3].As<Napi::Number>().Uint32Value();
+
+  uint8_t *data = static_cast<uint8_t *>(fn_get_memory_data_(memType));
+  size_t region = fn_get_memory_size_(memType);
+  if (!data || size < 1 || size > 4 || address >= region || size > region - address) {
+    return Napi::Boolean::New(env, false);
+  }
+
+  for (unsigned i = 0; i < size; i++) {
+    data[address + i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+  return Napi::Boolean::New(env, true);
+}
+
 Napi::Value LibretroCore::GetCoreOptions(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
   Napi::Object result = Napi::Object::New(env);
@@ -792,6 +942,7 @@ Napi::Value LibretroCore::SwapDisc(const Napi::CallbackInfo &info) {
     return Napi::Boolean::New(env, false);
   }
 
+  stall_watchdog::ScopedSpan span(s_instance->watchdog_.get(), "disc_swap");
   if (s_instance->has_disc_control_ext_) {
     auto &cb = s_instance->disc_control_ext_cb_;
     if (cb.set_eject_state) cb.set_eject_state(true);
@@ -924,6 +1075,437 @@ Napi::Value LibretroCore::AddDiscImage(const Napi::CallbackInfo &info) {
   return Napi::Number::New(env, static_cast<int32_t>(newIndex));
 }
 
+// ---------------------------------------------------------------------------
+// Headless fast-run
+// ---------------------------------------------------------------------------
+
+bool LibretroCore::ReadRunMemory(const RunCondition &cond, uint32_t *out) {
+  if (!fn_get_memory_data_ || !fn_get_memory_size_) return false;
+  const uint8_t *data = static_cast<const uint8_t *>(fn_get_memory_data_(cond.mem_type));
+  size_t size = fn_get_memory_size_(cond.mem_type);
+  if (!data || cond.address >= size || cond.size > size - cond.address) return false;
+
+  uint32_t value = 0;
+  for (unsigned i = 0; i < cond.size; i++) {
+    value |= static_cast<uint32_t>(data[cond.address + i]) << (8 * i);
+  }
+  *out = value & cond.mask;
+  return true;
+}
+
+// FNV-1a over the converted RGBA frame plus its dimensions, so the same
+// picture at a different resolution hashes differently.
+uint64_t LibretroCore::HashVideoFrame() {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  auto mix = [&hash](uint8_t byte) {
+    hash ^= byte;
+    hash *= 0x100000001b3ULL;
+  };
+  for (int i = 0; i < 4; i++) mix(static_cast<uint8_t>(video_width_ >> (8 * i)));
+  for (int i = 0; i < 4; i++) mix(static_cast<uint8_t>(video_height_ >> (8 * i)));
+  for (uint8_t byte : video_buffer_) mix(byte);
+  return hash;
+}
+
+// Compares the core's source pixels with the previous frame's. Hashing a
+// word at a time is cheap next to the RGBA conversion that follows, and
+// avoids keeping a copy of the last frame.
+void LibretroCore::TrackStaticFrame(const uint8_t *src, size_t row_bytes, unsigned height,
+                                    size_t pitch) {
+  uint64_t hash = 0xcbf29ce484222325ULL ^ height;
+  for (unsigned y = 0; y < height; y++) {
+    const uint8_t *row = src + y * pitch;
+    size_t x = 0;
+    for (; x + 8 <= row_bytes; x += 8) {
+      uint64_t word;
+      memcpy(&word, row + x, 8);
+      hash = (hash ^ word) * 0x100000001b3ULL;
+      hash ^= hash >> 29;
+    }
+    for (; x < row_bytes; x++) {
+      hash = (hash ^ row[x]) * 0x100000001b3ULL;
+    }
+  }
+  if (hash == last_source_hash_ && row_bytes == last_source_row_bytes_) {
+    static_frames_++;
+  } else {
+    static_frames_ = 0;
+    last_source_hash_ = hash;
+    last_source_row_bytes_ = row_bytes;
+  }
+}
+
+// The published frame changed without the source changing (new layout, HUD
+// toggled): start counting again so the change isn't held back as static.
+void LibretroCore::ResetStaticFrames() {
+  static_frames_ = 0;
+  last_source_hash_ = 0;
+  last_source_row_bytes_ = 0;
+}
+
+bool LibretroCore::RunConditionMet(const RunCondition &cond, bool new_frame) {
+  switch (cond.type) {
+    case RunCondition::MEMORY: {
+      uint32_t v;
+      if (!ReadRunMemory(cond, &v)) return false;
+      switch (cond.op) {
+        case RunCondition::EQ: return v == cond.value;
+        case RunCondition::NE:
+        case RunCondition::CHANGED: return v != cond.value;
+        case RunCondition::LT: return v < cond.value;
+        case RunCondition::LE: return v <= cond.value;
+        case RunCondition::GT: return v > cond.value;
+        case RunCondition::GE: return v >= cond.value;
+      }
+      return false;
+    }
+
+    case RunCondition::FRAME_HASH:
+      return new_frame && !video_buffer_.empty() && HashVideoFrame() == cond.hash;
+
+    case RunCondition::NON_BLANK_FRAME: {
+      if (!new_frame || video_buffer_.size() < 4) return false;
+      // Any pixel differing from the first one means something was drawn.
+      const uint32_t *px = reinterpret_cast<const uint32_t *>(video_buffer_.data());
+      size_t count = video_buffer_.size() / 4;
+      for (size_t i = 1; i < count; i++) {
+        if (px[i] != px[0]) return true;
+      }
+      return false;
+    }
+
+    case RunCondition::INPUT_POLL:
+      return input_polled_;
+  }
+  return false;
+}
+
+Napi::Value LibretroCore::RunUntil(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!game_loaded_ || !fn_run_) {
+    Napi::Error::New(env, "No game loaded").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (conditions: array, maxFrames: number)")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  static const std::unordered_map<std::string, RunCondition::Op> kOps = {
+    {"eq", RunCondition::EQ}, {"ne", RunCondition::NE}, {"lt", RunCondition::LT},
+    {"le", RunCondition::LE}, {"gt", RunCondition::GT}, {"ge", RunCondition::GE},
+    {"changed", RunCondition::CHANGED},
+  };
+
+  Napi::Array list = info[0].As<Napi::Array>();
+  std::vector<RunCondition> conditions;
+  bool needs_video = false;
+  for (uint32_t i = 0; i < list.Length(); i++) {
+    Napi::Value v = list.Get(i);
+    if (!v.IsObject() || !v.As<Napi::Object>().Get("type").IsString()) {
+      Napi::TypeError::New(env, "Each condition needs a type").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    Napi::Object o = v.As<Napi::Object>();
+    std::string type = o.Get("type").As<Napi::String>().Utf8Value();
+    RunCondition cond;
+
+    if (type == "memory") {
+      cond.type = RunCondition::MEMORY;
+      if (!o.Get("address").IsNumber()) {
+        Napi::TypeError::New(env, "memory condition needs an address").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      if (!ToMemoryAddress(o.Get("address"), &cond.address)) {
+        Napi::RangeError::New(env, "Address must be a non-negative integer")
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      if (o.Get("memType").IsNumber()) cond.mem_type = o.Get("memType").As<Napi::Number>().Uint32Value();
+      if (o.Get("size").IsNumber()) cond.size = o.Get("size").As<Napi::Number>().Uint32Value();
+      if (o.Get("mask").IsNumber()) cond.mask = o.Get("mask").As<Napi::Number>().Uint32Value();
+      if (o.Get("value").IsNumber()) cond.value = o.Get("value").As<Napi::Number>().Uint32Value();
+      if (o.Get("op").IsString()) {
+        auto op = kOps.find(o.Get("op").As<Napi::String>().Utf8Value());
+        if (op == kOps.end()) {
+          Napi::TypeError::New(env, "Unknown memory comparison").ThrowAsJavaScriptException();
+          return env.Undefined();
+        }
+        cond.op = op->second;
+      }
+      if (cond.size != 1 && cond.size != 2 && cond.size != 4) {
+        Napi::RangeError::New(env, "size must be 1, 2 or 4").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      uint32_t baseline;
+      if (!ReadRunMemory(cond, &baseline)) {
+        Napi::RangeError::New(env, "Address is outside the core's memory region")
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      if (cond.op == RunCondition::CHANGED) cond.value = baseline;
+    } else if (type == "frameHash") {
+      cond.type = RunCondition::FRAME_HASH;
+      if (!o.Get("hash").IsString()) {
+        Napi::TypeError::New(env, "frameHash condition needs a hash").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      cond.hash = std::strtoull(o.Get("hash").As<Napi::String>().Utf8Value().c_str(), nullptr, 16);
+      needs_video = true;
+    } else if (type == "nonBlankFrame") {
+      cond.type = RunCondition::NON_BLANK_FRAME;
+      needs_video = true;
+    } else if (type == "inputPoll") {
+      cond.type = RunCondition::INPUT_POLL;
+    } else {
+      Napi::TypeError::New(env, "Unknown condition type: " + type).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    conditions.push_back(cond);
+  }
+
+  int64_t max_frames = info[1].As<Napi::Number>().Int64Value();
+
+#ifdef __APPLE__
+  if (hw_render_.active && hw_render_.cgl_context) {
+    CGLSetCurrentContext(hw_render_.cgl_context);
+  }
+#endif
+
+  headless_run_ = true;
+  headless_video_ = needs_video;
+  auto start = std::chrono::steady_clock::now();
+  int64_t frames = 0;
+  int matched = -1;
+  bool produced_video = false;
+
+  while (frames < max_frames && matched < 0) {
+    input_polled_ = false;
+    {
+      std::lock_guard<std::mutex> lock(video_mutex_);
+      video_frame_ready_ = false;
+    }
+    RunCoreFrame();
+    frames++;
+
+    bool new_frame;
+    {
+      std::lock_guard<std::mutex> lock(video_mutex_);
+      new_frame = video_frame_ready_;
+      produced_video |= new_frame;
+      for (size_t i = 0; i < conditions.size(); i++) {
+        if (RunConditionMet(conditions[i], new_frame)) {
+          matched = static_cast<int>(i);
+          break;
+        }
+      }
+    }
+  }
+
+  double elapsed_ms = std::chrono::duration<double, std::milli>(
+    std::chrono::steady_clock::now() - start).count();
+  headless_run_ = false;
+  headless_video_ = false;
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("frames", Napi::Number::New(env, static_cast<double>(frames)));
+  result.Set("elapsedMs", Napi::Number::New(env, elapsed_ms));
+  result.Set("matched", Napi::Number::New(env, matched));
+  if (produced_video) {
+    std::lock_guard<std::mutex> lock(video_mutex_);
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(HashVideoFrame()));
+    result.Set("frameHash", Napi::String::New(env, hex));
+  }
+  return result;
+}
+
+// ---------------------------------------------------------------------------
+// Stall watchdog
+// ---------------------------------------------------------------------------
+
+void LibretroCore::StartWatchdog(const Napi::CallbackInfo &info) {
+  uint32_t threshold_ms = 250;
+  if (info.Length() >= 1 && info[0].IsNumber()) {
+    threshold_ms = info[0].As<Napi::Number>().Uint32Value();
+  }
+  // Must run on the emulation thread: that is the thread whose stack the
+  // watchdog captures.
+  watchdog_.reset();
+  watchdog_ = std::make_unique<stall_watchdog::Watchdog>(threshold_ms);
+}
+
+void LibretroCore::StopWatchdog(const Napi::CallbackInfo &info) {
+  watchdog_.reset();
+}
+
+Napi::Value LibretroCore::TakeStallReports(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  std::vector<stall_watchdog::Report> reports;
+  if (watchdog_) reports = watchdog_->TakeReports();
+
+  Napi::Array result = Napi::Array::New(env, reports.size());
+  for (size_t i = 0; i < reports.size(); i++) {
+    const auto &r = reports[i];
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("frame", Napi::Number::New(env, static_cast<double>(r.frame)));
+    obj.Set("stalledMs", Napi::Number::New(env, r.stalled_ms));
+    obj.Set("frameMs", Napi::Number::New(env, r.frame_ms));
+
+    Napi::Array stack = Napi::Array::New(env, r.stack.size());
+    for (size_t j = 0; j < r.stack.size(); j++) {
+      stack.Set(static_cast<uint32_t>(j), Napi::String::New(env, r.stack[j]));
+    }
+    obj.Set("stack", stack);
+
+    Napi::Array spans = Napi::Array::New(env, r.spans.size());
+    for (size_t j = 0; j < r.spans.size(); j++) {
+      const auto &span = r.spans[j];
+      Napi::Object s = Napi::Object::New(env);
+      s.Set("name", Napi::String::New(env, span.name));
+      s.Set("startMs", Napi::Number::New(env, span.start_ns / 1e6));
+      s.Set("durationMs", span.open ? env.Null()
+                                    : Napi::Number::New(env, (span.end_ns - span.start_ns) / 1e6));
+      spans.Set(static_cast<uint32_t>(j), s);
+    }
+    obj.Set("spans", spans);
+
+    Napi::Object io = Napi::Object::New(env);
+    io.Set("readBytes", Napi::Number::New(env, static_cast<double>(r.io.read_bytes)));
+    io.Set("writeBytes", Napi::Number::New(env, static_cast<double>(r.io.write_bytes)));
+    io.Set("majorFaults", Napi::Number::New(env, static_cast<double>(r.io.major_faults)));
+    io.Set("voluntarySwitches", Napi::Number::New(env, static_cast<double>(r.io.voluntary_switches)));
+    io.Set("involuntarySwitches",
+           Napi::Number::New(env, static_cast<double>(r.io.involuntary_switches)));
+    obj.Set("io", io);
+
+    result.Set(static_cast<uint32_t>(i), obj);
+  }
+  return result;
+}
+
+// ---------------------------------------------------------------------------
+// Memory accounting
+// ---------------------------------------------------------------------------
+
+void LibretroCore::AccountHWRender() {
+#ifdef __APPLE__
+  memory_.Set(memory_stats::kHwRender, hw_render_.AllocatedBytes());
+#endif
+}
+
+void LibretroCore::AccountCaches() {
+  size_t bytes = game_dir_.capacity() + game_name_.capacity() + game_ext_.capacity();
+  for (const auto &pair : core_options_) {
+    bytes += sizeof(pair) + pair.first.capacity() + pair.second.capacity();
+  }
+  for (const auto &path : disc_paths_) {
+    bytes += sizeof(path) + path.capacity();
+  }
+  memory_.Set(memory_stats::kCaches, bytes);
+}
+
+void LibretroCore::TrackCoreHeap(const Napi::CallbackInfo &info) {
+  track_core_heap_ = info.Length() >= 1 && info[0].ToBoolean().Value();
+  core_heap_growth_ = 0;
+  core_heap_frames_ = 0;
+}
+
+Napi::Value LibretroCore::GetMemoryStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  // Fixed-size or cheap-to-walk subsystems are refreshed on query; buffers
+  // that grow mid-frame are updated where they are allocated.
+  memory_.Set(memory_stats::kAudio, sizeof(audio_ring_));
+  AccountHWRender();
+  AccountCaches();
+
+  Napi::Object subsystems = Napi::Object::New(env);
+  double total = 0;
+  double total_high = 0;
+  for (int i = 0; i < memory_stats::kSubsystemCount; i++) {
+    auto subsystem = static_cast<memory_stats::Subsystem>(i);
+    double bytes = static_cast<double>(memory_.Current(subsystem));
+    double high = static_cast<double>(memory_.HighWater(subsystem));
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("bytes", Napi::Number::New(env, bytes));
+    entry.Set("highWater", Napi::Number::New(env, high));
+    subsystems.Set(memory_stats::SubsystemName(subsystem), entry);
+    total += bytes;
+    total_high += high; // subsystems peak at different times: an upper bound
+  }
+
+  memory_stats::ProcessMemory process = memory_stats::SampleProcess();
+  Napi::Object proc = Napi::Object::New(env);
+  proc.Set("rssBytes", Napi::Number::New(env, static_cast<double>(process.rss_bytes)));
+  proc.Set("peakRssBytes", Napi::Number::New(env, static_cast<double>(process.peak_rss_bytes)));
+  proc.Set("pssBytes", process.pss_bytes ? Napi::Number::New(env, static_cast<double>(process.pss_bytes))
+                                         : env.Null());
+
+  Napi::Object heap = Napi::Object::New(env);
+  heap.Set("supported", Napi::Boolean::New(env, memory_stats::HeapInUseSupported()));
+  heap.Set("tracking", Napi::Boolean::New(env, track_core_heap_));
+  heap.Set("netGrowthBytes", Napi::Number::New(env, static_cast<double>(core_heap_growth_)));
+  heap.Set("framesSampled", Napi::Number::New(env, static_cast<double>(core_heap_frames_)));
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("subsystems", subsystems);
+  result.Set("totalBytes", Napi::Number::New(env, total));
+  result.Set("totalHighWater", Napi::Number::New(env, total_high));
+  result.Set("process", proc);
+  result.Set("coreHeap", heap);
+
+  content_cache::Stats cache = content_cache::GetStats();
+  Napi::Object content = Napi::Object::New(env);
+  content.Set("entries", Napi::Number::New(env, static_cast<double>(cache.entries)));
+  content.Set("bytes", Napi::Number::New(env, static_cast<double>(cache.bytes)));
+  content.Set("hits", Napi::Number::New(env, static_cast<double>(cache.hits)));
+  content.Set("misses", Napi::Number::New(env, static_cast<double>(cache.misses)));
+  result.Set("contentCache", content);
+  return result;
+}
+
+Napi::Value LibretroCore::GetInputStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  input_queue::Stats stats = input_.TakeStats();
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("events", Napi::Number::New(env, static_cast<double>(stats.events)));
+  result.Set("overflows", Napi::Number::New(env, static_cast<double>(stats.overflows)));
+  result.Set("maxLatencyMs", Napi::Number::New(env, stats.max_latency_us / 1000.0));
+  return result;
+}
+
+Napi::Value LibretroCore::HasAudioCallback(const Napi::CallbackInfo &info) {
+  return Napi::Boolean::New(info.Env(), audio_callback_.callback != nullptr);
+}
+
+// Ask a pull-mode core for more audio. Returns the Int16 samples it wrote,
+// which the next getAudioBuffer() hands out.
+Napi::Value LibretroCore::PullAudio(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (!game_loaded_ || !audio_callback_.callback || !audio_callback_enabled_) {
+    return Napi::Number::New(env, 0);
+  }
+  size_t before = audio_write_pos_;
+  audio_callback_.callback();
+  return Napi::Number::New(env, static_cast<double>(audio_write_pos_ - before));
+}
+
+void LibretroCore::SetAudioState(const Napi::CallbackInfo &info) {
+  if (info.Length() < 1 || !info[0].IsBoolean()) return;
+  SetAudioCallbackState(info[0].As<Napi::Boolean>().Value());
+}
+
+void LibretroCore::SetAudioCallbackState(bool enabled) {
+  if (enabled == audio_callback_enabled_) return;
+  audio_callback_enabled_ = enabled;
+  if (audio_callback_.set_state) {
+    audio_callback_.set_state(enabled);
+  }
+}
+
 // ---------------------------------------------------------------------------
 // Disc control static callbacks (called by the core into our frontend)
 // ---------------------------------------------------------------------------
@@ -972,10 +1554,15 @@ bool RETRO_CALLCONV LibretroCore::DiskAddImageIndex() {
 // ---------------------------------------------------------------------------
 
 void LibretroCore::CloseCore() {
+  SetAudioCallbackState(false);
+  audio_callback_ = {};
+
   if (game_loaded_ && fn_unload_game_) {
     fn_unload_game_();
     game_loaded_ = false;
   }
+  content_.reset();
+  memory_.Set(memory_stats::kRom, 0);
 
 #ifdef __APPLE__
   // Tear down HW render resources after the core has unloaded the game
@@ -1234,12 +1821,30 @@ bool LibretroCore::EnvironmentCallback(unsigned cmd, void *data) {
     case RETRO_ENVIRONMENT_SET_CONTENT_INFO_OVERRIDE:
       return true;
 
-    case RETRO_ENVIRONMENT_GET_GAME_INFO_EXT:
-      return false;
+    case RETRO_ENVIRONMENT_GET_GAME_INFO_EXT: {
+      // One entry per content file; only valid once loadGame has set it up.
+      if (!data || !self->content_) return false;
+      *static_cast<const retro_game_info_ext **>(data) = &self->game_info_ext_;
+      return true;
+    }
 
     case RETRO_ENVIRONMENT_GET_INPUT_BITMASKS:
       return true;
 
+    case RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE: {
+      if (data) {
+        int *flags = static_cast<int *>(data);
+        *flags = self->headless_run_ ? (self->headless_video_ ? 1 : 0) : 3;
+      }
+      return true;
+    }
+
+    case RETRO_ENVIRONMENT_SET_AUDIO_CALLBACK: {
+      if (!data) return false;
+      self->audio_callback_ = *static_cast<const retro_audio_callback *>(data);
+      return true;
+    }
+
     case RETRO_ENVIRONMENT_SET_INPUT_DESCRIPTORS:
     case RETRO_ENVIRONMENT_SET_CONTROLLER_INFO:
     case RETRO_ENVIRONMENT_SET_SUBSYSTEM_INFO:
@@ -1318,6 +1923,7 @@ bool LibretroCore::EnvironmentCallback(unsigned cmd, void *data) {
       if (w == 0) w = 640;
       if (h == 0) h = 528;
       self->hw_render_.CreateFBO(w, h, cb->depth, cb->stencil);
+      self->AccountHWRender();
 
       // Fill in the function pointers the core will call back into
       cb->get_current_framebuffer = GetCurrentFramebuffer;
@@ -1346,85 +1952,264 @@ bool LibretroCore::EnvironmentCallback(unsigned cmd, void *data) {
   }
 }
 
+namespace {
+
+// Copy one screen's source rect into its place in the RGBA frame, sampling
+// nearest-neighbour when the layout scales it. `store` converts a pixel.
+template <typename Pixel, typename Store>
+void ConvertScreen(const screen_layout::Placement &screen, const uint8_t *src, size_t pitch,
+                   uint8_t *dst, unsigned dst_width, Store store) {
+  const screen_layout::Rect &from = screen.src;
+  const screen_layout::Rect &to = screen.dst;
+  bool scaled = from.width != to.width || from.height != to.height;
+  for (unsigned y = 0; y < to.height; y++) {
+    unsigned sy = from.y + (scaled ? y * from.height / to.height : y);
+    const Pixel *row = reinterpret_cast<const Pixel *>(src + sy * pitch) + from.x;
+    uint8_t *out = dst + (static_cast<size_t>(to.y + y) * dst_width + to.x) * 4;
+    if (scaled) {
+      for (unsigned x = 0; x < to.width; x++, out += 4) store(row[x * from.width / to.width], out);
+    } else {
+      for (unsigned x = 0; x < to.width; x++, out += 4) store(row[x], out);
+    }
+  }
+}
+
+} // namespace
+
+// Called with video_mutex_ held.
+void LibretroCore::ConvertFrame(const uint8_t *src, unsigned width, unsigned height,
+                                size_t pitch) {
+  if (layout_dirty_ || layout_plan_.src_width != width || layout_plan_.src_height != height ||
+      video_buffer_.size() != static_cast<size_t>(layout_plan_.width) * layout_plan_.height * 4) {
+    layout_plan_ = screen_layout::Compute(layout_config_, width, height, MaxFramePixels());
+    layout_dirty_ = false;
+    ResetStaticFrames();
+    // Gaps are never written by the screens, so clear them to opaque black
+    // once per plan rather than every frame.
+    video_buffer_.assign(static_cast<size_t>(layout_plan_.width) * layout_plan_.height * 4, 0);
+    for (size_t i = 3; i < video_buffer_.size(); i += 4) video_buffer_[i] = 0xFF;
+    memory_.Set(memory_stats::kVideo, video_buffer_.capacity());
+    video_width_ = layout_plan_.width;
+    video_height_ = layout_plan_.height;
+  }
+
+  uint8_t *dst = video_buffer_.data();
+  for (unsigned i = 0; i < layout_plan_.count; i++) {
+    const screen_layout::Placement &screen = layout_plan_.screens[i];
+    switch (pixel_format_) {
+      case RETRO_PIXEL_FORMAT_XRGB8888:
+        ConvertScreen<uint32_t>(screen, src, pitch, dst, video_width_, [](uint32_t px, uint8_t *out) {
+          out[0] = (px >> 16) & 0xFF; // R
+          out[1] = (px >> 8)  & 0xFF; // G
+          out[2] =  px        & 0xFF; // B
+          out[3] = 0xFF;              // A
+        });
+        break;
+
+      case RETRO_PIXEL_FORMAT_RGB565:
+        ConvertScreen<uint16_t>(screen, src, pitch, dst, video_width_, [](uint16_t px, uint8_t *out) {
+          out[0] = ((px >> 11) & 0x1F) * 255 / 31; // R
+          out[1] = ((px >> 5)  & 0x3F) * 255 / 63; // G
+          out[2] = ( px        & 0x1F) * 255 / 31; // B
+          out[3] = 0xFF;                            // A
+        });
+        break;
+
+      case RETRO_PIXEL_FORMAT_0RGB1555:
+      default:
+        ConvertScreen<uint16_t>(screen, src, pitch, dst, video_width_, [](uint16_t px, uint8_t *out) {
+          out[0] = ((px >> 10) & 0x1F) * 255 / 31; // R
+          out[1] = ((px >> 5)  & 0x1F) * 255 / 31; // G
+          out[2] = ( px        & 0x1F) * 255 / 31; // B
+          out[3] = 0xFF;                            // A
+        });
+        break;
+    }
+  }
+}
+
+// Largest frame, in pixels, the worker's shared video slots can hold; the
+// client sizes them from the same geometry (computeVideoBufferSize).
+uint64_t LibretroCore::MaxFramePixels() const {
+  const retro_game_geometry &geometry = av_info_.geometry;
+  uint64_t width = geometry.max_width ? geometry.max_width : std::max(geometry.base_width, 1024u);
+  uint64_t height =
+      geometry.max_height ? geometry.max_height : std::max(geometry.base_height, 1024u);
+  return width * height;
+}
+
+Napi::Value LibretroCore::SetScreenLayout(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsObject()) {
+    Napi::TypeError::New(env, "Expected ({ mode, gap?, primary?, scale? })")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Object options = info[0].As<Napi::Object>();
+  screen_layout::Config config;
+  std::string mode = options.Get("mode").IsString()
+                         ? options.Get("mode").As<Napi::String>().Utf8Value()
+                         : "none";
+  if (!screen_layout::ParseMode(mode.c_str(), &config.mode)) {
+    Napi::TypeError::New(env, "Unknown screen layout: " + mode).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  if (options.Get("gap").IsNumber()) {
+    config.gap = options.Get("gap").As<Napi::Number>().Uint32Value();
+  }
+  if (options.Get("primary").IsNumber()) {
+    config.primary = options.Get("primary").As<Napi::Number>().Uint32Value() ? 1 : 0;
+  }
+  if (options.Get("scale").IsNumber()) {
+    config.scale = options.Get("scale").As<Napi::Number>().Uint32Value();
+  }
+
+  // Applied by the next converted frame. The returned size lets the
+  // renderer fix its aspect ratio before that frame arrives.
+  std::lock_guard<std::mutex> lock(video_mutex_);
+  layout_config_ = config;
+  layout_dirty_ = true;
+  ResetStaticFrames();
+  unsigned src_width = layout_plan_.src_width ? layout_plan_.src_width
+                                              : av_info_.geometry.base_width;
+  unsigned src_height = layout_plan_.src_height ? layout_plan_.src_height
+                                                : av_info_.geometry.base_height;
+  screen_layout::Plan plan = screen_layout::Compute(config, src_width, src_height,
+                                                    MaxFramePixels());
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("width", Napi::Number::New(env, plan.width));
+  result.Set("height", Napi::Number::New(env, plan.height));
+  return result;
+}
+
+void LibretroCore::SetPointerState(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 3) {
+    Napi::TypeError::New(env, "Expected (x, y, pressed)").ThrowAsJavaScriptException();
+    return;
+  }
+
+  // x/y are normalized over the displayed frame; map them back through the
+  // layout to the pixel the core drew there.
+  double x = info[0].As<Napi::Number>().DoubleValue();
+  double y = info[1].As<Napi::Number>().DoubleValue();
+  bool pressed = info[2].ToBoolean().Value();
+
+  unsigned src_x = 0;
+  unsigned src_y = 0;
+  bool onscreen;
+  unsigned src_width;
+  unsigned src_height;
+  {
+    std::lock_guard<std::mutex> lock(video_mutex_);
+    onscreen = screen_layout::Unmap(layout_plan_, x, y, &src_x, &src_y);
+    src_width = layout_plan_.src_width;
+    src_height = layout_plan_.src_height;
+  }
+
+  if (onscreen) {
+    auto to_core = [](unsigned v, unsigned size) {
+      return static_cast<int16_t>(((v + 0.5) / size * 2 - 1) * 0x7fff);
+    };
+    pointer_x_ = to_core(src_x, src_width);
+    pointer_y_ = to_core(src_y, src_height);
+  }
+  pointer_offscreen_ = !onscreen;
+  pointer_pressed_ = pressed && onscreen;
+}
+
+void LibretroCore::SetPerfHud(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::TypeError::New(env, "Expected (enabled)").ThrowAsJavaScriptException();
+    return;
+  }
+
+  bool enabled = info[0].ToBoolean().Value();
+  if (enabled == hud_enabled_) return;
+  if (enabled) hud_.Reset();
+  hud_enabled_ = enabled;
+  std::lock_guard<std::mutex> lock(video_mutex_);
+  ResetStaticFrames();
+}
+
+void LibretroCore::SetPerfHudInputs(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2) {
+    Napi::TypeError::New(env, "Expected (audioFillMs, droppedFrames)")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  hud_.SetInputs(info[0].As<Napi::Number>().DoubleValue(),
+                 info[1].As<Napi::Number>().Uint32Value());
+}
+
+// drawPerfHud(pixels, width, height): blend the HUD into an RGBA frame the
+// caller is about to publish. A no-op while the HUD is off.
+void LibretroCore::DrawPerfHud(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 3 || !info[0].IsTypedArray()) {
+    Napi::TypeError::New(env, "Expected (pixels, width, height)").ThrowAsJavaScriptException();
+    return;
+  }
+  if (!hud_enabled_) return;
+
+  Napi::Uint8Array pixels = info[0].As<Napi::Uint8Array>();
+  unsigned width = info[1].As<Napi::Number>().Uint32Value();
+  unsigned height = info[2].As<Napi::Number>().Uint32Value();
+  if (pixels.ByteLength() < static_cast<size_t>(width) * height * 4) {
+    Napi::RangeError::New(env, "Pixel buffer is smaller than the frame")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  hud_.Draw(pixels.Data(), width, height, av_info_.timing.fps);
+}
+
 void LibretroCore::VideoRefreshCallback(const void *data, unsigned width, unsigned height, size_t pitch) {
   LibretroCore *self = s_instance;
   if (!self) return;
+  if (self->headless_run_ && !self->headless_video_) return;
 
   // NULL data means frame dupe — keep the previous frame buffer as-is
   if (!data) {
     std::lock_guard<std::mutex> lock(self->video_mutex_);
+    self->static_frames_++;
     self->video_frame_ready_ = true;
     return;
   }
 
   // HW render path: core rendered to our FBO, read back via PBO
   if (data == RETRO_HW_FRAME_BUFFER_VALID && self->hw_render_.active) {
+    self->static_frames_ = 0; // not worth reading back to compare
+    stall_watchdog::ScopedSpan span(self->watchdog_.get(), "hw_readback");
     self->ReadbackHWFrame(width, height);
     return;
   }
 
-  // SW render path: convert to RGBA8888 regardless of source format
-  size_t out_size = width * height * 4;
+  // SW render path: convert to RGBA8888 regardless of source format,
+  // composing the screen layout in the same pass
+  stall_watchdog::ScopedSpan span(self->watchdog_.get(), "video_convert");
 
   std::lock_guard<std::mutex> lock(self->video_mutex_);
-  self->video_buffer_.resize(out_size);
-  self->video_width_ = width;
-  self->video_height_ = height;
-
-  uint8_t *dst = self->video_buffer_.data();
-  const uint8_t *src = static_cast<const uint8_t *>(data);
-
-  switch (self->pixel_format_) {
-    case RETRO_PIXEL_FORMAT_XRGB8888: {
-      for (unsigned y = 0; y < height; y++) {
-        const uint32_t *row = reinterpret_cast<const uint32_t *>(src + y * pitch);
-        for (unsigned x = 0; x < width; x++) {
-          uint32_t px = row[x];
-          *dst++ = (px >> 16) & 0xFF; // R
-          *dst++ = (px >> 8)  & 0xFF; // G
-          *dst++ =  px        & 0xFF; // B
-          *dst++ = 0xFF;              // A
-        }
-      }
-      break;
-    }
-
-    case RETRO_PIXEL_FORMAT_RGB565: {
-      for (unsigned y = 0; y < height; y++) {
-        const uint16_t *row = reinterpret_cast<const uint16_t *>(src + y * pitch);
-        for (unsigned x = 0; x < width; x++) {
-          uint16_t px = row[x];
-          *dst++ = ((px >> 11) & 0x1F) * 255 / 31; // R
-          *dst++ = ((px >> 5)  & 0x3F) * 255 / 63; // G
-          *dst++ = ( px        & 0x1F) * 255 / 31; // B
-          *dst++ = 0xFF;                            // A
-        }
-      }
-      break;
-    }
-
-    case RETRO_PIXEL_FORMAT_0RGB1555:
-    default: {
-      for (unsigned y = 0; y < height; y++) {
-        const uint16_t *row = reinterpret_cast<const uint16_t *>(src + y * pitch);
-        for (unsigned x = 0; x < width; x++) {
-          uint16_t px = row[x];
-          *dst++ = ((px >> 10) & 0x1F) * 255 / 31; // R
-          *dst++ = ((px >> 5)  & 0x1F) * 255 / 31; // G
-          *dst++ = ( px        & 0x1F) * 255 / 31; // B
-          *dst++ = 0xFF;                            // A
-        }
-      }
-      break;
-    }
-  }
+  size_t bytes_per_pixel = self->pixel_format_ == RETRO_PIXEL_FORMAT_XRGB8888 ? 4 : 2;
+  self->TrackStaticFrame(static_cast<const uint8_t *>(data), width * bytes_per_pixel, height,
+                         pitch);
+  self->ConvertFrame(static_cast<const uint8_t *>(data), width, height, pitch);
 
   self->video_frame_ready_ = true;
 }
 
 void LibretroCore::AudioSampleCallback(int16_t left, int16_t right) {
   LibretroCore *self = s_instance;
-  if (!self) return;
+  if (!self || self->headless_run_) return;
 
   // Drop oldest stereo pair if full
   if (self->audio_write_pos_ - self->audio_read_pos_ + 2 > AUDIO_RING_CAPACITY) {
@@ -1439,6 +2224,7 @@ void LibretroCore::AudioSampleCallback(int16_t left, int16_t right) {
 size_t LibretroCore::AudioSampleBatchCallback(const int16_t *data, size_t frames) {
   LibretroCore *self = s_instance;
   if (!self || !data) return 0;
+  if (self->headless_run_) return frames;
 
   size_t incoming = frames * 2; // stereo Int16 samples
   size_t available = self->audio_write_pos_ - self->audio_read_pos_;
@@ -1473,38 +2259,52 @@ size_t LibretroCore::AudioSampleBatchCallback(const int16_t *data, size_t frames
 }
 
 void LibretroCore::InputPollCallback() {
-  // Nothing to do — input is set directly via setInputState
+  LibretroCore *self = s_instance;
+  if (!self) return;
+  // Recorded for runUntil's inputPoll condition.
+  self->input_polled_ = true;
+  self->input_.Poll();
+  self->input_folded_ = true;
 }
 
 int16_t LibretroCore::InputStateCallback(unsigned port, unsigned device, unsigned index, unsigned id) {
   LibretroCore *self = s_instance;
-  if (!self || port >= 2) return 0;
+  if (!self || port >= input_queue::kPorts) return 0;
 
-  std::lock_guard<std::mutex> lock(self->input_mutex_);
+  if (!self->input_folded_) {
+    self->input_.Poll();
+    self->input_folded_ = true;
+  }
 
   switch (device) {
     case RETRO_DEVICE_JOYPAD:
       if (id == RETRO_DEVICE_ID_JOYPAD_MASK) {
         // Bitmask query: return all 16 buttons packed into a single int16
-        int16_t mask = 0;
-        for (unsigned i = 0; i < 16; i++) {
-          if (self->input_state_[port][i]) {
-            mask |= (1 << i);
-          }
-        }
-        return mask;
+        return self->input_.ButtonMask(port);
       }
-      if (id < 16) {
-        return self->input_state_[port][id];
+      if (id < input_queue::kButtons) {
+        return self->input_.Button(port, id);
       }
       return 0;
 
     case RETRO_DEVICE_ANALOG:
-      if (index < 3 && id < 2) {
-        return self->analog_state_[port][index][id];
+      if (index < input_queue::kAnalogIndices && id < input_queue::kAnalogAxes) {
+        return self->input_.Analog(port, index, id);
       }
       return 0;
 
+    case RETRO_DEVICE_POINTER:
+      // Single touch, shared by every port.
+      if (index != 0) return 0;
+      switch (id) {
+        case RETRO_DEVICE_ID_POINTER_X: return self->pointer_x_;
+        case RETRO_DEVICE_ID_POINTER_Y: return self->pointer_y_;
+        case RETRO_DEVICE_ID_POINTER_PRESSED: return self->pointer_pressed_ ? 1 : 0;
+        case RETRO_DEVICE_ID_POINTER_COUNT: return self->pointer_pressed_ ? 1 : 0;
+        case RETRO_DEVICE_ID_POINTER_IS_OFFSCREEN: return self->pointer_offscreen_ ? 1 : 0;
+        default: return 0;
+      }
+
     default:
       return 0;
   }
@@ -1521,6 +2321,8 @@ void LibretroCore::LogCallback(enum retro_log_level level, const char *fmt, ...)
     std::lock_guard<std::mutex> lock(s_instance->log_mutex_);
     if (s_instance->log_buffer_.size() < MAX_LOG_ENTRIES) {
       s_instance->log_buffer_.push_back({static_cast<int>(level), std::string(buf)});
+      s_instance->log_bytes_ += sizeof(LogEntry) + s_instance->log_buffer_.back().message.capacity();
+      s_instance->memory_.Set(memory_stats::kLog, s_instance->log_bytes_);
     }
   }
 }
@@ -1532,6 +2334,8 @@ Napi::Value LibretroCore::GetLogMessages(const Napi::CallbackInfo &info) {
   {
     std::lock_guard<std::mutex> lock(log_mutex_);
     entries.swap(log_buffer_);
+    log_bytes_ = 0;
+    memory_.Set(memory_stats::kLog, 0);
   }
 
   Napi::Array result = Napi::Array::New(env, entries.size());
@@ -1579,6 +2383,7 @@ void LibretroCore::ReadbackHWFrame(unsigned width, unsigned height) {
   // Resize FBO + PBOs if resolution changed
   if (width != hw.fb_width || height != hw.fb_height) {
     hw.ResizeFBO(width, height);
+    AccountHWRender();
   }
 
   glBindFramebuffer(GL_READ_FRAMEBUFFER, hw.fbo);
@@ -1595,6 +2400,8 @@ void LibretroCore::ReadbackHWFrame(unsigned width, unsigned height) {
   // Step 1: Read back the PREVIOUS frame's PBO (async transfer completed)
   if (!hw.pbo_first_frame) {
     glBindBuffer(GL_PIXEL_PACK_BUFFER, hw.pbo[hw.pbo_read_idx]);
+    // Mapping blocks until the transfer lands; the HUD counts slow ones.
+    auto map_start = std::chrono::steady_clock::now();
     void *mapped = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
 
     // Only copy to video_buffer_ if we're not skipping this frame.
@@ -1602,8 +2409,13 @@ void LibretroCore::ReadbackHWFrame(unsigned width, unsigned height) {
     if (mapped && !skip) {
       std::lock_guard<std::mutex> lock(video_mutex_);
       video_buffer_.resize(frame_bytes);
+      memory_.Set(memory_stats::kVideo, video_buffer_.capacity());
       video_width_ = width;
       video_height_ = height;
+      // HW frames aren't composed: an identity plan keeps pointer mapping
+      // right, and the next SW frame rebuilds its layout.
+      layout_plan_ = screen_layout::Compute(screen_layout::Config(), width, height, 0);
+      layout_dirty_ = true;
 
       if (hw.hw_render_cb.bottom_left_origin) {
         const uint8_t *src = static_cast<const uint8_t *>(mapped);
@@ -1624,6 +2436,11 @@ void LibretroCore::ReadbackHWFrame(unsigned width, unsigned height) {
     if (mapped) {
       glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
     }
+    if (hud_enabled_) {
+      hud_.RecordReadback(std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::steady_clock::now() - map_start)
+                              .count());
+    }
   }
 
   // Step 2: Kick off async readback of CURRENT frame into write PBO
@@ -6,6 +6,7 @@
 #include <vector>
 #include <mutex>
 #include <atomic>
+#include <memory>
 #include <unordered_map>
 
 #ifdef __APPLE__
@@ -21,7 +22,13 @@
 #include <dlfcn.h>
 #endif
 
+#include "content_cache.h"
+#include "input_queue.h"
 #include "libretro.h"
+#include "memory_stats.h"
+#include "perf_hud.h"
+#include "screen_layout.h"
+#include "stall_watchdog.h"
 
 class LibretroCore : public Napi::ObjectWrap<LibretroCore> {
 public:
@@ -50,9 +57,12 @@ private:
   Napi::Value IsLoaded(const Napi::CallbackInfo &info);
   void SetSystemDirectory(const Napi::CallbackInfo &info);
   void SetSaveDirectory(const Napi::CallbackInfo &info);
+  void SetContentSnapshotDirectory(const Napi::CallbackInfo &info);
   Napi::Value GetMemoryData(const Napi::CallbackInfo &info);
   Napi::Value GetMemorySize(const Napi::CallbackInfo &info);
   void SetMemoryData(const Napi::CallbackInfo &info);
+  Napi::Value PeekMemory(const Napi::CallbackInfo &info);
+  Napi::Value PokeMemory(const Napi::CallbackInfo &info);
   Napi::Value GetLogMessages(const Napi::CallbackInfo &info);
   Napi::Value GetCoreOptions(const Napi::CallbackInfo &info);
   Napi::Value SetCoreOption(const Napi::CallbackInfo &info);
@@ -65,11 +75,45 @@ private:
   Napi::Value GetDiscLabel(const Napi::CallbackInfo &info);
   Napi::Value ReplaceDiscImage(const Napi::CallbackInfo &info);
   Napi::Value AddDiscImage(const Napi::CallbackInfo &info);
+  Napi::Value RunUntil(const Napi::CallbackInfo &info);
+  void StartWatchdog(const Napi::CallbackInfo &info);
+  void StopWatchdog(const Napi::CallbackInfo &info);
+  Napi::Value TakeStallReports(const Napi::CallbackInfo &info);
+  Napi::Value GetMemoryStats(const Napi::CallbackInfo &info);
+  void TrackCoreHeap(const Napi::CallbackInfo &info);
+  Napi::Value GetInputStats(const Napi::CallbackInfo &info);
+  Napi::Value HasAudioCallback(const Napi::CallbackInfo &info);
+  Napi::Value PullAudio(const Napi::CallbackInfo &info);
+  void SetAudioState(const Napi::CallbackInfo &info);
+  Napi::Value SetScreenLayout(const Napi::CallbackInfo &info);
+  void SetPointerState(const Napi::CallbackInfo &info);
+  void SetPerfHud(const Napi::CallbackInfo &info);
+  void SetPerfHudInputs(const Napi::CallbackInfo &info);
+  void DrawPerfHud(const Napi::CallbackInfo &info);
+
+  // A stop condition for RunUntil, checked after every frame.
+  struct RunCondition {
+    enum Type { MEMORY, FRAME_HASH, NON_BLANK_FRAME, INPUT_POLL } type = MEMORY;
+    enum Op { EQ, NE, LT, LE, GT, GE, CHANGED } op = EQ;
+    unsigned mem_type = 2; // RETRO_MEMORY_SYSTEM_RAM
+    size_t address = 0;
+    unsigned size = 1;     // bytes, little-endian
+    uint32_t mask = 0xFFFFFFFF;
+    uint32_t value = 0;    // compare value, or the baseline for CHANGED
+    uint64_t hash = 0;
+  };
 
   // Internal
+  bool ReadRunMemory(const RunCondition &cond, uint32_t *out);
+  bool RunConditionMet(const RunCondition &cond, bool new_frame);
+  uint64_t HashVideoFrame();
+  void TrackStaticFrame(const uint8_t *src, size_t row_bytes, unsigned height, size_t pitch);
+  void ResetStaticFrames();
   void CloseCore();
   bool ResolveFunctions();
   void ReadbackHWFrame(unsigned width, unsigned height);
+  void ConvertFrame(const uint8_t *src, unsigned width, unsigned height, size_t pitch);
+  uint64_t MaxFramePixels() const;
 
   // Static disc control callbacks (called by the core into our frontend)
   static bool RETRO_CALLCONV DiskSetEjectState(bool ejected);
@@ -140,11 +184,33 @@ private:
   unsigned video_width_ = 0;
   unsigned video_height_ = 0;
 
+  // Screen layout composed by the SW conversion pass (guarded by
+  // video_mutex_). The plan is rebuilt on the next frame after the config
+  // or the source size changes; until then layout_plan_ describes the
+  // frame currently in video_buffer_.
+  screen_layout::Config layout_config_;
+  screen_layout::Plan layout_plan_;
+  bool layout_dirty_ = true;
+
   // After a state load, skip N frames from ReadbackHWFrame to avoid
   // delivering magenta frames while Dolphin rebuilds its texture cache.
   int hw_render_skip_frames_ = 0;
   bool video_frame_ready_ = false;
 
+  // Consecutive frames identical to the one before (dupes, or the same
+  // source pixels), reported by getVideoFrame so the worker can present
+  // static screens less often.
+  uint32_t static_frames_ = 0;
+  uint64_t last_source_hash_ = 0;
+  size_t last_source_row_bytes_ = 0;
+
+  // Set while RunUntil fast-runs. Audio is dropped and video is only
+  // converted when a frame condition needs it (GET_AUDIO_VIDEO_ENABLE tells
+  // the core the same). input_polled_ records input_poll calls per frame.
+  bool headless_run_ = false;
+  bool headless_video_ = false;
+  bool input_polled_ = false;
+
   // Audio ring buffer (single-threaded: callbacks and GetAudioBuffer run
   // sequentially on the same utility-process thread, so no mutex needed).
   // Power-of-2 capacity for efficient modular arithmetic.
@@ -154,14 +220,33 @@ private:
   size_t audio_write_pos_ = 0; // monotonic write counter
   size_t audio_read_pos_ = 0;  // monotonic read counter
 
-  // Input state (written by JS, read by callback)
-  std::mutex input_mutex_;
-  // Digital buttons: input_state_[port][id] = pressed (0 or 1)
-  int16_t input_state_[2][16] = {};
-  // Analog axes: analog_state_[port][index][axis] = value (-32768..32767)
-  // index: 0=left stick, 1=right stick, 2=analog buttons
-  // axis: 0=X, 1=Y
-  int16_t analog_state_[2][3][2] = {};
+  // Pull-mode audio (RETRO_ENVIRONMENT_SET_AUDIO_CALLBACK). The worker calls
+  // pullAudio() whenever the output ring runs low instead of taking audio
+  // only after retro_run; set_state tells the core when output is live.
+  // Invoked on the same thread as retro_run, so the ring stays unshared.
+  retro_audio_callback audio_callback_ = {};
+  bool audio_callback_enabled_ = false;
+  void SetAudioCallbackState(bool enabled);
+
+  // Input events (queued by setInputState/setInputAnalog, folded into
+  // per-poll state by input_poll). input_folded_ covers cores that read
+  // input without polling first: the first read of a frame folds instead.
+  input_queue::InputQueue input_;
+  bool input_folded_ = false;
+
+  // Touch input for RETRO_DEVICE_POINTER, already mapped back through the
+  // screen layout into the core's [-0x7fff, 0x7fff] frame coordinates.
+  std::atomic<int16_t> pointer_x_{0};
+  std::atomic<int16_t> pointer_y_{0};
+  std::atomic<bool> pointer_pressed_{false};
+  std::atomic<bool> pointer_offscreen_{true};
+
+  // Performance HUD, drawn by drawPerfHud into the frame copies the worker
+  // publishes or saves as screenshots, so neither the frame buffer (frame
+  // hashes, dupes) nor getVideoFrame's copy (thumbnails) contains it. Fed by
+  // Run, HW readback and setPerfHudInputs, all on the emulation thread.
+  perf_hud::Hud hud_;
+  bool hud_enabled_ = false;
 
   // Log message buffer (written by callback, read by JS)
   struct LogEntry {
@@ -172,6 +257,25 @@ private:
   std::mutex log_mutex_;
   std::vector<LogEntry> log_buffer_;
 
+  // Stall watchdog (null unless startWatchdog was called). Heartbeats wrap
+  // every retro_run; spans mark the other calls into the core.
+  std::unique_ptr<stall_watchdog::Watchdog> watchdog_;
+
+  // Per-subsystem accounting of the addon's own buffers (getMemoryStats).
+  // Core heap tracking diffs malloc's in-use bytes around every retro_run;
+  // it costs milliseconds per frame on glibc, so it is off unless
+  // trackCoreHeap(true) was called.
+  memory_stats::Ledger memory_;
+  size_t log_bytes_ = 0; // guarded by log_mutex_
+  bool track_core_heap_ = false;
+  int64_t core_heap_growth_ = 0;
+  int64_t core_heap_frames_ = 0;
+
+  // retro_run wrapped in the watchdog heartbeat and heap tracking.
+  void RunCoreFrame();
+  void AccountHWRender();
+  void AccountCaches();
+
   // Directories
   std::string system_directory_;
   std::string save_directory_;
@@ -179,8 +283,14 @@ private:
   // AV info cache
   struct retro_system_av_info av_info_ = {};
 
-  // Game info for GET_GAME_INFO_EXT during retro_load_game
+  // Loaded content, shared with any other instance of the same file (see
+  // content_cache.h). Held until unload, which lets GET_GAME_INFO_EXT
+  // promise cores persistent data they can use without copying.
+  std::shared_ptr<const content_cache::Content> content_;
+
+  // Game info for GET_GAME_INFO_EXT
   struct retro_game_info_ext game_info_ext_ = {};
+  std::string game_path_;
   std::string game_dir_;
   std::string game_name_;
   std::string game_ext_;
@@ -230,6 +340,7 @@ private:
     void CreateFBO(unsigned width, unsigned height, bool depth, bool stencil);
     void DestroyFBO();
     void ResizeFBO(unsigned width, unsigned height);
+    size_t AllocatedBytes() const; // FBO attachments + PBOs
 #endif
 
     struct retro_hw_render_callback hw_render_cb = {};
@@ -0,0 +1,117 @@
+#include "memory_stats.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+namespace memory_stats {
+
+const char *SubsystemName(Subsystem subsystem) {
+  switch (subsystem) {
+    case kVideo: return "video";
+    case kHwRender: return "hwRender";
+    case kAudio: return "audio";
+    case kRom: return "rom";
+    case kState: return "state";
+    case kLog: return "log";
+    case kCaches: return "caches";
+    default: return "unknown";
+  }
+}
+
+#if defined(__linux__)
+namespace {
+
+// Sum of "<key>: <n> kB" lines in a /proc file, in bytes.
+uint64_t ReadProcKb(const char *path, const char *key) {
+  FILE *f = fopen(path, "r");
+  if (!f) return 0;
+  size_t key_len = strlen(key);
+  char line[256];
+  uint64_t total = 0;
+  while (fgets(line, sizeof(line), f)) {
+    unsigned long long kb;
+    if (strncmp(line, key, key_len) == 0 && line[key_len] == ':' &&
+        sscanf(line + key_len + 1, "%llu", &kb) == 1) {
+      total += kb * 1024;
+    }
+  }
+  fclose(f);
+  return total;
+}
+
+} // namespace
+#endif
+
+ProcessMemory SampleProcess() {
+  ProcessMemory memory;
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    memory.rss_bytes = counters.WorkingSetSize;
+    memory.peak_rss_bytes = counters.PeakWorkingSetSize;
+  }
+#elif defined(__APPLE__)
+  mach_task_basic_info_data_t basic;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&basic),
+                &count) == KERN_SUCCESS) {
+    memory.rss_bytes = basic.resident_size;
+    memory.peak_rss_bytes = basic.resident_size_max;
+  }
+  task_vm_info_data_t vm;
+  count = TASK_VM_INFO_COUNT;
+  if (task_info(mach_task_self(), TASK_VM_INFO, reinterpret_cast<task_info_t>(&vm), &count) ==
+      KERN_SUCCESS) {
+    memory.pss_bytes = vm.phys_footprint;
+  }
+#else
+  memory.rss_bytes = ReadProcKb("/proc/self/status", "VmRSS");
+  memory.peak_rss_bytes = ReadProcKb("/proc/self/status", "VmHWM");
+  // smaps_rollup (Linux 4.14+) is one pre-summed record; fall back to
+  // summing smaps, which is much slower on large address spaces.
+  memory.pss_bytes = ReadProcKb("/proc/self/smaps_rollup", "Pss");
+  if (memory.pss_bytes == 0) memory.pss_bytes = ReadProcKb("/proc/self/smaps", "Pss");
+#endif
+  return memory;
+}
+
+#if defined(__APPLE__) || \
+    (defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)))
+#define HAVE_HEAP_IN_USE 1
+#endif
+
+bool HeapInUseSupported() {
+#ifdef HAVE_HEAP_IN_USE
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool HeapInUse(uint64_t *bytes) {
+#if defined(__APPLE__)
+  malloc_statistics_t stats;
+  malloc_zone_statistics(nullptr, &stats);
+  *bytes = stats.size_in_use;
+  return true;
+#elif defined(HAVE_HEAP_IN_USE)
+  struct mallinfo2 info = mallinfo2();
+  *bytes = info.uordblks + info.hblkhd; // arena chunks + mmap'd blocks
+  return true;
+#else
+  (void)bytes;
+  return false;
+#endif
+}
+
+} // namespace memory_stats
@@ -0,0 +1,72 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Memory accounting for the emulation worker (surfaced through
+// LibretroCore.getMemoryStats()).
+//
+// The addon's own buffers are tracked per subsystem in a Ledger with a
+// high-water mark, so transient peaks (a serialize buffer) are visible
+// after the fact. Process-wide numbers come from the OS; core heap growth
+// is the change in malloc's in-use bytes measured around retro_run, which
+// is opt-in because glibc's mallinfo2() walks every free list
+// (milliseconds on a fragmented heap).
+namespace memory_stats {
+
+enum Subsystem {
+  kVideo,    // converted RGBA frame buffer
+  kHwRender, // FBO attachments + readback PBOs
+  kAudio,    // sample ring
+  kRom,      // content while a game is loaded (shared, see content_cache.h)
+  kState,    // serialize buffers
+  kLog,      // buffered core log messages
+  kCaches,   // core options, disc paths, game info strings
+  kSubsystemCount,
+};
+
+const char *SubsystemName(Subsystem subsystem);
+
+// Lock-free: written from the emulation thread and libretro callbacks, read
+// by getMemoryStats().
+class Ledger {
+public:
+  void Set(Subsystem subsystem, size_t bytes) {
+    current_[subsystem].store(bytes, std::memory_order_relaxed);
+    size_t high = high_[subsystem].load(std::memory_order_relaxed);
+    while (bytes > high &&
+           !high_[subsystem].compare_exchange_weak(high, bytes, std::memory_order_relaxed)) {
+    }
+  }
+
+  size_t Current(Subsystem subsystem) const {
+    return current_[subsystem].load(std::memory_order_relaxed);
+  }
+  size_t HighWater(Subsystem subsystem) const {
+    return high_[subsystem].load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<size_t> current_[kSubsystemCount] = {};
+  std::atomic<size_t> high_[kSubsystemCount] = {};
+};
+
+// Fields the platform can't report are 0 (`pss_bytes` is Linux-only; on
+// macOS it carries the phys_footprint Activity Monitor shows instead).
+struct ProcessMemory {
+  uint64_t rss_bytes = 0;
+  uint64_t peak_rss_bytes = 0;
+  uint64_t pss_bytes = 0;
+};
+
+ProcessMemory SampleProcess();
+
+// Bytes currently allocated through malloc. False where unsupported.
+bool HeapInUse(uint64_t *bytes);
+bool HeapInUseSupported();
+
+} // namespace memory_stats
+
+#endif // MEMORY_STATS_H
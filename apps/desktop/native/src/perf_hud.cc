@@ -0,0 +1,191 @@
+#include "perf_hud.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace perf_hud {
+
+namespace {
+
+constexpr unsigned kGlyphWidth = 3;
+constexpr unsigned kGlyphHeight = 5;
+constexpr unsigned kAdvance = kGlyphWidth + 1;
+constexpr unsigned kLineHeight = kGlyphHeight + 2;
+constexpr unsigned kPad = 2;
+constexpr unsigned kLines = 5;
+constexpr unsigned kGraphHeight = 20;
+
+constexpr uint32_t kWhite = 0xFFFFFF;
+constexpr uint32_t kGreen = 0x4ADE80;
+constexpr uint32_t kYellow = 0xFACC15;
+constexpr uint32_t kRed = 0xF87171;
+constexpr uint32_t kGrey = 0x808080;
+
+// 3x5 glyphs, one row per 3 bits, top row in the high bits. Only what the
+// panel prints: digits, a few capitals, '.', '-' and space.
+uint16_t Glyph(char c) {
+  switch (c) {
+    case '0': case 'O': return 0b111'101'101'101'111;
+    case '1': return 0b010'110'010'010'111;
+    case '2': return 0b111'001'111'100'111;
+    case '3': return 0b111'001'111'001'111;
+    case '4': return 0b101'101'111'001'001;
+    case '5': case 'S': return 0b111'100'111'001'111;
+    case '6': return 0b111'100'111'101'111;
+    case '7': return 0b111'001'001'001'001;
+    case '8': return 0b111'101'111'101'111;
+    case '9': return 0b111'101'111'001'111;
+    case 'A': return 0b010'101'111'101'101;
+    case 'D': return 0b110'101'101'101'110;
+    case 'F': return 0b111'100'110'100'100;
+    case 'L': return 0b100'100'100'100'111;
+    case 'M': return 0b101'111'111'101'101;
+    case 'P': return 0b111'101'111'100'100;
+    case 'R': return 0b110'101'110'101'101;
+    case 'T': return 0b111'010'010'010'010;
+    case 'U': return 0b101'101'101'101'111;
+    case '.': return 0b000'000'000'000'010;
+    case '-': return 0b000'000'111'000'000;
+    default: return 0;
+  }
+}
+
+// An RGBA frame addressed in HUD units of `scale` x `scale` pixels,
+// clipped to the frame.
+struct Canvas {
+  uint8_t *rgba;
+  unsigned width;
+  unsigned height;
+  unsigned scale;
+
+  template <typename Op>
+  void ForEach(unsigned x, unsigned y, unsigned w, unsigned h, Op op) const {
+    unsigned x1 = std::min((x + w) * scale, width);
+    unsigned y1 = std::min((y + h) * scale, height);
+    for (unsigned py = y * scale; py < y1; py++) {
+      uint8_t *px = rgba + (static_cast<size_t>(py) * width + x * scale) * 4;
+      for (unsigned pxx = x * scale; pxx < x1; pxx++, px += 4) op(px);
+    }
+  }
+
+  void Fill(unsigned x, unsigned y, unsigned w, unsigned h, uint32_t rgb) const {
+    ForEach(x, y, w, h, [rgb](uint8_t *px) {
+      px[0] = (rgb >> 16) & 0xFF;
+      px[1] = (rgb >> 8) & 0xFF;
+      px[2] = rgb & 0xFF;
+      px[3] = 0xFF;
+    });
+  }
+
+  // Darken to a quarter so text stays legible over any frame.
+  void Shade(unsigned x, unsigned y, unsigned w, unsigned h) const {
+    ForEach(x, y, w, h, [](uint8_t *px) {
+      px[0] >>= 2;
+      px[1] >>= 2;
+      px[2] >>= 2;
+    });
+  }
+
+  void Text(unsigned x, unsigned y, const char *text, uint32_t rgb) const {
+    for (; *text; text++, x += kAdvance) {
+      uint16_t glyph = Glyph(*text);
+      for (unsigned row = 0; row < kGlyphHeight; row++) {
+        for (unsigned col = 0; col < kGlyphWidth; col++) {
+          unsigned bit = (kGlyphHeight - 1 - row) * kGlyphWidth + (kGlyphWidth - 1 - col);
+          if (glyph & (1u << bit)) Fill(x + col, y + row, 1, 1, rgb);
+        }
+      }
+    }
+  }
+};
+
+// Colour for a frame interval relative to the target period.
+uint32_t PacingColor(double ratio) {
+  if (ratio <= 1.25) return kGreen;
+  if (ratio <= 2) return kYellow;
+  return kRed;
+}
+
+} // namespace
+
+void Hud::RecordFrame(int64_t now_us) {
+  int64_t interval = now_us - last_frame_us_;
+  last_frame_us_ = now_us;
+  if (interval <= 0 || interval > kMaxIntervalUs) {
+    window_start_us_ = now_us;
+    window_frames_ = 0;
+    return;
+  }
+
+  intervals_ms_[next_interval_] = static_cast<float>(interval / 1000.0);
+  next_interval_ = (next_interval_ + 1) % kGraphFrames;
+  interval_count_ = std::min(interval_count_ + 1, kGraphFrames);
+
+  window_frames_++;
+  if (now_us - window_start_us_ >= kFpsWindowUs) {
+    fps_ = window_frames_ * 1e6 / static_cast<double>(now_us - window_start_us_);
+    window_start_us_ = now_us;
+    window_frames_ = 0;
+  }
+}
+
+void Hud::RecordReadback(int64_t duration_us) {
+  if (duration_us >= kReadbackStallUs) readback_stalls_++;
+}
+
+void Hud::SetInputs(double audio_fill_ms, uint32_t dropped_frames) {
+  audio_fill_ms_ = audio_fill_ms;
+  dropped_frames_ = dropped_frames;
+}
+
+void Hud::Reset() {
+  *this = Hud();
+}
+
+void Hud::Draw(uint8_t *rgba, unsigned width, unsigned height, double target_fps) const {
+  if (!rgba || width < 32 || height < 32) return;
+  Canvas canvas{rgba, width, height, width >= 512 && height >= 384 ? 2u : 1u};
+  double target_ms = 1000.0 / (target_fps > 0 ? target_fps : 60);
+
+  double mean_ms = 0;
+  for (unsigned i = 0; i < interval_count_; i++) mean_ms += intervals_ms_[i];
+  if (interval_count_) mean_ms /= interval_count_;
+
+  char lines[kLines][24];
+  snprintf(lines[0], sizeof(lines[0]), "%.1f FPS", fps_);
+  snprintf(lines[1], sizeof(lines[1]), "%.1f MS", mean_ms);
+  if (audio_fill_ms_ >= 0) {
+    snprintf(lines[2], sizeof(lines[2]), "AUD %.0f MS", audio_fill_ms_);
+  } else {
+    snprintf(lines[2], sizeof(lines[2]), "AUD --");
+  }
+  snprintf(lines[3], sizeof(lines[3]), "DROP %u", dropped_frames_);
+  snprintf(lines[4], sizeof(lines[4]), "STALL %u", readback_stalls_);
+  uint32_t colors[kLines] = {
+      fps_ > 0 ? PacingColor(target_fps / fps_) : kWhite,
+      interval_count_ ? PacingColor(mean_ms / target_ms) : kWhite,
+      kWhite,
+      dropped_frames_ ? kYellow : kWhite,
+      readback_stalls_ ? kYellow : kWhite,
+  };
+
+  unsigned graph_top = kPad + kLines * kLineHeight;
+  canvas.Shade(0, 0, kGraphFrames + kPad * 2, graph_top + kGraphHeight + kPad);
+  for (unsigned i = 0; i < kLines; i++) {
+    canvas.Text(kPad, kPad + i * kLineHeight, lines[i], colors[i]);
+  }
+
+  // Intervals oldest to newest, right-aligned; full height is twice the
+  // target period and the grey line marks the target.
+  unsigned graph_bottom = graph_top + kGraphHeight;
+  unsigned first = (next_interval_ + kGraphFrames - interval_count_) % kGraphFrames;
+  for (unsigned i = 0; i < interval_count_; i++) {
+    double ratio = intervals_ms_[(first + i) % kGraphFrames] / target_ms;
+    unsigned bar = std::clamp(static_cast<unsigned>(ratio / 2 * kGraphHeight), 1u, kGraphHeight);
+    canvas.Fill(kPad + kGraphFrames - interval_count_ + i, graph_bottom - bar, 1, bar,
+                PacingColor(ratio));
+  }
+  canvas.Fill(kPad, graph_bottom - kGraphHeight / 2 - 1, kGraphFrames, 1, kGrey);
+}
+
+} // namespace perf_hud
@@ -0,0 +1,55 @@
+#ifndef PERF_HUD_H
+#define PERF_HUD_H
+
+#include <cstdint>
+
+// Performance HUD drawn by the addon into the frames the worker publishes (no
+// N-API surface of its own; LibretroCore exposes setPerfHud,
+// setPerfHudInputs and drawPerfHud).
+//
+// Frame pacing is measured natively around retro_run and HW readback; the
+// worker pushes the two figures only it knows (audio ring fill and frames
+// the renderer never claimed) with a plain in-process call. Draw blends a
+// small panel - fps, frame interval, audio fill, drops, readback stalls and
+// an interval graph - into the top-left corner with a 3x5 bitmap font. It
+// goes into the copies that leave the worker (shared frame slot, IPC
+// fallback, screenshots), so the renderer shows it without IPC or draw
+// calls of its own, while the frame buffer (hashes, static-frame tracking)
+// and save state thumbnails stay clean.
+namespace perf_hud {
+
+class Hud {
+public:
+  // Once per retro_run; the interval since the previous call feeds the fps
+  // figure and the graph. Gaps over kMaxIntervalUs (pauses) are skipped.
+  void RecordFrame(int64_t now_us);
+  // Duration of a HW frame readback; slow ones count as stalls.
+  void RecordReadback(int64_t duration_us);
+  // Negative `audio_fill_ms` when nobody reports the ring fill.
+  void SetInputs(double audio_fill_ms, uint32_t dropped_frames);
+  void Reset();
+
+  // Blend the panel into an RGBA8888 frame. `target_fps` scales the graph.
+  void Draw(uint8_t *rgba, unsigned width, unsigned height, double target_fps) const;
+
+private:
+  static constexpr unsigned kGraphFrames = 64;
+  static constexpr int64_t kMaxIntervalUs = 250000;
+  static constexpr int64_t kFpsWindowUs = 500000;
+  static constexpr int64_t kReadbackStallUs = 4000;
+
+  float intervals_ms_[kGraphFrames] = {};
+  unsigned next_interval_ = 0;
+  unsigned interval_count_ = 0;
+  int64_t last_frame_us_ = 0;
+  int64_t window_start_us_ = 0;
+  unsigned window_frames_ = 0;
+  double fps_ = 0;
+  uint32_t readback_stalls_ = 0;
+  double audio_fill_ms_ = -1;
+  uint32_t dropped_frames_ = 0;
+};
+
+} // namespace perf_hud
+
+#endif // PERF_HUD_H
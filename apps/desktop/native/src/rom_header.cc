@@ -0,0 +1,297 @@
+#include "rom_header.h"
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace rom_header {
+
+namespace {
+
+// Nintendo logo prefixes used as cartridge signatures.
+const uint8_t kGbLogo[] = {0xCE, 0xED, 0x66, 0x66, 0xCC, 0x0D, 0x00, 0x0B};
+const uint8_t kGbaLogo[] = {0x24, 0xFF, 0xAE, 0x51, 0x69, 0x9A, 0xA2, 0x21};
+
+// Raw (2352-byte) CD sectors start with a 12-byte sync pattern.
+const uint8_t kCdSync[] = {0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                           0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00};
+
+constexpr size_t kRawSectorSize = 2352;
+constexpr size_t kIsoSectorSize = 2048;
+
+// Small RAII wrapper around stdio so sniffing works on every platform the
+// addon builds for (no pread on Windows).
+class File {
+public:
+  explicit File(const std::string &path) : fp_(std::fopen(path.c_str(), "rb")) {
+    if (fp_ && std::fseek(fp_, 0, SEEK_END) == 0) {
+      long end = std::ftell(fp_);
+      size_ = end > 0 ? static_cast<uint64_t>(end) : 0;
+    }
+  }
+  ~File() {
+    if (fp_) std::fclose(fp_);
+  }
+  File(const File &) = delete;
+  File &operator=(const File &) = delete;
+
+  bool ok() const { return fp_ != nullptr; }
+  uint64_t size() const { return size_; }
+
+  // Returns the number of bytes actually read (short at EOF).
+  size_t ReadAt(uint64_t offset, void *dst, size_t len) {
+    if (!fp_ || offset >= size_) return 0;
+    if (std::fseek(fp_, static_cast<long>(offset), SEEK_SET) != 0) return 0;
+    return std::fread(dst, 1, len, fp_);
+  }
+
+private:
+  FILE *fp_ = nullptr;
+  uint64_t size_ = 0;
+};
+
+bool Matches(const uint8_t *buf, size_t len, size_t offset, const void *sig, size_t sig_len) {
+  return offset + sig_len <= len && std::memcmp(buf + offset, sig, sig_len) == 0;
+}
+
+uint16_t ReadLE16(const uint8_t *p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+uint32_t ReadLE32(const uint8_t *p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+std::string Lowercase(std::string s) {
+  for (auto &c : s) {
+    if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+  }
+  return s;
+}
+
+std::string ExtensionOf(const std::string &path) {
+  size_t slash = path.find_last_of("/\\");
+  size_t dot = path.rfind('.');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return "";
+  return Lowercase(path.substr(dot));
+}
+
+std::string DirectoryOf(const std::string &path) {
+  size_t slash = path.find_last_of("/\\");
+  return slash == std::string::npos ? "." : path.substr(0, slash);
+}
+
+std::string Trim(const std::string &s) {
+  size_t start = s.find_first_not_of(" \t\r\n");
+  if (start == std::string::npos) return "";
+  size_t end = s.find_last_not_of(" \t\r\n");
+  return s.substr(start, end - start + 1);
+}
+
+// CD images: Saturn/Sega CD IDs live in sector 0, PlayStation/PSP identify
+// themselves in the ISO9660 primary volume descriptor (sector 16).
+std::string SniffDisc(File &file) {
+  uint8_t sector[kRawSectorSize] = {};
+  size_t n = file.ReadAt(0, sector, sizeof(sector));
+  if (n < 64) return "";
+
+  bool raw = Matches(sector, n, 0, kCdSync, sizeof(kCdSync));
+  size_t sector_size = raw ? kRawSectorSize : kIsoSectorSize;
+  // Mode 2 sectors carry an 8-byte subheader after the 16-byte header.
+  size_t data_offset = raw ? (sector[15] == 2 ? 24 : 16) : 0;
+
+  if (Matches(sector, n, data_offset, "SEGA SEGASATURN ", 16)) return "saturn";
+  if (Matches(sector, n, data_offset, "SEGADISCSYSTEM", 14)) return "segacd";
+
+  uint8_t pvd[64] = {};
+  size_t pn = file.ReadAt(16 * sector_size + data_offset, pvd, sizeof(pvd));
+  if (pn >= 40 && pvd[0] == 1 && std::memcmp(pvd + 1, "CD001", 5) == 0) {
+    std::string system_id(reinterpret_cast<const char *>(pvd + 8), 32);
+    if (system_id.compare(0, 11, "PLAYSTATION") == 0) return "psx";
+    if (system_id.compare(0, 8, "PSP GAME") == 0) return "psp";
+  }
+  return "";
+}
+
+// SNES internal header: checksum + complement == 0xFFFF at the LoROM (0x7FC0)
+// or HiROM (0xFFC0) location, optionally shifted by a 512-byte copier header.
+bool LooksLikeSnes(File &file) {
+  uint64_t copier = (file.size() % 1024) == 512 ? 512 : 0;
+  const uint64_t bases[] = {0x7FC0, 0xFFC0};
+  for (uint64_t base : bases) {
+    uint8_t hdr[32] = {};
+    if (file.ReadAt(copier + base, hdr, sizeof(hdr)) < sizeof(hdr)) continue;
+    uint16_t complement = ReadLE16(hdr + 0x1C);
+    uint16_t checksum = ReadLE16(hdr + 0x1E);
+    uint8_t map_mode = hdr[0x15];
+    if (static_cast<uint16_t>(complement + checksum) == 0xFFFF && checksum != 0 &&
+        (map_mode & 0xE0) == 0x20) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string SniffPbp(File &file, const uint8_t *hdr, size_t n) {
+  if (n < 0x28) return "psp";
+  // DATA.PSAR offset; PS1 Classics embed a PSISOIMG / PSTITLEIMG container.
+  uint32_t psar = ReadLE32(hdr + 0x24);
+  uint8_t magic[8] = {};
+  if (file.ReadAt(psar, magic, sizeof(magic)) == sizeof(magic) &&
+      (std::memcmp(magic, "PSISOIMG", 8) == 0 || std::memcmp(magic, "PSTITLEI", 8) == 0)) {
+    return "psx";
+  }
+  return "psp";
+}
+
+std::string SniffFile(const std::string &path) {
+  File file(path);
+  if (!file.ok()) return "";
+
+  uint8_t hdr[0x200] = {};
+  size_t n = file.ReadAt(0, hdr, sizeof(hdr));
+  if (n < 4) return "";
+
+  if (Matches(hdr, n, 0, "NES\x1A", 4) || Matches(hdr, n, 0, "FDS\x1A", 4)) return "nes";
+  if (Matches(hdr, n, 0, "\x80\x37\x12\x40", 4) || Matches(hdr, n, 0, "\x37\x80\x40\x12", 4) ||
+      Matches(hdr, n, 0, "\x40\x12\x37\x80", 4)) {
+    return "n64";
+  }
+  if (Matches(hdr, n, 0, "\0PBP", 4)) return SniffPbp(file, hdr, n);
+  if (Matches(hdr, n, 0, "CISO", 4)) return "psp";
+
+  // GameCube / Wii disc magic words.
+  if (Matches(hdr, n, 0x1C, "\xC2\x33\x9F\x3D", 4)) return "gamecube";
+  if (Matches(hdr, n, 0x18, "\x5D\x1C\x9E\xA3", 4)) return "wii";
+
+  if (Matches(hdr, n, 0xC0, kGbaLogo, sizeof(kGbaLogo)) && n > 0x15D &&
+      hdr[0x15C] == 0x56 && hdr[0x15D] == 0xCF) {
+    return "nds";
+  }
+  if (Matches(hdr, n, 0x04, kGbaLogo, sizeof(kGbaLogo)) && n > 0xB2 && hdr[0xB2] == 0x96) {
+    return "gba";
+  }
+  if (Matches(hdr, n, 0x104, kGbLogo, sizeof(kGbLogo)) && n > 0x143) {
+    return (hdr[0x143] == 0x80 || hdr[0x143] == 0xC0) ? "gbc" : "gb";
+  }
+
+  // Disc images before the Genesis check: a raw PSX .bin never has "SEGA" at
+  // 0x100, but the sync pattern is unambiguous.
+  std::string disc = SniffDisc(file);
+  if (!disc.empty()) return disc;
+
+  for (size_t off = 0x100; off + 4 <= 0x110 && off + 4 <= n; off++) {
+    if (std::memcmp(hdr + off, "SEGA", 4) == 0) return "genesis";
+  }
+
+  if (file.size() >= 0x8000 && LooksLikeSnes(file)) return "snes";
+  return "";
+}
+
+} // namespace
+
+std::string SniffSystem(const std::string &path, const std::string &ext) {
+  if (ext == ".cue" || ext == ".m3u") {
+    std::string content;
+    if (!ReadSmallFile(path, 64 * 1024, content)) return "";
+    std::vector<std::string> entries =
+        ext == ".cue" ? ParseCueFiles(content) : ParseM3uEntries(content);
+    if (entries.empty()) return "";
+    std::string target = ResolveRelative(DirectoryOf(path), entries.front());
+    std::string target_ext = ExtensionOf(target);
+    // One level of indirection only: an .m3u pointing at a .cue is common,
+    // deeper nesting is not and could loop.
+    if (target_ext == ".m3u") return "";
+    if (target_ext == ".cue") {
+      if (!ReadSmallFile(target, 64 * 1024, content)) return "";
+      entries = ParseCueFiles(content);
+      if (entries.empty()) return "";
+      target = ResolveRelative(DirectoryOf(target), entries.front());
+    }
+    return SniffFile(target);
+  }
+  if (ext == ".chd") {
+    // CHD hunks are compressed; the container alone doesn't say which
+    // console the disc belongs to.
+    return "";
+  }
+  return SniffFile(path);
+}
+
+std::vector<std::string> ParseCueFiles(const std::string &content) {
+  // Mirrors LibraryService.parseCueReferences: quoted names first, otherwise
+  // the text between FILE and the trailing track type.
+  static const char *kTypes[] = {"BINARY", "MOTOROLA", "AIFF", "WAVE", "MP3"};
+  std::vector<std::string> files;
+  size_t pos = 0;
+  while (pos <= content.size()) {
+    size_t eol = content.find('\n', pos);
+    if (eol == std::string::npos) eol = content.size();
+    std::string line = Trim(content.substr(pos, eol - pos));
+    pos = eol + 1;
+
+    // `FILE\s+`: any run of whitespace may follow the keyword (cue sheets
+    // written by some tools use a tab).
+    size_t name_start = 4;
+    while (name_start < line.size() && std::isspace(static_cast<unsigned char>(line[name_start]))) {
+      name_start++;
+    }
+    if (name_start == 4 || name_start == line.size() || Lowercase(line.substr(0, 4)) != "file") {
+      continue;
+    }
+    std::string rest = line.substr(name_start);
+    if (!rest.empty() && rest[0] == '"') {
+      size_t close = rest.find('"', 1);
+      if (close != std::string::npos && close > 1) files.push_back(rest.substr(1, close - 1));
+      continue;
+    }
+    size_t last_space = rest.find_last_of(" \t\v\f");
+    if (last_space == std::string::npos) continue;
+    std::string type = Lowercase(rest.substr(last_space + 1));
+    for (const char *t : kTypes) {
+      if (type == Lowercase(t)) {
+        std::string name = Trim(rest.substr(0, last_space));
+        if (!name.empty()) files.push_back(name);
+        break;
+      }
+    }
+  }
+  return files;
+}
+
+std::vector<std::string> ParseM3uEntries(const std::string &content) {
+  std::vector<std::string> entries;
+  size_t pos = 0;
+  while (pos <= content.size()) {
+    size_t eol = content.find('\n', pos);
+    if (eol == std::string::npos) eol = content.size();
+    std::string line = Trim(content.substr(pos, eol - pos));
+    pos = eol + 1;
+    if (line.empty() || line[0] == '#') continue;
+    entries.push_back(line);
+  }
+  return entries;
+}
+
+bool ReadSmallFile(const std::string &path, size_t max_bytes, std::string &out) {
+  FILE *fp = std::fopen(path.c_str(), "rb");
+  if (!fp) return false;
+  out.resize(max_bytes);
+  size_t n = std::fread(&out[0], 1, max_bytes, fp);
+  std::fclose(fp);
+  out.resize(n);
+  return true;
+}
+
+std::string ResolveRelative(const std::string &dir, const std::string &entry) {
+  if (entry.empty()) return dir;
+  bool absolute = entry[0] == '/' || entry[0] == '\\' ||
+                  (entry.size() > 2 && entry[1] == ':' && (entry[2] == '\\' || entry[2] == '/'));
+  if (absolute) return entry;
+#ifdef _WIN32
+  return dir + "\\" + entry;
+#else
+  return dir + "/" + entry;
+#endif
+}
+
+} // namespace rom_header
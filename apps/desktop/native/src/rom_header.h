@@ -0,0 +1,35 @@
+#ifndef ROM_HEADER_H
+#define ROM_HEADER_H
+
+#include <string>
+#include <vector>
+
+// ROM / disc image header sniffing.
+//
+// Extension-based system detection is ambiguous for several formats (.bin is
+// both Genesis and PSX, .iso is PSX/PSP/GameCube, .cue/.chd/.m3u are PSX or
+// Saturn). These helpers read a few well-known header offsets and return the
+// library system ID ("nes", "snes", "psx", ...) that matches, or an empty
+// string when the content is not recognised.
+namespace rom_header {
+
+// Identify the system for a file on disk. `ext` is lowercase with a leading
+// dot (".bin"). Playlists (.cue/.m3u) are followed to their first entry.
+std::string SniffSystem(const std::string &path, const std::string &ext);
+
+// Raw FILE names referenced by a .cue sheet, in order (unresolved — callers
+// resolve them against the .cue directory).
+std::vector<std::string> ParseCueFiles(const std::string &content);
+
+// Non-comment, non-blank entries of an .m3u playlist, in order (unresolved).
+std::vector<std::string> ParseM3uEntries(const std::string &content);
+
+// Read up to `max_bytes` of a small text file (cue sheets, playlists).
+bool ReadSmallFile(const std::string &path, size_t max_bytes, std::string &out);
+
+// Join a playlist entry onto the playlist's directory unless it is absolute.
+std::string ResolveRelative(const std::string &dir, const std::string &entry);
+
+} // namespace rom_header
+
+#endif // ROM_HEADER_H
@@ -0,0 +1,134 @@
+#include "screen_layout.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace screen_layout {
+
+namespace {
+
+Plan Layout(const Config &config, unsigned src_width, unsigned src_height, unsigned scale,
+            unsigned gap) {
+  Plan plan;
+  plan.src_width = src_width;
+  plan.src_height = src_height;
+
+  if (config.mode == kNone || src_height < 2) {
+    plan.width = src_width;
+    plan.height = src_height;
+    plan.count = 1;
+    plan.screens[0].src = {0, 0, src_width, src_height};
+    plan.screens[0].dst = plan.screens[0].src;
+    return plan;
+  }
+
+  // Any odd last row belongs to neither screen.
+  unsigned band = src_height / 2;
+  Rect top = {0, 0, src_width, band};
+  Rect bottom = {0, band, src_width, band};
+  const Rect &first = config.primary ? bottom : top;
+  const Rect &second = config.primary ? top : bottom;
+
+  plan.screens[0].src = first;
+  plan.screens[1].src = second;
+  plan.count = 2;
+
+  switch (config.mode) {
+    case kStacked:
+      plan.screens[0].dst = {0, 0, src_width, band};
+      plan.screens[1].dst = {0, band + gap, src_width, band};
+      plan.width = src_width;
+      plan.height = band * 2 + gap;
+      break;
+
+    case kSideBySide:
+      plan.screens[0].dst = {0, 0, src_width, band};
+      plan.screens[1].dst = {src_width + gap, 0, src_width, band};
+      plan.width = src_width * 2 + gap;
+      plan.height = band;
+      break;
+
+    case kSingle:
+      plan.screens[0].dst = {0, 0, src_width, band};
+      plan.count = 1;
+      plan.width = src_width;
+      plan.height = band;
+      break;
+
+    case kLargeSmall:
+    default: {
+      // Small screen to the right, bottom-aligned with the large one.
+      unsigned large_width = src_width * scale;
+      unsigned large_height = band * scale;
+      plan.screens[0].dst = {0, 0, large_width, large_height};
+      plan.screens[1].dst = {large_width + gap, large_height - band, src_width, band};
+      plan.width = large_width + gap + src_width;
+      plan.height = large_height;
+      break;
+    }
+  }
+  return plan;
+}
+
+} // namespace
+
+bool ParseMode(const char *name, Mode *mode) {
+  static const struct {
+    const char *name;
+    Mode mode;
+  } kModes[] = {
+      {"none", kNone},
+      {"stacked", kStacked},
+      {"sideBySide", kSideBySide},
+      {"single", kSingle},
+      {"largeSmall", kLargeSmall},
+  };
+  for (const auto &entry : kModes) {
+    if (strcmp(entry.name, name) == 0) {
+      *mode = entry.mode;
+      return true;
+    }
+  }
+  return false;
+}
+
+Plan Compute(const Config &config, unsigned src_width, unsigned src_height,
+             uint64_t max_pixels) {
+  unsigned scale = config.mode == kLargeSmall ? std::clamp(config.scale, 1u, kMaxScale) : 1;
+  unsigned gap = std::min(config.gap, kMaxGap);
+  for (;;) {
+    Plan plan = Layout(config, src_width, src_height, scale, gap);
+    uint64_t pixels = static_cast<uint64_t>(plan.width) * plan.height;
+    if (max_pixels == 0 || pixels <= max_pixels || (scale == 1 && gap == 0)) {
+      return plan;
+    }
+    if (scale > 1) {
+      scale--;
+    } else {
+      gap = 0;
+    }
+  }
+}
+
+bool Unmap(const Plan &plan, double x, double y, unsigned *src_x, unsigned *src_y) {
+  if (plan.width == 0 || plan.height == 0) return false;
+  if (!(x >= 0 && x < 1 && y >= 0 && y < 1)) return false;
+
+  double px = x * plan.width;
+  double py = y * plan.height;
+  for (unsigned i = 0; i < plan.count; i++) {
+    const Rect &dst = plan.screens[i].dst;
+    const Rect &src = plan.screens[i].src;
+    if (px < dst.x || px >= dst.x + dst.width || py < dst.y || py >= dst.y + dst.height) {
+      continue;
+    }
+    unsigned sx = static_cast<unsigned>((px - dst.x) * src.width / dst.width);
+    unsigned sy = static_cast<unsigned>((py - dst.y) * src.height / dst.height);
+    *src_x = src.x + std::min(sx, src.width - 1);
+    *src_y = src.y + std::min(sy, src.height - 1);
+    return true;
+  }
+  return false;
+}
+
+} // namespace screen_layout
@@ -0,0 +1,78 @@
+#ifndef SCREEN_LAYOUT_H
+#define SCREEN_LAYOUT_H
+
+#include <cstdint>
+
+// Multi-screen layout for the SW video conversion pass.
+//
+// DS-style cores deliver both screens stacked in one buffer. A Plan splits
+// that source into equal horizontal bands and places each band somewhere in
+// the output frame, scaled by an integer factor, so the conversion to RGBA
+// writes the chosen layout directly instead of the renderer re-compositing
+// it. Mode kNone is a single identity placement, which is also what every
+// single-screen core gets.
+//
+// Plans are pure geometry and cheap to compute, so changing the Config takes
+// effect on the next frame at no extra cost. Unmap runs the other way for
+// touch input: an output position back to the source pixel the core drew.
+namespace screen_layout {
+
+constexpr unsigned kMaxScreens = 2;
+constexpr unsigned kMaxGap = 64;
+constexpr unsigned kMaxScale = 4;
+
+enum Mode {
+  kNone,       // source as delivered
+  kStacked,    // screens top to bottom
+  kSideBySide, // screens left to right
+  kSingle,     // the primary screen only
+  kLargeSmall, // the primary screen scaled up, the other beside it at 1x
+};
+
+struct Config {
+  Mode mode = kNone;
+  unsigned gap = 0;     // source pixels between screens
+  unsigned primary = 0; // screen placed first / large / alone
+  unsigned scale = 2;   // kLargeSmall only
+};
+
+struct Rect {
+  unsigned x = 0;
+  unsigned y = 0;
+  unsigned width = 0;
+  unsigned height = 0;
+};
+
+struct Placement {
+  Rect src;
+  Rect dst;
+};
+
+struct Plan {
+  unsigned src_width = 0;
+  unsigned src_height = 0;
+  unsigned width = 0;
+  unsigned height = 0;
+  unsigned count = 0;
+  Placement screens[kMaxScreens];
+};
+
+// Parse the renderer's mode names ("none", "stacked", "sideBySide",
+// "single", "largeSmall"). False for anything else.
+bool ParseMode(const char *name, Mode *mode);
+
+// Lay out a `src_width` x `src_height` source. When the result would exceed
+// `max_pixels` (the frame buffers' capacity) the scale, then the gap, are
+// reduced until it fits; at 1x without a gap every mode fits in the source's
+// own pixel count.
+Plan Compute(const Config &config, unsigned src_width, unsigned src_height,
+             uint64_t max_pixels);
+
+// Map a normalized output position (0..1 on each axis) to source pixel
+// coordinates. False when it falls in a gap, off the frame, or on a screen
+// the plan doesn't show.
+bool Unmap(const Plan &plan, double x, double y, unsigned *src_x, unsigned *src_y);
+
+} // namespace screen_layout
+
+#endif // SCREEN_LAYOUT_H
@@ -0,0 +1,451 @@
+#include "search_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace search_index {
+
+// ---------------------------------------------------------------------------
+// Folding
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct FoldRange {
+  uint32_t first;
+  uint32_t last;
+  const char *replacement; // "" = drop, " " = separator
+};
+
+// Latin-1 Supplement and Latin Extended-A, which cover the accented titles
+// that show up in No-Intro/Redump sets (Pokémon, Señor, Ōkami, ...).
+const FoldRange kFoldRanges[] = {
+  {0x00C0, 0x00C5, "a"}, {0x00C6, 0x00C6, "ae"}, {0x00C7, 0x00C7, "c"},
+  {0x00C8, 0x00CB, "e"}, {0x00CC, 0x00CF, "i"},  {0x00D0, 0x00D0, "d"},
+  {0x00D1, 0x00D1, "n"}, {0x00D2, 0x00D6, "o"},  {0x00D7, 0x00D7, " "},
+  {0x00D8, 0x00D8, "o"}, {0x00D9, 0x00DC, "u"},  {0x00DD, 0x00DD, "y"},
+  {0x00DE, 0x00DE, "th"}, {0x00DF, 0x00DF, "ss"}, {0x00E0, 0x00E5, "a"},
+  {0x00E6, 0x00E6, "ae"}, {0x00E7, 0x00E7, "c"},  {0x00E8, 0x00EB, "e"},
+  {0x00EC, 0x00EF, "i"}, {0x00F0, 0x00F0, "d"},  {0x00F1, 0x00F1, "n"},
+  {0x00F2, 0x00F6, "o"}, {0x00F7, 0x00F7, " "},  {0x00F8, 0x00F8, "o"},
+  {0x00F9, 0x00FC, "u"}, {0x00FD, 0x00FD, "y"},  {0x00FE, 0x00FE, "th"},
+  {0x00FF, 0x00FF, "y"}, {0x0100, 0x0105, "a"},  {0x0106, 0x010D, "c"},
+  {0x010E, 0x0111, "d"}, {0x0112, 0x011B, "e"},  {0x011C, 0x0123, "g"},
+  {0x0124, 0x0127, "h"}, {0x0128, 0x0131, "i"},  {0x0132, 0x0133, "ij"},
+  {0x0134, 0x0135, "j"}, {0x0136, 0x0138, "k"},  {0x0139, 0x0142, "l"},
+  {0x0143, 0x014B, "n"}, {0x014C, 0x0151, "o"},  {0x0152, 0x0153, "oe"},
+  {0x0154, 0x0159, "r"}, {0x015A, 0x0161, "s"},  {0x0162, 0x0167, "t"},
+  {0x0168, 0x0173, "u"}, {0x0174, 0x0175, "w"},  {0x0176, 0x0178, "y"},
+  {0x0179, 0x017E, "z"}, {0x017F, 0x017F, "s"},
+  {0x0300, 0x036F, ""},   // combining diacritics
+  {0x2018, 0x2019, ""},   // curly apostrophes
+  {0x2000, 0x206F, " "},  // general punctuation
+};
+
+// Decode one UTF-8 sequence at `s[i]`. Returns its length (1 for invalid bytes,
+// which decode as U+FFFD).
+size_t DecodeUtf8(const std::string &s, size_t i, uint32_t *cp) {
+  uint8_t b = static_cast<uint8_t>(s[i]);
+  size_t len = b < 0x80 ? 1 : (b >> 5) == 0x6 ? 2 : (b >> 4) == 0xE ? 3 : (b >> 3) == 0x1E ? 4 : 0;
+  if (len == 0 || i + len > s.size()) {
+    *cp = 0xFFFD;
+    return 1;
+  }
+  uint32_t value = len == 1 ? b : b & (0xFF >> (len + 1));
+  for (size_t k = 1; k < len; k++) {
+    uint8_t c = static_cast<uint8_t>(s[i + k]);
+    if ((c & 0xC0) != 0x80) {
+      *cp = 0xFFFD;
+      return 1;
+    }
+    value = (value << 6) | (c & 0x3F);
+  }
+  *cp = value;
+  return len;
+}
+
+uint32_t TrigramKey(const char *p) {
+  return (static_cast<uint32_t>(static_cast<uint8_t>(p[0])) << 16) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(p[1])) << 8) |
+         static_cast<uint32_t>(static_cast<uint8_t>(p[2]));
+}
+
+std::vector<std::string> SplitWords(const std::string &folded) {
+  std::vector<std::string> words;
+  size_t start = 0;
+  while (start < folded.size()) {
+    size_t end = folded.find(' ', start);
+    if (end == std::string::npos) end = folded.size();
+    if (end > start) words.push_back(folded.substr(start, end - start));
+    start = end + 1;
+  }
+  return words;
+}
+
+// Trigrams of a word padded with two leading spaces, so "zelda" yields
+// "  z", " ze", "zel", "eld", "lda".
+void WordTrigrams(const std::string &word, std::vector<uint32_t> *out) {
+  std::string padded = "  " + word;
+  for (size_t i = 0; i + 3 <= padded.size(); i++) out->push_back(TrigramKey(padded.data() + i));
+}
+
+// Keys a document must contain for `token` to match it. Short tokens only
+// match at a word start.
+std::vector<uint32_t> TokenKeys(const std::string &token) {
+  std::vector<uint32_t> keys;
+  if (token.size() < 3) {
+    std::string padded = std::string(3 - token.size(), ' ') + token;
+    keys.push_back(TrigramKey(padded.data()));
+  } else {
+    for (size_t i = 0; i + 3 <= token.size(); i++) keys.push_back(TrigramKey(token.data() + i));
+  }
+  return keys;
+}
+
+bool AtWordStart(const std::string &text, const std::string &token) {
+  for (size_t pos = text.find(token); pos != std::string::npos; pos = text.find(token, pos + 1)) {
+    if (pos == 0 || text[pos - 1] == ' ') return true;
+  }
+  return false;
+}
+
+} // namespace
+
+std::string Fold(const std::string &text) {
+  std::string out;
+  out.reserve(text.size());
+  bool pending_space = false;
+  auto emit = [&](const char *bytes, size_t len) {
+    if (pending_space && !out.empty()) out.push_back(' ');
+    pending_space = false;
+    out.append(bytes, len);
+  };
+
+  for (size_t i = 0; i < text.size();) {
+    uint32_t cp;
+    size_t len = DecodeUtf8(text, i, &cp);
+
+    if (cp < 0x80) {
+      char c = static_cast<char>(cp);
+      if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+      if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) {
+        emit(&c, 1);
+      } else if (c != '\'') {
+        pending_space = true;
+      }
+    } else {
+      const FoldRange *range = nullptr;
+      for (const auto &r : kFoldRanges) {
+        if (cp >= r.first && cp <= r.last) {
+          range = &r;
+          break;
+        }
+      }
+      if (!range) {
+        // Other scripts are indexed as raw UTF-8 bytes.
+        emit(text.data() + i, len);
+      } else if (range->replacement[0] == ' ') {
+        pending_space = true;
+      } else if (range->replacement[0] != '\0') {
+        emit(range->replacement, strlen(range->replacement));
+      }
+    }
+    i += len;
+  }
+  return out;
+}
+
+// ---------------------------------------------------------------------------
+// Index
+// ---------------------------------------------------------------------------
+
+void Index::AddPostings(uint32_t doc) {
+  std::vector<uint32_t> keys;
+  for (const auto &word : SplitWords(docs_[doc].folded)) WordTrigrams(word, &keys);
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  // Docs are only ever appended, so posting lists stay sorted.
+  for (uint32_t key : keys) postings_[key].push_back(doc);
+}
+
+void Index::Kill(uint32_t doc) {
+  docs_[doc].alive = false;
+  docs_[doc].folded.clear();
+  dead_++;
+}
+
+void Index::Upsert(const std::string &id, const std::string &title) {
+  std::string folded = Fold(title);
+  auto it = by_id_.find(id);
+  if (it != by_id_.end()) {
+    if (docs_[it->second].folded == folded) return;
+    Kill(it->second);
+  }
+  uint32_t doc = static_cast<uint32_t>(docs_.size());
+  docs_.push_back({id, std::move(folded), true});
+  by_id_[id] = doc;
+  AddPostings(doc);
+}
+
+void Index::Remove(const std::string &id) {
+  auto it = by_id_.find(id);
+  if (it == by_id_.end()) return;
+  Kill(it->second);
+  by_id_.erase(it);
+}
+
+void Index::Clear() {
+  docs_.clear();
+  by_id_.clear();
+  postings_.clear();
+  dead_ = 0;
+}
+
+void Index::MaybeSweep() {
+  if (dead_ < 1024 || dead_ < by_id_.size()) return;
+  std::vector<Doc> live;
+  live.reserve(by_id_.size());
+  for (auto &doc : docs_) {
+    if (doc.alive) live.push_back(std::move(doc));
+  }
+  docs_ = std::move(live);
+  by_id_.clear();
+  postings_.clear();
+  dead_ = 0;
+  for (uint32_t i = 0; i < docs_.size(); i++) {
+    by_id_[docs_[i].id] = i;
+    AddPostings(i);
+  }
+}
+
+size_t Index::Size() const {
+  return by_id_.size();
+}
+
+std::vector<std::string> Index::Query(const std::string &text, size_t limit) const {
+  std::string folded = Fold(text);
+  std::vector<std::string> tokens = SplitWords(folded);
+  if (tokens.empty()) return {};
+
+  // Intersect the posting lists, rarest first, so only documents holding
+  // every key are verified against the title.
+  std::vector<const std::vector<uint32_t> *> lists;
+  for (const auto &token : tokens) {
+    for (uint32_t key : TokenKeys(token)) {
+      auto it = postings_.find(key);
+      if (it == postings_.end()) return {};
+      lists.push_back(&it->second);
+    }
+  }
+  std::sort(lists.begin(), lists.end(),
+            [](const auto *a, const auto *b) { return a->size() < b->size(); });
+  lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+  std::vector<uint32_t> candidates = *lists[0];
+  for (size_t l = 1; l < lists.size() && !candidates.empty(); l++) {
+    const std::vector<uint32_t> &list = *lists[l];
+    auto cursor = list.begin();
+    size_t kept = 0;
+    for (uint32_t doc : candidates) {
+      cursor = std::lower_bound(cursor, list.end(), doc);
+      if (cursor == list.end()) break;
+      if (*cursor == doc) candidates[kept++] = doc;
+    }
+    candidates.resize(kept);
+  }
+
+  struct Hit {
+    uint32_t doc;
+    uint32_t length;
+    int rank;
+  };
+  std::vector<Hit> hits;
+  for (uint32_t doc : candidates) {
+    const Doc &d = docs_[doc];
+    if (!d.alive) continue;
+
+    bool all_word_starts = true;
+    bool matched = true;
+    for (const auto &token : tokens) {
+      bool word_start = AtWordStart(d.folded, token);
+      if (!word_start && (token.size() < 3 || d.folded.find(token) == std::string::npos)) {
+        matched = false;
+        break;
+      }
+      all_word_starts = all_word_starts && word_start;
+    }
+    if (!matched) continue;
+
+    int rank = 3;
+    if (d.folded == folded) {
+      rank = 0;
+    } else if (d.folded.compare(0, folded.size(), folded) == 0) {
+      rank = 1;
+    } else if (all_word_starts) {
+      rank = 2;
+    }
+    hits.push_back({doc, static_cast<uint32_t>(d.folded.size()), rank});
+  }
+
+  // Ties keep insertion order; comparing titles here costs more than the
+  // whole lookup on large result sets.
+  auto better = [](const Hit &a, const Hit &b) {
+    if (a.rank != b.rank) return a.rank < b.rank;
+    if (a.length != b.length) return a.length < b.length;
+    return a.doc < b.doc;
+  };
+  if (limit > 0 && limit < hits.size()) {
+    std::partial_sort(hits.begin(), hits.begin() + static_cast<ptrdiff_t>(limit), hits.end(), better);
+    hits.resize(limit);
+  } else {
+    std::sort(hits.begin(), hits.end(), better);
+  }
+
+  std::vector<std::string> ids;
+  ids.reserve(hits.size());
+  for (const auto &hit : hits) ids.push_back(docs_[hit.doc].id);
+  return ids;
+}
+
+} // namespace search_index
+
+// ---------------------------------------------------------------------------
+// N-API binding
+// ---------------------------------------------------------------------------
+
+namespace {
+
+class QueryWorker : public Napi::AsyncWorker {
+public:
+  QueryWorker(Napi::Env env, std::shared_ptr<search_index::Index> index, std::string text,
+              size_t limit)
+      : Napi::AsyncWorker(env),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        index_(std::move(index)),
+        text_(std::move(text)),
+        limit_(limit) {}
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+protected:
+  void Execute() override {
+    std::shared_lock<std::shared_mutex> lock(index_->Mutex());
+    ids_ = index_->Query(text_, limit_);
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::Array result = Napi::Array::New(env, ids_.size());
+    for (uint32_t i = 0; i < ids_.size(); i++) result.Set(i, Napi::String::New(env, ids_[i]));
+    deferred_.Resolve(result);
+  }
+
+  void OnError(const Napi::Error &error) override { deferred_.Reject(error.Value()); }
+
+private:
+  Napi::Promise::Deferred deferred_;
+  std::shared_ptr<search_index::Index> index_;
+  std::string text_;
+  size_t limit_;
+  std::vector<std::string> ids_;
+};
+
+} // namespace
+
+void SearchIndex::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "SearchIndex", {
+    StaticMethod("fold", &SearchIndex::FoldText),
+    InstanceMethod("upsert", &SearchIndex::Upsert),
+    InstanceMethod("remove", &SearchIndex::Remove),
+    InstanceMethod("clear", &SearchIndex::Clear),
+    InstanceMethod("size", &SearchIndex::Size),
+    InstanceMethod("query", &SearchIndex::Query),
+  });
+  exports.Set("SearchIndex", func);
+}
+
+SearchIndex::SearchIndex(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<SearchIndex>(info), index_(std::make_shared<search_index::Index>()) {}
+
+Napi::Value SearchIndex::FoldText(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected string").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  return Napi::String::New(env, search_index::Fold(info[0].As<Napi::String>().Utf8Value()));
+}
+
+void SearchIndex::Upsert(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected array of { id, title }").ThrowAsJavaScriptException();
+    return;
+  }
+
+  // Convert outside the lock so queries aren't held up by JS property access.
+  Napi::Array arr = info[0].As<Napi::Array>();
+  std::vector<std::pair<std::string, std::string>> entries;
+  entries.reserve(arr.Length());
+  for (uint32_t i = 0; i < arr.Length(); i++) {
+    Napi::Value v = arr.Get(i);
+    if (!v.IsObject()) continue;
+    Napi::Object entry = v.As<Napi::Object>();
+    Napi::Value id = entry.Get("id");
+    Napi::Value title = entry.Get("title");
+    if (!id.IsString() || !title.IsString()) continue;
+    entries.emplace_back(id.As<Napi::String>().Utf8Value(), title.As<Napi::String>().Utf8Value());
+  }
+
+  std::unique_lock<std::shared_mutex> lock(index_->Mutex());
+  for (const auto &entry : entries) index_->Upsert(entry.first, entry.second);
+  index_->MaybeSweep();
+}
+
+void SearchIndex::Remove(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected array of ids").ThrowAsJavaScriptException();
+    return;
+  }
+
+  Napi::Array arr = info[0].As<Napi::Array>();
+  std::vector<std::string> ids;
+  for (uint32_t i = 0; i < arr.Length(); i++) {
+    Napi::Value v = arr.Get(i);
+    if (v.IsString()) ids.push_back(v.As<Napi::String>().Utf8Value());
+  }
+
+  std::unique_lock<std::shared_mutex> lock(index_->Mutex());
+  for (const auto &id : ids) index_->Remove(id);
+  index_->MaybeSweep();
+}
+
+void SearchIndex::Clear(const Napi::CallbackInfo &info) {
+  std::unique_lock<std::shared_mutex> lock(index_->Mutex());
+  index_->Clear();
+}
+
+Napi::Value SearchIndex::Size(const Napi::CallbackInfo &info) {
+  std::shared_lock<std::shared_mutex> lock(index_->Mutex());
+  return Napi::Number::New(info.Env(), static_cast<double>(index_->Size()));
+}
+
+Napi::Value SearchIndex::Query(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected query string").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  size_t limit = 0;
+  if (info.Length() > 1 && info[1].IsNumber()) {
+    int64_t requested = info[1].As<Napi::Number>().Int64Value();
+    if (requested > 0) limit = static_cast<size_t>(requested);
+  }
+
+  auto *worker = new QueryWorker(env, index_, info[0].As<Napi::String>().Utf8Value(), limit);
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
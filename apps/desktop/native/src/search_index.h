@@ -0,0 +1,88 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include <napi.h>
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Title search index for the library.
+//
+// Titles are folded (lowercase, Latin diacritics stripped, punctuation
+// collapsed to single spaces) and every word is indexed by its byte
+// trigrams, padded at the front so one- and two-character queries become
+// word-prefix lookups. A query walks the shortest posting list among its
+// tokens and verifies each candidate against the folded title, so results
+// are exact substring matches, ranked:
+//
+//   exact title > title prefix > every token at a word start > substring
+//
+// with shorter titles first within a rank. Updates are incremental; removed
+// and replaced entries are tombstoned and swept once they outnumber live ones.
+namespace search_index {
+
+// Fold `text` for indexing / querying. Also exposed to JS as SearchIndex.fold.
+std::string Fold(const std::string &text);
+
+class Index {
+public:
+  void Upsert(const std::string &id, const std::string &title);
+  void Remove(const std::string &id);
+  void Clear();
+  // Rebuild postings if tombstones outnumber live entries.
+  void MaybeSweep();
+  size_t Size() const;
+
+  // Matching ids, best first. `limit` 0 means no limit.
+  std::vector<std::string> Query(const std::string &text, size_t limit) const;
+
+  std::shared_mutex &Mutex() const { return mutex_; }
+
+private:
+  struct Doc {
+    std::string id;
+    std::string folded;
+    bool alive;
+  };
+
+  void AddPostings(uint32_t doc);
+  void Kill(uint32_t doc);
+
+  std::vector<Doc> docs_;
+  std::unordered_map<std::string, uint32_t> by_id_;
+  std::unordered_map<uint32_t, std::vector<uint32_t>> postings_;
+  size_t dead_ = 0;
+  mutable std::shared_mutex mutex_;
+};
+
+} // namespace search_index
+
+// N-API wrapper:
+//
+//   const index = new SearchIndex();
+//   index.upsert([{ id, title }]); index.remove(ids); index.clear();
+//   index.size() → number
+//   index.query(text, limit?) → Promise<Array<id>>
+//   SearchIndex.fold(text) → string
+class SearchIndex : public Napi::ObjectWrap<SearchIndex> {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+  SearchIndex(const Napi::CallbackInfo &info);
+
+private:
+  static Napi::Value FoldText(const Napi::CallbackInfo &info);
+  void Upsert(const Napi::CallbackInfo &info);
+  void Remove(const Napi::CallbackInfo &info);
+  void Clear(const Napi::CallbackInfo &info);
+  Napi::Value Size(const Napi::CallbackInfo &info);
+  Napi::Value Query(const Napi::CallbackInfo &info);
+
+  // Shared with in-flight query workers.
+  std::shared_ptr<search_index::Index> index_;
+};
+
+#endif // SEARCH_INDEX_H
@@ -0,0 +1,324 @@
+#include "stall_watchdog.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <csignal>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#ifdef __APPLE__
+#include <libproc.h>
+#endif
+
+namespace stall_watchdog {
+
+namespace {
+
+// A frame still running after this long is treated as hung and its report is
+// written to stderr (see TakeReports).
+constexpr int64_t kHangNs = 5'000'000'000;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+IoCounters ReadIo() {
+  IoCounters io;
+#ifdef _WIN32
+  IO_COUNTERS counters;
+  if (GetProcessIoCounters(GetCurrentProcess(), &counters)) {
+    io.read_bytes = counters.ReadTransferCount;
+    io.write_bytes = counters.WriteTransferCount;
+  }
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    io.major_faults = static_cast<uint64_t>(usage.ru_majflt);
+    io.voluntary_switches = static_cast<uint64_t>(usage.ru_nvcsw);
+    io.involuntary_switches = static_cast<uint64_t>(usage.ru_nivcsw);
+  }
+#endif
+
+#ifdef __linux__
+  // rchar/wchar count every read()/write(), including page-cache hits, which
+  // is what a disc seek inside a core looks like.
+  if (FILE *f = fopen("/proc/self/io", "r")) {
+    char key[32];
+    unsigned long long value;
+    while (fscanf(f, "%31[^:]: %llu\n", key, &value) == 2) {
+      if (strcmp(key, "rchar") == 0) io.read_bytes = value;
+      else if (strcmp(key, "wchar") == 0) io.write_bytes = value;
+    }
+    fclose(f);
+  }
+#elif defined(__APPLE__)
+  rusage_info_v2 info;
+  if (proc_pid_rusage(getpid(), RUSAGE_INFO_V2, reinterpret_cast<rusage_info_t *>(&info)) == 0) {
+    io.read_bytes = info.ri_diskio_bytesread;
+    io.write_bytes = info.ri_diskio_byteswritten;
+  }
+#endif
+  return io;
+}
+
+IoCounters Delta(const IoCounters &now, const IoCounters &then) {
+  auto sub = [](uint64_t a, uint64_t b) { return a > b ? a - b : 0; };
+  IoCounters d;
+  d.read_bytes = sub(now.read_bytes, then.read_bytes);
+  d.write_bytes = sub(now.write_bytes, then.write_bytes);
+  d.major_faults = sub(now.major_faults, then.major_faults);
+  d.voluntary_switches = sub(now.voluntary_switches, then.voluntary_switches);
+  d.involuntary_switches = sub(now.involuntary_switches, then.involuntary_switches);
+  return d;
+}
+
+#ifndef _WIN32
+// Written by the signal handler on the emulation thread, read by the
+// watchdog once g_captured is set. Only one watchdog exists at a time.
+constexpr int kMaxFrames = 64;
+void *g_frames[kMaxFrames];
+std::atomic<int> g_frame_count{0};
+std::atomic<bool> g_captured{false};
+struct sigaction g_previous_action;
+
+void HandleStackSignal(int) {
+  int saved_errno = errno;
+  g_frame_count.store(backtrace(g_frames, kMaxFrames), std::memory_order_relaxed);
+  g_captured.store(true, std::memory_order_release);
+  errno = saved_errno;
+}
+
+std::string Symbolize(void *address) {
+  char buf[512];
+  Dl_info info;
+  if (!dladdr(address, &info) || !info.dli_fname) {
+    snprintf(buf, sizeof(buf), "%p", address);
+    return buf;
+  }
+
+  const char *module = strrchr(info.dli_fname, '/');
+  module = module ? module + 1 : info.dli_fname;
+  uintptr_t addr = reinterpret_cast<uintptr_t>(address);
+
+  if (info.dli_sname && info.dli_saddr) {
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    snprintf(buf, sizeof(buf), "%s!%s+0x%lx", module,
+             status == 0 && demangled ? demangled : info.dli_sname,
+             static_cast<unsigned long>(addr - reinterpret_cast<uintptr_t>(info.dli_saddr)));
+    free(demangled);
+  } else {
+    snprintf(buf, sizeof(buf), "%s+0x%lx", module,
+             static_cast<unsigned long>(addr - reinterpret_cast<uintptr_t>(info.dli_fbase)));
+  }
+  return buf;
+}
+#endif
+
+void PrintReport(const Report &report) {
+  fprintf(stderr, "[stall-watchdog] frame %llu still running after %.0f ms\n",
+          static_cast<unsigned long long>(report.frame), report.stalled_ms);
+  for (const auto &frame : report.stack) {
+    fprintf(stderr, "    at %s\n", frame.c_str());
+  }
+  for (const auto &span : report.spans) {
+    fprintf(stderr, "    span %s @ %.1f ms%s\n", span.name, span.start_ns / 1e6,
+            span.open ? " (open)" : "");
+  }
+  fprintf(stderr, "    io: read %llu B, written %llu B, %llu major faults\n",
+          static_cast<unsigned long long>(report.io.read_bytes),
+          static_cast<unsigned long long>(report.io.write_bytes),
+          static_cast<unsigned long long>(report.io.major_faults));
+}
+
+} // namespace
+
+Watchdog::Watchdog(uint32_t threshold_ms) : threshold_ms_(std::max<uint32_t>(threshold_ms, 1)) {
+#ifndef _WIN32
+  target_ = pthread_self();
+
+  // backtrace() lazily loads the unwinder on first use (which allocates), so
+  // call it once here rather than first inside the signal handler.
+  void *warmup[1];
+  backtrace(warmup, 1);
+
+  struct sigaction action = {};
+  action.sa_handler = HandleStackSignal;
+  sigemptyset(&action.sa_mask);
+  // SA_RESTART so a stalled read() in the core resumes after the handler.
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGUSR2, &action, &g_previous_action);
+#endif
+
+  thread_ = std::thread([this] { Loop(); });
+}
+
+Watchdog::~Watchdog() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) thread_.join();
+#ifndef _WIN32
+  sigaction(SIGUSR2, &g_previous_action, nullptr);
+#endif
+}
+
+void Watchdog::BeginFrame() {
+  frame_seq_.fetch_add(1, std::memory_order_relaxed);
+  frame_start_ns_.store(NowNs(), std::memory_order_release);
+}
+
+void Watchdog::EndFrame() {
+  int64_t start = frame_start_ns_.exchange(0, std::memory_order_acq_rel);
+  uint64_t seq = frame_seq_.load(std::memory_order_relaxed);
+  if (start != 0 && seq == stalled_seq_.load(std::memory_order_acquire)) {
+    stalled_frame_ns_.store(NowNs() - start, std::memory_order_relaxed);
+  }
+  completed_seq_.store(seq, std::memory_order_release);
+}
+
+void Watchdog::BeginSpan(const char *name) {
+  int depth = depth_.load(std::memory_order_relaxed);
+  if (depth < kMaxDepth) {
+    open_[depth].name.store(name, std::memory_order_relaxed);
+    open_[depth].start_ns.store(NowNs(), std::memory_order_relaxed);
+  }
+  depth_.store(depth + 1, std::memory_order_release);
+}
+
+void Watchdog::EndSpan() {
+  int depth = depth_.load(std::memory_order_relaxed) - 1;
+  if (depth < 0) return;
+  depth_.store(depth, std::memory_order_release);
+  if (depth >= kMaxDepth) return;
+
+  SpanSlot &slot = ring_[ring_head_.fetch_add(1, std::memory_order_relaxed) % kRingSize];
+  slot.name.store(open_[depth].name.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  slot.start_ns.store(open_[depth].start_ns.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+  slot.end_ns.store(NowNs(), std::memory_order_release);
+}
+
+std::vector<Report> Watchdog::TakeReports() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Report> done;
+  std::vector<Report> pending;
+  for (auto &report : reports_) {
+    (report.frame_ms >= 0 ? done : pending).push_back(std::move(report));
+  }
+  reports_ = std::move(pending);
+  return done;
+}
+
+void Watchdog::CollectSpans(int64_t frame_start_ns, std::vector<Span> *out) {
+  // Spans that ended within the previous second, plus whatever is open now.
+  int64_t horizon = frame_start_ns - 1'000'000'000;
+  for (auto &slot : ring_) {
+    const char *name = slot.name.load(std::memory_order_relaxed);
+    int64_t end = slot.end_ns.load(std::memory_order_acquire);
+    if (!name || end < horizon) continue;
+    out->push_back({name, slot.start_ns.load(std::memory_order_relaxed) - frame_start_ns,
+                    end - frame_start_ns, false});
+  }
+  int depth = std::min(depth_.load(std::memory_order_acquire), kMaxDepth);
+  for (int i = 0; i < depth; i++) {
+    const char *name = open_[i].name.load(std::memory_order_relaxed);
+    if (name) {
+      out->push_back(
+        {name, open_[i].start_ns.load(std::memory_order_relaxed) - frame_start_ns, 0, true});
+    }
+  }
+  std::sort(out->begin(), out->end(),
+            [](const Span &a, const Span &b) { return a.start_ns < b.start_ns; });
+}
+
+void Watchdog::Capture(uint64_t frame, int64_t frame_start_ns, int64_t now_ns) {
+  Report report;
+  report.frame = frame;
+  report.stalled_ms = (now_ns - frame_start_ns) / 1e6;
+  stalled_frame_ns_.store(-1, std::memory_order_relaxed);
+  stalled_seq_.store(frame, std::memory_order_release);
+
+#ifndef _WIN32
+  g_captured.store(false, std::memory_order_relaxed);
+  if (pthread_kill(target_, SIGUSR2) == 0) {
+    for (int i = 0; i < 50 && !g_captured.load(std::memory_order_acquire); i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  if (g_captured.load(std::memory_order_acquire)) {
+    // Skip the handler itself and the kernel's signal trampoline.
+    int count = g_frame_count.load(std::memory_order_relaxed);
+    for (int i = 2; i < count; i++) report.stack.push_back(Symbolize(g_frames[i]));
+  }
+#endif
+
+  CollectSpans(frame_start_ns, &report.spans);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  reports_.push_back(std::move(report));
+}
+
+void Watchdog::Loop() {
+  const auto poll = std::chrono::milliseconds(std::max<uint32_t>(threshold_ms_ / 4, 10));
+  const int64_t threshold_ns = static_cast<int64_t>(threshold_ms_) * 1'000'000;
+  IoCounters baseline = ReadIo();
+  uint64_t reported_frame = 0;
+  bool hang_printed = false;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    cv_.wait_for(lock, poll);
+    if (stopping_) break;
+    lock.unlock();
+
+    int64_t now = NowNs();
+    int64_t start = frame_start_ns_.load(std::memory_order_acquire);
+    uint64_t frame = frame_seq_.load(std::memory_order_relaxed);
+    bool stalled = start != 0 && now - start > threshold_ns;
+
+    if (stalled && frame != reported_frame) {
+      Capture(frame, start, now);
+      reported_frame = frame;
+      hang_printed = false;
+      IoCounters io = ReadIo();
+      std::lock_guard<std::mutex> guard(mutex_);
+      reports_.back().io = Delta(io, baseline);
+    } else if (!stalled) {
+      baseline = ReadIo();
+    }
+
+    lock.lock();
+    // Fill in the full duration once the stalled frame completes. Frames run
+    // one at a time, so only the newest report can still be open.
+    if (!reports_.empty() && reports_.back().frame_ms < 0) {
+      Report &open = reports_.back();
+      if (completed_seq_.load(std::memory_order_acquire) >= open.frame) {
+        // -1 here means the frame ended before stalled_seq_ was published;
+        // the stall time at capture is then the best lower bound.
+        int64_t frame_ns = stalled_frame_ns_.load(std::memory_order_relaxed);
+        open.frame_ms = frame_ns >= 0 ? frame_ns / 1e6 : open.stalled_ms;
+      } else if (!hang_printed && start != 0 && now - start > kHangNs) {
+        PrintReport(open);
+        hang_printed = true;
+      }
+    }
+  }
+}
+
+} // namespace stall_watchdog
@@ -0,0 +1,136 @@
+#ifndef STALL_WATCHDOG_H
+#define STALL_WATCHDOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+// Emulation stall watchdog (no N-API surface of its own; LibretroCore exposes
+// startWatchdog / stopWatchdog / takeStallReports).
+//
+// The emulation thread publishes a heartbeat around every retro_run and
+// records short named spans (serialize, HW readback, disc swaps...) into a
+// lock-free ring. A watchdog thread polls the heartbeat; once a frame has
+// been running longer than the threshold it interrupts the emulation thread
+// with SIGUSR2, whose handler unwinds its own stack with backtrace() into a
+// static buffer. The watchdog symbolizes that with dladdr and attaches the
+// recent spans and process I/O counters accumulated since the last healthy
+// poll.
+//
+// Stack capture needs frame pointers in the stalled code (always true on
+// arm64 macOS; cores built with -fomit-frame-pointer yield short stacks). On
+// Windows stalls are still detected and timed but the stack is empty.
+namespace stall_watchdog {
+
+struct Span {
+  const char *name = nullptr; // string literal
+  int64_t start_ns = 0;
+  int64_t end_ns = 0;
+  bool open = false; // still running when captured; end_ns is unset
+};
+
+// Deltas since the watchdog's last poll before the stall. Fields a platform
+// can't provide stay 0.
+struct IoCounters {
+  uint64_t read_bytes = 0;
+  uint64_t write_bytes = 0;
+  uint64_t major_faults = 0;
+  uint64_t voluntary_switches = 0;
+  uint64_t involuntary_switches = 0;
+};
+
+struct Report {
+  uint64_t frame = 0;       // heartbeat sequence number of the stalled frame
+  double stalled_ms = 0;    // frame age when the stack was captured
+  double frame_ms = -1;     // full frame duration; -1 until the frame ends
+  std::vector<std::string> stack; // innermost first, "module!symbol+0xoff"
+  std::vector<Span> spans;  // recent spans, oldest first; times relative to frame start
+  IoCounters io;
+};
+
+class Watchdog {
+public:
+  // Must be called on the thread that runs the core.
+  explicit Watchdog(uint32_t threshold_ms);
+  ~Watchdog();
+
+  Watchdog(const Watchdog &) = delete;
+  Watchdog &operator=(const Watchdog &) = delete;
+
+  // Heartbeat, called around each retro_run on the emulation thread.
+  void BeginFrame();
+  void EndFrame();
+
+  // Spans must nest and `name` must outlive the watchdog.
+  void BeginSpan(const char *name);
+  void EndSpan();
+
+  // Reports whose frame has finished. A frame that never finishes is dumped
+  // to stderr instead, since the JS thread that would collect it is stuck.
+  std::vector<Report> TakeReports();
+
+private:
+  static constexpr size_t kRingSize = 64;
+  static constexpr int kMaxDepth = 8;
+
+  struct SpanSlot {
+    std::atomic<const char *> name{nullptr};
+    std::atomic<int64_t> start_ns{0};
+    std::atomic<int64_t> end_ns{0};
+  };
+
+  void Loop();
+  void Capture(uint64_t frame, int64_t frame_start_ns, int64_t now_ns);
+  void CollectSpans(int64_t frame_start_ns, std::vector<Span> *out);
+
+  uint32_t threshold_ms_;
+
+  // Heartbeat: frame_start_ns_ is 0 between frames.
+  std::atomic<uint64_t> frame_seq_{0};
+  std::atomic<int64_t> frame_start_ns_{0};
+  std::atomic<uint64_t> completed_seq_{0};
+  // Frame the watchdog captured, and its duration once EndFrame sees it.
+  std::atomic<uint64_t> stalled_seq_{0};
+  std::atomic<int64_t> stalled_frame_ns_{-1};
+
+  SpanSlot ring_[kRingSize];
+  std::atomic<uint32_t> ring_head_{0};
+  SpanSlot open_[kMaxDepth];
+  std::atomic<int> depth_{0};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+  std::vector<Report> reports_; // guarded by mutex_
+  std::thread thread_;
+
+#ifndef _WIN32
+  pthread_t target_;
+#endif
+};
+
+// RAII span that tolerates a null watchdog (the common, disabled case).
+class ScopedSpan {
+public:
+  ScopedSpan(Watchdog *watchdog, const char *name) : watchdog_(watchdog) {
+    if (watchdog_) watchdog_->BeginSpan(name);
+  }
+  ~ScopedSpan() {
+    if (watchdog_) watchdog_->EndSpan();
+  }
+
+private:
+  Watchdog *watchdog_;
+};
+
+} // namespace stall_watchdog
+
+#endif // STALL_WATCHDOG_H
@@ -0,0 +1,285 @@
+#include "state_summary.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+
+#include "fs_util.h"
+#include "thread_pool.h"
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace state_summary {
+
+namespace {
+
+constexpr size_t kMaxPrefix = kHeaderSize + kMaxThumbWidth * kMaxThumbHeight * 4;
+
+uint16_t ReadU16(const uint8_t *p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadU32(const uint8_t *p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+double ReadF64(const uint8_t *p) {
+  uint64_t bits = static_cast<uint64_t>(ReadU32(p)) | (static_cast<uint64_t>(ReadU32(p + 4)) << 32);
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+std::string ReadField(const uint8_t *p, size_t length) {
+  const void *nul = memchr(p, 0, length);
+  size_t n = nul ? static_cast<size_t>(static_cast<const uint8_t *>(nul) - p) : length;
+  return std::string(reinterpret_cast<const char *>(p), n);
+}
+
+// Parse the container prefix. False for legacy raw states and for headers
+// that don't fit the file, which are then reported as legacy.
+bool ParseHeader(const uint8_t *data, size_t length, uint64_t file_size, Summary *summary) {
+  if (length < kHeaderSize || ReadU32(data) != kMagic || ReadU16(data + 4) != kVersion) {
+    return false;
+  }
+  uint32_t width = ReadU16(data + 6);
+  uint32_t height = ReadU16(data + 8);
+  uint64_t state_offset = ReadU32(data + 12);
+  uint64_t state_size = ReadU32(data + 16);
+  size_t thumb_bytes = static_cast<size_t>(width) * height * 4;
+  if (width > kMaxThumbWidth || height > kMaxThumbHeight ||
+      state_offset < kHeaderSize + thumb_bytes || state_offset + state_size > file_size ||
+      kHeaderSize + thumb_bytes > length) {
+    return false;
+  }
+
+  summary->has_header = true;
+  summary->created_at_ms = ReadF64(data + 24);
+  summary->state_size = state_size;
+  summary->core_name = ReadField(data + 32, 64);
+  summary->core_version = ReadField(data + 96, 32);
+  if (thumb_bytes > 0) {
+    summary->thumb_width = width;
+    summary->thumb_height = height;
+    summary->thumbnail.assign(data + kHeaderSize, data + kHeaderSize + thumb_bytes);
+  }
+  return true;
+}
+
+#ifndef _WIN32
+// pread until `length` bytes or EOF; returns the bytes read.
+size_t ReadAt(int fd, uint8_t *out, size_t length, off_t offset) {
+  size_t done = 0;
+  while (done < length) {
+    ssize_t n = pread(fd, out + done, length - done, offset + static_cast<off_t>(done));
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    done += static_cast<size_t>(n);
+  }
+  return done;
+}
+#endif
+
+} // namespace
+
+int SlotForFile(const std::string &name) {
+  if (name == "autosave.sav") return 99;
+  static const char kPrefix[] = "state-";
+  static const char kSuffix[] = ".sav";
+  size_t prefix = sizeof(kPrefix) - 1, suffix = sizeof(kSuffix) - 1;
+  if (name.size() <= prefix + suffix || name.compare(0, prefix, kPrefix) != 0 ||
+      name.compare(name.size() - suffix, suffix, kSuffix) != 0) {
+    return -1;
+  }
+  int slot = 0;
+  for (size_t i = prefix; i < name.size() - suffix; i++) {
+    char c = name[i];
+    if (c < '0' || c > '9' || slot > 9999) return -1;
+    slot = slot * 10 + (c - '0');
+  }
+  return slot;
+}
+
+#ifndef _WIN32
+
+bool ReadSummary(const std::string &path, Summary *summary, std::string *error) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    *error = std::string("cannot open state: ") + strerror(errno);
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    *error = std::string("cannot stat state: ") + strerror(errno);
+    close(fd);
+    return false;
+  }
+  uint64_t file_size = static_cast<uint64_t>(st.st_size);
+  summary->created_at_ms = fs_util::MtimeMs(st);
+  summary->state_size = file_size;
+
+  // Read the header, then just the thumbnail it describes; the state after
+  // it is never touched. Reads rather than a mapping, because the worker
+  // rewrites states in place and a mapped read past a truncated end would
+  // SIGBUS this process.
+  uint8_t header[kHeaderSize];
+  if (file_size >= kHeaderSize && ReadAt(fd, header, kHeaderSize, 0) == kHeaderSize &&
+      ReadU32(header) == kMagic) {
+    size_t thumb_bytes = static_cast<size_t>(ReadU16(header + 6)) * ReadU16(header + 8) * 4;
+    size_t length = static_cast<size_t>(
+        std::min<uint64_t>({file_size, kMaxPrefix, kHeaderSize + thumb_bytes}));
+    std::vector<uint8_t> prefix(header, header + kHeaderSize);
+    prefix.resize(length);
+    length = kHeaderSize + ReadAt(fd, prefix.data() + kHeaderSize, length - kHeaderSize,
+                                  static_cast<off_t>(kHeaderSize));
+    ParseHeader(prefix.data(), length, file_size, summary);
+  }
+  close(fd);
+  return true;
+}
+
+#else
+
+bool ReadSummary(const std::string &, Summary *, std::string *error) {
+  *error = "not supported on this platform";
+  return false;
+}
+
+#endif // !_WIN32
+
+} // namespace state_summary
+
+// ---------------------------------------------------------------------------
+// N-API
+// ---------------------------------------------------------------------------
+
+namespace {
+
+class ReadSummariesWorker : public Napi::AsyncWorker {
+public:
+  ReadSummariesWorker(Napi::Env env, std::string dir)
+      : Napi::AsyncWorker(env),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        dir_(std::move(dir)) {}
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+protected:
+  void Execute() override {
+#ifndef _WIN32
+    DIR *d = opendir(dir_.c_str());
+    if (!d) return; // no states for this game yet
+    while (struct dirent *entry = readdir(d)) {
+      std::string name = entry->d_name;
+      int slot = state_summary::SlotForFile(name);
+      if (slot < 0) continue;
+      state_summary::Summary summary;
+      summary.file = std::move(name);
+      summary.slot = slot;
+      summaries_.push_back(std::move(summary));
+    }
+    closedir(d);
+    if (summaries_.empty()) return;
+
+    // A couple of small reads per file; overlap them for a full slot grid.
+    std::vector<char> ok(summaries_.size(), 0);
+    ThreadPool pool(std::min(ThreadPool::DefaultThreadCount(), summaries_.size()));
+    for (size_t i = 0; i < summaries_.size(); i++) {
+      pool.Submit([this, i, &ok] {
+        std::string error;
+        ok[i] = state_summary::ReadSummary(fs_util::JoinPath(dir_, summaries_[i].file),
+                                           &summaries_[i], &error);
+      });
+    }
+    pool.Wait();
+
+    size_t kept = 0;
+    for (size_t i = 0; i < summaries_.size(); i++) {
+      if (ok[i]) summaries_[kept++] = std::move(summaries_[i]);
+    }
+    summaries_.resize(kept);
+    std::sort(summaries_.begin(), summaries_.end(),
+              [](const state_summary::Summary &a, const state_summary::Summary &b) {
+                return a.slot < b.slot;
+              });
+#else
+    SetError("Native state summaries are not supported on this platform");
+#endif
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    size_t total = 0;
+    for (const auto &summary : summaries_) total += summary.thumbnail.size();
+    Napi::Buffer<uint8_t> pixels = Napi::Buffer<uint8_t>::New(env, total);
+
+    Napi::Array states = Napi::Array::New(env, summaries_.size());
+    size_t offset = 0;
+    for (size_t i = 0; i < summaries_.size(); i++) {
+      const auto &summary = summaries_[i];
+      Napi::Object o = Napi::Object::New(env);
+      o.Set("slot", Napi::Number::New(env, summary.slot));
+      o.Set("file", Napi::String::New(env, summary.file));
+      o.Set("createdAt", Napi::Number::New(env, summary.created_at_ms));
+      o.Set("stateSize", Napi::Number::New(env, static_cast<double>(summary.state_size)));
+      if (summary.has_header) {
+        o.Set("coreName", Napi::String::New(env, summary.core_name));
+        o.Set("coreVersion", Napi::String::New(env, summary.core_version));
+      } else {
+        o.Set("coreName", env.Null());
+        o.Set("coreVersion", env.Null());
+      }
+      if (summary.thumbnail.empty()) {
+        o.Set("thumbnail", env.Null());
+      } else {
+        memcpy(pixels.Data() + offset, summary.thumbnail.data(), summary.thumbnail.size());
+        Napi::Object thumb = Napi::Object::New(env);
+        thumb.Set("width", Napi::Number::New(env, summary.thumb_width));
+        thumb.Set("height", Napi::Number::New(env, summary.thumb_height));
+        thumb.Set("offset", Napi::Number::New(env, static_cast<double>(offset)));
+        o.Set("thumbnail", thumb);
+        offset += summary.thumbnail.size();
+      }
+      states.Set(static_cast<uint32_t>(i), o);
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("states", states);
+    result.Set("pixels", pixels);
+    deferred_.Resolve(result);
+  }
+
+  void OnError(const Napi::Error &error) override { deferred_.Reject(error.Value()); }
+
+private:
+  Napi::Promise::Deferred deferred_;
+  std::string dir_;
+  std::vector<state_summary::Summary> summaries_;
+};
+
+} // namespace
+
+void StateSummaryReader::Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("readStateSummaries",
+              Napi::Function::New(env, ReadStateSummaries, "readStateSummaries"));
+}
+
+Napi::Value StateSummaryReader::ReadStateSummaries(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected (dir: string)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  auto *worker = new ReadSummariesWorker(env, info[0].As<Napi::String>().Utf8Value());
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
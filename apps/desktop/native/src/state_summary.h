@@ -0,0 +1,64 @@
+#ifndef STATE_SUMMARY_H
+#define STATE_SUMMARY_H
+
+#include <napi.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Save-state slot previews without a running core.
+//
+// States written by the core worker start with a 128-byte header and a
+// small RGBA thumbnail (see src/main/workers/save-state-container.ts for the
+// layout). Only that prefix is read; the core's state after it is never
+// touched. Legacy raw states are reported from stat() alone, without a
+// thumbnail.
+namespace state_summary {
+
+constexpr uint32_t kMagic = 0x54534c47; // "GLST"
+constexpr uint16_t kVersion = 1;
+constexpr size_t kHeaderSize = 128;
+constexpr uint32_t kMaxThumbWidth = 160;
+constexpr uint32_t kMaxThumbHeight = 120;
+
+struct Summary {
+  std::string file; // basename
+  int slot = 0;
+  bool has_header = false;
+  double created_at_ms = 0; // header time, or mtime for legacy states
+  uint64_t state_size = 0;
+  std::string core_name;
+  std::string core_version;
+  uint32_t thumb_width = 0;
+  uint32_t thumb_height = 0;
+  std::vector<uint8_t> thumbnail; // RGBA8888, thumb_width * thumb_height * 4
+};
+
+// Slot for a save state basename: `state-<n>.sav` → n, `autosave.sav` → 99
+// (the same mapping as the worker's listSaveStates). -1 for other files.
+int SlotForFile(const std::string &name);
+
+// Read the summary of one state file.
+bool ReadSummary(const std::string &path, Summary *summary, std::string *error);
+
+} // namespace state_summary
+
+// N-API wrapper:
+//
+//   readStateSummaries(dir)
+//     → Promise<{ states: Array<{ slot, file, createdAt, stateSize, coreName,
+//                                 coreVersion, thumbnail }>, pixels: Buffer }>
+//
+// States are sorted by slot. `thumbnail` is { width, height, offset } into
+// `pixels`, which packs every thumbnail back to back, or null. A missing
+// directory resolves with no states; unreadable files are skipped.
+class StateSummaryReader {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+
+private:
+  static Napi::Value ReadStateSummaries(const Napi::CallbackInfo &info);
+};
+
+#endif // STATE_SUMMARY_H
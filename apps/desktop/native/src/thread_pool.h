@@ -0,0 +1,98 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size worker pool shared by the background native services (library
+// scanning, hashing, decoding). Tasks may submit further tasks; Wait() blocks
+// until the queue is drained and every worker is idle, which makes recursive
+// fan-out (e.g. one task per directory) terminate cleanly.
+class ThreadPool {
+public:
+  explicit ThreadPool(size_t threads = 0) {
+    if (threads == 0) threads = DefaultThreadCount();
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; i++) {
+      workers_.emplace_back([this] { WorkerLoop(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    task_cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  void Submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+      outstanding_++;
+    }
+    task_cv_.notify_one();
+  }
+
+  // Block until every submitted task (including tasks submitted by tasks)
+  // has finished.
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this] { return outstanding_ == 0; });
+  }
+
+  size_t Size() const { return workers_.size(); }
+
+  // Leave one hardware thread for the main/emulation thread, but always use
+  // at least two workers so I/O-bound tasks overlap.
+  static size_t DefaultThreadCount() {
+    size_t hw = std::thread::hardware_concurrency();
+    if (hw <= 2) return 2;
+    return std::min<size_t>(hw - 1, 16);
+  }
+
+private:
+  void WorkerLoop() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        task_cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+        if (tasks_.empty()) return; // stopping_ and drained
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+
+      task();
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        outstanding_--;
+        if (outstanding_ == 0) idle_cv_.notify_all();
+      }
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable task_cv_;
+  std::condition_variable idle_cv_;
+  size_t outstanding_ = 0;
+  bool stopping_ = false;
+};
+
+#endif // THREAD_POOL_H
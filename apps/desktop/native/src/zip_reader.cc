@@ -0,0 +1,400 @@
+#include "zip_reader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#include "thread_pool.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace zip_reader {
+
+namespace {
+
+constexpr uint32_t kEocdSignature = 0x06054b50;
+constexpr uint32_t kEocd64Signature = 0x06064b50;
+constexpr uint32_t kEocd64LocatorSignature = 0x07064b50;
+constexpr uint32_t kCentralHeaderSignature = 0x02014b50;
+
+constexpr size_t kEocdSize = 22;
+constexpr size_t kEocd64Size = 56;
+constexpr size_t kEocd64LocatorSize = 20;
+constexpr size_t kCentralHeaderSize = 46;
+constexpr size_t kMaxCommentSize = 0xFFFF;
+
+uint16_t ReadU16(const uint8_t *p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadU32(const uint8_t *p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t ReadU64(const uint8_t *p) {
+  return static_cast<uint64_t>(ReadU32(p)) | (static_cast<uint64_t>(ReadU32(p + 4)) << 32);
+}
+
+// One byte range of a file, copied into memory. The library watcher scans
+// archives while they are still being written or replaced, so a mapping
+// could SIGBUS this process when the file shrinks under it; a short read is
+// just an error.
+class FileRegion {
+public:
+#ifdef _WIN32
+  bool Load(FILE *file, uint64_t offset, size_t length, std::string *error) {
+    data_.resize(length);
+    if (_fseeki64(file, static_cast<long long>(offset), SEEK_SET) != 0 ||
+        fread(data_.data(), 1, length, file) != length) {
+      *error = "cannot read archive";
+      return false;
+    }
+    return true;
+  }
+#else
+  bool Load(int fd, uint64_t offset, size_t length, std::string *error) {
+    data_.resize(length);
+    size_t done = 0;
+    while (done < length) {
+      ssize_t n = pread(fd, data_.data() + done, length - done, static_cast<off_t>(offset + done));
+      if (n < 0 && errno == EINTR) continue;
+      if (n < 0) {
+        *error = std::string("cannot read archive: ") + strerror(errno);
+        return false;
+      }
+      if (n == 0) {
+        *error = "archive was truncated while reading";
+        return false;
+      }
+      done += static_cast<size_t>(n);
+    }
+    return true;
+  }
+#endif
+
+  const uint8_t *data() const { return data_.data(); }
+  size_t size() const { return data_.size(); }
+
+private:
+  std::vector<uint8_t> data_;
+};
+
+class ArchiveFile {
+public:
+  explicit ArchiveFile(const std::string &path) {
+#ifdef _WIN32
+    file_ = fopen(path.c_str(), "rb");
+    if (file_ && _fseeki64(file_, 0, SEEK_END) == 0) {
+      size_ = static_cast<uint64_t>(_ftelli64(file_));
+    }
+#else
+    fd_ = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd_ >= 0 && fstat(fd_, &st) == 0) size_ = static_cast<uint64_t>(st.st_size);
+#endif
+  }
+
+  ~ArchiveFile() {
+#ifdef _WIN32
+    if (file_) fclose(file_);
+#else
+    if (fd_ >= 0) close(fd_);
+#endif
+  }
+
+#ifdef _WIN32
+  bool IsOpen() const { return file_ != nullptr; }
+#else
+  bool IsOpen() const { return fd_ >= 0; }
+#endif
+  uint64_t Size() const { return size_; }
+
+  bool Load(FileRegion *region, uint64_t offset, uint64_t length, std::string *error) const {
+    if (offset > size_ || length > size_ - offset) {
+      *error = "central directory is out of bounds";
+      return false;
+    }
+#ifdef _WIN32
+    return region->Load(file_, offset, static_cast<size_t>(length), error);
+#else
+    return region->Load(fd_, offset, static_cast<size_t>(length), error);
+#endif
+  }
+
+private:
+#ifdef _WIN32
+  FILE *file_ = nullptr;
+#else
+  int fd_ = -1;
+#endif
+  uint64_t size_ = 0;
+};
+
+struct Directory {
+  uint64_t offset = 0;
+  uint64_t size = 0;
+  uint64_t count = 0;
+};
+
+// Locate the central directory from the EOCD record (and the ZIP64 record
+// when any EOCD field is saturated).
+bool FindDirectory(const ArchiveFile &file, Directory *dir, std::string *error) {
+  uint64_t file_size = file.Size();
+  if (file_size < kEocdSize) {
+    *error = "not a zip archive";
+    return false;
+  }
+  uint64_t tail_size = std::min<uint64_t>(file_size, kEocdSize + kMaxCommentSize + kEocd64LocatorSize);
+  FileRegion tail;
+  if (!file.Load(&tail, file_size - tail_size, tail_size, error)) return false;
+
+  // The EOCD ends the file, followed only by its comment (and occasionally
+  // junk appended by broken tools). Scan backwards for a signature whose
+  // comment fits in the file.
+  const uint8_t *t = tail.data();
+  int64_t eocd = -1;
+  for (int64_t i = static_cast<int64_t>(tail_size - kEocdSize); i >= 0; i--) {
+    if (ReadU32(t + i) == kEocdSignature &&
+        static_cast<uint64_t>(i) + kEocdSize + ReadU16(t + i + 20) <= tail_size) {
+      eocd = i;
+      break;
+    }
+  }
+  if (eocd < 0) {
+    *error = "not a zip archive (end of central directory not found)";
+    return false;
+  }
+
+  const uint8_t *e = t + eocd;
+  dir->count = ReadU16(e + 10);
+  dir->size = ReadU32(e + 12);
+  dir->offset = ReadU32(e + 16);
+
+  bool zip64 = dir->count == 0xFFFF || dir->size == 0xFFFFFFFF || dir->offset == 0xFFFFFFFF;
+  if (zip64 && eocd >= static_cast<int64_t>(kEocd64LocatorSize) &&
+      ReadU32(e - kEocd64LocatorSize) == kEocd64LocatorSignature) {
+    uint64_t record_offset = ReadU64(e - kEocd64LocatorSize + 8);
+    FileRegion record;
+    if (!file.Load(&record, record_offset, kEocd64Size, error)) return false;
+    if (ReadU32(record.data()) != kEocd64Signature) {
+      *error = "invalid ZIP64 end of central directory";
+      return false;
+    }
+    dir->count = ReadU64(record.data() + 32);
+    dir->size = ReadU64(record.data() + 40);
+    dir->offset = ReadU64(record.data() + 48);
+  }
+
+  if (dir->offset > file_size || dir->size > file_size - dir->offset ||
+      dir->count > dir->size / kCentralHeaderSize) {
+    *error = "central directory is out of bounds";
+    return false;
+  }
+  return true;
+}
+
+// Replace saturated 32-bit fields from the ZIP64 extended information extra
+// field. Values appear in a fixed order, only for fields that overflowed.
+void ApplyZip64Extra(const uint8_t *extra, size_t length, Entry *entry) {
+  size_t pos = 0;
+  while (pos + 4 <= length) {
+    uint16_t id = ReadU16(extra + pos);
+    uint16_t size = ReadU16(extra + pos + 2);
+    pos += 4;
+    if (pos + size > length) return;
+    if (id == 0x0001) {
+      const uint8_t *p = extra + pos;
+      const uint8_t *end = p + size;
+      if (entry->uncompressed_size == 0xFFFFFFFF && p + 8 <= end) {
+        entry->uncompressed_size = ReadU64(p);
+        p += 8;
+      }
+      if (entry->compressed_size == 0xFFFFFFFF && p + 8 <= end) {
+        entry->compressed_size = ReadU64(p);
+        p += 8;
+      }
+      if (entry->local_header_offset == 0xFFFFFFFF && p + 8 <= end) {
+        entry->local_header_offset = ReadU64(p);
+      }
+      return;
+    }
+    pos += size;
+  }
+}
+
+} // namespace
+
+bool ReadCentralDirectory(const std::string &path, std::vector<Entry> *entries,
+                          std::string *error) {
+  entries->clear();
+  ArchiveFile file(path);
+  if (!file.IsOpen()) {
+    *error = std::string("cannot open archive: ") + strerror(errno);
+    return false;
+  }
+
+  Directory dir;
+  if (!FindDirectory(file, &dir, error)) return false;
+  if (dir.count == 0) return true;
+
+  FileRegion region;
+  if (!file.Load(&region, dir.offset, dir.size, error)) return false;
+
+  const uint8_t *cd = region.data();
+  size_t pos = 0;
+  entries->reserve(static_cast<size_t>(dir.count));
+  for (uint64_t i = 0; i < dir.count; i++) {
+    if (pos + kCentralHeaderSize > region.size() || ReadU32(cd + pos) != kCentralHeaderSignature) {
+      *error = "invalid central directory entry";
+      return false;
+    }
+    const uint8_t *h = cd + pos;
+    size_t name_length = ReadU16(h + 28);
+    size_t extra_length = ReadU16(h + 30);
+    size_t comment_length = ReadU16(h + 32);
+    size_t record_size = kCentralHeaderSize + name_length + extra_length + comment_length;
+    if (pos + record_size > region.size()) {
+      *error = "invalid central directory entry";
+      return false;
+    }
+
+    std::string name(reinterpret_cast<const char *>(h + kCentralHeaderSize), name_length);
+    pos += record_size;
+    if (name.empty() || name.back() == '/' || name.compare(0, 9, "__MACOSX/") == 0) continue;
+
+    Entry entry;
+    entry.name = std::move(name);
+    entry.method = ReadU16(h + 10);
+    entry.crc32 = ReadU32(h + 16);
+    entry.compressed_size = ReadU32(h + 20);
+    entry.uncompressed_size = ReadU32(h + 24);
+    entry.local_header_offset = ReadU32(h + 42);
+    ApplyZip64Extra(h + kCentralHeaderSize + name_length, extra_length, &entry);
+    entries->push_back(std::move(entry));
+  }
+  return true;
+}
+
+} // namespace zip_reader
+
+// ---------------------------------------------------------------------------
+// N-API
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct ZipResult {
+  std::vector<zip_reader::Entry> entries;
+  std::string error;
+  bool ok = false;
+};
+
+class ReadZipsWorker : public Napi::AsyncWorker {
+public:
+  ReadZipsWorker(Napi::Env env, std::vector<std::string> paths, size_t threads)
+      : Napi::AsyncWorker(env),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        paths_(std::move(paths)),
+        threads_(threads),
+        results_(paths_.size()) {}
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+protected:
+  void Execute() override {
+    // Opening the archive dominates, so fan out even for small batches.
+    size_t threads = threads_ ? threads_ : ThreadPool::DefaultThreadCount();
+    ThreadPool pool(std::min(threads, std::max<size_t>(paths_.size(), 1)));
+    for (size_t i = 0; i < paths_.size(); i++) {
+      pool.Submit([this, i] {
+        ZipResult &result = results_[i];
+        result.ok = zip_reader::ReadCentralDirectory(paths_[i], &result.entries, &result.error);
+      });
+    }
+    pool.Wait();
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::Array out = Napi::Array::New(env, results_.size());
+    char crc[9];
+    for (size_t i = 0; i < results_.size(); i++) {
+      const ZipResult &result = results_[i];
+      Napi::Object o = Napi::Object::New(env);
+      if (!result.ok) {
+        o.Set("error", Napi::String::New(env, result.error));
+        out.Set(static_cast<uint32_t>(i), o);
+        continue;
+      }
+      Napi::Array entries = Napi::Array::New(env, result.entries.size());
+      for (size_t j = 0; j < result.entries.size(); j++) {
+        const zip_reader::Entry &entry = result.entries[j];
+        snprintf(crc, sizeof(crc), "%08x", entry.crc32);
+        Napi::Object e = Napi::Object::New(env);
+        e.Set("name", Napi::String::New(env, entry.name));
+        e.Set("size", Napi::Number::New(env, static_cast<double>(entry.uncompressed_size)));
+        e.Set("compressedSize", Napi::Number::New(env, static_cast<double>(entry.compressed_size)));
+        e.Set("crc32", Napi::String::New(env, crc));
+        e.Set("method", Napi::Number::New(env, entry.method));
+        entries.Set(static_cast<uint32_t>(j), e);
+      }
+      o.Set("entries", entries);
+      out.Set(static_cast<uint32_t>(i), o);
+    }
+    deferred_.Resolve(out);
+  }
+
+  void OnError(const Napi::Error &error) override { deferred_.Reject(error.Value()); }
+
+private:
+  Napi::Promise::Deferred deferred_;
+  std::vector<std::string> paths_;
+  size_t threads_;
+  std::vector<ZipResult> results_;
+};
+
+} // namespace
+
+void ZipReader::Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("readZipDirectories",
+              Napi::Function::New(env, ReadZipDirectories, "readZipDirectories"));
+}
+
+Napi::Value ZipReader::ReadZipDirectories(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected (paths: string[], options?: object)")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Array arr = info[0].As<Napi::Array>();
+  std::vector<std::string> paths;
+  paths.reserve(arr.Length());
+  for (uint32_t i = 0; i < arr.Length(); i++) {
+    Napi::Value v = arr.Get(i);
+    if (!v.IsString()) {
+      Napi::TypeError::New(env, "paths must be strings").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    paths.push_back(v.As<Napi::String>().Utf8Value());
+  }
+
+  size_t threads = 0;
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Value t = info[1].As<Napi::Object>().Get("threads");
+    if (t.IsNumber()) threads = static_cast<size_t>(std::max(0, t.As<Napi::Number>().Int32Value()));
+  }
+
+  auto *worker = new ReadZipsWorker(env, std::move(paths), threads);
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
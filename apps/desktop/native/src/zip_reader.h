@@ -0,0 +1,53 @@
+#ifndef ZIP_READER_H
+#define ZIP_READER_H
+
+#include <napi.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ZIP central-directory reader for library scanning.
+//
+// Only the end-of-central-directory record (the last 64 KiB + 22 bytes of
+// the file at most) and the central directory itself are read (pread into a
+// buffer, so an archive rewritten mid-scan fails cleanly instead of faulting);
+// nothing is decompressed and local headers are never touched. ZIP64
+// archives are handled through the EOCD64 locator and the 0x0001 extra
+// field. The CRC32 stored per entry is the CRC of the uncompressed data, so
+// it can identify a ROM without extracting it.
+namespace zip_reader {
+
+struct Entry {
+  std::string name;
+  uint64_t compressed_size = 0;
+  uint64_t uncompressed_size = 0;
+  uint64_t local_header_offset = 0;
+  uint32_t crc32 = 0;
+  uint16_t method = 0;
+};
+
+// Entries of `path` in central-directory order, excluding directories and
+// macOS resource forks (`__MACOSX/`) — the same filter as utils/zip.ts.
+bool ReadCentralDirectory(const std::string &path, std::vector<Entry> *entries,
+                          std::string *error);
+
+} // namespace zip_reader
+
+// N-API wrapper:
+//
+//   readZipDirectories(paths, { threads? }?)
+//     → Promise<Array<{ entries: Array<{ name, size, compressedSize,
+//                                        crc32, method }> } | { error }>>
+//
+// Results are in input order; `crc32` is 8 lowercase hex digits, the format
+// used for Game.romHashes.
+class ZipReader {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+
+private:
+  static Napi::Value ReadZipDirectories(const Napi::CallbackInfo &info);
+};
+
+#endif // ZIP_READER_H
@@ -13,6 +13,7 @@ import { setupAppMenu } from "./main/appMenu";
 import { IPCHandlers } from "./main/ipc/handlers";
 import { mainLog } from "./main/logger";
 import { AutoUpdaterService } from "./main/services/AutoUpdaterService";
+import { ThumbnailCache } from "./main/services/ThumbnailCache";
 import { initSentryMain } from "./main/sentry";
 import {
   getSavedWindowBounds,
@@ -174,10 +175,15 @@ app.on("ready", () => {
 
   // Register artwork:// protocol to serve cached cover art images
   // from the sandboxed renderer via <img src="artwork://gameId.png">.
+  // A `?w=<px>` query serves a downsized thumbnail for the library grid.
   // The CORP header is required because COEP require-corp is enabled above.
+  const artworkDirectory = path.join(app.getPath("userData"), "artwork");
+  const thumbnailCache = new ThumbnailCache(artworkDirectory);
   protocol.handle("artwork", async (request) => {
-    const filename = request.url.slice("artwork://".length);
-    const filePath = path.join(app.getPath("userData"), "artwork", filename);
+    const [filename, query = ""] = request.url.slice("artwork://".length).split("?");
+    const sourcePath = path.join(artworkDirectory, filename);
+    const width = Number(new URLSearchParams(query).get("w"));
+    const filePath = width > 0 ? await thumbnailCache.resolve(sourcePath, width) : sourcePath;
     const response = await net.fetch(`file://${filePath}`);
     const headers = new Headers(response.headers);
     headers.set("Cross-Origin-Resource-Policy", "same-origin");
@@ -595,6 +595,10 @@ export class GameWindowManager extends EventEmitter {
         this.activeWorkerClient?.setInputAnalog(port, index, id, value);
       },
     );
+
+    ipcMain.on("game:pointer", (_event, x: number, y: number, pressed: boolean) => {
+      this.activeWorkerClient?.setPointer(x, y, pressed);
+    });
   }
 
   destroy(): void {
@@ -616,5 +620,6 @@ export class GameWindowManager extends EventEmitter {
     ipcMain.removeAllListeners("game-window:ready-to-close");
     ipcMain.removeAllListeners("game:input");
     ipcMain.removeAllListeners("game:input-analog");
+    ipcMain.removeAllListeners("game:pointer");
   }
 }
@@ -0,0 +1,147 @@
+import { describe, it, expect } from "vitest";
+import {
+  chooseDefaultCores,
+  runCoreMatrix,
+  sustainsFullSpeed,
+  type BenchmarkWorker,
+  type CoreMatrixEntry,
+} from "./CoreBenchmark";
+import type { BenchmarkResult } from "../workers/core-worker-protocol";
+
+function result(fps: number, p99Ms: number, targetFps = 60): BenchmarkResult {
+  return {
+    fps,
+    frameTimeMeanMs: 1000 / fps,
+    frameTimeP99Ms: p99Ms,
+    frameTimeStdDevMs: 0.1,
+    frames: 100,
+    loadMs: 5,
+    serializeMs: 0.5,
+    stateSize: 1024,
+    targetFps,
+  };
+}
+
+function entry(coreName: string, benchmark: BenchmarkResult | null): CoreMatrixEntry {
+  return {
+    bootMs: benchmark ? 100 : null,
+    coreName,
+    error: benchmark ? null : "Failed to load game",
+    result: benchmark,
+    romPath: "/roms/game.sfc",
+    systemId: "snes",
+  };
+}
+
+describe("runCoreMatrix", () => {
+  it("runs every candidate core per game in its own worker", async () => {
+    let live = 0;
+    let peak = 0;
+    const initialized: Array<string> = [];
+    let destroyed = 0;
+
+    const createWorker = (): BenchmarkWorker => {
+      let corePath = "";
+      return {
+        benchmark: async () => {
+          await new Promise((resolve) => setTimeout(resolve, 5));
+          if (corePath.includes("broken")) {
+            throw new Error("core crashed");
+          }
+          return result(corePath.includes("fast") ? 900 : 300, 3);
+        },
+        destroy: async () => {
+          live--;
+          destroyed++;
+        },
+        init: async (options) => {
+          live++;
+          peak = Math.max(peak, live);
+          corePath = options.corePath;
+          initialized.push(`${options.corePath}:${options.romPath}`);
+        },
+      };
+    };
+
+    const entries = await runCoreMatrix(
+      [
+        { romPath: "/roms/a.sfc", systemId: "snes" },
+        { romPath: "/roms/b.sfc", systemId: "snes" },
+      ],
+      {
+        candidates: () => [
+          { coreName: "fast_libretro", corePath: "/cores/fast" },
+          { coreName: "slow_libretro", corePath: "/cores/slow" },
+          { coreName: "broken_libretro", corePath: "/cores/broken" },
+        ],
+        concurrency: 2,
+        createWorker,
+        initOptions: (game, core) => ({
+          addonPath: "/addon.node",
+          corePath: core.corePath,
+          romPath: game.romPath,
+          saveDir: "/tmp",
+          saveStatesDir: "/tmp",
+          sramDir: "/tmp",
+          systemDir: "/bios",
+        }),
+      },
+    );
+
+    expect(initialized).toHaveLength(6);
+    expect(destroyed).toBe(6);
+    expect(peak).toBe(2);
+    expect(entries.map((e) => `${e.coreName}:${e.romPath}`)).toEqual([
+      "fast_libretro:/roms/a.sfc",
+      "slow_libretro:/roms/a.sfc",
+      "broken_libretro:/roms/a.sfc",
+      "fast_libretro:/roms/b.sfc",
+      "slow_libretro:/roms/b.sfc",
+      "broken_libretro:/roms/b.sfc",
+    ]);
+    expect(entries[0].result?.fps).toBe(900);
+    expect(entries[0].bootMs).not.toBe(null);
+    expect(entries[2].result).toBe(null);
+    expect(entries[2].error).toBe("core crashed");
+  });
+});
+
+describe("sustainsFullSpeed", () => {
+  it("needs the 99th percentile within 80% of the frame budget", () => {
+    expect(sustainsFullSpeed(result(300, 13))).toBe(true);
+    expect(sustainsFullSpeed(result(300, 14))).toBe(false);
+    expect(sustainsFullSpeed(result(300, 15, 50))).toBe(true);
+  });
+});
+
+describe("chooseDefaultCores", () => {
+  const preference = () => ["bsnes_libretro", "snes9x_libretro"];
+
+  it("keeps the preferred core when it runs at full speed", () => {
+    const defaults = chooseDefaultCores(
+      [entry("snes9x_libretro", result(2000, 1)), entry("bsnes_libretro", result(150, 9))],
+      preference,
+    );
+    expect(defaults).toEqual({ "/roms/game.sfc": "bsnes_libretro" });
+  });
+
+  it("falls back to the next core that runs at full speed", () => {
+    const defaults = chooseDefaultCores(
+      [entry("bsnes_libretro", result(58, 20)), entry("snes9x_libretro", result(2000, 1))],
+      preference,
+    );
+    expect(defaults).toEqual({ "/roms/game.sfc": "snes9x_libretro" });
+  });
+
+  it("takes the fastest core when none keeps up, and skips failed games", () => {
+    const defaults = chooseDefaultCores(
+      [
+        entry("bsnes_libretro", result(40, 30)),
+        entry("snes9x_libretro", result(55, 19)),
+        { ...entry("snes9x_libretro", null), romPath: "/roms/broken.sfc" },
+      ],
+      preference,
+    );
+    expect(defaults).toEqual({ "/roms/game.sfc": "snes9x_libretro" });
+  });
+});
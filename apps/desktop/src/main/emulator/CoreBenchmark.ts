@@ -0,0 +1,159 @@
+import * as os from "node:os";
+import { performance } from "node:perf_hooks";
+import type { BenchmarkResult } from "../workers/core-worker-protocol";
+import type { EmulationWorkerInitOptions } from "./EmulationWorkerClient";
+
+/** Frames run (and discarded) before timing starts, past boot screens and JIT warmup. */
+export const DEFAULT_WARMUP_FRAMES = 600;
+
+/** Frames timed per combination (~50 seconds of play at 60fps). */
+export const DEFAULT_BENCHMARK_FRAMES = 3000;
+
+/** The subset of EmulationWorkerClient the runner drives. */
+export interface BenchmarkWorker {
+  init(options: EmulationWorkerInitOptions): Promise<unknown>;
+  benchmark(warmupFrames: number, frames: number): Promise<BenchmarkResult>;
+  destroy(): Promise<void>;
+}
+
+export interface CoreMatrixGame {
+  romPath: string;
+  systemId: string;
+}
+
+export interface CoreCandidate {
+  coreName: string;
+  corePath: string;
+}
+
+/** One (game, core) cell of the matrix. */
+export interface CoreMatrixEntry {
+  romPath: string;
+  systemId: string;
+  coreName: string;
+  /** Worker spawn to ready, including content load. Null if it never booted. */
+  bootMs: number | null;
+  result: BenchmarkResult | null;
+  error: string | null;
+}
+
+export interface CoreMatrixOptions {
+  /** Installed cores to try for a system, in preference order. */
+  candidates: (systemId: string) => Array<CoreCandidate>;
+  /** Worker init options for one combination. */
+  initOptions: (game: CoreMatrixGame, core: CoreCandidate) => EmulationWorkerInitOptions;
+  createWorker: () => BenchmarkWorker;
+  /** Workers alive at once. Defaults to one per core, minus one. */
+  concurrency?: number;
+  warmupFrames?: number;
+  frames?: number;
+  onEntry?: (entry: CoreMatrixEntry) => void;
+}
+
+/**
+ * Benchmark every installed candidate core against every game.
+ *
+ * Each combination gets its own emulation worker: libretro cores keep
+ * process-global state (and the addon's LibretroCore is a singleton), so a
+ * process is the unit of isolation. Up to `concurrency` run at once.
+ * Entries come back in game order, then preference order.
+ */
+export async function runCoreMatrix(
+  games: Array<CoreMatrixGame>,
+  options: CoreMatrixOptions,
+): Promise<Array<CoreMatrixEntry>> {
+  const cells = games.flatMap((game) =>
+    options.candidates(game.systemId).map((core) => ({ core, game })),
+  );
+  const concurrency = Math.max(
+    1,
+    Math.min(options.concurrency ?? os.availableParallelism() - 1, cells.length),
+  );
+  const entries = new Array<CoreMatrixEntry>(cells.length);
+
+  let next = 0;
+  const lane = async () => {
+    while (next < cells.length) {
+      const index = next++;
+      const { core, game } = cells[index];
+      entries[index] = await benchmarkOne(game, core, options);
+      options.onEntry?.(entries[index]);
+    }
+  };
+  await Promise.all(Array.from({ length: concurrency }, lane));
+  return entries;
+}
+
+async function benchmarkOne(
+  game: CoreMatrixGame,
+  core: CoreCandidate,
+  options: CoreMatrixOptions,
+): Promise<CoreMatrixEntry> {
+  const entry: CoreMatrixEntry = {
+    bootMs: null,
+    coreName: core.coreName,
+    error: null,
+    result: null,
+    romPath: game.romPath,
+    systemId: game.systemId,
+  };
+  const worker = options.createWorker();
+  try {
+    const startedAt = performance.now();
+    await worker.init(options.initOptions(game, core));
+    entry.bootMs = performance.now() - startedAt;
+    entry.result = await worker.benchmark(
+      options.warmupFrames ?? DEFAULT_WARMUP_FRAMES,
+      options.frames ?? DEFAULT_BENCHMARK_FRAMES,
+    );
+  } catch (error) {
+    entry.error = error instanceof Error ? error.message : String(error);
+  } finally {
+    await worker.destroy().catch(() => {});
+  }
+  return entry;
+}
+
+/**
+ * Whether a core keeps up with its own frame rate: 99% of frames fit the
+ * frame budget with 20% left for the renderer, audio and the OS.
+ */
+export function sustainsFullSpeed(result: BenchmarkResult): boolean {
+  return result.frameTimeP99Ms <= (1000 / result.targetFps) * 0.8;
+}
+
+/**
+ * Default core per game from a matrix: the first core in preference order
+ * (the accuracy-first order of the core list) that sustains full speed, or
+ * the fastest one when none does. Games with no working core are omitted.
+ */
+export function chooseDefaultCores(
+  entries: Array<CoreMatrixEntry>,
+  preference: (systemId: string) => Array<string>,
+): Record<string, string> {
+  const byGame = new Map<string, Array<CoreMatrixEntry & { result: BenchmarkResult }>>();
+  for (const entry of entries) {
+    if (!entry.result) {
+      continue;
+    }
+    const list = byGame.get(entry.romPath) ?? [];
+    list.push({ ...entry, result: entry.result });
+    byGame.set(entry.romPath, list);
+  }
+
+  const defaults: Record<string, string> = {};
+  for (const [romPath, working] of byGame) {
+    const order = preference(working[0].systemId);
+    const rank = (name: string) => {
+      const index = order.indexOf(name);
+      return index === -1 ? order.length : index;
+    };
+    working.sort((a, b) => rank(a.coreName) - rank(b.coreName));
+    const fullSpeed = working.find((entry) => sustainsFullSpeed(entry.result));
+    const fastest = working.reduce((best, entry) =>
+      entry.result.fps > best.result.fps ? entry : best,
+    );
+    defaults[romPath] = (fullSpeed ?? fastest).coreName;
+  }
+  return defaults;
+}
@@ -1,4 +1,5 @@
 import { describe, it, expect, vi, beforeEach, afterEach } from "vitest";
+import { utilityProcess } from "electron";
 import { EmulationWorkerClient } from "./EmulationWorkerClient";
 import type { WorkerEvent, AVInfo } from "../workers/core-worker-protocol";
 
@@ -151,6 +152,82 @@ describe("EmulationWorkerClient", () => {
     });
   });
 
+  describe("prewarm", () => {
+    async function prewarm(): Promise<void> {
+      const prewarmPromise = client.prewarm(TEST_INIT_OPTIONS);
+      emitWorkerMessage({ type: "preloaded", addonMs: 4, coreLoadMs: 20 });
+      await prewarmPromise;
+    }
+
+    it("loads the core without content and reports it as preloaded", async () => {
+      await prewarm();
+
+      expect(lastPostedMessage()).toEqual({
+        action: "preload",
+        addonPath: TEST_INIT_OPTIONS.addonPath,
+        corePath: TEST_INIT_OPTIONS.corePath,
+        saveDir: TEST_INIT_OPTIONS.saveDir,
+        systemDir: TEST_INIT_OPTIONS.systemDir,
+      });
+      expect(client.preloadedCore).toBe(TEST_INIT_OPTIONS.corePath);
+      expect(client.isRunning()).toBe(false);
+    });
+
+    it("reuses the parked worker when init asks for the same core", async () => {
+      await prewarm();
+      vi.mocked(utilityProcess.fork).mockClear();
+
+      const initPromise = client.init(TEST_INIT_OPTIONS);
+      emitWorkerMessage({ type: "ready", avInfo: TEST_AV_INFO, saveStatesSupported: true });
+      await initPromise;
+
+      expect(utilityProcess.fork).not.toHaveBeenCalled();
+      expect(mockKill).not.toHaveBeenCalled();
+      expect(client.preloadedCore).toBe(null);
+
+      const handler = vi.fn();
+      client.on("launchPhases", handler);
+      emitWorkerMessage({
+        type: "launchPhases",
+        phases: { addonMs: 4, coreLoadMs: 20, firstFrameMs: 16, gameLoadMs: 30, prewarmed: true },
+      });
+
+      expect(handler).toHaveBeenCalledTimes(1);
+      expect(client.getLaunchPhases()).toMatchObject({ gameLoadMs: 30, prewarmed: true });
+    });
+
+    it("replaces the parked worker when init asks for a different core", async () => {
+      await prewarm();
+      vi.mocked(utilityProcess.fork).mockClear();
+
+      const initPromise = client.init({ ...TEST_INIT_OPTIONS, corePath: "/cores/snes9x.dylib" });
+      emitWorkerMessage({ type: "ready", avInfo: TEST_AV_INFO, saveStatesSupported: true });
+      await initPromise;
+
+      expect(mockKill).toHaveBeenCalled();
+      expect(utilityProcess.fork).toHaveBeenCalledTimes(1);
+    });
+
+    it("kills the parked worker on shutdown without a handshake", async () => {
+      await prewarm();
+      mockPostMessage.mockClear();
+
+      await client.shutdown();
+
+      expect(mockKill).toHaveBeenCalled();
+      expect(mockPostMessage).not.toHaveBeenCalled();
+      expect(client.preloadedCore).toBe(null);
+    });
+
+    it("rejects and kills the worker when the core fails to preload", async () => {
+      const prewarmPromise = client.prewarm(TEST_INIT_OPTIONS);
+      emitWorkerMessage({ type: "error", message: "Failed to load core", fatal: true });
+
+      await expect(prewarmPromise).rejects.toThrow("Failed to load core");
+      expect(mockKill).toHaveBeenCalled();
+    });
+  });
+
   describe("fire-and-forget commands", () => {
     beforeEach(async () => {
       const initPromise = client.init(TEST_INIT_OPTIONS);
@@ -252,6 +329,50 @@ describe("EmulationWorkerClient", () => {
       await expect(screenshotPromise).resolves.toBe("/tmp/shot.raw");
     });
 
+    it("runUntil forwards conditions and returns the run result", async () => {
+      const runPromise = client.runUntil([{ type: "nonBlankFrame" }], 600);
+
+      const lastCall = lastPostedMessage();
+      expect(lastCall.action).toBe("runUntil");
+      expect(lastCall.conditions).toEqual([{ type: "nonBlankFrame" }]);
+      expect(lastCall.maxFrames).toBe(600);
+
+      // Longer than the default request timeout: fast-runs can take a while.
+      await vi.advanceTimersByTimeAsync(30_000);
+      const result = { elapsedMs: 812, frameHash: "0123456789abcdef", frames: 240, matched: 0 };
+      emitWorkerMessage({
+        type: "response",
+        requestId: lastCall.requestId,
+        success: true,
+        data: result,
+      });
+
+      await expect(runPromise).resolves.toEqual(result);
+    });
+
+    it("getMemoryStats returns the worker's memory snapshot", async () => {
+      const statsPromise = client.getMemoryStats();
+
+      const lastCall = lastPostedMessage();
+      expect(lastCall.action).toBe("getMemoryStats");
+
+      const stats = {
+        coreHeap: { framesSampled: 0, netGrowthBytes: 0, supported: true, tracking: false },
+        process: { peakRssBytes: 300_000_000, pssBytes: 180_000_000, rssBytes: 250_000_000 },
+        subsystems: { rom: { bytes: 0, highWater: 4_194_304 } },
+        totalBytes: 1_310_720,
+        totalHighWater: 5_505_024,
+      };
+      emitWorkerMessage({
+        type: "response",
+        requestId: lastCall.requestId,
+        success: true,
+        data: stats,
+      });
+
+      await expect(statsPromise).resolves.toEqual(stats);
+    });
+
     it("request times out after 10 seconds", async () => {
       let caughtError: unknown = null;
       const savePromise = client.saveState(0).catch((error: unknown) => {
@@ -310,6 +431,29 @@ describe("EmulationWorkerClient", () => {
       });
     });
 
+    it("emits stall reports from worker", () => {
+      const handler = vi.fn();
+      client.on("stall", handler);
+
+      const report = {
+        frame: 90,
+        frameMs: 480,
+        io: {
+          involuntarySwitches: 0,
+          majorFaults: 0,
+          readBytes: 0,
+          voluntarySwitches: 2,
+          writeBytes: 0,
+        },
+        spans: [],
+        stack: ["core.dylib!retro_run+0x40"],
+        stalledMs: 260,
+      };
+      emitWorkerMessage({ type: "stall", report });
+
+      expect(handler).toHaveBeenCalledWith(report);
+    });
+
     it("emits error events from worker", () => {
       const handler = vi.fn();
       client.on("error", handler);
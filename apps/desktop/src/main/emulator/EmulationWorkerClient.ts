@@ -2,13 +2,24 @@ import { utilityProcess, UtilityProcess } from "electron";
 import { EventEmitter } from "node:events";
 import * as path from "node:path";
 import * as crypto from "node:crypto";
+import { performance } from "node:perf_hooks";
 import type {
   WorkerCommand,
   WorkerEvent,
   AVInfo,
+  BenchmarkResult,
+  InputStats,
+  LaunchPhases,
+  MemoryStats,
+  PowerStats,
+  RunCondition,
+  RunUntilResult,
   SaveStateMetadata,
+  ScreenLayout,
+  ScriptStats,
 } from "../workers/core-worker-protocol";
 import {
+  formatStallReport,
   RETRO_LOG_DEBUG,
   RETRO_LOG_INFO,
   RETRO_LOG_WARN,
@@ -18,7 +29,11 @@ import {
   computeVideoBufferSize,
   CTRL_SAB_BYTE_LENGTH,
   CTRL_AUDIO_SAMPLE_RATE,
+  CTRL_AUDIO_FILL,
+  AUDIO_FILL_UNKNOWN,
   AUDIO_RING_BYTE_LENGTH,
+  VIDEO_SLOT_COUNT,
+  initVideoSlots,
 } from "../workers/shared-frame-protocol";
 import { libretroLog } from "../logger";
 
@@ -38,6 +53,11 @@ export interface EmulationWorkerInitOptions {
   forceHWSaveStates?: boolean;
 }
 
+export type EmulationWorkerPrewarmOptions = Pick<
+  EmulationWorkerInitOptions,
+  "addonPath" | "corePath" | "saveDir" | "systemDir"
+>;
+
 interface PendingRequest {
   reject: (error: Error) => void;
   resolve: (data?: unknown) => void;
@@ -46,6 +66,8 @@ interface PendingRequest {
 
 const DEFAULT_REQUEST_TIMEOUT_MS = 10_000;
 const SHUTDOWN_TIMEOUT_MS = 5000;
+/** runUntil can legitimately fast-run tens of thousands of frames. */
+const RUN_UNTIL_TIMEOUT_MS = 120_000;
 
 /**
  * Main-process client for the emulation utility process.
@@ -58,6 +80,8 @@ const SHUTDOWN_TIMEOUT_MS = 5000;
  * - `videoFrame` — `{ data: Buffer, width: number, height: number }`
  * - `audioSamples` — `{ samples: Buffer, sampleRate: number }`
  * - `error` — `{ message: string, fatal: boolean }`
+ * - `stall` — `StallReport` for a frame that overran the watchdog threshold
+ * - `launchPhases` — `LaunchPhases` once the first frame has been produced
  */
 export interface SharedBuffers {
   audio: SharedArrayBuffer;
@@ -72,36 +96,97 @@ export class EmulationWorkerClient extends EventEmitter {
   private shuttingDown = false;
   private sharedBuffers: SharedBuffers | null = null;
   private detectedSerial: string | null = null;
+  /** Core loaded by `prewarm()` into a worker that has not been `init`ed yet. */
+  private preloadedCorePath: string | null = null;
+  private launchTiming: { prewarmed: boolean; readyAt: number; startedAt: number } | null =
+    null;
+  private lastLaunchPhases: LaunchPhases | null = null;
+  /** Rejects an in-flight `prewarm()` when its worker goes away. */
+  private abortPrewarm: ((error: Error) => void) | null = null;
 
   /**
-   * Spawn the utility process, load the core and ROM, and start the
-   * emulation loop. Resolves with AV info once the worker is ready.
+   * Spawn the utility process and load the core without any content, so a
+   * later `init()` for the same core only has to load the game. Rejects
+   * (and kills the worker) if the core fails to load.
    */
-  async init(
-    options: EmulationWorkerInitOptions,
-  ): Promise<{ avInfo: AVInfo; saveStatesSupported: boolean }> {
+  async prewarm(options: EmulationWorkerPrewarmOptions): Promise<void> {
     if (this.workerProcess) {
       await this.destroy();
     }
+    const proc = this.spawn();
+
+    await new Promise<void>((resolve, reject) => {
+      const onMessage = (event: WorkerEvent) => {
+        if (event.type === "preloaded") {
+          settle();
+          libretroLog.info(
+            `Prewarmed worker for ${path.basename(options.corePath)}: addon ` +
+              `${event.addonMs.toFixed(1)}ms, core ${event.coreLoadMs.toFixed(1)}ms`,
+          );
+          resolve();
+        } else if (event.type === "error" && event.fatal) {
+          settle();
+          reject(new Error(event.message));
+        }
+      };
+      const settle = () => {
+        clearTimeout(preloadTimeout);
+        proc.removeListener("message", onMessage);
+        this.abortPrewarm = null;
+      };
+      proc.on("message", onMessage);
+      this.abortPrewarm = (error) => {
+        settle();
+        reject(error);
+      };
+
+      const preloadTimeout = setTimeout(() => {
+        settle();
+        reject(new Error("Emulation worker did not preload within 10 seconds"));
+      }, DEFAULT_REQUEST_TIMEOUT_MS);
+
+      const preloadCommand: WorkerCommand = {
+        action: "preload",
+        addonPath: options.addonPath,
+        corePath: options.corePath,
+        saveDir: options.saveDir,
+        systemDir: options.systemDir,
+      };
+      proc.postMessage(preloadCommand);
+    }).catch((error: unknown) => {
+      proc.kill();
+      throw error;
+    });
 
-    const workerPath = path.join(__dirname, "workers/core-worker.mjs");
+    this.preloadedCorePath = options.corePath;
+  }
 
-    this.workerProcess = utilityProcess.fork(workerPath, [], {
-      serviceName: "LibretroCore",
-    });
+  /** Core path a parked, prewarmed worker is holding, or null. */
+  get preloadedCore(): string | null {
+    return this.preloadedCorePath;
+  }
 
-    this.workerProcess.on("exit", (code) => {
-      if (this.running && !this.shuttingDown) {
-        // Unexpected exit — only emit if we're not in the middle of
-        // a graceful shutdown (the process can exit before the async
-        // shutdown handshake completes, e.g. during app quit).
-        this.emit("error", {
-          fatal: true,
-          message: `Emulation worker exited unexpectedly (code ${code})`,
-        });
+  /**
+   * Spawn the utility process, load the core and ROM, and start the
+   * emulation loop. Resolves with AV info once the worker is ready.
+   * Reuses the worker from `prewarm()` when it holds the same core.
+   */
+  async init(
+    options: EmulationWorkerInitOptions,
+  ): Promise<{ avInfo: AVInfo; saveStatesSupported: boolean }> {
+    const startedAt = performance.now();
+    const parked = this.preloadedCorePath === options.corePath ? this.workerProcess : null;
+    const prewarmed = parked !== null;
+    let proc: UtilityProcess;
+    if (parked) {
+      proc = parked;
+    } else {
+      if (this.workerProcess) {
+        await this.destroy();
       }
-      this.cleanup();
-    });
+      proc = this.spawn();
+    }
+    this.preloadedCorePath = null;
 
     // Wait for the 'ready' event from the worker
     const initResult = await new Promise<{ avInfo: AVInfo; saveStatesSupported: boolean }>(
@@ -122,12 +207,6 @@ export class EmulationWorkerClient extends EventEmitter {
           }
         };
 
-        const proc = this.workerProcess;
-        if (!proc) {
-          reject(new Error("Worker process failed to spawn"));
-          return;
-        }
-
         proc.on("message", onMessage);
 
         // Timeout if worker doesn't become ready
@@ -143,9 +222,10 @@ export class EmulationWorkerClient extends EventEmitter {
     );
 
     const { avInfo, saveStatesSupported } = initResult;
+    this.launchTiming = { prewarmed, readyAt: performance.now(), startedAt };
 
     // Set up the permanent message handler
-    this.workerProcess.on("message", (event: WorkerEvent) => {
+    proc.on("message", (event: WorkerEvent) => {
       this.handleWorkerEvent(event);
     });
 
@@ -157,6 +237,42 @@ export class EmulationWorkerClient extends EventEmitter {
     return { avInfo, saveStatesSupported };
   }
 
+  /** Fork the worker process and watch it for exits. */
+  private spawn(): UtilityProcess {
+    const workerPath = path.join(__dirname, "workers/core-worker.mjs");
+
+    const proc = utilityProcess.fork(workerPath, [], {
+      serviceName: "LibretroCore",
+    });
+    this.workerProcess = proc;
+
+    proc.on("exit", (code) => {
+      // A replaced worker's late exit must not touch its successor.
+      if (this.workerProcess !== proc) {
+        return;
+      }
+      if (this.running && !this.shuttingDown) {
+        // Unexpected exit — only emit if we're not in the middle of
+        // a graceful shutdown (the process can exit before the async
+        // shutdown handshake completes, e.g. during app quit).
+        this.emit("error", {
+          fatal: true,
+          message: `Emulation worker exited unexpectedly (code ${code})`,
+        });
+      }
+      this.cleanup();
+    });
+    return proc;
+  }
+
+  /**
+   * Launch latency of the last `init()`, by phase, once its first frame
+   * has been produced.
+   */
+  getLaunchPhases(): LaunchPhases | null {
+    return this.lastLaunchPhases;
+  }
+
   /**
    * Forward input to the emulation core. Fire-and-forget — no response
    * expected (input is too high-frequency for request/response).
@@ -169,6 +285,22 @@ export class EmulationWorkerClient extends EventEmitter {
     this.postCommand({ action: "inputAnalog", port, index, id, value });
   }
 
+  /** Touch input, normalized over the displayed frame. Fire-and-forget. */
+  setPointer(x: number, y: number, pressed: boolean): void {
+    this.postCommand({ action: "pointer", pressed, x, y });
+  }
+
+  /**
+   * Arrange a dual-screen core's output. Takes effect on the next frame;
+   * resolves with the composed frame size.
+   */
+  async setScreenLayout(layout: ScreenLayout): Promise<{ width: number; height: number }> {
+    return this.sendRequest<{ width: number; height: number }>({
+      action: "setScreenLayout",
+      layout,
+    });
+  }
+
   pause(): void {
     this.postCommand({ action: "pause" });
     this.emit("paused");
@@ -192,6 +324,16 @@ export class EmulationWorkerClient extends EventEmitter {
     this.postCommand({ action: "setFastForwardAudio", enabled });
   }
 
+  /** Publish static screens at a reduced rate to save power. */
+  setStaticFrameThrottle(enabled: boolean): void {
+    this.postCommand({ action: "setStaticFrameThrottle", enabled });
+  }
+
+  /** Draw the native performance HUD into published frames. */
+  setPerfHud(enabled: boolean): void {
+    this.postCommand({ action: "setPerfHud", enabled });
+  }
+
   async saveState(slot: number): Promise<void> {
     await this.sendRequest({ action: "saveState", slot });
   }
@@ -251,6 +393,66 @@ export class EmulationWorkerClient extends EventEmitter {
     });
   }
 
+  /**
+   * Fast-run the core headlessly until one of `conditions` holds (boot skip,
+   * automated tests, thumbnails). Emulation is blocked for the duration.
+   */
+  async runUntil(conditions: Array<RunCondition>, maxFrames: number): Promise<RunUntilResult> {
+    return this.sendRequest<RunUntilResult>(
+      { action: "runUntil", conditions, maxFrames },
+      RUN_UNTIL_TIMEOUT_MS,
+    );
+  }
+
+  /** Per-subsystem and process memory for the running core. */
+  async getMemoryStats(): Promise<MemoryStats> {
+    return this.sendRequest<MemoryStats>({ action: "getMemoryStats" });
+  }
+
+  /** Attribute heap growth to retro_run (expensive; for investigations). */
+  async trackCoreHeap(enabled: boolean): Promise<void> {
+    await this.sendRequest({ action: "trackCoreHeap", enabled });
+  }
+
+  /** Input queue counters; resets the worst-case poll latency. */
+  async getInputStats(): Promise<InputStats> {
+    return this.sendRequest<InputStats>({ action: "getInputStats" });
+  }
+
+  /**
+   * Time `frames` unpaced frames (after `warmupFrames`) and save state
+   * serialization. Blocks the worker's frame loop while it runs.
+   */
+  async benchmark(warmupFrames: number, frames: number): Promise<BenchmarkResult> {
+    return this.sendRequest<BenchmarkResult>(
+      { action: "benchmark", frames, warmupFrames },
+      RUN_UNTIL_TIMEOUT_MS,
+    );
+  }
+
+  /** Loop wakeups, CPU and package power since the last query. */
+  async getPowerStats(): Promise<PowerStats> {
+    return this.sendRequest<PowerStats>({ action: "getPowerStats" });
+  }
+
+  /**
+   * Load a WebAssembly frame script whose hooks run around every retro_run,
+   * replacing any current one. Hooks over `budgetMs` per frame count as
+   * overruns; a script that keeps overrunning or traps is switched off.
+   */
+  async loadScript(scriptPath: string, budgetMs?: number): Promise<ScriptStats> {
+    return this.sendRequest<ScriptStats>({ action: "loadScript", budgetMs, path: scriptPath });
+  }
+
+  async unloadScript(): Promise<void> {
+    await this.sendRequest({ action: "unloadScript" });
+  }
+
+  /** Frame script overhead, or null when no script is loaded. */
+  async getScriptStats(): Promise<ScriptStats | null> {
+    return this.sendRequest<ScriptStats | null>({ action: "getScriptStats" });
+  }
+
   /**
    * Mark the worker as shutting down so that a process exit during the
    * async shutdown sequence doesn't emit an unexpected-exit error.
@@ -266,6 +468,12 @@ export class EmulationWorkerClient extends EventEmitter {
    * native core, and waits for the process to exit.
    */
   async shutdown(): Promise<void> {
+    if (this.workerProcess && !this.running) {
+      // Parked or still starting up: nothing to save, just drop it.
+      this.workerProcess.kill();
+      this.cleanup();
+      return;
+    }
     if (!this.workerProcess || !this.running) {
       return;
     }
@@ -332,12 +540,15 @@ export class EmulationWorkerClient extends EventEmitter {
       );
 
       const controlSAB = new SharedArrayBuffer(CTRL_SAB_BYTE_LENGTH);
-      const videoSAB = new SharedArrayBuffer(videoBufferSize * 2); // double buffer
+      const videoSAB = new SharedArrayBuffer(videoBufferSize * VIDEO_SLOT_COUNT);
       const audioSAB = new SharedArrayBuffer(AUDIO_RING_BYTE_LENGTH);
 
-      // Initialize audio sample rate in control buffer
+      // Initialize audio sample rate in control buffer. Rate control stays
+      // off until the renderer's audio worklet starts reporting its fill.
       const ctrl = new Int32Array(controlSAB);
       Atomics.store(ctrl, CTRL_AUDIO_SAMPLE_RATE, avInfo.timing.sampleRate || 44_100);
+      Atomics.store(ctrl, CTRL_AUDIO_FILL, AUDIO_FILL_UNKNOWN);
+      initVideoSlots(ctrl);
 
       this.sharedBuffers = { audio: audioSAB, control: controlSAB, video: videoSAB };
 
@@ -351,7 +562,7 @@ export class EmulationWorkerClient extends EventEmitter {
       });
 
       libretroLog.info(
-        `SharedArrayBuffer enabled: video=${videoBufferSize * 2} bytes (double-buffered), ` +
+        `SharedArrayBuffer enabled: video=${videoBufferSize * VIDEO_SLOT_COUNT} bytes (triple-buffered), ` +
           `audio=${AUDIO_RING_BYTE_LENGTH} bytes (ring buffer)`,
       );
     } catch (error) {
@@ -467,6 +678,41 @@ export class EmulationWorkerClient extends EventEmitter {
         this.emit("discChanged", { index: event.index, total: event.total });
         break;
 
+      case "stall":
+        libretroLog.warn(formatStallReport(event.report));
+        this.emit("stall", event.report);
+        break;
+
+      case "scriptOverlay":
+        this.emit("scriptOverlay", event.text);
+        break;
+
+      case "launchPhases": {
+        if (!this.launchTiming) {
+          break;
+        }
+        const { prewarmed, readyAt, startedAt } = this.launchTiming;
+        const { addonMs, coreLoadMs, gameLoadMs } = event.phases;
+        // Whatever init() time the worker did not account for is process
+        // spawn and IPC. A prewarmed worker paid for those up front.
+        const workerMs = gameLoadMs + (prewarmed ? 0 : addonMs + coreLoadMs);
+        const phases: LaunchPhases = {
+          ...event.phases,
+          spawnMs: Math.max(0, readyAt - startedAt - workerMs),
+          totalMs: performance.now() - startedAt,
+        };
+        this.launchTiming = null;
+        this.lastLaunchPhases = phases;
+        libretroLog.info(
+          `Launch ${phases.totalMs.toFixed(1)}ms (${prewarmed ? "prewarmed" : "cold"}): ` +
+            `spawn ${phases.spawnMs.toFixed(1)}, addon ${addonMs.toFixed(1)}, ` +
+            `core ${coreLoadMs.toFixed(1)}, game ${gameLoadMs.toFixed(1)}, ` +
+            `first frame ${phases.firstFrameMs.toFixed(1)}`,
+        );
+        this.emit("launchPhases", phases);
+        break;
+      }
+
       case "ready":
         // Handled during init — ignore if received after startup
         break;
@@ -480,11 +726,14 @@ export class EmulationWorkerClient extends EventEmitter {
       pending.reject(new Error("Worker process terminated"));
     }
     this.pendingRequests.clear();
+    this.abortPrewarm?.(new Error("Worker process terminated"));
 
     this.workerProcess = null;
     this.running = false;
     this.shuttingDown = false;
     this.sharedBuffers = null;
     this.detectedSerial = null;
+    this.preloadedCorePath = null;
+    this.launchTiming = null;
   }
 }
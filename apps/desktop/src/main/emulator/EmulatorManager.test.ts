@@ -18,6 +18,7 @@ vi.mock("node:fs", () => ({
   existsSync: vi.fn(() => false),
   readdirSync: vi.fn(() => []),
   mkdirSync: vi.fn(),
+  writeFileSync: vi.fn(),
 }));
 
 vi.mock("os", () => ({
@@ -65,9 +66,15 @@ vi.mock("./LibretroNativeCore", async () => {
 
 vi.mock("./EmulationWorkerClient");
 
+vi.mock("../services/BiosVerifier", () => ({
+  verifyBiosFiles: vi.fn(async () => []),
+}));
+
 import { powerSaveBlocker } from "electron";
 import * as fs from "node:fs";
 import { EmulatorManager } from "./EmulatorManager";
+import { verifyBiosFiles } from "../services/BiosVerifier";
+import { EmulationWorkerClient } from "./EmulationWorkerClient";
 
 // ---------------------------------------------------------------------------
 // Helpers
@@ -216,4 +223,64 @@ describe("EmulatorManager — BIOS validation", () => {
     expect(result.valid).toBe(false);
     expect(result.missingFiles).toEqual(["mpr-17933.bin"]);
   });
+
+  it("reports bad dumps from the hash check", async () => {
+    vi.mocked(verifyBiosFiles).mockResolvedValueOnce([
+      { cached: true, file: "sega_101.bin", md5: "0".repeat(32), size: 524_288, status: "bad" },
+      { cached: false, file: "mpr-17933.bin", md5: null, size: 0, status: "missing" },
+    ]);
+    const result = await manager.verifyBios("saturn");
+    expect(result.valid).toBe(false);
+    expect(result.badFiles).toEqual(["sega_101.bin"]);
+    expect(result.missingFiles).toEqual(["mpr-17933.bin"]);
+    expect(vi.mocked(verifyBiosFiles).mock.calls[0][2]).toContain("bios-cache");
+  });
+
+  it("skips hashing for systems without BIOS requirements", async () => {
+    const result = await manager.verifyBios("nes");
+    expect(result.valid).toBe(true);
+    expect(verifyBiosFiles).not.toHaveBeenCalled();
+  });
+});
+
+describe("EmulatorManager — spare worker", () => {
+  let manager: EmulatorManager;
+
+  function parkSpare(corePath: string) {
+    const spare = { destroy: vi.fn(async () => {}), preloadedCore: corePath };
+    internals(manager).spareWorker = spare;
+    return spare;
+  }
+
+  beforeEach(() => {
+    vi.clearAllMocks();
+    manager = new EmulatorManager();
+  });
+
+  it("hands out the spare worker when it holds the launched core", () => {
+    const spare = parkSpare("/cores/fceumm_libretro.so");
+
+    expect(manager.takeWorker("/cores/fceumm_libretro.so")).toBe(spare);
+    expect(spare.destroy).not.toHaveBeenCalled();
+    expect(internals(manager).spareWorker).toBe(null);
+  });
+
+  it("drops a spare holding another core and spawns a fresh worker", () => {
+    const spare = parkSpare("/cores/snes9x_libretro.so");
+
+    const worker = manager.takeWorker("/cores/fceumm_libretro.so");
+
+    expect(worker).not.toBe(spare);
+    expect(worker).toBeInstanceOf(EmulationWorkerClient);
+    expect(spare.destroy).toHaveBeenCalled();
+  });
+
+  it("destroys the spare worker on quit", async () => {
+    const spare = parkSpare("/cores/fceumm_libretro.so");
+
+    await manager.destroySpareWorker();
+
+    expect(spare.destroy).toHaveBeenCalled();
+    expect(internals(manager).spareWorker).toBe(null);
+  });
 });
@@ -4,8 +4,21 @@ import { EmulatorCore, EmulatorInfo, EmulatorLaunchOptions } from "./EmulatorCor
 import { RetroArchCore } from "./RetroArchCore";
 import { LibretroNativeCore } from "./LibretroNativeCore";
 import { EmulationWorkerClient } from "./EmulationWorkerClient";
-import type { SaveStateMetadata } from "../workers/core-worker-protocol";
+import type {
+  SaveStateMetadata,
+  ScreenLayout,
+  ScriptStats,
+} from "../workers/core-worker-protocol";
 import { CoreDownloader, CoreInfo } from "./CoreDownloader";
+import {
+  chooseDefaultCores,
+  runCoreMatrix,
+  type CoreMatrixEntry,
+  type CoreMatrixGame,
+} from "./CoreBenchmark";
+import { resolveAddonPath } from "./resolveAddonPath";
+import type { NativeBiosFile, NativeBiosReport } from "../native/nativeAddon";
+import { verifyBiosFiles } from "../services/BiosVerifier";
 import * as fs from "node:fs";
 import * as path from "node:path";
 import * as os from "node:os";
@@ -17,20 +30,44 @@ import * as os from "node:os";
  * which manages its own GPU context.
  */
 /**
- * Systems that require BIOS files to run. Maps system ID to an array of
- * required filenames that must be present in the BIOS directory.
+ * Systems that require BIOS files to run. Maps system ID to the files that
+ * must be present in the BIOS directory, with their known-good dumps.
  */
-const BIOS_REQUIREMENTS: Record<string, { files: Array<string>; systemName: string }> = {
+const BIOS_REQUIREMENTS: Record<string, { files: Array<NativeBiosFile>; systemName: string }> = {
   psx: {
-    files: ["scph5501.bin"],
+    files: [{ file: "scph5501.bin", md5: ["490f666e1afb15b7362b406ed1cea246"], size: 524_288 }],
     systemName: "PlayStation",
   },
   saturn: {
-    files: ["sega_101.bin", "mpr-17933.bin"],
+    files: [
+      { file: "sega_101.bin", md5: ["85ec9ca47d8f6807718151cbcca8b964"], size: 524_288 },
+      { file: "mpr-17933.bin", md5: ["3240872c70984b6cbfda1586cab68dbe"], size: 524_288 },
+    ],
     systemName: "Sega Saturn",
   },
 };
 
+/** Hashes of BIOS files, keyed by path, size and mtime. */
+const BIOS_CACHE_FILE = "bios-cache.txt";
+
+/**
+ * Keep a spare emulation worker parked with the last-used core loaded, so a
+ * launch only has to load the game. Linux only for now; elsewhere every
+ * launch spawns a fresh worker.
+ */
+const WORKER_PREWARM_SUPPORTED = process.platform === "linux";
+
+/** Core of the most recent native launch, prewarmed on the next start. */
+const LAST_CORE_FILE = "last-core.json";
+
+/** Saved by benchmarkCores; read back to pick each game's default core. */
+interface CoreMatrixFile {
+  generatedAt: string;
+  entries: Array<CoreMatrixEntry>;
+  /** romPath → core name. */
+  defaults: Record<string, string>;
+}
+
 export interface BiosValidationResult {
   biosDir: string;
   missingFiles: Array<string>;
@@ -38,6 +75,12 @@ export interface BiosValidationResult {
   valid: boolean;
 }
 
+export interface BiosVerificationResult extends BiosValidationResult {
+  /** Present, but not a known-good dump (wrong size or hash). */
+  badFiles: Array<string>;
+  files: Array<NativeBiosReport>;
+}
+
 /**
  * Manages emulator instances and provides a unified interface for launching games.
  * Handles emulator discovery, selection, and lifecycle management.
@@ -45,10 +88,12 @@ export interface BiosValidationResult {
 export class EmulatorManager extends EventEmitter {
   private currentEmulator: EmulatorCore | null = null;
   private workerClient: EmulationWorkerClient | null = null;
+  private spareWorker: EmulationWorkerClient | null = null;
   private activeCoreId: string | null = null;
   private availableEmulators: Map<string, EmulatorInfo> = new Map();
   private coreDownloader: CoreDownloader;
   private powerSaveBlockerId: number | null = null;
+  private benchmarkedCores: Record<string, string> | null = null;
 
   constructor() {
     super();
@@ -75,9 +120,9 @@ export class EmulatorManager extends EventEmitter {
     }
 
     const biosDir = path.join(app.getPath("userData"), "BIOS");
-    const missingFiles = requirement.files.filter(
-      (file) => !fs.existsSync(path.join(biosDir, file)),
-    );
+    const missingFiles = requirement.files
+      .map((spec) => spec.file)
+      .filter((file) => !fs.existsSync(path.join(biosDir, file)));
 
     return {
       biosDir,
@@ -87,6 +132,43 @@ export class EmulatorManager extends EventEmitter {
     };
   }
 
+  /**
+   * Hash a system's BIOS files against their known-good dumps, so a bad
+   * dump fails before the core is loaded rather than as a broken boot.
+   * Hashes are cached by path, size and mtime, so repeat checks only stat.
+   */
+  async verifyBios(systemId: string): Promise<BiosVerificationResult> {
+    const requirement = BIOS_REQUIREMENTS[systemId];
+    if (!requirement) {
+      return { ...this.validateBios(systemId), badFiles: [], files: [] };
+    }
+
+    const biosDir = path.join(app.getPath("userData"), "BIOS");
+    const files = await verifyBiosFiles(
+      biosDir,
+      requirement.files,
+      path.join(app.getPath("userData"), BIOS_CACHE_FILE),
+    );
+    const missingFiles = files.filter((f) => f.status === "missing").map((f) => f.file);
+    const badFiles = files.filter((f) => f.status === "bad").map((f) => f.file);
+
+    return {
+      badFiles,
+      biosDir,
+      files,
+      missingFiles,
+      systemName: requirement.systemName,
+      valid: missingFiles.length === 0 && badFiles.length === 0,
+    };
+  }
+
+  /** BIOS report for every system that needs one; also warms the hash cache. */
+  async verifyAllBios(): Promise<Record<string, BiosVerificationResult>> {
+    const systems = Object.keys(BIOS_REQUIREMENTS);
+    const results = await Promise.all(systems.map((systemId) => this.verifyBios(systemId)));
+    return Object.fromEntries(systems.map((systemId, i) => [systemId, results[i]]));
+  }
+
   /**
    * Discover available emulators on the system
    */
@@ -253,7 +335,8 @@ export class EmulatorManager extends EventEmitter {
           options.corePath = await this.coreDownloader.downloadCore(coreName, systemId);
         }
       } else {
-        options.corePath = this.getCorePathForSystem(systemId) ?? undefined;
+        options.corePath =
+          this.getBenchmarkedCorePath(romPath) ?? this.getCorePathForSystem(systemId) ?? undefined;
         if (!options.corePath) {
           // Auto-download the preferred core
           options.corePath = await this.coreDownloader.downloadCoreForSystem(systemId);
@@ -363,6 +446,87 @@ export class EmulatorManager extends EventEmitter {
     return null;
   }
 
+  private getCoreMatrixPath(): string {
+    return path.join(app.getPath("userData"), "core-matrix.json");
+  }
+
+  /**
+   * The installed core the last benchmarkCores run chose for this game,
+   * or null when the game hasn't been benchmarked.
+   */
+  private getBenchmarkedCorePath(romPath: string): string | null {
+    if (!this.benchmarkedCores) {
+      this.benchmarkedCores = {};
+      const matrixPath = this.getCoreMatrixPath();
+      if (fs.existsSync(matrixPath)) {
+        try {
+          const file = JSON.parse(fs.readFileSync(matrixPath, "utf8")) as CoreMatrixFile;
+          this.benchmarkedCores = file.defaults ?? {};
+        } catch {
+          // Unreadable matrix: fall back to preference order
+        }
+      }
+    }
+    const coreName = this.benchmarkedCores[romPath];
+    return coreName ? this.coreDownloader.getCorePath(coreName) : null;
+  }
+
+  /**
+   * Benchmark every installed core for each game in its own emulation
+   * worker (see CoreBenchmark.ts), save the matrix to `core-matrix.json`
+   * and use it to choose default cores from then on. Saves and SRAM go to
+   * a temporary directory, never the user's.
+   */
+  async benchmarkCores(
+    games: Array<CoreMatrixGame>,
+    onEntry?: (entry: CoreMatrixEntry) => void,
+  ): Promise<Array<CoreMatrixEntry>> {
+    const addonPath = resolveAddonPath();
+    const biosDir = path.join(app.getPath("userData"), "BIOS");
+    const scratchDir = fs.mkdtempSync(path.join(os.tmpdir(), "gamelord-core-matrix-"));
+    let cell = 0;
+
+    try {
+      const entries = await runCoreMatrix(games, {
+        candidates: (systemId) =>
+          this.getCoresForSystem(systemId).flatMap((core) => {
+            const corePath = core.installed ? this.coreDownloader.getCorePath(core.name) : null;
+            return corePath ? [{ coreName: core.name, corePath }] : [];
+          }),
+        createWorker: () => new EmulationWorkerClient(),
+        initOptions: (game, core) => {
+          // Own directory per combination so parallel runs never share SRAM.
+          const dir = path.join(scratchDir, String(cell++));
+          fs.mkdirSync(dir, { recursive: true });
+          return {
+            addonPath,
+            corePath: core.corePath,
+            romPath: game.romPath,
+            saveDir: dir,
+            saveStatesDir: path.join(dir, "states"),
+            sramDir: dir,
+            systemDir: biosDir,
+          };
+        },
+        onEntry,
+      });
+
+      const defaults = chooseDefaultCores(entries, (systemId) =>
+        this.getCoresForSystem(systemId).map((core) => core.name),
+      );
+      const file: CoreMatrixFile = {
+        defaults: { ...this.benchmarkedCores, ...defaults },
+        entries,
+        generatedAt: new Date().toISOString(),
+      };
+      fs.writeFileSync(this.getCoreMatrixPath(), JSON.stringify(file, null, 2));
+      this.benchmarkedCores = file.defaults;
+      return entries;
+    } finally {
+      fs.rmSync(scratchDir, { force: true, recursive: true });
+    }
+  }
+
   /**
    * Get the RetroArch cores directory path (used as fallback).
    */
@@ -449,6 +613,90 @@ export class EmulatorManager extends EventEmitter {
       client.on("error", (error) => this.emit("emulator:error", error));
       client.on("speedChanged", (data) => this.emit("emulator:speedChanged", data));
       client.on("discChanged", (data) => this.emit("emulator:discChanged", data));
+      client.on("scriptOverlay", (text) => this.emit("emulator:scriptOverlay", text));
+    }
+  }
+
+  /**
+   * Worker client for a native launch of `corePath`: the parked spare when
+   * it holds that core, otherwise a fresh one (any other spare is dropped).
+   * Also records the core as the one to prewarm next time.
+   */
+  takeWorker(corePath: string): EmulationWorkerClient {
+    const spare = this.spareWorker;
+    this.spareWorker = null;
+    this.rememberLastCore(corePath);
+    if (spare && spare.preloadedCore === corePath) {
+      return spare;
+    }
+    void spare?.destroy();
+    return new EmulationWorkerClient();
+  }
+
+  /**
+   * Spawn a spare worker with `corePath` loaded, replacing any spare that
+   * holds a different core. No-op while a native game is running or where
+   * prewarming isn't supported.
+   */
+  async prewarmWorker(corePath: string): Promise<void> {
+    if (!WORKER_PREWARM_SUPPORTED || this.workerClient?.isRunning()) {
+      return;
+    }
+    if (this.spareWorker?.preloadedCore === corePath) {
+      return;
+    }
+    await this.spareWorker?.destroy();
+
+    const spare = new EmulationWorkerClient();
+    this.spareWorker = spare;
+    const userData = app.getPath("userData");
+    try {
+      await spare.prewarm({
+        addonPath: resolveAddonPath(),
+        corePath,
+        saveDir: path.join(userData, "saves"),
+        systemDir: path.join(userData, "BIOS"),
+      });
+    } catch (error) {
+      if (this.spareWorker === spare) {
+        this.spareWorker = null;
+      }
+      throw error;
+    }
+  }
+
+  /** Prewarm the core of the most recent native launch, if it's still installed. */
+  async prewarmLastCore(): Promise<void> {
+    const lastCorePath = path.join(app.getPath("userData"), LAST_CORE_FILE);
+    if (!WORKER_PREWARM_SUPPORTED || !fs.existsSync(lastCorePath)) {
+      return;
+    }
+    const { corePath } = JSON.parse(fs.readFileSync(lastCorePath, "utf8")) as {
+      corePath?: string;
+    };
+    if (corePath && fs.existsSync(corePath)) {
+      await this.prewarmWorker(corePath);
+    }
+  }
+
+  /** Kill the parked spare worker, if any. Called on quit. */
+  async destroySpareWorker(): Promise<void> {
+    const spare = this.spareWorker;
+    this.spareWorker = null;
+    await spare?.destroy();
+  }
+
+  private rememberLastCore(corePath: string): void {
+    if (!WORKER_PREWARM_SUPPORTED) {
+      return;
+    }
+    try {
+      fs.writeFileSync(
+        path.join(app.getPath("userData"), LAST_CORE_FILE),
+        JSON.stringify({ corePath }),
+      );
+    } catch {
+      // Only costs the next start its prewarm
     }
   }
 
@@ -557,6 +805,32 @@ export class EmulatorManager extends EventEmitter {
     await this.workerClient.swapDisc(index);
   }
 
+  /**
+   * Load a WebAssembly frame script into the running game's worker.
+   */
+  async loadScript(scriptPath: string, budgetMs?: number): Promise<ScriptStats> {
+    if (!this.workerClient?.isRunning()) {
+      throw new Error("No emulator is currently running");
+    }
+    return this.workerClient.loadScript(scriptPath, budgetMs);
+  }
+
+  async unloadScript(): Promise<void> {
+    if (this.workerClient?.isRunning()) {
+      await this.workerClient.unloadScript();
+    }
+  }
+
+  /**
+   * Arrange a dual-screen core's output; resolves with the composed size.
+   */
+  async setScreenLayout(layout: ScreenLayout): Promise<{ width: number; height: number }> {
+    if (!this.workerClient?.isRunning()) {
+      throw new Error("No emulator is currently running");
+    }
+    return this.workerClient.setScreenLayout(layout);
+  }
+
   /**
    * Query runtime disc info from the running core.
    */
@@ -610,6 +884,15 @@ export class EmulatorManager extends EventEmitter {
     }
   }
 
+  /**
+   * Show or hide the performance HUD drawn into the game's frames.
+   */
+  setPerfHud(enabled: boolean): void {
+    if (this.workerClient?.isRunning()) {
+      this.workerClient.setPerfHud(enabled);
+    }
+  }
+
   /**
    * Reset the current emulator
    */
@@ -630,6 +913,7 @@ export class EmulatorManager extends EventEmitter {
    */
   prepareForQuit(): void {
     this.workerClient?.prepareForQuit();
+    this.spareWorker?.prepareForQuit();
   }
 
   /**
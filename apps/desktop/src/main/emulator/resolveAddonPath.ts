@@ -6,8 +6,9 @@ import { app } from "electron";
  * Resolve the path to the native libretro addon without loading it.
  *
  * Searches the same candidate locations as `LibretroNativeCore.loadNativeAddon()`
- * but only checks file existence — the addon itself is loaded inside the
- * emulation worker process, not the main process.
+ * but only checks file existence — the libretro core is loaded inside the
+ * emulation worker process. The main process only loads the addon for its
+ * library helpers (see `native/nativeAddon.ts`).
  *
  * @returns Absolute path to the `.node` addon file.
  * @throws If no addon file is found at any candidate path.
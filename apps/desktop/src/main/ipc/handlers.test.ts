@@ -28,9 +28,12 @@ vi.mock("../emulator/LibretroNativeCore");
 vi.mock("../emulator/EmulationWorkerClient");
 vi.mock("../emulator/resolveAddonPath");
 vi.mock("../services/LibraryService");
+vi.mock("../services/LibraryWatcher");
 vi.mock("../services/ArtworkService");
+vi.mock("../services/DatService");
 vi.mock("../services/CheatDatabaseService");
 vi.mock("../services/CheatPersistenceService");
+vi.mock("../services/SaveStateSummaries");
 vi.mock("../GameWindowManager");
 vi.mock("../logger", () => ({
   ipcLog: { error: vi.fn(), warn: vi.fn(), info: vi.fn(), debug: vi.fn() },
@@ -43,6 +46,7 @@ import { resolveAddonPath } from "../emulator/resolveAddonPath";
 import { LibraryService } from "../services/LibraryService";
 import { CheatDatabaseService } from "../services/CheatDatabaseService";
 import { CheatPersistenceService } from "../services/CheatPersistenceService";
+import { readStateSummaries } from "../services/SaveStateSummaries";
 import { GameWindowManager } from "../GameWindowManager";
 import { IPCHandlers } from "./handlers";
 import type { Game, GameSystem } from "../../types/library";
@@ -106,7 +110,14 @@ interface MockEmulatorManager {
   loadState: ReturnType<typeof vi.fn>;
   screenshot: ReturnType<typeof vi.fn>;
   setWorkerClient: ReturnType<typeof vi.fn>;
-  validateBios: ReturnType<typeof vi.fn>;
+  prewarmLastCore: ReturnType<typeof vi.fn>;
+  takeWorker: ReturnType<typeof vi.fn>;
+  verifyAllBios: ReturnType<typeof vi.fn>;
+  verifyBios: ReturnType<typeof vi.fn>;
+  benchmarkCores?: ReturnType<typeof vi.fn>;
+  loadScript?: ReturnType<typeof vi.fn>;
+  unloadScript?: ReturnType<typeof vi.fn>;
+  setScreenLayout?: ReturnType<typeof vi.fn>;
   setSpeed?: ReturnType<typeof vi.fn>;
   [key: string]: unknown;
 }
@@ -117,6 +128,7 @@ interface MockLibraryService {
   removeSystem: ReturnType<typeof vi.fn>;
   updateSystemPath: ReturnType<typeof vi.fn>;
   getGames: ReturnType<typeof vi.fn>;
+  searchGames: ReturnType<typeof vi.fn>;
   addGame: ReturnType<typeof vi.fn>;
   removeGame: ReturnType<typeof vi.fn>;
   updateGame: ReturnType<typeof vi.fn>;
@@ -200,7 +212,17 @@ beforeEach(() => {
       loadState: vi.fn(),
       screenshot: vi.fn(),
       setWorkerClient: vi.fn(),
-      validateBios: vi.fn(() => ({ valid: true, missingFiles: [], biosDir: "", systemName: "" })),
+      prewarmLastCore: vi.fn(async () => {}),
+      takeWorker: vi.fn(() => new EmulationWorkerClient()),
+      verifyAllBios: vi.fn(async () => ({})),
+      verifyBios: vi.fn(async () => ({
+        badFiles: [],
+        biosDir: "",
+        files: [],
+        missingFiles: [],
+        systemName: "",
+        valid: true,
+      })),
     }) as unknown as MockEmulatorManager;
     return emulatorManagerInstance as unknown as EmulatorManager;
   } as unknown as () => EmulatorManager);
@@ -236,6 +258,7 @@ beforeEach(() => {
       removeSystem: vi.fn(),
       updateSystemPath: vi.fn(),
       getGames: vi.fn(() => []),
+      searchGames: vi.fn(async () => null),
       addGame: vi.fn(),
       removeGame: vi.fn(),
       updateGame: vi.fn(),
@@ -304,7 +327,9 @@ describe("IPCHandlers", () => {
 
       const expectedHandleChannels = [
         "emulator:getCoresForSystem",
+        "emulator:verifyBios",
         "emulator:downloadCore",
+        "emulator:benchmarkCores",
         "emulator:launch",
         "emulator:stop",
         "emulator:getAvailable",
@@ -314,14 +339,20 @@ describe("IPCHandlers", () => {
         "emulation:reset",
         "emulation:setSpeed",
         "emulation:setFastForwardAudio",
+        "emulation:setPerfHud",
+        "emulation:setScreenLayout",
+        "emulation:loadScript",
+        "emulation:unloadScript",
         "savestate:save",
         "savestate:load",
+        "savestate:summaries",
         "emulation:screenshot",
         "library:getSystems",
         "library:addSystem",
         "library:removeSystem",
         "library:updateSystemPath",
         "library:getGames",
+        "library:searchGames",
         "library:addGame",
         "library:removeGame",
         "library:updateGame",
@@ -342,7 +373,7 @@ describe("IPCHandlers", () => {
 
     it("registers exactly the expected number of handle channels", () => {
       const handleCalls = vi.mocked(ipcMain.handle).mock.calls;
-      expect(handleCalls).toHaveLength(53);
+      expect(handleCalls).toHaveLength(61);
     });
   });
 
@@ -362,6 +393,28 @@ describe("IPCHandlers", () => {
     });
   });
 
+  describe("emulator:verifyBios", () => {
+    it("returns the BIOS report for every system", async () => {
+      const systems = { psx: { missingFiles: ["scph5501.bin"], valid: false } };
+      emulatorManagerInstance.verifyAllBios.mockResolvedValue(systems);
+
+      const handler = getHandler("emulator:verifyBios");
+      const result = await handler(fakeEvent);
+
+      expect(emulatorManagerInstance.verifyAllBios).toHaveBeenCalled();
+      expect(result).toEqual({ success: true, systems });
+    });
+
+    it("returns error when verification fails", async () => {
+      emulatorManagerInstance.verifyAllBios.mockRejectedValue(new Error("EACCES"));
+
+      const handler = getHandler("emulator:verifyBios");
+      const result = await handler(fakeEvent);
+
+      expect(result).toEqual({ success: false, error: "EACCES" });
+    });
+  });
+
   // -----------------------------------------------------------------------
   // 3-4. emulator:downloadCore
   // -----------------------------------------------------------------------
@@ -388,6 +441,34 @@ describe("IPCHandlers", () => {
     });
   });
 
+  describe("emulator:benchmarkCores", () => {
+    it("returns the matrix entries from EmulatorManager.benchmarkCores", async () => {
+      const games = [{ romPath: "/roms/zelda.nes", systemId: "nes" }];
+      const entries = [{ coreName: "fceumm", romPath: "/roms/zelda.nes", result: { fps: 600 } }];
+      emulatorManagerInstance.benchmarkCores = vi.fn(async () => entries);
+
+      const handler = getHandler("emulator:benchmarkCores");
+      const result = await handler(fakeEvent, games);
+
+      expect(emulatorManagerInstance.benchmarkCores).toHaveBeenCalledWith(
+        games,
+        expect.any(Function),
+      );
+      expect(result).toEqual({ success: true, entries });
+    });
+
+    it("returns an empty matrix when benchmarking fails", async () => {
+      emulatorManagerInstance.benchmarkCores = vi.fn(async () => {
+        throw new Error("No cores installed");
+      });
+
+      const handler = getHandler("emulator:benchmarkCores");
+      const result = await handler(fakeEvent, []);
+
+      expect(result).toEqual({ success: false, entries: [], error: "No cores installed" });
+    });
+  });
+
   // -----------------------------------------------------------------------
   // 5-6. emulator:launch
   // -----------------------------------------------------------------------
@@ -660,6 +741,30 @@ describe("IPCHandlers", () => {
     });
   });
 
+  describe("emulation:setScreenLayout", () => {
+    it("returns the composed frame size for the new layout", async () => {
+      emulatorManagerInstance.setScreenLayout = vi.fn(async () => ({ width: 512, height: 192 }));
+
+      const handler = getHandler("emulation:setScreenLayout");
+      const layout = { gap: 0, mode: "sideBySide" };
+      const result = await handler(fakeEvent, layout);
+
+      expect(emulatorManagerInstance.setScreenLayout).toHaveBeenCalledWith(layout);
+      expect(result).toEqual({ success: true, width: 512, height: 192 });
+    });
+
+    it("returns error when no emulator is running", async () => {
+      emulatorManagerInstance.setScreenLayout = vi.fn(async () => {
+        throw new Error("No emulator is currently running");
+      });
+
+      const handler = getHandler("emulation:setScreenLayout");
+      const result = await handler(fakeEvent, { mode: "stacked" });
+
+      expect(result).toEqual({ success: false, error: "No emulator is currently running" });
+    });
+  });
+
   // -----------------------------------------------------------------------
   // 13. savestate:save
   // -----------------------------------------------------------------------
@@ -721,6 +826,33 @@ describe("IPCHandlers", () => {
     });
   });
 
+  describe("savestate:summaries", () => {
+    it("reads the slot previews from the game's save state directory", async () => {
+      const pixels = Buffer.alloc(4);
+      vi.mocked(readStateSummaries).mockResolvedValue({ pixels, states: [] });
+
+      const handler = getHandler("savestate:summaries");
+      const result = await handler(fakeEvent, "/roms/nes/Zelda.nes");
+
+      expect(readStateSummaries).toHaveBeenCalledWith("/tmp/test/savestates/Zelda");
+      expect(result).toEqual({ success: true, pixels, states: [] });
+    });
+
+    it("returns an empty result when the directory can't be read", async () => {
+      vi.mocked(readStateSummaries).mockRejectedValue(new Error("EACCES"));
+
+      const handler = getHandler("savestate:summaries");
+      const result = await handler(fakeEvent, "/roms/nes/Zelda.nes");
+
+      expect(result).toEqual({
+        success: false,
+        states: [],
+        pixels: new Uint8Array(0),
+        error: "EACCES",
+      });
+    });
+  });
+
   // -----------------------------------------------------------------------
   // 15. emulation:screenshot
   // -----------------------------------------------------------------------
@@ -755,6 +887,69 @@ describe("IPCHandlers", () => {
     });
   });
 
+  describe("emulation:loadScript", () => {
+    const stats = { budgetMs: 2, hookCalls: 0, loaded: true };
+
+    it("loads the given script without opening a dialog", async () => {
+      emulatorManagerInstance.loadScript = vi.fn(async () => stats);
+
+      const handler = getHandler("emulation:loadScript");
+      const result = await handler(fakeEvent, "/scripts/hud.wasm");
+
+      expect(dialog.showOpenDialog).not.toHaveBeenCalled();
+      expect(emulatorManagerInstance.loadScript).toHaveBeenCalledWith("/scripts/hud.wasm");
+      expect(result).toEqual({ success: true, path: "/scripts/hud.wasm", stats });
+    });
+
+    it("asks for a script when no path is given", async () => {
+      vi.mocked(dialog.showOpenDialog).mockResolvedValue({
+        canceled: false,
+        filePaths: ["/scripts/picked.wasm"],
+      });
+      emulatorManagerInstance.loadScript = vi.fn(async () => stats);
+
+      const handler = getHandler("emulation:loadScript");
+      const result = await handler(fakeEvent);
+
+      expect(emulatorManagerInstance.loadScript).toHaveBeenCalledWith("/scripts/picked.wasm");
+      expect(result).toEqual({ success: true, path: "/scripts/picked.wasm", stats });
+    });
+
+    it("reports a canceled dialog without loading anything", async () => {
+      vi.mocked(dialog.showOpenDialog).mockResolvedValue({ canceled: true, filePaths: [] });
+      emulatorManagerInstance.loadScript = vi.fn();
+
+      const handler = getHandler("emulation:loadScript");
+      const result = await handler(fakeEvent);
+
+      expect(emulatorManagerInstance.loadScript).not.toHaveBeenCalled();
+      expect(result).toEqual({ success: false, canceled: true });
+    });
+
+    it("returns error when the script fails to load", async () => {
+      emulatorManagerInstance.loadScript = vi.fn(async () => {
+        throw new Error("Script does not export memory");
+      });
+
+      const handler = getHandler("emulation:loadScript");
+      const result = await handler(fakeEvent, "/scripts/bad.wasm");
+
+      expect(result).toEqual({ success: false, error: "Script does not export memory" });
+    });
+  });
+
+  describe("emulation:unloadScript", () => {
+    it("unloads the running script", async () => {
+      emulatorManagerInstance.unloadScript = vi.fn(async () => {});
+
+      const handler = getHandler("emulation:unloadScript");
+      const result = await handler(fakeEvent);
+
+      expect(emulatorManagerInstance.unloadScript).toHaveBeenCalled();
+      expect(result).toEqual({ success: true });
+    });
+  });
+
   // -----------------------------------------------------------------------
   // 16. library:getSystems
   // -----------------------------------------------------------------------
@@ -850,6 +1045,18 @@ describe("IPCHandlers", () => {
     });
   });
 
+  describe("library:searchGames", () => {
+    it("delegates the query and limit to LibraryService.searchGames", async () => {
+      libraryServiceInstance.searchGames.mockResolvedValue(["g2", "g1"]);
+
+      const handler = getHandler("library:searchGames");
+      const result = await handler(fakeEvent, "zel", 20);
+
+      expect(libraryServiceInstance.searchGames).toHaveBeenCalledWith("zel", 20);
+      expect(result).toEqual(["g2", "g1"]);
+    });
+  });
+
   // -----------------------------------------------------------------------
   // 20. library:addGame
   // -----------------------------------------------------------------------
@@ -1,20 +1,25 @@
-import { ipcMain, IpcMainInvokeEvent, BrowserWindow, dialog } from "electron";
+import { app, ipcMain, IpcMainInvokeEvent, BrowserWindow, dialog } from "electron";
 import { EmulatorManager } from "../emulator/EmulatorManager";
 import { LibretroNativeCore } from "../emulator/LibretroNativeCore";
 import { EmulationWorkerClient } from "../emulator/EmulationWorkerClient";
 import { resolveAddonPath } from "../emulator/resolveAddonPath";
 import { LibraryService } from "../services/LibraryService";
+import { LibraryWatcher } from "../services/LibraryWatcher";
 import { ArtworkService } from "../services/ArtworkService";
+import { DatService } from "../services/DatService";
 import { HomebrewService } from "../services/HomebrewService";
 import { CheatDatabaseService } from "../services/CheatDatabaseService";
 import { CheatPersistenceService } from "../services/CheatPersistenceService";
 import { ScreenScraperError } from "../services/ScreenScraperClient";
+import { readStateSummaries } from "../services/SaveStateSummaries";
 import { GameWindowManager } from "../GameWindowManager";
 import type { AutoUpdaterService } from "../services/AutoUpdaterService";
 import { Game, GameSystem } from "../../types/library";
+import type { ScreenLayout } from "../workers/core-worker-protocol";
 import type { AmbiguousRomFile } from "../services/LibraryService";
 import { ipcLog } from "../logger";
 import fs from "node:fs";
+import path from "node:path";
 
 function errorMessage(error: unknown): string {
   return error instanceof Error ? error.message : String(error);
@@ -28,7 +33,9 @@ interface ResumeDialogResponse {
 export class IPCHandlers {
   private emulatorManager: EmulatorManager;
   private libraryService: LibraryService;
+  private libraryWatcher: LibraryWatcher;
   private artworkService: ArtworkService;
+  private datService: DatService;
   private homebrewService: HomebrewService;
   private gameWindowManager: GameWindowManager;
   private cheatDatabaseService: CheatDatabaseService;
@@ -45,7 +52,9 @@ export class IPCHandlers {
   constructor(preloadPath: string) {
     this.emulatorManager = new EmulatorManager();
     this.libraryService = new LibraryService();
+    this.libraryWatcher = new LibraryWatcher(this.libraryService);
     this.artworkService = new ArtworkService(this.libraryService);
+    this.datService = new DatService(this.libraryService);
     this.homebrewService = new HomebrewService(this.libraryService);
     this.cheatDatabaseService = new CheatDatabaseService();
     this.cheatPersistenceService = new CheatPersistenceService();
@@ -56,6 +65,25 @@ export class IPCHandlers {
     this.setupArtworkHandlers();
     this.setupDialogHandlers();
 
+    // Keep the library in sync with the ROM folders (non-blocking). Changes
+    // made while the app was closed are reconciled from the watch journal.
+    void this.libraryWatcher.start();
+
+    // Verify ROMs against any installed No-Intro / Redump DATs (non-blocking).
+    void this.verifyWithDats();
+
+    // Hash BIOS files ahead of the first launch so the pre-launch check is
+    // a cache hit (non-blocking).
+    this.emulatorManager.verifyAllBios().catch((error) => {
+      ipcLog.warn("BIOS verification failed:", error);
+    });
+
+    // Park a worker with the last-used core loaded so the first launch
+    // only pays for loading the game (non-blocking).
+    this.emulatorManager.prewarmLastCore().catch((error) => {
+      ipcLog.warn("Failed to prewarm emulation worker:", error);
+    });
+
     // Import bundled homebrew ROMs on first launch (async, non-blocking).
     // Notifies the renderer when done so it can reload the library.
     // Also sets homebrewDone so late-loading renderers can query the state
@@ -83,6 +111,19 @@ export class IPCHandlers {
       });
   }
 
+  /**
+   * Re-apply DAT titles, regions and disc sets. Scans reset those fields from
+   * filenames, so this runs after every scan before results go back to the
+   * renderer (the returned games are the same objects DAT updates mutate).
+   */
+  private async verifyWithDats(): Promise<void> {
+    try {
+      await this.datService.verifyLibrary();
+    } catch (error) {
+      ipcLog.error("DAT verification failed:", error);
+    }
+  }
+
   private setupHandlers(): void {
     // Emulator management
     ipcMain.handle(
@@ -92,6 +133,15 @@ export class IPCHandlers {
       },
     );
 
+    ipcMain.handle("emulator:verifyBios", async () => {
+      try {
+        return { success: true, systems: await this.emulatorManager.verifyAllBios() };
+      } catch (error) {
+        ipcLog.error("Failed to verify BIOS files:", error);
+        return { success: false, error: errorMessage(error) };
+      }
+    });
+
     ipcMain.handle(
       "emulator:downloadCore",
       async (event: IpcMainInvokeEvent, coreName: string, systemId: string) => {
@@ -107,6 +157,24 @@ export class IPCHandlers {
       },
     );
 
+    ipcMain.handle(
+      "emulator:benchmarkCores",
+      async (event: IpcMainInvokeEvent, games: Array<{ romPath: string; systemId: string }>) => {
+        try {
+          const entries = await this.emulatorManager.benchmarkCores(games, (entry) => {
+            ipcLog.info(
+              `Core matrix: ${entry.coreName} on ${entry.romPath}: ` +
+                (entry.result ? `${entry.result.fps.toFixed(0)} fps` : `failed (${entry.error})`),
+            );
+          });
+          return { success: true, entries };
+        } catch (error) {
+          ipcLog.error("Failed to benchmark cores:", error);
+          return { success: false, entries: [], error: errorMessage(error) };
+        }
+      },
+    );
+
     ipcMain.handle(
       "emulator:launch",
       async (
@@ -126,15 +194,22 @@ export class IPCHandlers {
             throw new Error("Game not found in library");
           }
 
-          // Validate BIOS files before attempting to launch
-          const biosCheck = this.emulatorManager.validateBios(systemId);
-          if (!biosCheck.valid) {
+          // Verify BIOS files before attempting to launch
+          const biosCheck = await this.emulatorManager.verifyBios(systemId);
+          if (biosCheck.missingFiles.length > 0) {
             const fileList = biosCheck.missingFiles.join(", ");
             return {
               success: false,
               error: `${biosCheck.systemName} requires BIOS files that are missing: ${fileList}. Place them in: ${biosCheck.biosDir}`,
             };
           }
+          if (biosCheck.badFiles.length > 0) {
+            const fileList = biosCheck.badFiles.join(", ");
+            return {
+              success: false,
+              error: `${biosCheck.systemName} BIOS files don't match a known-good dump: ${fileList}. Replace them in: ${biosCheck.biosDir}`,
+            };
+          }
 
           // Ensure cheat database is downloaded (non-blocking background task)
           this.cheatDatabaseService.ensureDatabase().catch((error) => {
@@ -187,8 +262,9 @@ export class IPCHandlers {
               }
             }
 
-            // Spawn the emulation worker process
-            const workerClient = new EmulationWorkerClient();
+            // Spawn the emulation worker process, or take the spare one
+            // already holding this core
+            const workerClient = this.emulatorManager.takeWorker(nativeCore.getCorePath());
             const addonPath = resolveAddonPath();
 
             // Build disc paths for multi-disc games.
@@ -373,6 +449,26 @@ export class IPCHandlers {
       }
     });
 
+    ipcMain.handle("emulation:setPerfHud", (_event, enabled: boolean) => {
+      try {
+        this.emulatorManager.setPerfHud(enabled);
+        return { success: true };
+      } catch (error) {
+        ipcLog.error("Failed to set performance HUD:", error);
+        return { success: false, error: errorMessage(error) };
+      }
+    });
+
+    ipcMain.handle("emulation:setScreenLayout", async (_event, layout: ScreenLayout) => {
+      try {
+        const size = await this.emulatorManager.setScreenLayout(layout);
+        return { success: true, ...size };
+      } catch (error) {
+        ipcLog.error("Failed to set screen layout:", error);
+        return { success: false, error: errorMessage(error) };
+      }
+    });
+
     ipcMain.handle("emulation:swapDisc", async (_event, index: number) => {
       try {
         await this.emulatorManager.swapDisc(index);
@@ -393,6 +489,38 @@ export class IPCHandlers {
       }
     });
 
+    ipcMain.handle("emulation:loadScript", async (_event, scriptPath?: string) => {
+      try {
+        let file = scriptPath;
+        if (!file) {
+          const result = await dialog.showOpenDialog({
+            title: "Load Frame Script",
+            filters: [{ name: "WebAssembly", extensions: ["wasm"] }],
+            properties: ["openFile"],
+          });
+          if (result.canceled || result.filePaths.length === 0) {
+            return { success: false, canceled: true };
+          }
+          file = result.filePaths[0];
+        }
+        const stats = await this.emulatorManager.loadScript(file);
+        return { success: true, path: file, stats };
+      } catch (error) {
+        ipcLog.error("Failed to load frame script:", error);
+        return { success: false, error: errorMessage(error) };
+      }
+    });
+
+    ipcMain.handle("emulation:unloadScript", async () => {
+      try {
+        await this.emulatorManager.unloadScript();
+        return { success: true };
+      } catch (error) {
+        ipcLog.error("Failed to unload frame script:", error);
+        return { success: false, error: errorMessage(error) };
+      }
+    });
+
     ipcMain.handle("emulation:browseForDisc", async (_event, index: number) => {
       try {
         const result = await dialog.showOpenDialog({
@@ -458,6 +586,23 @@ export class IPCHandlers {
       }
     });
 
+    // Slot previews for any game, read from the state files without a core.
+    ipcMain.handle("savestate:summaries", async (_event, romPath: string) => {
+      try {
+        const romName = path.basename(romPath, path.extname(romPath));
+        const dir = path.join(app.getPath("userData"), "savestates", romName);
+        return { success: true, ...(await readStateSummaries(dir)) };
+      } catch (error) {
+        ipcLog.error("Failed to read save state summaries:", error);
+        return {
+          success: false,
+          states: [],
+          pixels: new Uint8Array(0),
+          error: errorMessage(error),
+        };
+      }
+    });
+
     // Screenshot
     ipcMain.handle("emulation:screenshot", async (event, outputPath?: string) => {
       try {
@@ -650,6 +795,9 @@ export class IPCHandlers {
     this.emulatorManager.on("emulator:discChanged", (data) =>
       forwardEvent("emulator:discChanged", data),
     );
+    this.emulatorManager.on("emulator:scriptOverlay", (text) =>
+      forwardEvent("emulator:scriptOverlay", text),
+    );
     this.emulatorManager.on("emulator:terminated", () => {
       forwardEvent("emulator:terminated");
       this.artworkService.setGameplayActive(false);
@@ -665,6 +813,10 @@ export class IPCHandlers {
     // so we listen on GameWindowManager directly to end gameplay mode.
     this.gameWindowManager.on("gameWindowClosed", () => {
       this.artworkService.setGameplayActive(false);
+      // Park a worker for the core just played; it's the likeliest next launch.
+      this.emulatorManager.prewarmLastCore().catch((error) => {
+        ipcLog.warn("Failed to prewarm emulation worker:", error);
+      });
     });
   }
 
@@ -677,6 +829,13 @@ export class IPCHandlers {
       });
     });
 
+    // Forward watcher-driven library changes so the renderer can refresh
+    this.libraryService.on("libraryChanged", (summary) => {
+      for (const window of BrowserWindow.getAllWindows()) {
+        window.webContents.send("library:changed", summary);
+      }
+    });
+
     // Homebrew import status — lets the renderer check if the import check
     // has already completed (the event may have fired before the renderer loaded).
     ipcMain.handle("library:isHomebrewDone", () => {
@@ -747,11 +906,13 @@ export class IPCHandlers {
 
     ipcMain.handle("library:addSystem", async (event, system: GameSystem) => {
       await this.libraryService.addSystem(system);
+      void this.libraryWatcher.restart();
       return { success: true };
     });
 
     ipcMain.handle("library:removeSystem", async (event, systemId: string) => {
       await this.libraryService.removeSystem(systemId);
+      void this.libraryWatcher.restart();
       return { success: true };
     });
 
@@ -759,6 +920,7 @@ export class IPCHandlers {
       "library:updateSystemPath",
       async (event, systemId: string, romsPath: string) => {
         await this.libraryService.updateSystemPath(systemId, romsPath);
+        void this.libraryWatcher.restart();
         return { success: true };
       },
     );
@@ -768,6 +930,10 @@ export class IPCHandlers {
       return this.libraryService.getGames(systemId);
     });
 
+    ipcMain.handle("library:searchGames", (event, query: string, limit?: number) => {
+      return this.libraryService.searchGames(query, limit);
+    });
+
     ipcMain.handle("library:addGame", async (event, romPath: string, systemId: string) => {
       const game = await this.libraryService.addGame(romPath, systemId);
       return game;
@@ -788,12 +954,14 @@ export class IPCHandlers {
       "library:scanDirectory",
       async (event, directoryPath: string, systemId?: string) => {
         const games = await this.libraryService.scanDirectory(directoryPath, systemId);
+        await this.verifyWithDats();
         return games;
       },
     );
 
     ipcMain.handle("library:scanSystemFolders", async () => {
       const games = await this.libraryService.scanSystemFolders();
+      await this.verifyWithDats();
       return games;
     });
 
@@ -804,6 +972,7 @@ export class IPCHandlers {
 
     ipcMain.handle("library:setRomsBasePath", async (event, basePath: string) => {
       await this.libraryService.setRomsBasePath(basePath);
+      void this.libraryWatcher.restart();
       return { success: true };
     });
 
@@ -1009,10 +1178,12 @@ export class IPCHandlers {
     // before the shutdown handshake completes.
     this.emulatorManager.prepareForQuit();
     await this.emulatorManager.stopEmulator();
+    await this.emulatorManager.destroySpareWorker();
 
     // Stop any in-progress artwork sync and flush pending batched library
     // writes so artwork downloaded during this session isn't lost on quit.
     this.artworkService.cancelSync();
+    await this.libraryWatcher.stop();
     await this.libraryService.flushSave();
   }
 
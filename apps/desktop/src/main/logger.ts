@@ -40,5 +40,6 @@ export const libretroLog = log.scope("libretro");
 export const artworkLog = log.scope("artwork");
 export const mainLog = log.scope("main");
 export const updaterLog = log.scope("updater");
+export const nativeLog = log.scope("native");
 
 export default log;
@@ -0,0 +1,50 @@
+import { describe, it, expect, beforeEach, vi } from "vitest";
+
+const resolveAddonPath = vi.fn<() => string>();
+
+vi.mock("../emulator/resolveAddonPath", () => ({
+  resolveAddonPath: () => resolveAddonPath(),
+}));
+
+vi.mock("../logger", () => ({
+  nativeLog: {
+    debug: vi.fn(),
+    error: vi.fn(),
+    info: vi.fn(),
+    warn: vi.fn(),
+  },
+}));
+
+import { loadNativeAddon, resetNativeAddonForTesting } from "./nativeAddon";
+
+describe("loadNativeAddon", () => {
+  beforeEach(() => {
+    resetNativeAddonForTesting();
+    resolveAddonPath.mockReset();
+  });
+
+  it("returns null when the addon has not been built", () => {
+    resolveAddonPath.mockImplementation(() => {
+      throw new Error("Failed to locate libretro native addon");
+    });
+
+    expect(loadNativeAddon()).toBeNull();
+  });
+
+  it("returns null when the addon file fails to load", () => {
+    resolveAddonPath.mockReturnValue("/nonexistent/gamelord_libretro.node");
+
+    expect(loadNativeAddon()).toBeNull();
+  });
+
+  it("caches the load result so the lookup only happens once", () => {
+    resolveAddonPath.mockImplementation(() => {
+      throw new Error("Failed to locate libretro native addon");
+    });
+
+    loadNativeAddon();
+    loadNativeAddon();
+
+    expect(resolveAddonPath).toHaveBeenCalledOnce();
+  });
+});
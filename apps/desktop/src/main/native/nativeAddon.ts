@@ -0,0 +1,375 @@
+import { createRequire } from "node:module";
+
+import { resolveAddonPath } from "../emulator/resolveAddonPath";
+import { nativeLog } from "../logger";
+
+// ---------------------------------------------------------------------------
+// Native library scanner (library_scanner.cc)
+// ---------------------------------------------------------------------------
+
+/** A ROM-ish file reported by the native scanner. */
+export interface NativeScanFile {
+  /** Lowercase extension with leading dot. */
+  ext: string;
+  /** File modification time, computed exactly like `fs.Stats#mtimeMs`. */
+  mtimeMs: number;
+  /** Basename within the containing directory. */
+  name: string;
+  /** Raw `.cue` FILE / `.m3u` entries (unresolved), or null for other files. */
+  refs: Array<string> | null;
+  size: number;
+  /** System ID identified from the file header, when the extension was ambiguous. */
+  sniffedSystemId: string | null;
+}
+
+/** One directory's worth of scan results. Batches never split a directory. */
+export interface NativeScanDirectory {
+  files: Array<NativeScanFile>;
+  path: string;
+  /** System inherited from the root or resolved from a system-named folder. */
+  systemId: string | null;
+}
+
+export interface NativeScanOptions {
+  /** Minimum number of files per streamed batch. */
+  batchSize?: number;
+  recursive: boolean;
+  roots: Array<{ path: string; systemId?: string }>;
+  systems: Array<{ extensions: Array<string>; id: string; name: string; shortName: string }>;
+  /** Worker thread count (0 = hardware concurrency - 1). */
+  threads?: number;
+}
+
+export interface NativeScanSummary {
+  directories: number;
+  elapsedMs: number;
+  errors: Array<{ message: string; path: string }>;
+  filesMatched: number;
+  filesSeen: number;
+  filesSniffed: number;
+}
+
+// ---------------------------------------------------------------------------
+// Library watcher (library_watcher.cc, Linux inotify)
+// ---------------------------------------------------------------------------
+
+/** A coalesced filesystem change under a watched library root. */
+export interface NativeWatchChange {
+  isDirectory: boolean;
+  /** Previous path, for renames. */
+  oldPath?: string;
+  /** Empty for `overflow`. */
+  path: string;
+  /** `overflow` means events were dropped and the caller must fully reconcile. */
+  type: "add" | "change" | "overflow" | "remove" | "rename";
+}
+
+export interface NativeWatcherOptions {
+  /** Quiet period before a burst of changes is delivered. */
+  coalesceMs?: number;
+  /** Lowercase extensions (with dot) to report file changes for; empty = all. */
+  extensions?: Array<string>;
+  roots: Array<string>;
+}
+
+export interface NativeWatchStartResult {
+  /** Every directory now being watched, with its current mtime. */
+  directories: Array<{ mtimeMs: number; path: string }>;
+  errors: Array<{ message: string; path: string }>;
+}
+
+export interface NativeLibraryWatcher {
+  close(): void;
+  /** Install the recursive watch set. Throws on platforms without inotify. */
+  start(): NativeWatchStartResult;
+}
+
+// ---------------------------------------------------------------------------
+// Binary library store (library_store.cc)
+// ---------------------------------------------------------------------------
+
+/**
+ * Flat record persisted by the native store. Hashes are lowercase hex;
+ * anything without a fixed column is carried in `extra` as JSON.
+ */
+export interface NativeStoreRecord {
+  artworkNotFound?: number;
+  coverArt?: string;
+  coverArtAspectRatio?: number;
+  crc32?: string;
+  discGroup?: string;
+  discNumber?: number;
+  discTotal?: number;
+  extra?: string;
+  favorite?: boolean;
+  id: string;
+  m3uPath?: string;
+  md5?: string;
+  playTime?: number;
+  romMtime?: number;
+  romPath?: string;
+  serial?: string;
+  sha1?: string;
+  sourceArchivePath?: string;
+  system?: string;
+  systemId?: string;
+  title?: string;
+}
+
+export interface NativeStoreStats {
+  baseBytes: number;
+  logBytes: number;
+  records: number;
+}
+
+export interface NativeLibraryStore {
+  close(): void;
+  /** Fold the change log into a new base image on a worker thread. */
+  compact(): Promise<void>;
+  /** Returns false when no store exists on disk yet. Throws if it is corrupt. */
+  open(): boolean;
+  put(records: Array<NativeStoreRecord>): void;
+  readAll(): Array<NativeStoreRecord>;
+  remove(ids: Array<string>): void;
+  /** Write `records` as the whole library, discarding the current contents. */
+  replaceAll(records: Array<NativeStoreRecord>): Promise<void>;
+  stats(): NativeStoreStats;
+}
+
+// ---------------------------------------------------------------------------
+// Title search index (search_index.cc)
+// ---------------------------------------------------------------------------
+
+export interface NativeSearchIndex {
+  clear(): void;
+  /**
+   * Matching ids, best first: exact title, title prefix, every word matched
+   * at a word start, then plain substring. `limit` 0 or omitted = all.
+   */
+  query(text: string, limit?: number): Promise<Array<string>>;
+  remove(ids: Array<string>): void;
+  size(): number;
+  upsert(entries: Array<{ id: string; title: string }>): void;
+}
+
+// ---------------------------------------------------------------------------
+// DAT verification index (dat_index.cc)
+// ---------------------------------------------------------------------------
+
+export interface NativeDatLoadOptions {
+  /** Logiqx XML or clrmamepro DAT files. */
+  files: Array<string>;
+  /** Where to cache the parsed index. Omit to always re-parse. */
+  cachePath?: string;
+  /** Identifies the DAT set; a cache written under another key is ignored. */
+  cacheKey?: string;
+}
+
+export interface NativeDatLoadResult {
+  dats: number;
+  games: number;
+  roms: number;
+  fromCache: boolean;
+  /** Per-file parse failures; the other files still load. */
+  errors: Array<{ path: string; message: string }>;
+}
+
+export interface NativeDatQuery {
+  crc32?: string;
+  md5?: string;
+  sha1?: string;
+  size?: number;
+}
+
+export interface NativeDatMatch {
+  /** DAT header name, e.g. "Sony - PlayStation". */
+  dat: string;
+  /** Game name, e.g. "Final Fantasy VII (USA) (Disc 1)". */
+  name: string;
+  description: string;
+  romName: string;
+  matchedBy: "sha1" | "md5" | "crc32";
+  discNumber?: number;
+  discTotal?: number;
+}
+
+export interface NativeDatIndex {
+  load(options: NativeDatLoadOptions): Promise<NativeDatLoadResult>;
+  /**
+   * Match by SHA-1, then MD5, then CRC32 (with size when both sides have
+   * it). Hashes are hex, any case. One entry per query, null when unmatched.
+   */
+  match(queries: Array<NativeDatQuery>): Array<NativeDatMatch | null>;
+}
+
+// ---------------------------------------------------------------------------
+// ZIP central directories (zip_reader.cc)
+// ---------------------------------------------------------------------------
+
+export interface NativeZipEntry {
+  compressedSize: number;
+  /** CRC32 of the uncompressed data, 8 lowercase hex digits. */
+  crc32: string;
+  /** 0 = stored, 8 = deflate. */
+  method: number;
+  name: string;
+  /** Uncompressed size. */
+  size: number;
+}
+
+/** One archive's listing, or why it couldn't be read. */
+export type NativeZipDirectory = { entries: Array<NativeZipEntry> } | { error: string };
+
+// ---------------------------------------------------------------------------
+// Save state summaries (state_summary.cc)
+// ---------------------------------------------------------------------------
+
+/** One save state slot, read from its container header. */
+export interface NativeStateSummary {
+  /** Null for legacy states written before the container header. */
+  coreName: string | null;
+  coreVersion: string | null;
+  /** Save time in ms since the epoch (file mtime for legacy states). */
+  createdAt: number;
+  /** Basename within the directory. */
+  file: string;
+  slot: number;
+  /** Size of the core's serialized state. */
+  stateSize: number;
+  /** Location of the RGBA8888 thumbnail in `pixels`, or null. */
+  thumbnail: { height: number; offset: number; width: number } | null;
+}
+
+export interface NativeStateSummaries {
+  /** Every thumbnail, back to back. */
+  pixels: Buffer;
+  /** Sorted by slot. */
+  states: Array<NativeStateSummary>;
+}
+
+// ---------------------------------------------------------------------------
+// BIOS verification (bios_verifier.cc)
+// ---------------------------------------------------------------------------
+
+/** A system file the core expects in the system directory. */
+export interface NativeBiosFile {
+  /** Name within the system directory. */
+  file: string;
+  /** Known-good dumps, hex. Empty accepts any content. */
+  md5: Array<string>;
+  /** Expected size in bytes; omit to accept any. */
+  size?: number;
+}
+
+export interface NativeBiosReport {
+  cached: boolean;
+  file: string;
+  /** Lowercase hex, or null when missing or unreadable. */
+  md5: string | null;
+  size: number;
+  status: "verified" | "missing" | "bad";
+}
+
+// ---------------------------------------------------------------------------
+// Image resizing
+// ---------------------------------------------------------------------------
+
+/**
+ * One source image and the sizes to produce from it. `pixels` is 4 bytes per
+ * pixel, premultiplied, alpha last — the layout of `nativeImage.toBitmap()`.
+ */
+export interface NativeResizeJob {
+  height: number;
+  pixels: Buffer;
+  targets: Array<{ height: number; width: number }>;
+  width: number;
+}
+
+// ---------------------------------------------------------------------------
+// Loader
+// ---------------------------------------------------------------------------
+
+/**
+ * Main-process view of the native addon. The same `.node` binary also
+ * exports `LibretroCore`, which is only ever loaded inside the emulation
+ * worker (see `core-worker-protocol.ts`).
+ */
+export interface MainNativeAddon {
+  LibraryStore: new (path: string) => NativeLibraryStore;
+  SearchIndex: new () => NativeSearchIndex;
+  DatIndex: new () => NativeDatIndex;
+  LibraryWatcher: new (
+    options: NativeWatcherOptions,
+    onChanges: (changes: Array<NativeWatchChange>) => void,
+  ) => NativeLibraryWatcher;
+  /**
+   * List archives from their central directories without decompressing.
+   * Directories and `__MACOSX/` entries are omitted. Results are in input
+   * order.
+   */
+  readZipDirectories(
+    paths: Array<string>,
+    options?: { threads?: number },
+  ): Promise<Array<NativeZipDirectory>>;
+  /**
+   * Read the headers and thumbnails of every save state in a directory
+   * (mapping only those bytes, in parallel). A missing directory resolves
+   * with no states. Rejects on unsupported platforms.
+   */
+  readStateSummaries(dir: string): Promise<NativeStateSummaries>;
+  /**
+   * MD5 each expected system file in parallel and compare it with its
+   * known-good dumps. Hashes are cached by path, size and mtime in
+   * `cachePath`. Results are in input order. Rejects on unsupported platforms.
+   */
+  verifyBiosFiles(
+    dir: string,
+    files: Array<NativeBiosFile>,
+    cachePath?: string,
+  ): Promise<Array<NativeBiosReport>>;
+  /**
+   * Lanczos-resample each job to its targets on the thread pool. Resolves
+   * with one buffer per target, in the input's pixel layout.
+   */
+  resizeImages(jobs: Array<NativeResizeJob>): Promise<Array<Array<Buffer>>>;
+  scanLibrary(
+    options: NativeScanOptions,
+    onBatch: (batch: Array<NativeScanDirectory>) => void,
+  ): Promise<NativeScanSummary>;
+}
+
+let cachedAddon: MainNativeAddon | null | undefined;
+
+/**
+ * Load the native addon in the main process for library services.
+ *
+ * Returns null when the addon hasn't been built (fresh checkout, tests) or
+ * fails to load — callers fall back to their JS implementations. The result
+ * is cached, including failure, so a missing addon is only logged once.
+ */
+export function loadNativeAddon(): MainNativeAddon | null {
+  if (cachedAddon !== undefined) {
+    return cachedAddon;
+  }
+
+  try {
+    const addonPath = resolveAddonPath();
+    // The main bundle is ESM, so `require` has to be recreated to load the
+    // `.node` binary (native addons can't be imported).
+    const nativeRequire = createRequire(import.meta.url);
+    cachedAddon = nativeRequire(addonPath) as MainNativeAddon;
+  } catch (error) {
+    nativeLog.info(
+      "Native addon unavailable in main process, using JS fallbacks:",
+      error instanceof Error ? error.message : String(error),
+    );
+    cachedAddon = null;
+  }
+
+  return cachedAddon;
+}
+
+/** Reset the cached load result. Test-only. */
+export function resetNativeAddonForTesting(): void {
+  cachedAddon = undefined;
+}
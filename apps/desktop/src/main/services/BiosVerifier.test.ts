@@ -0,0 +1,99 @@
+// @vitest-environment node
+import { describe, it, expect, beforeEach, afterEach, vi } from "vitest";
+import fs from "node:fs";
+import os from "node:os";
+import path from "node:path";
+
+const TEST_DIR = path.join(os.tmpdir(), "gamelord-bios-verifier-test-" + Date.now());
+const CACHE_PATH = path.join(TEST_DIR, "bios-cache.txt");
+
+vi.mock("../logger", () => ({
+  nativeLog: { debug: vi.fn(), error: vi.fn(), info: vi.fn(), warn: vi.fn() },
+}));
+
+const nativeAddonMock = vi.hoisted(() => ({
+  loadNativeAddon: vi.fn((): unknown => null),
+}));
+vi.mock("../native/nativeAddon", () => nativeAddonMock);
+
+import { verifyBiosFiles } from "./BiosVerifier";
+
+// MD5 of "abc".
+const ABC_MD5 = "900150983cd24fb0d6963f7d28e17f72";
+
+beforeEach(() => {
+  fs.mkdirSync(TEST_DIR, { recursive: true });
+  nativeAddonMock.loadNativeAddon.mockClear();
+});
+
+afterEach(() => {
+  fs.rmSync(TEST_DIR, { force: true, recursive: true });
+});
+
+describe("verifyBiosFiles", () => {
+  it("reports verified, bad and missing files in input order", async () => {
+    fs.writeFileSync(path.join(TEST_DIR, "good.bin"), "abc");
+    fs.writeFileSync(path.join(TEST_DIR, "bad.bin"), "abd");
+
+    const reports = await verifyBiosFiles(
+      TEST_DIR,
+      [
+        { file: "good.bin", md5: [ABC_MD5.toUpperCase()], size: 3 },
+        { file: "bad.bin", md5: [ABC_MD5] },
+        { file: "missing.bin", md5: [ABC_MD5] },
+      ],
+      CACHE_PATH,
+    );
+
+    expect(reports.map((r) => r.status)).toEqual(["verified", "bad", "missing"]);
+    expect(reports[0]).toEqual({
+      cached: false,
+      file: "good.bin",
+      md5: ABC_MD5,
+      size: 3,
+      status: "verified",
+    });
+    expect(reports[2].md5).toBe(null);
+  });
+
+  it("flags a known hash with the wrong size as bad", async () => {
+    fs.writeFileSync(path.join(TEST_DIR, "good.bin"), "abc");
+    const [report] = await verifyBiosFiles(
+      TEST_DIR,
+      [{ file: "good.bin", md5: [ABC_MD5], size: 524_288 }],
+      CACHE_PATH,
+    );
+    expect(report.status).toBe("bad");
+  });
+
+  it("reuses cached hashes until the file changes", async () => {
+    const file = path.join(TEST_DIR, "good.bin");
+    fs.writeFileSync(file, "abc");
+    const expected = [{ file: "good.bin", md5: [ABC_MD5] }];
+
+    await verifyBiosFiles(TEST_DIR, expected, CACHE_PATH);
+    const [second] = await verifyBiosFiles(TEST_DIR, expected, CACHE_PATH);
+    expect(second.cached).toBe(true);
+    expect(second.status).toBe("verified");
+
+    fs.writeFileSync(file, "xyz");
+    fs.utimesSync(file, new Date(), new Date(Date.now() + 5000));
+    const [third] = await verifyBiosFiles(TEST_DIR, expected, CACHE_PATH);
+    expect(third.cached).toBe(false);
+    expect(third.status).toBe("bad");
+  });
+
+  it("prefers the native verifier when the addon provides it", async () => {
+    const native = [
+      { cached: true, file: "a.bin", md5: ABC_MD5, size: 3, status: "verified" as const },
+    ];
+    const verifyBiosFilesNative = vi.fn(async () => native);
+    nativeAddonMock.loadNativeAddon.mockReturnValueOnce({
+      verifyBiosFiles: verifyBiosFilesNative,
+    });
+    const expected = [{ file: "a.bin", md5: [ABC_MD5] }];
+
+    expect(await verifyBiosFiles(TEST_DIR, expected, CACHE_PATH)).toBe(native);
+    expect(verifyBiosFilesNative).toHaveBeenCalledWith(TEST_DIR, expected, CACHE_PATH);
+  });
+});
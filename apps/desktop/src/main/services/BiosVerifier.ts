@@ -0,0 +1,126 @@
+import { createHash } from "node:crypto";
+import { promises as fs } from "node:fs";
+import path from "node:path";
+import { nativeLog } from "../logger";
+import {
+  loadNativeAddon,
+  type NativeBiosFile,
+  type NativeBiosReport,
+} from "../native/nativeAddon";
+
+const CACHE_HEADER = "gamelord-bios-cache 1";
+
+interface CacheEntry {
+  md5: string;
+  mtimeMs: number;
+  size: number;
+}
+
+/**
+ * Check expected system files against their known-good dumps before a core
+ * is loaded. Uses the addon's threaded hasher when it is available; both
+ * paths share the same path/size/mtime hash cache file, so only new or
+ * changed files are ever re-read.
+ */
+export async function verifyBiosFiles(
+  dir: string,
+  files: Array<NativeBiosFile>,
+  cachePath: string,
+): Promise<Array<NativeBiosReport>> {
+  const addon = loadNativeAddon();
+  if (typeof addon?.verifyBiosFiles === "function") {
+    try {
+      return await addon.verifyBiosFiles(dir, files, cachePath);
+    } catch (error) {
+      nativeLog.warn("Native BIOS verification failed, using JS fallback:", error);
+    }
+  }
+  return verifyBiosFilesJs(dir, files, cachePath);
+}
+
+async function verifyBiosFilesJs(
+  dir: string,
+  files: Array<NativeBiosFile>,
+  cachePath: string,
+): Promise<Array<NativeBiosReport>> {
+  const cache = await readCache(cachePath);
+  let dirty = false;
+
+  const reports = await Promise.all(
+    files.map(async (expected): Promise<NativeBiosReport> => {
+      const filePath = path.join(dir, expected.file);
+      const report: NativeBiosReport = {
+        cached: false,
+        file: expected.file,
+        md5: null,
+        size: 0,
+        status: "missing",
+      };
+      try {
+        const stat = await fs.stat(filePath);
+        if (!stat.isFile()) {
+          return report;
+        }
+        report.size = stat.size;
+        const hit = cache.get(filePath);
+        if (hit && hit.size === stat.size && hit.mtimeMs === stat.mtimeMs) {
+          report.md5 = hit.md5;
+          report.cached = true;
+        } else {
+          report.md5 = createHash("md5")
+            .update(await fs.readFile(filePath))
+            .digest("hex");
+          cache.set(filePath, { md5: report.md5, mtimeMs: stat.mtimeMs, size: stat.size });
+          dirty = true;
+        }
+      } catch {
+        return report;
+      }
+
+      const known = expected.md5.map((hash) => hash.toLowerCase());
+      const sizeOk = expected.size === undefined || expected.size === report.size;
+      const md5Ok = known.length === 0 || known.includes(report.md5);
+      report.status = sizeOk && md5Ok ? "verified" : "bad";
+      return report;
+    }),
+  );
+
+  if (dirty) {
+    await writeCache(cachePath, cache).catch((error) => {
+      nativeLog.warn("Failed to write BIOS hash cache:", error);
+    });
+  }
+  return reports;
+}
+
+/** One entry per line: `<md5> <size> <mtimeMs> <path>`, as the addon writes it. */
+async function readCache(cachePath: string): Promise<Map<string, CacheEntry>> {
+  const cache = new Map<string, CacheEntry>();
+  let text: string;
+  try {
+    text = await fs.readFile(cachePath, "utf8");
+  } catch {
+    return cache;
+  }
+  const [header, ...lines] = text.split("\n");
+  if (header !== CACHE_HEADER) {
+    return cache;
+  }
+  for (const line of lines) {
+    const match = line.match(/^([0-9a-f]{32}) (\d+) (\S+) (.+)$/);
+    if (match) {
+      cache.set(match[4], { md5: match[1], mtimeMs: Number(match[3]), size: Number(match[2]) });
+    }
+  }
+  return cache;
+}
+
+async function writeCache(cachePath: string, cache: Map<string, CacheEntry>): Promise<void> {
+  const lines = [CACHE_HEADER];
+  for (const [filePath, entry] of cache) {
+    lines.push(`${entry.md5} ${entry.size} ${entry.mtimeMs} ${filePath}`);
+  }
+  const tmp = `${cachePath}.tmp`;
+  await fs.writeFile(tmp, lines.join("\n") + "\n");
+  await fs.rename(tmp, cachePath);
+}
@@ -0,0 +1,201 @@
+import { describe, it, expect, beforeEach, afterEach, vi } from "vitest";
+import fs from "node:fs";
+import os from "node:os";
+import path from "node:path";
+
+const TEST_DIR = path.join(os.tmpdir(), "gamelord-dat-service-test-" + Date.now());
+
+vi.mock("electron", () => ({
+  app: {
+    getPath: vi.fn(() => TEST_DIR),
+  },
+}));
+
+vi.mock("../logger", () => ({
+  libraryLog: {
+    debug: vi.fn(),
+    error: vi.fn(),
+    info: vi.fn(),
+    warn: vi.fn(),
+  },
+}));
+
+const nativeAddonMock = vi.hoisted(() => ({
+  loadNativeAddon: vi.fn((): unknown => null),
+}));
+vi.mock("../native/nativeAddon", () => nativeAddonMock);
+
+import { DatService, datTitle, parseDatRegions } from "./DatService";
+import type { LibraryService } from "./LibraryService";
+import type { NativeDatMatch, NativeDatQuery } from "../native/nativeAddon";
+import type { Game } from "../../types/library";
+
+const DAT_DIR = path.join(TEST_DIR, "dats");
+
+/** Fake native index answering from a sha1 → match table. */
+function installDatIndex(table: Record<string, NativeDatMatch>) {
+  const state = {
+    loads: [] as Array<{ cacheKey?: string; cachePath?: string; files: Array<string> }>,
+    queries: [] as Array<Array<NativeDatQuery>>,
+  };
+
+  class FakeDatIndex {
+    async load(options: { cacheKey?: string; cachePath?: string; files: Array<string> }) {
+      state.loads.push(options);
+      return { dats: options.files.length, errors: [], fromCache: false, games: 0, roms: 0 };
+    }
+    match(queries: Array<NativeDatQuery>) {
+      state.queries.push(queries);
+      return queries.map((query) => (query.sha1 ? (table[query.sha1] ?? null) : null));
+    }
+  }
+
+  nativeAddonMock.loadNativeAddon.mockReturnValue({ DatIndex: FakeDatIndex });
+  return state;
+}
+
+function makeGame(id: string, overrides: Partial<Game> = {}): Game {
+  return {
+    id,
+    romHashes: { crc32: "00000000", md5: "", sha1: id },
+    romPath: `/roms/${id}`,
+    system: "Super Nintendo Entertainment System",
+    systemId: "snes",
+    title: id,
+    ...overrides,
+  };
+}
+
+function createLibrary(games: Array<Game>) {
+  const library = {
+    flushSave: vi.fn(async () => {}),
+    getGames: vi.fn(() => games),
+    updateGameBatched: vi.fn((id: string, updates: Partial<Game>) => {
+      const game = games.find((g) => g.id === id);
+      if (game) {
+        Object.assign(game, updates);
+      }
+    }),
+    whenReady: vi.fn(async () => {}),
+  };
+  return { library: library as unknown as LibraryService, mock: library };
+}
+
+beforeEach(() => {
+  fs.mkdirSync(DAT_DIR, { recursive: true });
+});
+
+afterEach(() => {
+  nativeAddonMock.loadNativeAddon.mockReset();
+  nativeAddonMock.loadNativeAddon.mockReturnValue(null);
+  fs.rmSync(TEST_DIR, { force: true, recursive: true });
+});
+
+describe("DAT name helpers", () => {
+  it("reads regions from the first region tag", () => {
+    expect(parseDatRegions("Street Fighter II (USA, Europe) (Rev 1)")).toEqual(["us", "eu"]);
+    expect(parseDatRegions("Mother 2 (Japan) (En)")).toEqual(["jp"]);
+    expect(parseDatRegions("Some Demo (PD)")).toEqual([]);
+  });
+
+  it("strips tags from titles", () => {
+    expect(datTitle("Final Fantasy VII (USA) (Disc 2) [b]")).toBe("Final Fantasy VII");
+  });
+});
+
+describe("DatService", () => {
+  it("skips verification when no DATs are installed", async () => {
+    const state = installDatIndex({});
+    const { library, mock } = createLibrary([makeGame("a")]);
+
+    const result = await new DatService(library).verifyLibrary();
+
+    expect(result).toEqual({ matched: 0, total: 0 });
+    expect(state.loads).toHaveLength(0);
+    expect(mock.updateGameBatched).not.toHaveBeenCalled();
+  });
+
+  it("applies DAT titles, regions and disc sets to matched games", async () => {
+    fs.writeFileSync(path.join(DAT_DIR, "snes.dat"), "");
+    fs.writeFileSync(path.join(DAT_DIR, "notes.txt"), "");
+    const state = installDatIndex({
+      disc: {
+        dat: "Redump",
+        description: "",
+        discNumber: 2,
+        discTotal: 3,
+        matchedBy: "sha1",
+        name: "Tales (Japan) (Disc 2)",
+        romName: "t.cue",
+      },
+      snes: {
+        dat: "Nintendo - SNES",
+        description: "",
+        matchedBy: "sha1",
+        name: "Super Mario World (Japan)",
+        romName: "smw.sfc",
+      },
+    });
+    const games = [makeGame("snes"), makeGame("disc"), makeGame("unknown")];
+    const { library, mock } = createLibrary(games);
+
+    const result = await new DatService(library).verifyLibrary();
+
+    expect(result).toEqual({ matched: 2, total: 3 });
+    expect(state.loads[0].files).toEqual([path.join(DAT_DIR, "snes.dat")]);
+    expect(state.loads[0].cachePath).toBe(path.join(TEST_DIR, "dat-index.bin"));
+    expect(games[0]).toMatchObject({
+      datVerified: { dat: "Nintendo - SNES", name: "Super Mario World (Japan)" },
+      romRegions: ["jp"],
+      system: "Super Famicom",
+      title: "Super Mario World",
+    });
+    expect(games[1]).toMatchObject({
+      discGroup: "dat:Tales (Japan):snes",
+      discNumber: 2,
+      discTotal: 3,
+      title: "Tales",
+    });
+    expect(games[2].datVerified).toBeUndefined();
+    expect(mock.flushSave).toHaveBeenCalled();
+  });
+
+  it("reuses the loaded index and leaves in-sync games alone", async () => {
+    fs.writeFileSync(path.join(DAT_DIR, "nes.xml"), "");
+    const state = installDatIndex({
+      a: { dat: "NES", description: "", matchedBy: "sha1", name: "Zelda (USA)", romName: "z" },
+    });
+    const { library, mock } = createLibrary([makeGame("a", { systemId: "nes" })]);
+    const service = new DatService(library);
+
+    await service.verifyLibrary();
+    mock.updateGameBatched.mockClear();
+    await service.verifyLibrary();
+
+    expect(state.loads).toHaveLength(1);
+    expect(state.queries).toHaveLength(2);
+    expect(mock.updateGameBatched).not.toHaveBeenCalled();
+  });
+
+  it("keeps .m3u disc grouping", async () => {
+    fs.writeFileSync(path.join(DAT_DIR, "psx.dat"), "");
+    installDatIndex({
+      d: {
+        dat: "Redump",
+        description: "",
+        discNumber: 1,
+        discTotal: 2,
+        matchedBy: "sha1",
+        name: "Game (USA) (Disc 1)",
+        romName: "g.cue",
+      },
+    });
+    const game = makeGame("d", { discGroup: "m3u:/roms/Game.m3u", m3uPath: "/roms/Game.m3u" });
+    const { library } = createLibrary([game]);
+
+    await new DatService(library).verifyLibrary();
+
+    expect(game.discGroup).toBe("m3u:/roms/Game.m3u");
+    expect(game.title).toBe("Game");
+  });
+});
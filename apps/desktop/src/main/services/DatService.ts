@@ -0,0 +1,235 @@
+import { promises as fs } from "node:fs";
+import path from "node:path";
+import { app } from "electron";
+import { libraryLog } from "../logger";
+import { loadNativeAddon, type NativeDatIndex, type NativeDatMatch } from "../native/nativeAddon";
+import { Game, getRegionalSystemName } from "../../types/library";
+import type { LibraryService } from "./LibraryService";
+
+const DAT_EXTENSIONS = new Set([".dat", ".xml"]);
+
+/**
+ * No-Intro / Redump region names → ScreenScraper region codes, so DAT
+ * results share `romRegions` and regional system names with artwork sync.
+ */
+const DAT_REGION_CODES: Record<string, string> = {
+  Asia: "asi",
+  Australia: "au",
+  Brazil: "br",
+  China: "cn",
+  Europe: "eu",
+  France: "fr",
+  Germany: "de",
+  Italy: "it",
+  Japan: "jp",
+  Korea: "kr",
+  Spain: "sp",
+  USA: "us",
+  World: "wor",
+};
+
+export interface DatVerifyResult {
+  matched: number;
+  total: number;
+}
+
+/** Region codes from a DAT name's tags, e.g. "(USA, Europe)" → ["us", "eu"]. */
+export function parseDatRegions(name: string): Array<string> {
+  const regions: Array<string> = [];
+  for (const [, tag] of name.matchAll(/\(([^)]*)\)/g)) {
+    for (const part of tag.split(",")) {
+      const code = DAT_REGION_CODES[part.trim()];
+      if (code && !regions.includes(code)) {
+        regions.push(code);
+      }
+    }
+    // Region is the first tag in No-Intro / Redump naming; later tags are
+    // languages, revisions and disc numbers.
+    if (regions.length > 0) {
+      break;
+    }
+  }
+  return regions;
+}
+
+/** Display title for a DAT name: tags in parentheses / brackets removed. */
+export function datTitle(name: string): string {
+  return name
+    .replaceAll(/\([^)]*\)/g, "")
+    .replaceAll(/\[[^\]]*\]/g, "")
+    .replaceAll(/\s+/g, " ")
+    .trim();
+}
+
+/**
+ * Verifies library ROMs against No-Intro / Redump DAT files dropped into
+ * `userData/dats`, without any network lookups.
+ *
+ * The DATs are parsed by the native `DatIndex` into a hash index that is
+ * cached in `dat-index.bin` and only rebuilt when a DAT is added, removed or
+ * modified. Matched games get the DAT's canonical title, regions and disc
+ * set. Requires the native addon; without it verification is skipped.
+ */
+export class DatService {
+  private libraryService: LibraryService;
+  private datDirectory: string;
+  private cachePath: string;
+  private index: NativeDatIndex | null = null;
+  private indexKey: string | null = null;
+  /** Serializes runs so a scan finishing mid-verify queues a second pass. */
+  private chain: Promise<unknown> = Promise.resolve();
+
+  constructor(libraryService: LibraryService) {
+    this.libraryService = libraryService;
+    const userData = app.getPath("userData");
+    this.datDirectory = path.join(userData, "dats");
+    this.cachePath = path.join(userData, "dat-index.bin");
+  }
+
+  /** Match every hashed game in the library against the installed DATs. */
+  verifyLibrary(): Promise<DatVerifyResult> {
+    const run = this.chain.then(() => this.runVerify());
+    this.chain = run.catch(() => {});
+    return run;
+  }
+
+  private async runVerify(): Promise<DatVerifyResult> {
+    await this.libraryService.whenReady();
+    const index = await this.loadIndex();
+    if (!index) {
+      return { matched: 0, total: 0 };
+    }
+
+    const games = this.libraryService
+      .getGames()
+      .filter((game) => game.romHashes?.sha1 || game.romHashes?.md5 || game.romHashes?.crc32);
+    const start = performance.now();
+    const matches = index.match(
+      games.map((game) => ({
+        crc32: game.romHashes.crc32 || undefined,
+        md5: game.romHashes.md5 || undefined,
+        sha1: game.romHashes.sha1 || undefined,
+      })),
+    );
+
+    let matched = 0;
+    let updated = 0;
+    for (const [i, game] of games.entries()) {
+      const match = matches[i];
+      if (!match) {
+        continue;
+      }
+      matched++;
+      const updates = this.buildUpdates(game, match);
+      if (Object.keys(updates).length > 0) {
+        this.libraryService.updateGameBatched(game.id, updates);
+        updated++;
+      }
+    }
+    await this.libraryService.flushSave();
+
+    libraryLog.info(
+      `DAT verification: ${matched}/${games.length} matched, ${updated} updated in ${Math.round(performance.now() - start)}ms`,
+    );
+    return { matched, total: games.length };
+  }
+
+  /** Fields that differ from what the DAT says. Empty when already in sync. */
+  private buildUpdates(game: Game, match: NativeDatMatch): Partial<Game> {
+    const target: Partial<Game> = {
+      title: datTitle(match.name) || game.title,
+    };
+
+    const regions = parseDatRegions(match.name);
+    if (regions.length > 0 && !game.romRegions?.length) {
+      target.romRegions = regions;
+    }
+    const regionalName = getRegionalSystemName(
+      game.systemId,
+      (target.romRegions ?? game.romRegions)?.[0],
+    );
+    if (regionalName) {
+      target.system = regionalName;
+    }
+
+    // .m3u and ScreenScraper grouping take precedence over name-derived sets.
+    if (
+      match.discNumber !== undefined &&
+      !game.m3uPath &&
+      (!game.discGroup || game.discGroup.startsWith("dat:"))
+    ) {
+      target.discGroup = `dat:${match.name.replace(/\s*\(Disc \d+\)/, "")}:${game.systemId}`;
+      target.discNumber = match.discNumber;
+      target.discTotal = match.discTotal;
+    }
+
+    const updates: Partial<Game> = {};
+    for (const key of Object.keys(target) as Array<keyof Game>) {
+      const value = target[key];
+      const current = game[key];
+      const same = Array.isArray(value)
+        ? Array.isArray(current) && value.join(",") === current.join(",")
+        : value === current;
+      if (!same) {
+        (updates as Record<string, unknown>)[key] = value;
+      }
+    }
+    if (game.datVerified?.dat !== match.dat || game.datVerified?.name !== match.name) {
+      updates.datVerified = { dat: match.dat, name: match.name };
+    }
+    return updates;
+  }
+
+  /** Load (or reuse) the index for the DATs currently on disk. */
+  private async loadIndex(): Promise<NativeDatIndex | null> {
+    const addon = loadNativeAddon();
+    if (!addon?.DatIndex) {
+      return null;
+    }
+
+    await fs.mkdir(this.datDirectory, { recursive: true });
+    const files = await this.listDatFiles();
+    if (files.length === 0) {
+      this.index = null;
+      this.indexKey = null;
+      return null;
+    }
+
+    // Path + size + mtime of every DAT; any change rebuilds the cache.
+    const cacheKey = JSON.stringify(files.map((file) => [file.path, file.size, file.mtimeMs]));
+    if (this.index && this.indexKey === cacheKey) {
+      return this.index;
+    }
+
+    const index = new addon.DatIndex();
+    const result = await index.load({
+      cacheKey,
+      cachePath: this.cachePath,
+      files: files.map((file) => file.path),
+    });
+    for (const error of result.errors) {
+      libraryLog.warn(`DAT ${error.path}: ${error.message}`);
+    }
+    libraryLog.info(
+      `Loaded ${result.dats} DAT(s), ${result.roms} ROMs${result.fromCache ? " (cached)" : ""}`,
+    );
+
+    this.index = index;
+    this.indexKey = cacheKey;
+    return index;
+  }
+
+  private async listDatFiles(): Promise<Array<{ mtimeMs: number; path: string; size: number }>> {
+    const entries = await fs.readdir(this.datDirectory, { withFileTypes: true });
+    const files: Array<{ mtimeMs: number; path: string; size: number }> = [];
+    for (const entry of entries) {
+      if (!entry.isFile() || !DAT_EXTENSIONS.has(path.extname(entry.name).toLowerCase())) {
+        continue;
+      }
+      const fullPath = path.join(this.datDirectory, entry.name);
+      const stat = await fs.stat(fullPath);
+      files.push({ mtimeMs: stat.mtimeMs, path: fullPath, size: stat.size });
+    }
+    return files.sort((a, b) => a.path.localeCompare(b.path));
+  }
+}
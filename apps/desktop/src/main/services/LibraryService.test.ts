@@ -1,4 +1,4 @@
-import { describe, it, expect, beforeAll, afterAll, beforeEach, vi } from "vitest";
+import { describe, it, expect, beforeAll, afterAll, afterEach, beforeEach, vi } from "vitest";
 import fs from "node:fs";
 import path from "node:path";
 import os from "node:os";
@@ -40,6 +40,13 @@ vi.mock("../logger", () => ({
   },
 }));
 
+// The native addon isn't built in the test environment; individual tests
+// install a fake scanner to exercise the native scan path.
+const nativeAddonMock = vi.hoisted(() => ({
+  loadNativeAddon: vi.fn((): unknown => null),
+}));
+vi.mock("../native/nativeAddon", () => nativeAddonMock);
+
 import { LibraryService } from "./LibraryService";
 import type { ScanProgressEvent } from "./LibraryService";
 import { DEFAULT_SYSTEMS } from "../../types/library";
@@ -1855,6 +1862,86 @@ describe("LibraryService", () => {
       expect(zipProgress.length).toBeGreaterThanOrEqual(1);
       expect(zipProgress.every((e) => !e.isNew)).toBe(true);
     });
+
+    describe("native central-directory listing", () => {
+      afterEach(() => {
+        nativeAddonMock.loadNativeAddon.mockReset();
+        nativeAddonMock.loadNativeAddon.mockReturnValue(null);
+      });
+
+      function writeGbConfig() {
+        fs.writeFileSync(
+          path.join(USER_DATA_DIR, "library-config.json"),
+          JSON.stringify({ autoScan: false, scanRecursive: false, systems: [TEST_GB_SYSTEM] }),
+        );
+      }
+
+      it("lists every archive in one native call and picks ROMs from it", async () => {
+        const readZipDirectories = vi.fn(async (paths: Array<string>) =>
+          paths.map((zipPath) =>
+            zipPath.endsWith("tetris.zip")
+              ? {
+                  entries: [
+                    {
+                      compressedSize: 19,
+                      crc32: "00000000",
+                      method: 0,
+                      name: "Tetris (World).gb",
+                      size: 19,
+                    },
+                  ],
+                }
+              : { error: "not a zip archive" },
+          ),
+        );
+        nativeAddonMock.loadNativeAddon.mockReturnValue({ readZipDirectories });
+        writeGbConfig();
+
+        const service = await createService();
+        const games = await service.scanDirectory(zipScanDir);
+
+        expect(readZipDirectories).toHaveBeenCalledTimes(1);
+        expect(readZipDirectories.mock.calls[0][0]).toEqual(
+          expect.arrayContaining([path.join(zipScanDir, "tetris.zip")]),
+        );
+        const zipGame = games.find((g) => g.sourceArchivePath?.endsWith("tetris.zip"));
+        expect(zipGame?.id).toBe(sha256String("fake-gb-tetris-data"));
+      });
+
+      it("refreshes the mtime of a touched archive whose ROM CRC32 is unchanged", async () => {
+        writeGbConfig();
+        const service = await createService();
+        await service.scanDirectory(zipScanDir);
+        const zipPath = path.join(zipScanDir, "tetris.zip");
+        const game = service.getGames().find((g) => g.sourceArchivePath === zipPath);
+        expect(game).toBeDefined();
+
+        const touched = new Date(Date.now() + 60_000);
+        fs.utimesSync(zipPath, touched, touched);
+        const readZipDirectories = vi.fn(async (paths: Array<string>) =>
+          paths.map((p) =>
+            p === zipPath
+              ? {
+                  entries: [
+                    {
+                      compressedSize: 19,
+                      crc32: game!.romHashes.crc32,
+                      method: 0,
+                      name: "Tetris (World).gb",
+                      size: 19,
+                    },
+                  ],
+                }
+              : { error: "not a zip archive" },
+          ),
+        );
+        nativeAddonMock.loadNativeAddon.mockReturnValue({ readZipDirectories });
+
+        await service.scanDirectory(zipScanDir);
+
+        expect(service.getGame(game!.id)?.romMtime).toBe(fs.statSync(zipPath).mtimeMs);
+      });
+    });
   });
 
   describe("addGame with zip file", () => {
@@ -2616,6 +2703,38 @@ describe("LibraryService", () => {
 
       fs.rmSync(unquotedDir, { force: true, recursive: true });
     });
+
+    it("handles .cue with a tab after FILE", async () => {
+      const tabDir = path.join(TEST_DIR, "tab-cue");
+      fs.mkdirSync(tabDir, { recursive: true });
+
+      fs.writeFileSync(
+        path.join(tabDir, "Game.cue"),
+        'FILE\t"Game (Track 1).bin" BINARY\n  TRACK 01 MODE2/2352\n' +
+          "FILE\tGame (Track 2).bin\tBINARY\n  TRACK 02 AUDIO\n",
+      );
+      fs.writeFileSync(path.join(tabDir, "Game (Track 1).bin"), "bin-data-1");
+      fs.writeFileSync(path.join(tabDir, "Game (Track 2).bin"), "bin-data-2");
+
+      const config = {
+        autoScan: false,
+        scanRecursive: false,
+        systems: [TEST_PSX_SYSTEM],
+      };
+      fs.writeFileSync(
+        path.join(USER_DATA_DIR, "library-config.json"),
+        JSON.stringify(config, null, 2),
+      );
+
+      const service = await createService();
+      const games = await service.scanDirectory(tabDir, "psx");
+
+      // Both tracks are claimed by the .cue, so only the .cue is listed
+      expect(games).toHaveLength(1);
+      expect(games[0].romPath).toBe(path.join(tabDir, "Game.cue"));
+
+      fs.rmSync(tabDir, { force: true, recursive: true });
+    });
   });
 
   // ---------------------------------------------------------------------------
@@ -2979,4 +3098,494 @@ describe("LibraryService", () => {
       fs.rmSync(precedenceDir, { force: true, recursive: true });
     });
   });
+
+  describe("scanDirectory — native scanner", () => {
+    const TEST_GENESIS_SYSTEM: GameSystem = {
+      extensions: [".md", ".bin", ".gen"],
+      id: "genesis",
+      name: "Sega Genesis",
+      shortName: "Genesis",
+    };
+    const TEST_PSX_SYSTEM: GameSystem = {
+      extensions: [".cue", ".bin", ".chd"],
+      id: "psx",
+      name: "PlayStation",
+      shortName: "PS1",
+    };
+
+    /**
+     * Fake `scanLibrary` that lists a single (non-recursive) root with real fs
+     * calls, reporting `sniffed[name]` as the header-sniffed system and raw
+     * FILE entries for .cue sheets, like the native scanner does.
+     */
+    function fakeNativeAddon(sniffed: Record<string, string> = {}) {
+      return {
+        scanLibrary: vi.fn(
+          async (
+            options: { roots: Array<{ path: string; systemId?: string }> },
+            onBatch: (batch: Array<unknown>) => void,
+          ) => {
+            const root = options.roots[0];
+            const files = fs.readdirSync(root.path).map((name) => {
+              const fullPath = path.join(root.path, name);
+              const ext = path.extname(name).toLowerCase();
+              const refs =
+                ext === ".cue"
+                  ? Array.from(
+                      fs.readFileSync(fullPath, "utf8").matchAll(/FILE "([^"]+)"/g),
+                      (m) => m[1],
+                    )
+                  : null;
+              return {
+                ext,
+                mtimeMs: fs.statSync(fullPath).mtimeMs,
+                name,
+                refs,
+                size: fs.statSync(fullPath).size,
+                sniffedSystemId: sniffed[name] ?? null,
+              };
+            });
+            onBatch([{ files, path: root.path, systemId: root.systemId ?? null }]);
+            return {
+              directories: 1,
+              elapsedMs: 1,
+              errors: [],
+              filesMatched: files.length,
+              filesSeen: files.length,
+              filesSniffed: Object.keys(sniffed).length,
+            };
+          },
+        ),
+      };
+    }
+
+    function writeConfig(): void {
+      const config = {
+        autoScan: false,
+        scanRecursive: false,
+        systems: [TEST_GENESIS_SYSTEM, TEST_PSX_SYSTEM],
+      };
+      fs.writeFileSync(
+        path.join(USER_DATA_DIR, "library-config.json"),
+        JSON.stringify(config, null, 2),
+      );
+    }
+
+    afterEach(() => {
+      nativeAddonMock.loadNativeAddon.mockReset();
+      nativeAddonMock.loadNativeAddon.mockReturnValue(null);
+    });
+
+    it("assigns an ambiguous extension to the header-sniffed system", async () => {
+      const dir = path.join(TEST_DIR, "native-sniffed");
+      fs.mkdirSync(dir, { recursive: true });
+      fs.writeFileSync(path.join(dir, "Sonic.bin"), "genesis-rom");
+
+      const addon = fakeNativeAddon({ "Sonic.bin": "genesis" });
+      nativeAddonMock.loadNativeAddon.mockReturnValue(addon);
+      writeConfig();
+
+      const service = await createService();
+      const ambiguous = vi.fn();
+      service.on("scanAmbiguous", ambiguous);
+      const games = await service.scanDirectory(dir);
+
+      expect(addon.scanLibrary).toHaveBeenCalledOnce();
+      expect(ambiguous).not.toHaveBeenCalled();
+      expect(games).toHaveLength(1);
+      expect(games[0].systemId).toBe("genesis");
+      expect(games[0].romPath).toBe(path.join(dir, "Sonic.bin"));
+
+      fs.rmSync(dir, { force: true, recursive: true });
+    });
+
+    it("still reports the file as ambiguous when nothing was sniffed", async () => {
+      const dir = path.join(TEST_DIR, "native-unsniffed");
+      fs.mkdirSync(dir, { recursive: true });
+      fs.writeFileSync(path.join(dir, "Mystery.bin"), "unknown-data");
+
+      nativeAddonMock.loadNativeAddon.mockReturnValue(fakeNativeAddon());
+      writeConfig();
+
+      const service = await createService();
+      const ambiguous = vi.fn();
+      service.on("scanAmbiguous", ambiguous);
+      const games = await service.scanDirectory(dir);
+
+      expect(games).toHaveLength(0);
+      expect(ambiguous).toHaveBeenCalledOnce();
+      expect(ambiguous.mock.calls[0][0][0].fullPath).toBe(path.join(dir, "Mystery.bin"));
+
+      fs.rmSync(dir, { force: true, recursive: true });
+    });
+
+    it("uses native .cue references to skip referenced .bin files", async () => {
+      const dir = path.join(TEST_DIR, "native-cue");
+      fs.mkdirSync(dir, { recursive: true });
+      fs.writeFileSync(path.join(dir, "Game.cue"), 'FILE "Game.bin" BINARY\n');
+      fs.writeFileSync(path.join(dir, "Game.bin"), "track-data");
+
+      nativeAddonMock.loadNativeAddon.mockReturnValue(fakeNativeAddon());
+      writeConfig();
+
+      const service = await createService();
+      const games = await service.scanDirectory(dir, "psx");
+
+      expect(games).toHaveLength(1);
+      expect(games[0].romPath).toBe(path.join(dir, "Game.cue"));
+
+      fs.rmSync(dir, { force: true, recursive: true });
+    });
+
+    it("falls back to the JS walk when the native scan fails", async () => {
+      const dir = path.join(TEST_DIR, "native-fallback");
+      fs.mkdirSync(dir, { recursive: true });
+      fs.writeFileSync(path.join(dir, "Sonic.md"), "genesis-rom");
+
+      nativeAddonMock.loadNativeAddon.mockReturnValue({
+        scanLibrary: vi.fn(() => Promise.reject(new Error("scan failed"))),
+      });
+      writeConfig();
+
+      const service = await createService();
+      const games = await service.scanDirectory(dir);
+
+      expect(games).toHaveLength(1);
+      expect(games[0].systemId).toBe("genesis");
+
+      fs.rmSync(dir, { force: true, recursive: true });
+    });
+  });
+
+  describe("applyLibraryDelta", () => {
+    function writeNesConfig(romsPath: string): void {
+      const config = {
+        autoScan: false,
+        scanRecursive: true,
+        systems: [{ ...TEST_NES_SYSTEM, romsPath }],
+      };
+      fs.writeFileSync(
+        path.join(USER_DATA_DIR, "library-config.json"),
+        JSON.stringify(config, null, 2),
+      );
+    }
+
+    it("adds new files from a changed directory only", async () => {
+      const root = path.join(TEST_DIR, "delta-add");
+      const untouched = path.join(root, "untouched");
+      fs.mkdirSync(untouched, { recursive: true });
+      fs.writeFileSync(path.join(root, "New.nes"), "new-rom");
+      fs.writeFileSync(path.join(untouched, "Other.nes"), "other-rom");
+      writeNesConfig(root);
+
+      const service = await createService();
+      const changed = vi.fn();
+      service.on("libraryChanged", changed);
+      const summary = await service.applyLibraryDelta({
+        directories: [{ path: root, recursive: false }],
+        removed: [],
+        renamed: [],
+      });
+
+      expect(summary.added.map((g) => g.romPath)).toEqual([path.join(root, "New.nes")]);
+      expect(service.getGames("nes")).toHaveLength(1);
+      expect(changed).toHaveBeenCalledOnce();
+
+      fs.rmSync(root, { force: true, recursive: true });
+    });
+
+    it("keeps metadata when a ROM is renamed", async () => {
+      const root = path.join(TEST_DIR, "delta-rename");
+      fs.mkdirSync(root, { recursive: true });
+      fs.writeFileSync(path.join(root, "Old.nes"), "renamed-rom");
+      writeNesConfig(root);
+
+      const service = await createService();
+      await service.scanDirectory(root, "nes");
+      const [game] = service.getGames("nes");
+      await service.updateGame(game.id, { favorite: true });
+
+      fs.renameSync(path.join(root, "Old.nes"), path.join(root, "New.nes"));
+      const summary = await service.applyLibraryDelta({
+        directories: [{ path: root, recursive: false }],
+        removed: [],
+        renamed: [{ from: path.join(root, "Old.nes"), to: path.join(root, "New.nes") }],
+      });
+
+      expect(summary.added).toHaveLength(0);
+      expect(summary.removedIds).toHaveLength(0);
+      const renamed = service.getGame(game.id);
+      expect(renamed?.romPath).toBe(path.join(root, "New.nes"));
+      expect(renamed?.favorite).toBe(true);
+
+      fs.rmSync(root, { force: true, recursive: true });
+    });
+
+    it("removes games under a deleted directory", async () => {
+      const root = path.join(TEST_DIR, "delta-remove");
+      const sub = path.join(root, "sub");
+      fs.mkdirSync(sub, { recursive: true });
+      fs.writeFileSync(path.join(sub, "Gone.nes"), "gone-rom");
+      fs.writeFileSync(path.join(root, "Kept.nes"), "kept-rom");
+      writeNesConfig(root);
+
+      const service = await createService();
+      await service.scanDirectory(root, "nes");
+      expect(service.getGames("nes")).toHaveLength(2);
+
+      fs.rmSync(sub, { force: true, recursive: true });
+      const summary = await service.applyLibraryDelta({
+        directories: [{ path: root, recursive: false }],
+        removed: [sub],
+        renamed: [],
+      });
+
+      expect(summary.removedIds).toHaveLength(1);
+      expect(service.getGames("nes").map((g) => g.romPath)).toEqual([path.join(root, "Kept.nes")]);
+
+      fs.rmSync(root, { force: true, recursive: true });
+    });
+
+    it("does not remove a game whose file still exists", async () => {
+      const root = path.join(TEST_DIR, "delta-stale-remove");
+      fs.mkdirSync(root, { recursive: true });
+      fs.writeFileSync(path.join(root, "Back.nes"), "back-rom");
+      writeNesConfig(root);
+
+      const service = await createService();
+      await service.scanDirectory(root, "nes");
+
+      const summary = await service.applyLibraryDelta({
+        directories: [],
+        removed: [path.join(root, "Back.nes")],
+        renamed: [],
+      });
+
+      expect(summary.removedIds).toHaveLength(0);
+      expect(service.getGames("nes")).toHaveLength(1);
+
+      fs.rmSync(root, { force: true, recursive: true });
+    });
+  });
+
+  // ---------------------------------------------------------------------------
+  // Binary library store
+  // ---------------------------------------------------------------------------
+
+  describe("binary library store", () => {
+    /** In-memory stand-in for the native `LibraryStore`. */
+    function fakeStoreAddon(existing: Array<Record<string, unknown>> | null = null) {
+      const records = new Map<string, Record<string, unknown>>(
+        (existing ?? []).map((r) => [r.id as string, r]),
+      );
+      const state = { logBytes: 0 };
+      const store = {
+        close: vi.fn(),
+        compact: vi.fn(async () => {
+          state.logBytes = 0;
+        }),
+        open: vi.fn(() => existing !== null),
+        put: vi.fn((puts: Array<Record<string, unknown>>) => {
+          for (const r of puts) {
+            records.set(r.id as string, r);
+          }
+          state.logBytes += puts.length * 256;
+        }),
+        readAll: vi.fn(() => Array.from(records.values())),
+        remove: vi.fn((ids: Array<string>) => {
+          for (const id of ids) {
+            records.delete(id);
+          }
+          state.logBytes += ids.length * 64;
+        }),
+        replaceAll: vi.fn(async (all: Array<Record<string, unknown>>) => {
+          records.clear();
+          for (const r of all) {
+            records.set(r.id as string, r);
+          }
+        }),
+        stats: vi.fn(() => ({ baseBytes: 0, logBytes: state.logBytes, records: records.size })),
+      };
+      class FakeLibraryStore {
+        constructor() {
+          return store;
+        }
+      }
+      const addon = { LibraryStore: FakeLibraryStore };
+      return { addon, records, state, store };
+    }
+
+    function writeGame(romName: string, content: string): Game {
+      const romPath = path.join(ROMS_DIR, romName);
+      fs.writeFileSync(romPath, content);
+      return {
+        id: sha256File(romPath),
+        romHashes: computeExpectedHashes(content),
+        romPath,
+        system: "Nintendo Entertainment System",
+        systemId: "nes",
+        title: romName,
+      };
+    }
+
+    afterEach(() => {
+      nativeAddonMock.loadNativeAddon.mockReset();
+      nativeAddonMock.loadNativeAddon.mockReturnValue(null);
+    });
+
+    it("migrates library.json into the store on first run", async () => {
+      const game = writeGame("store_migrate.nes", "store-migrate");
+      fs.writeFileSync(path.join(USER_DATA_DIR, "library.json"), JSON.stringify([game]));
+      const { addon, records, store } = fakeStoreAddon();
+      nativeAddonMock.loadNativeAddon.mockReturnValue(addon);
+
+      const service = await createService();
+      await service.whenReady();
+
+      expect(store.replaceAll).toHaveBeenCalledOnce();
+      expect(records.get(game.id)?.crc32).toBe(game.romHashes.crc32);
+      expect(service.getGame(game.id)?.title).toBe("store_migrate.nes");
+      // Left in place for downgrades
+      expect(fs.existsSync(path.join(USER_DATA_DIR, "library.json"))).toBe(true);
+    });
+
+    it("loads from the store without reading library.json", async () => {
+      const game = writeGame("store_load.nes", "store-load");
+      fs.writeFileSync(path.join(USER_DATA_DIR, "library.json"), "not json");
+      const { addon, store } = fakeStoreAddon([
+        { ...game, romHashes: undefined, ...game.romHashes, favorite: true },
+      ]);
+      nativeAddonMock.loadNativeAddon.mockReturnValue(addon);
+
+      const service = await createService();
+      await service.whenReady();
+
+      expect(store.replaceAll).not.toHaveBeenCalled();
+      expect(service.getGame(game.id)?.favorite).toBe(true);
+      expect(service.getGame(game.id)?.romHashes).toEqual(game.romHashes);
+    });
+
+    it("writes only changed games on save", async () => {
+      const a = writeGame("store_a.nes", "store-a");
+      const b = writeGame("store_b.nes", "store-b");
+      const { addon, store } = fakeStoreAddon([
+        { ...a, romHashes: undefined, ...a.romHashes },
+        { ...b, romHashes: undefined, ...b.romHashes },
+      ]);
+      nativeAddonMock.loadNativeAddon.mockReturnValue(addon);
+
+      const service = await createService();
+      await service.whenReady();
+      await service.updateGame(a.id, { playTime: 120 });
+
+      expect(store.put).toHaveBeenCalledOnce();
+      expect(store.put.mock.calls[0][0]).toEqual([
+        expect.objectContaining({ id: a.id, playTime: 120 }),
+      ]);
+
+      await service.removeGame(b.id);
+      expect(store.remove).toHaveBeenCalledWith([b.id]);
+      expect(store.put).toHaveBeenCalledOnce();
+    });
+
+    it("compacts once the change log outgrows the threshold", async () => {
+      const game = writeGame("store_compact.nes", "store-compact");
+      const { addon, state, store } = fakeStoreAddon([
+        { ...game, romHashes: undefined, ...game.romHashes },
+      ]);
+      nativeAddonMock.loadNativeAddon.mockReturnValue(addon);
+
+      const service = await createService();
+      await service.whenReady();
+      await service.updateGame(game.id, { playTime: 1 });
+      expect(store.compact).not.toHaveBeenCalled();
+
+      state.logBytes = 2 * 1024 * 1024;
+      await service.updateGame(game.id, { playTime: 2 });
+
+      expect(store.compact).toHaveBeenCalledOnce();
+      const json = JSON.parse(fs.readFileSync(path.join(USER_DATA_DIR, "library.json"), "utf8"));
+      expect(json[0].playTime).toBe(2);
+    });
+  });
+
+  // ---------------------------------------------------------------------------
+  // Native title search
+  // ---------------------------------------------------------------------------
+
+  describe("searchGames", () => {
+    /** Fake `SearchIndex` doing a plain lowercase substring match. */
+    function fakeSearchAddon() {
+      const titles = new Map<string, string>();
+      const index = {
+        clear: vi.fn(() => titles.clear()),
+        query: vi.fn(async (text: string) =>
+          Array.from(titles)
+            .filter(([, title]) => title.toLowerCase().includes(text.toLowerCase()))
+            .map(([id]) => id),
+        ),
+        remove: vi.fn((ids: Array<string>) => {
+          for (const id of ids) {
+            titles.delete(id);
+          }
+        }),
+        size: vi.fn(() => titles.size),
+        upsert: vi.fn((entries: Array<{ id: string; title: string }>) => {
+          for (const { id, title } of entries) {
+            titles.set(id, title);
+          }
+        }),
+      };
+      class FakeSearchIndex {
+        constructor() {
+          return index;
+        }
+      }
+      return { addon: { SearchIndex: FakeSearchIndex }, index };
+    }
+
+    afterEach(() => {
+      nativeAddonMock.loadNativeAddon.mockReset();
+      nativeAddonMock.loadNativeAddon.mockReturnValue(null);
+    });
+
+    it("returns null without the native index", async () => {
+      const service = await createService();
+      expect(await service.searchGames("zelda")).toBeNull();
+    });
+
+    it("indexes loaded games and applies changes before the next query", async () => {
+      const romPath = path.join(ROMS_DIR, "search_zelda.nes");
+      fs.writeFileSync(romPath, "search-zelda");
+      const gameId = sha256File(romPath);
+      fs.writeFileSync(
+        path.join(USER_DATA_DIR, "library.json"),
+        JSON.stringify([
+          {
+            id: gameId,
+            romHashes: computeExpectedHashes("search-zelda"),
+            romPath,
+            system: "Nintendo Entertainment System",
+            systemId: "nes",
+            title: "The Legend of Zelda",
+          },
+        ]),
+      );
+      const { addon, index } = fakeSearchAddon();
+      nativeAddonMock.loadNativeAddon.mockReturnValue(addon);
+
+      const service = await createService();
+      expect(await service.searchGames("zelda")).toEqual([gameId]);
+
+      await service.updateGame(gameId, { title: "Zelda II" });
+      // Applied lazily on the next query, not on every update
+      expect(index.upsert).toHaveBeenCalledTimes(1);
+      expect(await service.searchGames("legend")).toEqual([]);
+      expect(index.upsert).toHaveBeenLastCalledWith([{ id: gameId, title: "Zelda II" }]);
+
+      await service.removeGame(gameId);
+      expect(await service.searchGames("zelda")).toEqual([]);
+      expect(index.remove).toHaveBeenLastCalledWith([gameId]);
+    });
+  });
 });
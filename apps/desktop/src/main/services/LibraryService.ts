@@ -13,7 +13,20 @@ import {
 import crypto from "node:crypto";
 import zlib from "node:zlib";
 import { libraryLog } from "../logger";
-import { findRomInZip, extractFileFromZip } from "../utils/zipExtraction";
+import {
+  extractFileFromZip,
+  findRomEntry,
+  findRomInZip,
+  type ZipListingEntry,
+} from "../utils/zipExtraction";
+import {
+  loadNativeAddon,
+  type MainNativeAddon,
+  type NativeLibraryStore,
+  type NativeSearchIndex,
+  type NativeStoreRecord,
+} from "../native/nativeAddon";
+import { fromStoreRecord, toStoreRecord } from "../utils/libraryStoreRecord";
 
 export interface RomHashes {
   crc32: string;
@@ -52,6 +65,8 @@ interface RomCandidate {
   system?: GameSystem;
   /** System ID filter passed into the scan (propagated for context). */
   systemIdFilter?: string;
+  /** Archive listing read ahead by the native zip reader, when available. */
+  zipEntries?: Array<ZipListingEntry>;
   // ── Multi-disc fields (populated when the file appears in an .m3u playlist) ──
   discGroup?: string;
   discNumber?: number;
@@ -59,6 +74,19 @@ interface RomCandidate {
   m3uPath?: string;
 }
 
+/** A file listed during the directory walk, before classification. */
+interface ScannedFile {
+  fullPath: string;
+  /** File modification time in ms since epoch. */
+  mtimeMs: number;
+  /** Basename within the containing directory. */
+  name: string;
+  /** Resolved .cue / .m3u references, when already parsed by the native scanner. */
+  refs?: Array<string>;
+  /** System identified from the file header by the native scanner. */
+  sniffedSystemId?: string;
+}
+
 /** A file whose extension matches multiple systems and requires user disambiguation. */
 export interface AmbiguousRomFile {
   /** File extension (lowercase, with leading dot). */
@@ -71,9 +99,32 @@ export interface AmbiguousRomFile {
   mtimeMs: number;
 }
 
+/**
+ * Incremental change set produced by the library watcher (see
+ * `LibraryWatcher`). Paths are absolute.
+ */
+export interface LibraryDelta {
+  /** Directories to re-walk; `recursive` for newly appeared subtrees. */
+  directories: Array<{ path: string; recursive: boolean }>;
+  /** Files or directories that disappeared. */
+  removed: Array<string>;
+  /** Files or directories that were moved within the library. */
+  renamed: Array<{ from: string; to: string }>;
+}
+
+/** Result of applying a `LibraryDelta`, also emitted as `libraryChanged`. */
+export interface LibraryChangeSummary {
+  added: Array<Game>;
+  removedIds: Array<string>;
+  updated: Array<Game>;
+}
+
 /** Number of ROM files to hash concurrently. */
 const HASH_CONCURRENCY = 4;
 
+/** Change-log size below which the binary store is never compacted. */
+const STORE_COMPACT_MIN_LOG_BYTES = 1024 * 1024;
+
 export class LibraryService extends EventEmitter {
   private config: LibraryConfig;
   private games: Map<string, Game> = new Map();
@@ -83,7 +134,21 @@ export class LibraryService extends EventEmitter {
   private archivePathIndex: Map<string, string> = new Map();
   private configPath: string;
   private libraryPath: string;
+  private storePath: string;
   private romsCacheDir: string;
+  /**
+   * Native binary library store (library.bin). Null when the addon isn't
+   * available, in which case the library is persisted as library.json.
+   */
+  private store: NativeLibraryStore | null = null;
+  /** Game IDs added or modified since the last save (binary store only). */
+  private changedIds: Set<string> = new Set();
+  /** Game IDs removed since the last save (binary store only). */
+  private removedIds: Set<string> = new Set();
+  /** Native title index; null when the addon is unavailable. */
+  private searchIndex: NativeSearchIndex | null = null;
+  /** Game IDs whose index entry is stale, applied lazily before the next query. */
+  private searchPending: Set<string> = new Set();
   /** Tracks whether batched updates need flushing to disk. */
   private dirty = false;
   /** Resolves once the library JSON has been loaded from disk. */
@@ -94,6 +159,7 @@ export class LibraryService extends EventEmitter {
     const userData = app.getPath("userData");
     this.configPath = path.join(userData, "library-config.json");
     this.libraryPath = path.join(userData, "library.json");
+    this.storePath = path.join(userData, "library.bin");
     this.romsCacheDir = path.join(userData, "roms-cache");
     this.config = {
       autoScan: false,
@@ -292,6 +358,23 @@ export class LibraryService extends EventEmitter {
   }
 
   private async loadLibrary(): Promise<void> {
+    const games = (await this.loadFromStore()) ?? (await this.readLibraryJSON());
+    this.games = new Map((games ?? []).map((game) => [game.id, game]));
+    this.buildSearchIndex();
+    if (!games) {
+      // Nothing on disk — start fresh
+      return;
+    }
+
+    this.rebuildRomPathIndex();
+    await this.migrateGameIds();
+    await this.backfillRomHashes();
+    await this.migrateGbcGames();
+    await this.backfillRegionalSystemNames();
+  }
+
+  /** Read library.json (or its backup). Returns null if neither is usable. */
+  private async readLibraryJSON(): Promise<Array<Game> | null> {
     let data: string | undefined;
 
     try {
@@ -304,19 +387,110 @@ export class LibraryService extends EventEmitter {
         JSON.parse(data);
         libraryLog.warn("Primary library.json was corrupt/missing; loaded from backup");
       } catch {
-        // No backup either — start fresh
-        this.games = new Map();
-        return;
+        return null;
       }
     }
 
-    const games: Array<Game> = JSON.parse(data);
-    this.games = new Map(games.map((game) => [game.id, game]));
-    this.rebuildRomPathIndex();
-    await this.migrateGameIds();
-    await this.backfillRomHashes();
-    await this.migrateGbcGames();
-    await this.backfillRegionalSystemNames();
+    return JSON.parse(data) as Array<Game>;
+  }
+
+  /**
+   * Open the native binary store and read the library from it. On first run
+   * (or if library.bin is corrupt) the store is seeded from library.json,
+   * which is left in place as a downgrade path. Returns null when the addon
+   * is unavailable, so the caller falls back to library.json.
+   */
+  private async loadFromStore(): Promise<Array<Game> | null> {
+    const addon = loadNativeAddon();
+    // Older addon builds predate the store
+    if (!addon?.LibraryStore) {
+      return null;
+    }
+
+    const store = new addon.LibraryStore(this.storePath);
+    try {
+      let exists = false;
+      try {
+        exists = store.open();
+      } catch (error) {
+        libraryLog.warn("library.bin is unreadable; rebuilding it from library.json:", error);
+      }
+
+      if (exists) {
+        this.store = store;
+        return store.readAll().map(fromStoreRecord);
+      }
+
+      const games = await this.readLibraryJSON();
+      await store.replaceAll((games ?? []).map(toStoreRecord));
+      this.store = store;
+      if (games) {
+        libraryLog.info(`Migrated ${games.length} game(s) from library.json to library.bin`);
+      }
+      return games;
+    } catch (error) {
+      libraryLog.warn("Binary library store unavailable, using library.json:", error);
+      store.close();
+      return null;
+    }
+  }
+
+  /** Record that a game needs persisting on the next save. */
+  private markChanged(gameId: string): void {
+    this.removedIds.delete(gameId);
+    this.changedIds.add(gameId);
+    this.searchPending.add(gameId);
+  }
+
+  /** Record that a game needs deleting from disk on the next save. */
+  private markRemoved(gameId: string): void {
+    this.changedIds.delete(gameId);
+    this.removedIds.add(gameId);
+    this.searchPending.add(gameId);
+  }
+
+  /** Index every loaded title in the native search index, if available. */
+  private buildSearchIndex(): void {
+    const addon = loadNativeAddon();
+    if (!addon?.SearchIndex) {
+      return;
+    }
+    this.searchIndex = new addon.SearchIndex();
+    this.searchIndex.upsert(
+      Array.from(this.games.values(), (game) => ({ id: game.id, title: game.title })),
+    );
+    this.searchPending.clear();
+  }
+
+  /**
+   * Search game titles (case- and diacritic-insensitive). Returns matching
+   * IDs best first, or null when the native index is unavailable and the
+   * caller should filter on its own.
+   */
+  public async searchGames(query: string, limit?: number): Promise<Array<string> | null> {
+    await this.libraryLoaded;
+    const index = this.searchIndex;
+    if (!index) {
+      return null;
+    }
+
+    if (this.searchPending.size > 0) {
+      const upserts: Array<{ id: string; title: string }> = [];
+      const removed: Array<string> = [];
+      for (const gameId of this.searchPending) {
+        const game = this.games.get(gameId);
+        if (game) {
+          upserts.push({ id: gameId, title: game.title });
+        } else {
+          removed.push(gameId);
+        }
+      }
+      this.searchPending.clear();
+      index.remove(removed);
+      index.upsert(upserts);
+    }
+
+    return index.query(query, limit);
   }
 
   /** Rebuild reverse indexes from the current games map. */
@@ -347,9 +521,11 @@ export class LibraryService extends EventEmitter {
         const { gameId, hashes } = await this.computeRomHashes(game.romPath);
         if (gameId !== oldId) {
           this.games.delete(oldId);
+          this.markRemoved(oldId);
           game.id = gameId;
           game.romHashes = hashes;
           this.games.set(gameId, game);
+          this.markChanged(gameId);
           migrated = true;
         }
       } catch (error) {
@@ -385,6 +561,7 @@ export class LibraryService extends EventEmitter {
       try {
         const { hashes: computed } = await this.computeRomHashes(game.romPath);
         game.romHashes = computed;
+        this.markChanged(game.id);
         changed = true;
       } catch (error) {
         libraryLog.warn(
@@ -445,6 +622,7 @@ export class LibraryService extends EventEmitter {
       if (game.systemId === "gb" && game.romPath.toLowerCase().endsWith(".gbc")) {
         game.systemId = "gbc";
         game.system = "Game Boy Color";
+        this.markChanged(game.id);
         changed = true;
       }
     }
@@ -496,6 +674,7 @@ export class LibraryService extends EventEmitter {
       if (regionalName && game.system !== regionalName) {
         const oldName = game.system;
         game.system = regionalName;
+        this.markChanged(game.id);
         changed = true;
         libraryLog.info(`Backfilled system name for "${game.title}": ${oldName} → ${regionalName}`);
       }
@@ -507,10 +686,48 @@ export class LibraryService extends EventEmitter {
   }
 
   private async saveLibrary(): Promise<void> {
+    if (this.store) {
+      await this.saveToStore(this.store);
+      return;
+    }
+    this.changedIds.clear();
+    this.removedIds.clear();
     const games = Array.from(this.games.values());
     await this.atomicWriteJSON(this.libraryPath, games);
   }
 
+  /**
+   * Append only the games changed since the last save to the store's change
+   * log. Once the log outgrows a quarter of the base image it is folded back
+   * in on a worker thread, and library.json is refreshed at the same time so
+   * it stays a usable fallback and downgrade copy.
+   */
+  private async saveToStore(store: NativeLibraryStore): Promise<void> {
+    const records: Array<NativeStoreRecord> = [];
+    for (const gameId of this.changedIds) {
+      const game = this.games.get(gameId);
+      if (game) {
+        records.push(toStoreRecord(game));
+      }
+    }
+    const removed = Array.from(this.removedIds);
+
+    if (records.length > 0) {
+      store.put(records);
+    }
+    if (removed.length > 0) {
+      store.remove(removed);
+    }
+    this.changedIds.clear();
+    this.removedIds.clear();
+
+    const { baseBytes, logBytes } = store.stats();
+    if (logBytes > Math.max(STORE_COMPACT_MIN_LOG_BYTES, baseBytes / 4)) {
+      await store.compact();
+      await this.atomicWriteJSON(this.libraryPath, Array.from(this.games.values()));
+    }
+  }
+
   /**
    * Check if an artwork file already exists on disk for a game ID.
    * Returns the `artwork://` URL if found, undefined otherwise.
@@ -580,15 +797,110 @@ export class LibraryService extends EventEmitter {
   // Optimized scan pipeline
   // ---------------------------------------------------------------------------
 
+  /**
+   * Collect all candidate ROM files under a directory. Uses the native
+   * parallel scanner when the addon is available and falls back to the
+   * JS walk otherwise (or if the native scan fails part-way).
+   */
+  private async collectCandidates(
+    directoryPath: string,
+    systemId: string | undefined,
+    candidates: Array<RomCandidate>,
+    ambiguousFiles: Array<AmbiguousRomFile>,
+    recursive = this.config.scanRecursive ?? false,
+  ): Promise<void> {
+    const native = loadNativeAddon();
+    if (native) {
+      try {
+        await this.collectCandidatesNative(
+          native,
+          directoryPath,
+          systemId,
+          candidates,
+          ambiguousFiles,
+          recursive,
+        );
+        return;
+      } catch (error) {
+        libraryLog.warn("Native library scan failed, falling back to JS walk:", error);
+      }
+    }
+    await this.walkDirectory(directoryPath, systemId, candidates, ambiguousFiles, recursive);
+  }
+
+  /**
+   * Walk the library with the native scanner. Directory listing, stat, cue /
+   * m3u parsing and header sniffing all happen off the main thread; batches
+   * are classified here as they stream in. Results are only appended to the
+   * output arrays once the whole scan succeeds, so a failure can fall back to
+   * the JS walk without duplicating candidates.
+   */
+  private async collectCandidatesNative(
+    native: MainNativeAddon,
+    directoryPath: string,
+    systemId: string | undefined,
+    candidates: Array<RomCandidate>,
+    ambiguousFiles: Array<AmbiguousRomFile>,
+    recursive: boolean,
+  ): Promise<void> {
+    const nativeCandidates: Array<RomCandidate> = [];
+    const nativeAmbiguous: Array<AmbiguousRomFile> = [];
+    let classified: Promise<void> = Promise.resolve();
+
+    const summary = await native.scanLibrary(
+      {
+        recursive,
+        roots: [{ path: directoryPath, systemId }],
+        systems: this.config.systems.map((s) => ({
+          extensions: s.extensions,
+          id: s.id,
+          name: s.name,
+          shortName: s.shortName,
+        })),
+      },
+      (batch) => {
+        classified = classified.then(async () => {
+          for (const dir of batch) {
+            const dirPath = path.normalize(dir.path);
+            await this.classifyDirectoryFiles(
+              dir.systemId ?? undefined,
+              dir.files.map((file) => ({
+                fullPath: path.join(dirPath, file.name),
+                mtimeMs: file.mtimeMs,
+                name: file.name,
+                refs: file.refs?.map((ref) => path.resolve(dirPath, ref)),
+                sniffedSystemId: file.sniffedSystemId ?? undefined,
+              })),
+              nativeCandidates,
+              nativeAmbiguous,
+            );
+          }
+        });
+      },
+    );
+    await classified;
+
+    for (const { message, path: errorPath } of summary.errors) {
+      libraryLog.error(`Error reading directory ${errorPath}: ${message}`);
+    }
+    libraryLog.info(
+      `Native scan: ${summary.directories} dirs, ${summary.filesMatched}/${summary.filesSeen} files matched, ${summary.filesSniffed} sniffed in ${Math.round(summary.elapsedMs)}ms`,
+    );
+
+    candidates.push(...nativeCandidates);
+    ambiguousFiles.push(...nativeAmbiguous);
+  }
+
   /**
    * Recursively walk a directory tree and collect all candidate ROM files.
    * This is a fast I/O-only pass — no hashing happens here.
    */
-  private async collectCandidates(
+  private async walkDirectory(
     directoryPath: string,
     systemId: string | undefined,
     candidates: Array<RomCandidate>,
     ambiguousFiles: Array<AmbiguousRomFile>,
+    recursive: boolean,
   ): Promise<void> {
     let entries;
     try {
@@ -609,7 +921,7 @@ export class LibraryService extends EventEmitter {
     for (const entry of entries) {
       const fullPath = path.join(directoryPath, entry.name);
 
-      if (entry.isDirectory() && this.config.scanRecursive) {
+      if (entry.isDirectory() && recursive) {
         let resolvedSystemId = systemId;
         if (!systemId) {
           const matchingSystem = this.config.systems.find(
@@ -633,22 +945,43 @@ export class LibraryService extends EventEmitter {
       fileEntries.map(async ({ entry, fullPath }) => {
         try {
           const stat = await fs.stat(fullPath);
-          return { entry, fullPath, mtimeMs: stat.mtimeMs };
+          return { fullPath, mtimeMs: stat.mtimeMs, name: entry.name };
         } catch {
           return null; // Skip unreadable files
         }
       }),
     );
 
+    await this.classifyDirectoryFiles(
+      systemId,
+      statResults.filter((result): result is ScannedFile => result !== null),
+      candidates,
+      ambiguousFiles,
+    );
+
+    // Recurse into subdirectories
+    for (const { fullPath, resolvedSystemId } of dirEntries) {
+      await this.walkDirectory(fullPath, resolvedSystemId, candidates, ambiguousFiles, recursive);
+    }
+  }
+
+  /**
+   * Turn the files of a single directory into scan candidates. Shared by the
+   * JS walk and the native scanner so cue/m3u handling, disc grouping and
+   * ambiguity detection behave identically on both paths.
+   */
+  private async classifyDirectoryFiles(
+    systemId: string | undefined,
+    files: Array<ScannedFile>,
+    candidates: Array<RomCandidate>,
+    ambiguousFiles: Array<AmbiguousRomFile>,
+  ): Promise<void> {
     // Build a set of .bin paths referenced by .cue files in this directory.
     // Referenced .bin files are skipped to avoid duplicate library entries.
     const cueReferencedBins = new Set<string>();
-    for (const result of statResults) {
-      if (!result) {
-        continue;
-      }
-      if (path.extname(result.entry.name).toLowerCase() === ".cue") {
-        const refs = await this.parseCueReferences(result.fullPath);
+    for (const file of files) {
+      if (path.extname(file.name).toLowerCase() === ".cue") {
+        const refs = file.refs ?? (await this.parseCueReferences(file.fullPath));
         for (const ref of refs) {
           cueReferencedBins.add(ref);
         }
@@ -661,20 +994,17 @@ export class LibraryService extends EventEmitter {
       string,
       { discGroup: string; discNumber: number; discTotal: number; m3uPath: string }
     >();
-    for (const result of statResults) {
-      if (!result) {
-        continue;
-      }
-      if (path.extname(result.entry.name).toLowerCase() === ".m3u") {
-        const discPaths = await this.parseM3uPlaylist(result.fullPath);
+    for (const file of files) {
+      if (path.extname(file.name).toLowerCase() === ".m3u") {
+        const discPaths = file.refs ?? (await this.parseM3uPlaylist(file.fullPath));
         const discTotal = discPaths.length;
-        const discGroup = path.basename(result.entry.name, ".m3u");
+        const discGroup = path.basename(file.name, ".m3u");
         discPaths.forEach((discPath, index) => {
           m3uDiscAnnotations.set(discPath, {
             discGroup,
             discNumber: index + 1,
             discTotal,
-            m3uPath: result.fullPath,
+            m3uPath: file.fullPath,
           });
         });
       }
@@ -685,15 +1015,11 @@ export class LibraryService extends EventEmitter {
     // Pattern matches: (Disc 1), (Disc 2), (Disc1), etc. — case-insensitive.
     const DISC_PATTERN = /\s*\(Disc\s*(\d+)\)/i;
     const filenameDiscGroups = new Map<string, Array<{ fullPath: string; discNumber: number }>>();
-    for (const result of statResults) {
-      if (!result) {
-        continue;
-      }
-      const { entry, fullPath } = result;
+    for (const { fullPath, name } of files) {
       if (m3uDiscAnnotations.has(fullPath)) {
         continue; // .m3u takes precedence
       }
-      const baseName = path.basename(entry.name, path.extname(entry.name).toLowerCase());
+      const baseName = path.basename(name, path.extname(name).toLowerCase());
       const discMatch = DISC_PATTERN.exec(baseName);
       if (discMatch) {
         const discNumber = Number.parseInt(discMatch[1], 10);
@@ -723,12 +1049,8 @@ export class LibraryService extends EventEmitter {
       }
     }
 
-    for (const result of statResults) {
-      if (!result) {
-        continue;
-      }
-      const { entry, fullPath, mtimeMs } = result;
-      const ext = path.extname(entry.name).toLowerCase();
+    for (const { fullPath, mtimeMs, name, sniffedSystemId } of files) {
+      const ext = path.extname(name).toLowerCase();
 
       // .m3u files are playlist metadata — not game entries
       if (ext === ".m3u") {
@@ -760,10 +1082,19 @@ export class LibraryService extends EventEmitter {
           ? this.config.systems.filter((s) => s.id === systemId)
           : this.config.systems;
 
-        const matchingSystems = systems.filter((s) => s.extensions.includes(ext));
+        let matchingSystems = systems.filter((s) => s.extensions.includes(ext));
+        if (matchingSystems.length > 1 && !systemId && sniffedSystemId) {
+          // The native scanner identified the system from the file header —
+          // trust it as long as it is one of the systems claiming the extension.
+          const sniffed = matchingSystems.find((s) => s.id === sniffedSystemId);
+          if (sniffed) {
+            matchingSystems = [sniffed];
+          }
+        }
+
         if (matchingSystems.length === 0) {
           if (systemId) {
-            libraryLog.debug(`Skipped ${entry.name}: ext=${ext} not in ${systemId} extensions`);
+            libraryLog.debug(`Skipped ${name}: ext=${ext} not in ${systemId} extensions`);
           }
         } else if (matchingSystems.length > 1 && !systemId) {
           // Extension matches multiple systems and no system filter — ambiguous
@@ -798,11 +1129,6 @@ export class LibraryService extends EventEmitter {
         }
       }
     }
-
-    // Recurse into subdirectories
-    for (const { fullPath, resolvedSystemId } of dirEntries) {
-      await this.collectCandidates(fullPath, resolvedSystemId, candidates, ambiguousFiles);
-    }
   }
 
   /** Find a game by its sourceArchivePath (for zip dedup). O(1) via index. */
@@ -840,16 +1166,22 @@ export class LibraryService extends EventEmitter {
         // File unchanged — update title/system in case config changed, but skip hash.
         // Preserve regional system name if ScreenScraper metadata has already been applied.
         const title = this.cleanGameTitle(path.basename(path.basename(fullPath), ext));
-        existingGame.title = title;
-        if (!existingGame.metadata) {
-          existingGame.system = system.name;
+        const refreshed: Partial<Game> = {
+          // Always update disc fields in case the .m3u was added or changed
+          discGroup,
+          discNumber,
+          discTotal,
+          m3uPath,
+          system: existingGame.metadata ? existingGame.system : system.name,
+          systemId: system.id,
+          title,
+        };
+        // Only games whose fields actually moved need re-persisting
+        const keys = Object.keys(refreshed) as Array<keyof Game>;
+        if (keys.some((key) => existingGame[key] !== refreshed[key])) {
+          Object.assign(existingGame, refreshed);
+          this.markChanged(existingGame.id);
         }
-        existingGame.systemId = system.id;
-        // Always update disc fields in case the .m3u was added or changed
-        existingGame.discGroup = discGroup;
-        existingGame.discNumber = discNumber;
-        existingGame.discTotal = discTotal;
-        existingGame.m3uPath = m3uPath;
         return { game: existingGame, isNew: false };
       }
     }
@@ -900,6 +1232,7 @@ export class LibraryService extends EventEmitter {
       }
 
       this.games.set(gameId, game);
+      this.markChanged(gameId);
       this.romPathIndex.set(fullPath, gameId);
       libraryLog.debug(`${isNew ? "Added" : "Updated"} ${title} (${system.id})`);
       return { game, isNew };
@@ -913,7 +1246,7 @@ export class LibraryService extends EventEmitter {
   private async processZipCandidate(
     candidate: RomCandidate,
   ): Promise<{ game: Game; isNew: boolean } | null> {
-    const { fullPath, mtimeMs, systemIdFilter } = candidate;
+    const { fullPath, mtimeMs, systemIdFilter, zipEntries } = candidate;
 
     // Check mtime cache: if this zip is already imported and unchanged, skip entirely
     const existingGameId = this.findGameByArchivePath(fullPath);
@@ -922,10 +1255,25 @@ export class LibraryService extends EventEmitter {
       if (existingGame && existingGame.romMtime === mtimeMs) {
         return { game: existingGame, isNew: false };
       }
+      // Touched but not changed: the stored CRC32 of the ROM entry still
+      // matches, so refresh the mtime without extracting or re-hashing.
+      if (existingGame && zipEntries) {
+        const match = findRomEntry(zipEntries, this.getZipRomExtensions(systemIdFilter));
+        if (match && match.crc32 === existingGame.romHashes?.crc32) {
+          try {
+            await fs.access(existingGame.romPath);
+            existingGame.romMtime = mtimeMs;
+            this.markChanged(existingGame.id);
+            return { game: existingGame, isNew: false };
+          } catch {
+            // Extracted copy is gone; re-extract below
+          }
+        }
+      }
     }
 
     try {
-      const game = await this.handleZipFile(fullPath, systemIdFilter);
+      const game = await this.handleZipFile(fullPath, systemIdFilter, zipEntries);
       if (game) {
         game.romMtime = mtimeMs;
 
@@ -939,6 +1287,7 @@ export class LibraryService extends EventEmitter {
         }
 
         this.games.set(game.id, game);
+        this.markChanged(game.id);
         this.romPathIndex.set(game.romPath, game.id);
         if (game.sourceArchivePath) {
           this.archivePathIndex.set(game.sourceArchivePath, game.id);
@@ -959,8 +1308,10 @@ export class LibraryService extends EventEmitter {
   private async processCandidatesBatch(
     candidates: Array<RomCandidate>,
     progressState: { processed: number; skipped: number; total: number },
+    emitProgress = true,
   ): Promise<Array<Game>> {
     const foundGames: Array<Game> = [];
+    await this.prefetchZipListings(candidates);
 
     // Process with bounded concurrency
     let i = 0;
@@ -975,14 +1326,16 @@ export class LibraryService extends EventEmitter {
           if (!result.isNew) {
             progressState.skipped++;
           }
-          const progressEvent: ScanProgressEvent = {
-            game: result.game,
-            isNew: result.isNew,
-            processed: progressState.processed,
-            skipped: progressState.skipped,
-            total: progressState.total,
-          };
-          this.emit("scanProgress", progressEvent);
+          if (emitProgress) {
+            const progressEvent: ScanProgressEvent = {
+              game: result.game,
+              isNew: result.isNew,
+              processed: progressState.processed,
+              skipped: progressState.skipped,
+              total: progressState.total,
+            };
+            this.emit("scanProgress", progressEvent);
+          }
         }
       }
 
@@ -992,6 +1345,33 @@ export class LibraryService extends EventEmitter {
     return foundGames;
   }
 
+  /**
+   * List every zip that will actually be opened in one native call (thread
+   * pool, central directories only, nothing decompressed). Archives left
+   * without a listing are read by the JS fallback in handleZipFile.
+   */
+  private async prefetchZipListings(candidates: Array<RomCandidate>): Promise<void> {
+    const addon = loadNativeAddon();
+    if (typeof addon?.readZipDirectories !== "function") {
+      return;
+    }
+    const zips = candidates.filter((c) => c.isZip && c.existingMtime !== c.mtimeMs);
+    if (zips.length === 0) {
+      return;
+    }
+
+    try {
+      const listings = await addon.readZipDirectories(zips.map((c) => c.fullPath));
+      for (const [i, listing] of listings.entries()) {
+        if ("entries" in listing) {
+          zips[i].zipEntries = listing.entries;
+        }
+      }
+    } catch (error) {
+      libraryLog.warn("Native zip listing failed, falling back to JS:", error);
+    }
+  }
+
   public async scanDirectory(directoryPath: string, systemId?: string): Promise<Array<Game>> {
     // Phase 1: Fast directory walk — collect all candidate files with stat info
     const candidates: Array<RomCandidate> = [];
@@ -1091,6 +1471,160 @@ export class LibraryService extends EventEmitter {
     return foundGames;
   }
 
+  /**
+   * Apply an incremental change set from the library watcher. Only the
+   * listed directories are re-walked (known files hit the mtime cache), so
+   * the cost is proportional to what changed rather than to library size.
+   *
+   * Renames are applied first so moved ROMs keep their metadata without a
+   * re-hash; removals only drop games whose file is really gone.
+   */
+  public async applyLibraryDelta(delta: LibraryDelta): Promise<LibraryChangeSummary> {
+    const summary: LibraryChangeSummary = { added: [], removedIds: [], updated: [] };
+    let dirty = false;
+
+    for (const { from, to } of delta.renamed) {
+      dirty = this.remapGamePaths(from, to) || dirty;
+    }
+
+    for (const removedPath of delta.removed) {
+      const prefix = removedPath + path.sep;
+      const gone: Array<string> = [];
+      for (const game of this.games.values()) {
+        const sourcePath = game.sourceArchivePath ?? game.romPath;
+        if (sourcePath === removedPath || sourcePath.startsWith(prefix)) {
+          gone.push(game.id);
+        }
+      }
+      for (const gameId of gone) {
+        const game = this.games.get(gameId);
+        if (!game) {
+          continue;
+        }
+        const sourcePath = game.sourceArchivePath ?? game.romPath;
+        const stillExists = await fs
+          .access(sourcePath)
+          .then(() => true)
+          .catch(() => false);
+        if (stillExists) {
+          continue;
+        }
+        await this.forgetGame(gameId);
+        summary.removedIds.push(gameId);
+        dirty = true;
+      }
+    }
+
+    const candidates: Array<RomCandidate> = [];
+    const ambiguousFiles: Array<AmbiguousRomFile> = [];
+    for (const dir of delta.directories) {
+      await this.collectCandidates(
+        dir.path,
+        this.findSystemForPath(dir.path)?.id,
+        candidates,
+        ambiguousFiles,
+        dir.recursive,
+      );
+    }
+
+    if (ambiguousFiles.length > 0) {
+      this.emit("scanAmbiguous", ambiguousFiles);
+    }
+
+    if (candidates.length > 0) {
+      const knownIds = new Set(this.games.keys());
+      const modifiedPaths = new Set(
+        candidates.filter((c) => c.isKnown && c.existingMtime !== c.mtimeMs).map((c) => c.fullPath),
+      );
+      const progressState = { processed: 0, skipped: 0, total: candidates.length };
+      const games = await this.processCandidatesBatch(candidates, progressState, false);
+      for (const game of games) {
+        if (!knownIds.has(game.id)) {
+          summary.added.push(game);
+        } else if (modifiedPaths.has(game.sourceArchivePath ?? game.romPath)) {
+          summary.updated.push(game);
+        }
+      }
+      dirty = dirty || games.length > 0;
+    }
+
+    if (dirty) {
+      await this.saveLibrary();
+    }
+
+    if (summary.added.length > 0 || summary.removedIds.length > 0 || summary.updated.length > 0) {
+      libraryLog.info(
+        `Library delta: ${summary.added.length} added, ${summary.updated.length} updated, ${summary.removedIds.length} removed`,
+      );
+      this.emit("libraryChanged", summary);
+    }
+
+    return summary;
+  }
+
+  /**
+   * Point games at a renamed file or directory. Returns true if any game
+   * was updated. Matches ROM paths, source archives and .m3u playlists.
+   */
+  private remapGamePaths(from: string, to: string): boolean {
+    const remap = (p: string | undefined): string | undefined => {
+      if (p === undefined) {
+        return undefined;
+      }
+      if (p === from) {
+        return to;
+      }
+      if (p.startsWith(from + path.sep)) {
+        return to + p.slice(from.length);
+      }
+      return undefined;
+    };
+
+    let changed = false;
+    for (const game of this.games.values()) {
+      const romPath = remap(game.romPath);
+      const archivePath = remap(game.sourceArchivePath);
+      const m3uPath = remap(game.m3uPath);
+      if (romPath) {
+        this.romPathIndex.delete(game.romPath);
+        this.romPathIndex.set(romPath, game.id);
+        game.romPath = romPath;
+        changed = true;
+      }
+      if (archivePath && game.sourceArchivePath) {
+        this.archivePathIndex.delete(game.sourceArchivePath);
+        this.archivePathIndex.set(archivePath, game.id);
+        game.sourceArchivePath = archivePath;
+        changed = true;
+      }
+      if (m3uPath) {
+        game.m3uPath = m3uPath;
+        changed = true;
+      }
+      if (romPath || archivePath || m3uPath) {
+        this.markChanged(game.id);
+      }
+    }
+    return changed;
+  }
+
+  /** System whose roms folder contains `targetPath` (deepest match wins). */
+  private findSystemForPath(targetPath: string): GameSystem | undefined {
+    let best: GameSystem | undefined;
+    for (const system of this.config.systems) {
+      if (!system.romsPath) {
+        continue;
+      }
+      const root = path.resolve(system.romsPath);
+      if (targetPath === root || targetPath.startsWith(root + path.sep)) {
+        if (!best || root.length > path.resolve(best.romsPath ?? "").length) {
+          best = system;
+        }
+      }
+    }
+    return best;
+  }
+
   public async scanSystemFolders(): Promise<Array<Game>> {
     const allGames: Array<Game> = [];
 
@@ -1130,6 +1664,7 @@ export class LibraryService extends EventEmitter {
         }
 
         this.games.set(game.id, game);
+        this.markChanged(game.id);
         this.romPathIndex.set(game.romPath, game.id);
         if (game.sourceArchivePath) {
           this.archivePathIndex.set(game.sourceArchivePath, game.id);
@@ -1171,12 +1706,19 @@ export class LibraryService extends EventEmitter {
     }
 
     this.games.set(gameId, game);
+    this.markChanged(gameId);
     this.romPathIndex.set(romPath, gameId);
     await this.saveLibrary();
     return game;
   }
 
   public async removeGame(gameId: string): Promise<void> {
+    await this.forgetGame(gameId);
+    await this.saveLibrary();
+  }
+
+  /** Drop a game and its index entries (and extracted ROM) without saving. */
+  private async forgetGame(gameId: string): Promise<void> {
     const game = this.games.get(gameId);
     if (game?.romPath.startsWith(this.romsCacheDir)) {
       try {
@@ -1193,7 +1735,7 @@ export class LibraryService extends EventEmitter {
       }
     }
     this.games.delete(gameId);
-    await this.saveLibrary();
+    this.markRemoved(gameId);
   }
 
   public async updateGame(gameId: string, updates: Partial<Game>): Promise<void> {
@@ -1201,6 +1743,7 @@ export class LibraryService extends EventEmitter {
     if (game) {
       const oldRomPath = game.romPath;
       Object.assign(game, updates);
+      this.markChanged(gameId);
       // Update romPath index if romPath changed
       if (updates.romPath && updates.romPath !== oldRomPath) {
         this.romPathIndex.delete(oldRomPath);
@@ -1220,6 +1763,7 @@ export class LibraryService extends EventEmitter {
     if (game) {
       const oldRomPath = game.romPath;
       Object.assign(game, updates);
+      this.markChanged(gameId);
       if (updates.romPath && updates.romPath !== oldRomPath) {
         this.romPathIndex.delete(oldRomPath);
         this.romPathIndex.set(updates.romPath, gameId);
@@ -1264,16 +1808,26 @@ export class LibraryService extends EventEmitter {
     return this.romsCacheDir;
   }
 
+  /** ROM extensions to look for inside an archive scanned for `systemId`. */
+  private getZipRomExtensions(systemId?: string): Array<string> {
+    return systemId
+      ? (this.config.systems.find((s) => s.id === systemId)?.extensions ?? [])
+      : this.getNonArcadeExtensions();
+  }
+
   /**
    * Extracts a ROM from a zip archive and returns a Game object.
    * Returns null if no matching ROM is found inside the zip.
    */
-  private async handleZipFile(zipPath: string, systemId?: string): Promise<Game | null> {
-    const nativeExtensions = systemId
-      ? (this.config.systems.find((s) => s.id === systemId)?.extensions ?? [])
-      : this.getNonArcadeExtensions();
-
-    const match = await findRomInZip(zipPath, nativeExtensions);
+  private async handleZipFile(
+    zipPath: string,
+    systemId?: string,
+    entries?: Array<ZipListingEntry>,
+  ): Promise<Game | null> {
+    const nativeExtensions = this.getZipRomExtensions(systemId);
+    const match = entries
+      ? findRomEntry(entries, nativeExtensions)
+      : await findRomInZip(zipPath, nativeExtensions);
     if (!match) {
       libraryLog.debug(`No matching ROM found in zip: ${zipPath}`);
       return null;
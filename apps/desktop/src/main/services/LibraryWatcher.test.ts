@@ -0,0 +1,190 @@
+import { describe, it, expect, beforeEach, afterEach, vi } from "vitest";
+import fs from "node:fs";
+import os from "node:os";
+import path from "node:path";
+
+const TEST_DIR = path.join(os.tmpdir(), "gamelord-library-watcher-test-" + Date.now());
+
+vi.mock("electron", () => ({
+  app: {
+    getPath: vi.fn(() => TEST_DIR),
+  },
+}));
+
+vi.mock("../logger", () => ({
+  libraryLog: {
+    debug: vi.fn(),
+    error: vi.fn(),
+    info: vi.fn(),
+    warn: vi.fn(),
+  },
+}));
+
+const nativeAddonMock = vi.hoisted(() => ({
+  loadNativeAddon: vi.fn((): unknown => null),
+}));
+vi.mock("../native/nativeAddon", () => nativeAddonMock);
+
+import { LibraryWatcher } from "./LibraryWatcher";
+import type { LibraryDelta, LibraryService } from "./LibraryService";
+import type { NativeWatchChange } from "../native/nativeAddon";
+
+const JOURNAL_PATH = path.join(TEST_DIR, "library-journal.json");
+const ROOT = path.join(TEST_DIR, "roms", "NES");
+
+/** Fake native watcher that reports `snapshot` and lets tests push changes. */
+function installNativeWatcher(snapshot: Array<{ mtimeMs: number; path: string }>) {
+  const state: {
+    emit: (changes: Array<NativeWatchChange>) => void;
+    instances: number;
+    closed: number;
+  } = { closed: 0, emit: () => {}, instances: 0 };
+
+  class FakeWatcher {
+    constructor(_options: unknown, onChanges: (changes: Array<NativeWatchChange>) => void) {
+      state.instances++;
+      state.emit = onChanges;
+    }
+    start() {
+      return { directories: snapshot, errors: [] };
+    }
+    close() {
+      state.closed++;
+    }
+  }
+
+  nativeAddonMock.loadNativeAddon.mockReturnValue({ LibraryWatcher: FakeWatcher });
+  return state;
+}
+
+function createLibrary() {
+  const deltas: Array<LibraryDelta> = [];
+  const library = {
+    applyLibraryDelta: vi.fn(async (delta: LibraryDelta) => {
+      deltas.push(delta);
+      return { added: [], removedIds: [], updated: [] };
+    }),
+    getSystems: vi.fn(() => [{ extensions: [".nes"], id: "nes", romsPath: ROOT }]),
+    whenReady: vi.fn(async () => {}),
+  };
+  return { deltas, library: library as unknown as LibraryService, mock: library };
+}
+
+beforeEach(() => {
+  fs.mkdirSync(ROOT, { recursive: true });
+});
+
+afterEach(() => {
+  nativeAddonMock.loadNativeAddon.mockReset();
+  nativeAddonMock.loadNativeAddon.mockReturnValue(null);
+  fs.rmSync(TEST_DIR, { force: true, recursive: true });
+});
+
+describe("LibraryWatcher", () => {
+  it("turns file changes into a per-directory delta", async () => {
+    const native = installNativeWatcher([{ mtimeMs: 1, path: ROOT }]);
+    const { deltas, library } = createLibrary();
+    const watcher = new LibraryWatcher(library);
+    await watcher.start();
+
+    native.emit([
+      { isDirectory: false, path: path.join(ROOT, "A.nes"), type: "change" },
+      { isDirectory: false, path: path.join(ROOT, "B.nes"), type: "change" },
+      {
+        isDirectory: false,
+        oldPath: path.join(ROOT, "Old.nes"),
+        path: path.join(ROOT, "New.nes"),
+        type: "rename",
+      },
+    ]);
+    await watcher.stop();
+
+    expect(deltas).toHaveLength(1);
+    expect(deltas[0].directories).toEqual([{ path: ROOT, recursive: false }]);
+    expect(deltas[0].renamed).toEqual([
+      { from: path.join(ROOT, "Old.nes"), to: path.join(ROOT, "New.nes") },
+    ]);
+  });
+
+  it("rescans a new directory recursively", async () => {
+    const native = installNativeWatcher([{ mtimeMs: 1, path: ROOT }]);
+    const { deltas, library } = createLibrary();
+    const watcher = new LibraryWatcher(library);
+    await watcher.start();
+
+    native.emit([{ isDirectory: true, path: path.join(ROOT, "Imported"), type: "add" }]);
+    await watcher.stop();
+
+    expect(deltas[0].directories).toEqual([{ path: path.join(ROOT, "Imported"), recursive: true }]);
+  });
+
+  it("reconciles only directories that changed since the last run", async () => {
+    const unchanged = path.join(ROOT, "unchanged");
+    const changed = path.join(ROOT, "changed");
+    const vanished = path.join(ROOT, "vanished");
+    const added = path.join(ROOT, "added");
+    fs.writeFileSync(
+      JOURNAL_PATH,
+      JSON.stringify({
+        directories: { [ROOT]: 1, [unchanged]: 2, [changed]: 3, [vanished]: 4 },
+        pending: [],
+        version: 1,
+      }),
+    );
+    installNativeWatcher([
+      { mtimeMs: 1, path: ROOT },
+      { mtimeMs: 2, path: unchanged },
+      { mtimeMs: 30, path: changed },
+      { mtimeMs: 5, path: added },
+    ]);
+
+    const { deltas, library } = createLibrary();
+    const watcher = new LibraryWatcher(library);
+    await watcher.start();
+    await watcher.stop();
+
+    expect(deltas).toHaveLength(1);
+    expect(deltas[0].directories.map((d) => d.path).sort()).toEqual([added, changed].sort());
+    expect(deltas[0].removed).toEqual([vanished]);
+
+    const journal = JSON.parse(fs.readFileSync(JOURNAL_PATH, "utf8"));
+    expect(journal.directories[changed]).toBe(30);
+    expect(journal.directories[vanished]).toBeUndefined();
+    expect(journal.pending).toEqual([]);
+  });
+
+  it("does not reconcile on first run without a journal", async () => {
+    installNativeWatcher([{ mtimeMs: 1, path: ROOT }]);
+    const { library, mock } = createLibrary();
+    const watcher = new LibraryWatcher(library);
+    await watcher.start();
+    await watcher.stop();
+
+    expect(mock.applyLibraryDelta).not.toHaveBeenCalled();
+    expect(fs.existsSync(JOURNAL_PATH)).toBe(true);
+  });
+
+  it("re-creates the watch set after an event queue overflow", async () => {
+    const native = installNativeWatcher([{ mtimeMs: 1, path: ROOT }]);
+    const { library } = createLibrary();
+    const watcher = new LibraryWatcher(library);
+    await watcher.start();
+
+    native.emit([{ isDirectory: false, path: "", type: "overflow" }]);
+    await vi.waitFor(() => expect(native.instances).toBe(2));
+    expect(native.closed).toBe(1);
+
+    await watcher.stop();
+  });
+
+  it("falls back to fs.watch when the native watcher is unavailable", async () => {
+    fs.mkdirSync(path.join(ROOT, "sub"), { recursive: true });
+    const { library } = createLibrary();
+    const watcher = new LibraryWatcher(library);
+    await watcher.start();
+    await watcher.stop();
+
+    const journal = JSON.parse(fs.readFileSync(JOURNAL_PATH, "utf8"));
+    expect(Object.keys(journal.directories).sort()).toEqual([ROOT, path.join(ROOT, "sub")].sort());
+  });
+});
@@ -0,0 +1,466 @@
+import { promises as fs, watch as fsWatch, type FSWatcher } from "node:fs";
+import path from "node:path";
+import { app } from "electron";
+import { libraryLog } from "../logger";
+import {
+  loadNativeAddon,
+  type NativeLibraryWatcher,
+  type NativeWatchChange,
+} from "../native/nativeAddon";
+import type { LibraryDelta, LibraryService } from "./LibraryService";
+
+/** Quiet period before a burst of filesystem events is applied. */
+const COALESCE_MS = 250;
+
+/** Journal debounce — rapid change bursts produce a single write. */
+const JOURNAL_WRITE_DELAY_MS = 1000;
+
+/**
+ * On-disk journal. `directories` is the mtime of every watched directory as
+ * of the last applied change; `pending` lists directories that had changes
+ * queued but not yet applied (e.g. the app quit mid-update).
+ */
+interface LibraryJournal {
+  directories: Record<string, number>;
+  pending: Array<string>;
+  version: 1;
+}
+
+/**
+ * Keeps the library in sync with the ROM folders while the app runs.
+ *
+ * Uses the native inotify watcher on Linux and `fs.watch({ recursive })`
+ * elsewhere. Changes are translated into a `LibraryDelta` so only the
+ * affected directories are re-walked.
+ *
+ * A compact journal of directory mtimes is persisted so that at startup only
+ * directories whose entries changed while the app was closed are reconciled,
+ * instead of re-walking every file. In-place content edits made while the
+ * app was closed don't touch the directory mtime — a manual scan still picks
+ * those up.
+ */
+export class LibraryWatcher {
+  private library: LibraryService;
+  private journalPath: string;
+  private journal: LibraryJournal = { directories: {}, pending: [], version: 1 };
+  private journalTimer: ReturnType<typeof setTimeout> | null = null;
+
+  private nativeWatcher: NativeLibraryWatcher | null = null;
+  private fsWatchers: Array<FSWatcher> = [];
+  private fsPending = new Set<string>();
+  private fsTimer: ReturnType<typeof setTimeout> | null = null;
+
+  /** Serializes delta application so overlapping batches never interleave. */
+  private applyChain: Promise<void> = Promise.resolve();
+  private running = false;
+
+  constructor(library: LibraryService) {
+    this.library = library;
+    this.journalPath = path.join(app.getPath("userData"), "library-journal.json");
+  }
+
+  /** Watch every system ROM folder and reconcile what changed since last run. */
+  async start(): Promise<void> {
+    if (this.running) {
+      return;
+    }
+    await this.library.whenReady();
+
+    const roots = this.getRoots();
+    if (roots.length === 0) {
+      return;
+    }
+    this.running = true;
+
+    const previous = await this.loadJournal();
+    let directories: Array<{ mtimeMs: number; path: string }>;
+    try {
+      directories = this.startNative(roots) ?? (await this.startFsWatch(roots));
+    } catch (error) {
+      libraryLog.warn("Library watcher failed to start:", error);
+      this.running = false;
+      return;
+    }
+
+    const current: Record<string, number> = {};
+    for (const dir of directories) {
+      current[dir.path] = dir.mtimeMs;
+    }
+
+    if (previous) {
+      const delta = this.diffJournal(previous, current);
+      if (delta.directories.length > 0 || delta.removed.length > 0) {
+        libraryLog.info(
+          `Library watcher: reconciling ${delta.directories.length} changed and ${delta.removed.length} removed directories since last run`,
+        );
+        this.journal = { directories: previous.directories, pending: previous.pending, version: 1 };
+        await this.enqueue(delta);
+      }
+    }
+
+    this.journal = { directories: current, pending: [], version: 1 };
+    this.scheduleJournalWrite();
+    libraryLog.info(
+      `Library watcher: watching ${directories.length} directories (${this.nativeWatcher ? "inotify" : "fs.watch"})`,
+    );
+  }
+
+  /** Stop watching and flush the journal. */
+  async stop(): Promise<void> {
+    if (!this.running) {
+      return;
+    }
+    this.running = false;
+
+    this.nativeWatcher?.close();
+    this.nativeWatcher = null;
+    for (const watcher of this.fsWatchers) {
+      watcher.close();
+    }
+    this.fsWatchers = [];
+    if (this.fsTimer) {
+      clearTimeout(this.fsTimer);
+      this.fsTimer = null;
+    }
+    this.fsPending.clear();
+
+    await this.applyChain;
+    if (this.journalTimer) {
+      clearTimeout(this.journalTimer);
+      this.journalTimer = null;
+    }
+    await this.writeJournal();
+  }
+
+  /** Re-create the watch set, e.g. after a system's ROM folder changed. */
+  async restart(): Promise<void> {
+    await this.stop();
+    await this.start();
+  }
+
+  // ---------------------------------------------------------------------------
+  // Backends
+  // ---------------------------------------------------------------------------
+
+  private getRoots(): Array<string> {
+    const roots = new Set<string>();
+    for (const system of this.library.getSystems()) {
+      if (system.romsPath) {
+        roots.add(path.resolve(system.romsPath));
+      }
+    }
+    return Array.from(roots);
+  }
+
+  private getExtensions(): Array<string> {
+    const extensions = new Set([".zip", ".cue", ".m3u"]);
+    for (const system of this.library.getSystems()) {
+      for (const ext of system.extensions) {
+        extensions.add(ext.toLowerCase());
+      }
+    }
+    return Array.from(extensions);
+  }
+
+  /** Returns the watched directory snapshot, or null if inotify isn't available. */
+  private startNative(roots: Array<string>): Array<{ mtimeMs: number; path: string }> | null {
+    const native = loadNativeAddon();
+    if (!native?.LibraryWatcher) {
+      return null;
+    }
+
+    const watcher = new native.LibraryWatcher(
+      { coalesceMs: COALESCE_MS, extensions: this.getExtensions(), roots },
+      (changes) => {
+        void this.onNativeChanges(changes);
+      },
+    );
+    let result;
+    try {
+      result = watcher.start();
+    } catch (error) {
+      libraryLog.debug("Native library watcher unavailable:", error);
+      return null;
+    }
+
+    for (const { message, path: errorPath } of result.errors) {
+      libraryLog.warn(`Library watcher: cannot watch ${errorPath}: ${message}`);
+    }
+    this.nativeWatcher = watcher;
+    return result.directories;
+  }
+
+  private async startFsWatch(roots: Array<string>): Promise<Array<{ mtimeMs: number; path: string }>> {
+    const directories: Array<{ mtimeMs: number; path: string }> = [];
+    for (const root of roots) {
+      await this.snapshotTree(root, directories);
+      try {
+        const watcher = fsWatch(root, { recursive: true }, (_event, filename) => {
+          if (filename) {
+            this.onFsWatchEvent(path.join(root, filename.toString()));
+          }
+        });
+        watcher.on("error", (error) => {
+          libraryLog.warn(`Library watcher error for ${root}:`, error);
+        });
+        this.fsWatchers.push(watcher);
+      } catch (error) {
+        libraryLog.warn(`Library watcher: cannot watch ${root}:`, error);
+      }
+    }
+    return directories;
+  }
+
+  /** Directory-only walk: stats directories, never individual files. */
+  private async snapshotTree(
+    root: string,
+    out: Array<{ mtimeMs: number; path: string }>,
+  ): Promise<void> {
+    const stack = [root];
+    while (stack.length > 0) {
+      const dir = stack.pop() as string;
+      try {
+        const stat = await fs.stat(dir);
+        out.push({ mtimeMs: stat.mtimeMs, path: dir });
+        const entries = await fs.readdir(dir, { withFileTypes: true });
+        for (const entry of entries) {
+          if (entry.isDirectory()) {
+            stack.push(path.join(dir, entry.name));
+          }
+        }
+      } catch {
+        // Vanished or unreadable — it simply won't be in the snapshot.
+      }
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+  // Change handling
+  // ---------------------------------------------------------------------------
+
+  private async onNativeChanges(changes: Array<NativeWatchChange>): Promise<void> {
+    if (changes.some((change) => change.type === "overflow")) {
+      libraryLog.warn("Library watcher: event queue overflowed, re-snapshotting");
+      await this.restart();
+      return;
+    }
+    await this.enqueue(this.toDelta(changes));
+  }
+
+  /**
+   * fs.watch only says "something happened to this path" — stat it after
+   * the coalescing window to work out what.
+   */
+  private onFsWatchEvent(fullPath: string): void {
+    this.fsPending.add(fullPath);
+    if (this.fsTimer) {
+      clearTimeout(this.fsTimer);
+    }
+    this.fsTimer = setTimeout(() => {
+      this.fsTimer = null;
+      const paths = Array.from(this.fsPending);
+      this.fsPending.clear();
+      void this.resolveFsWatchPaths(paths).then((changes) => this.enqueue(this.toDelta(changes)));
+    }, COALESCE_MS);
+  }
+
+  private async resolveFsWatchPaths(paths: Array<string>): Promise<Array<NativeWatchChange>> {
+    const extensions = new Set(this.getExtensions());
+    const changes: Array<NativeWatchChange> = [];
+    for (const fullPath of paths) {
+      try {
+        const stat = await fs.stat(fullPath);
+        if (stat.isDirectory()) {
+          // Only new directories matter; existing ones report their files.
+          if (!(fullPath in this.journal.directories)) {
+            changes.push({ isDirectory: true, path: fullPath, type: "add" });
+          }
+        } else if (extensions.has(path.extname(fullPath).toLowerCase())) {
+          changes.push({ isDirectory: false, path: fullPath, type: "change" });
+        }
+      } catch {
+        changes.push({
+          isDirectory: fullPath in this.journal.directories,
+          path: fullPath,
+          type: "remove",
+        });
+      }
+    }
+    return changes;
+  }
+
+  /** Translate watcher changes into the directories/paths the library must revisit. */
+  private toDelta(changes: Array<NativeWatchChange>): LibraryDelta {
+    const directories = new Map<string, boolean>();
+    const markDirectory = (dir: string, recursive: boolean): void => {
+      directories.set(dir, (directories.get(dir) ?? false) || recursive);
+    };
+    const removed: Array<string> = [];
+    const renamed: Array<{ from: string; to: string }> = [];
+
+    for (const change of changes) {
+      switch (change.type) {
+        case "add":
+        case "change":
+          if (change.isDirectory) {
+            markDirectory(change.path, true);
+          } else {
+            markDirectory(path.dirname(change.path), false);
+          }
+          break;
+        case "remove":
+          removed.push(change.path);
+          // Removing a .cue or .m3u can surface files it used to hide.
+          markDirectory(path.dirname(change.path), false);
+          break;
+        case "rename":
+          if (change.oldPath) {
+            renamed.push({ from: change.oldPath, to: change.path });
+            markDirectory(path.dirname(change.oldPath), false);
+          }
+          // A moved directory may land under a different system folder.
+          markDirectory(change.isDirectory ? change.path : path.dirname(change.path), change.isDirectory);
+          break;
+        case "overflow":
+          break;
+      }
+    }
+
+    return {
+      directories: Array.from(directories, ([dirPath, recursive]) => ({ path: dirPath, recursive })),
+      removed,
+      renamed,
+    };
+  }
+
+  /** Apply a delta after any in-flight one, journaling it as pending first. */
+  private enqueue(delta: LibraryDelta): Promise<void> {
+    const affected = [
+      ...delta.directories.map((d) => d.path),
+      ...delta.removed,
+      ...delta.renamed.flatMap((r) => [r.from, r.to]),
+    ];
+    if (affected.length === 0) {
+      return this.applyChain;
+    }
+
+    this.journal.pending = Array.from(new Set([...this.journal.pending, ...affected]));
+    this.scheduleJournalWrite();
+
+    this.applyChain = this.applyChain.then(async () => {
+      try {
+        await this.library.applyLibraryDelta(delta);
+        await this.refreshJournal(delta);
+      } catch (error) {
+        libraryLog.error("Library watcher: failed to apply changes:", error);
+      }
+    });
+    return this.applyChain;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Journal
+  // ---------------------------------------------------------------------------
+
+  /**
+   * Work out what changed while the app wasn't running: directories whose
+   * mtime moved (entries added/removed/renamed), new directories, vanished
+   * directories, and anything left pending by the previous session.
+   */
+  private diffJournal(previous: LibraryJournal, current: Record<string, number>): LibraryDelta {
+    const directories: Array<{ path: string; recursive: boolean }> = [];
+    const removed: Array<string> = [];
+
+    for (const [dir, mtimeMs] of Object.entries(current)) {
+      if (previous.directories[dir] !== mtimeMs) {
+        directories.push({ path: dir, recursive: false });
+      }
+    }
+    for (const dir of Object.keys(previous.directories)) {
+      if (!(dir in current)) {
+        removed.push(dir);
+      }
+    }
+    for (const pendingPath of previous.pending) {
+      if (pendingPath in current) {
+        if (!directories.some((d) => d.path === pendingPath)) {
+          directories.push({ path: pendingPath, recursive: true });
+        }
+      } else {
+        removed.push(pendingPath);
+        const parent = path.dirname(pendingPath);
+        if (parent in current && !directories.some((d) => d.path === parent)) {
+          directories.push({ path: parent, recursive: false });
+        }
+      }
+    }
+
+    return { directories, removed, renamed: [] };
+  }
+
+  /** Record the post-change mtimes of the directories a delta touched. */
+  private async refreshJournal(delta: LibraryDelta): Promise<void> {
+    const { directories } = this.journal;
+
+    for (const removedPath of [...delta.removed, ...delta.renamed.map((r) => r.from)]) {
+      const prefix = removedPath + path.sep;
+      for (const dir of Object.keys(directories)) {
+        if (dir === removedPath || dir.startsWith(prefix)) {
+          delete directories[dir];
+        }
+      }
+    }
+
+    for (const dir of delta.directories) {
+      const snapshot: Array<{ mtimeMs: number; path: string }> = [];
+      if (dir.recursive) {
+        await this.snapshotTree(dir.path, snapshot);
+      } else {
+        try {
+          snapshot.push({ mtimeMs: (await fs.stat(dir.path)).mtimeMs, path: dir.path });
+        } catch {
+          // Gone again — handled by the next remove event.
+        }
+      }
+      for (const entry of snapshot) {
+        directories[entry.path] = entry.mtimeMs;
+      }
+    }
+
+    this.journal.pending = [];
+    this.scheduleJournalWrite();
+  }
+
+  private async loadJournal(): Promise<LibraryJournal | null> {
+    try {
+      const data = JSON.parse(await fs.readFile(this.journalPath, "utf8")) as LibraryJournal;
+      if (data.version !== 1 || typeof data.directories !== "object") {
+        return null;
+      }
+      return { directories: data.directories, pending: data.pending ?? [], version: 1 };
+    } catch {
+      // First run (or unreadable journal) — nothing to reconcile against.
+      return null;
+    }
+  }
+
+  private scheduleJournalWrite(): void {
+    if (this.journalTimer) {
+      return;
+    }
+    this.journalTimer = setTimeout(() => {
+      this.journalTimer = null;
+      void this.writeJournal();
+    }, JOURNAL_WRITE_DELAY_MS);
+  }
+
+  private async writeJournal(): Promise<void> {
+    const tmpPath = `${this.journalPath}.tmp`;
+    try {
+      await fs.writeFile(tmpPath, JSON.stringify(this.journal), "utf8");
+      await fs.rename(tmpPath, this.journalPath);
+    } catch (error) {
+      libraryLog.warn("Failed to write library journal:", error);
+    }
+  }
+}
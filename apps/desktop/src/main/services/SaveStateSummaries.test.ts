@@ -0,0 +1,104 @@
+// @vitest-environment node
+import { describe, it, expect, beforeEach, afterEach, vi } from "vitest";
+import fs from "node:fs";
+import os from "node:os";
+import path from "node:path";
+
+const TEST_DIR = path.join(os.tmpdir(), "gamelord-state-summaries-test-" + Date.now());
+
+vi.mock("../logger", () => ({
+  nativeLog: { debug: vi.fn(), error: vi.fn(), info: vi.fn(), warn: vi.fn() },
+}));
+
+const nativeAddonMock = vi.hoisted(() => ({
+  loadNativeAddon: vi.fn((): unknown => null),
+}));
+vi.mock("../native/nativeAddon", () => nativeAddonMock);
+
+import { readStateSummaries, slotForStateFile } from "./SaveStateSummaries";
+import { encodeSaveState } from "../workers/save-state-container";
+
+const INFO = { coreName: "mGBA", coreVersion: "0.10.3", createdAtMs: 1_700_000_000_000 };
+
+function thumbnail(width: number, height: number, value: number) {
+  return { data: new Uint8Array(width * height * 4).fill(value), height, width };
+}
+
+beforeEach(() => {
+  fs.mkdirSync(TEST_DIR, { recursive: true });
+  nativeAddonMock.loadNativeAddon.mockClear();
+});
+
+afterEach(() => {
+  fs.rmSync(TEST_DIR, { force: true, recursive: true });
+});
+
+describe("slotForStateFile", () => {
+  it("maps state files to slots", () => {
+    expect(slotForStateFile("state-3.sav")).toBe(3);
+    expect(slotForStateFile("autosave.sav")).toBe(99);
+    expect(slotForStateFile("state-3.json")).toBe(null);
+    expect(slotForStateFile("notes.sav")).toBe(null);
+  });
+});
+
+describe("readStateSummaries", () => {
+  it("packs every thumbnail into one buffer, sorted by slot", async () => {
+    const state = new Uint8Array(1000);
+    fs.writeFileSync(
+      path.join(TEST_DIR, "state-2.sav"),
+      encodeSaveState(state, INFO, thumbnail(2, 2, 0x22)),
+    );
+    fs.writeFileSync(
+      path.join(TEST_DIR, "state-1.sav"),
+      encodeSaveState(state, INFO, thumbnail(3, 1, 0x11)),
+    );
+    fs.writeFileSync(path.join(TEST_DIR, "state-1.json"), "{}");
+
+    const { pixels, states } = await readStateSummaries(TEST_DIR);
+
+    expect(states.map((s) => s.slot)).toEqual([1, 2]);
+    expect(states[0]).toEqual({
+      coreName: "mGBA",
+      coreVersion: "0.10.3",
+      createdAt: INFO.createdAtMs,
+      file: "state-1.sav",
+      slot: 1,
+      stateSize: 1000,
+      thumbnail: { height: 1, offset: 0, width: 3 },
+    });
+    expect(states[1].thumbnail).toEqual({ height: 2, offset: 12, width: 2 });
+    expect(pixels.byteLength).toBe(12 + 16);
+    expect(pixels[0]).toBe(0x11);
+    expect(pixels[12]).toBe(0x22);
+  });
+
+  it("reports legacy states from stat alone", async () => {
+    fs.writeFileSync(path.join(TEST_DIR, "autosave.sav"), new Uint8Array(300).fill(1));
+
+    const { pixels, states } = await readStateSummaries(TEST_DIR);
+
+    expect(pixels.byteLength).toBe(0);
+    expect(states).toHaveLength(1);
+    expect(states[0].slot).toBe(99);
+    expect(states[0].coreName).toBe(null);
+    expect(states[0].stateSize).toBe(300);
+    expect(states[0].thumbnail).toBe(null);
+  });
+
+  it("resolves with no states for a missing directory", async () => {
+    const result = await readStateSummaries(path.join(TEST_DIR, "missing"));
+    expect(result.states).toEqual([]);
+  });
+
+  it("prefers the native reader when the addon provides it", async () => {
+    const native = { pixels: Buffer.alloc(0), states: [] };
+    const readStateSummariesNative = vi.fn(async () => native);
+    nativeAddonMock.loadNativeAddon.mockReturnValueOnce({
+      readStateSummaries: readStateSummariesNative,
+    });
+
+    expect(await readStateSummaries(TEST_DIR)).toBe(native);
+    expect(readStateSummariesNative).toHaveBeenCalledWith(TEST_DIR);
+  });
+});
@@ -0,0 +1,118 @@
+import { promises as fs } from "node:fs";
+import type { FileHandle } from "node:fs/promises";
+import path from "node:path";
+import { nativeLog } from "../logger";
+import {
+  loadNativeAddon,
+  type NativeStateSummaries,
+  type NativeStateSummary,
+} from "../native/nativeAddon";
+import {
+  parseStateHeader,
+  STATE_HEADER_SIZE,
+  STATE_SUMMARY_MAX_BYTES,
+} from "../workers/save-state-container";
+
+/** Slot for a save state file name, matching the worker's listSaveStates. */
+export function slotForStateFile(name: string): number | null {
+  if (name === "autosave.sav") {
+    return 99;
+  }
+  const match = name.match(/^state-(\d+)\.sav$/);
+  return match ? Number.parseInt(match[1], 10) : null;
+}
+
+/**
+ * Headers and thumbnails of every save state in `dir`, for slot previews
+ * without a running core. Uses the addon's parallel prefix reader when it is
+ * available and reads the same prefix with fs otherwise.
+ */
+export async function readStateSummaries(dir: string): Promise<NativeStateSummaries> {
+  const addon = loadNativeAddon();
+  if (typeof addon?.readStateSummaries === "function") {
+    try {
+      return await addon.readStateSummaries(dir);
+    } catch (error) {
+      nativeLog.warn("Native state summaries failed, using JS fallback:", error);
+    }
+  }
+  return readStateSummariesJs(dir);
+}
+
+async function readStateSummariesJs(dir: string): Promise<NativeStateSummaries> {
+  let names: Array<string>;
+  try {
+    names = await fs.readdir(dir);
+  } catch {
+    return { pixels: Buffer.alloc(0), states: [] };
+  }
+
+  const read = await Promise.all(
+    names.map(async (file) => {
+      const slot = slotForStateFile(file);
+      return slot === null ? null : readOne(path.join(dir, file), file, slot);
+    }),
+  );
+  const found = read.filter((entry) => entry !== null).sort((a, b) => a.state.slot - b.state.slot);
+
+  const pixels = Buffer.alloc(found.reduce((sum, entry) => sum + entry.pixels.byteLength, 0));
+  let offset = 0;
+  const states = found.map(({ pixels: thumb, state }) => {
+    if (state.thumbnail) {
+      pixels.set(thumb, offset);
+      state.thumbnail.offset = offset;
+      offset += thumb.byteLength;
+    }
+    return state;
+  });
+  return { pixels, states };
+}
+
+async function readOne(
+  filePath: string,
+  file: string,
+  slot: number,
+): Promise<{ pixels: Uint8Array; state: NativeStateSummary } | null> {
+  let handle: FileHandle | undefined;
+  try {
+    handle = await fs.open(filePath, "r");
+    const stat = await handle.stat();
+    const prefix = Buffer.alloc(Math.min(stat.size, STATE_SUMMARY_MAX_BYTES));
+    await handle.read(prefix, 0, prefix.byteLength, 0);
+
+    const header = parseStateHeader(prefix, stat.size);
+    if (!header) {
+      return {
+        pixels: new Uint8Array(0),
+        state: {
+          coreName: null,
+          coreVersion: null,
+          createdAt: stat.mtimeMs,
+          file,
+          slot,
+          stateSize: stat.size,
+          thumbnail: null,
+        },
+      };
+    }
+
+    const { thumbnailHeight: height, thumbnailWidth: width } = header;
+    const thumbBytes = width * height * 4;
+    return {
+      pixels: prefix.subarray(STATE_HEADER_SIZE, STATE_HEADER_SIZE + thumbBytes),
+      state: {
+        coreName: header.coreName,
+        coreVersion: header.coreVersion,
+        createdAt: header.createdAtMs,
+        file,
+        slot,
+        stateSize: header.stateSize,
+        thumbnail: thumbBytes > 0 ? { height, offset: 0, width } : null,
+      },
+    };
+  } catch {
+    return null;
+  } finally {
+    await handle?.close();
+  }
+}
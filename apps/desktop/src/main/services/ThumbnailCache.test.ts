@@ -0,0 +1,143 @@
+// @vitest-environment node
+import { describe, it, expect, beforeEach, afterEach, vi } from "vitest";
+import fs from "node:fs";
+import os from "node:os";
+import path from "node:path";
+
+const TEST_DIR = path.join(os.tmpdir(), "gamelord-thumbnail-cache-test-" + Date.now());
+
+/** Fake nativeImage decoding sources registered by `writeSource`. */
+const nativeImageMock = vi.hoisted(() => {
+  function makeImage(width: number, height: number, alpha = 255) {
+    return {
+      getSize: () => ({ height, width }),
+      isEmpty: () => width === 0,
+      resize: vi.fn((size: { height: number; width: number }) =>
+        makeImage(size.width, size.height, alpha),
+      ),
+      toBitmap: () => Buffer.alloc(width * height * 4, alpha),
+      toJPEG: () => Buffer.from(`jpeg ${width}x${height}`),
+      toPNG: () => Buffer.from(`png ${width}x${height}`),
+    };
+  }
+  const sources = new Map<string, { alpha: number; height: number; width: number }>();
+  return {
+    createFromBitmap: vi.fn((_pixels: Buffer, size: { height: number; width: number }) =>
+      makeImage(size.width, size.height),
+    ),
+    createFromPath: vi.fn((filePath: string) => {
+      const source = sources.get(filePath) ?? { alpha: 255, height: 0, width: 0 };
+      return makeImage(source.width, source.height, source.alpha);
+    }),
+    sources,
+  };
+});
+
+vi.mock("electron", () => ({ nativeImage: nativeImageMock }));
+
+vi.mock("../logger", () => ({
+  artworkLog: {
+    debug: vi.fn(),
+    error: vi.fn(),
+    info: vi.fn(),
+    warn: vi.fn(),
+  },
+}));
+
+const nativeAddonMock = vi.hoisted(() => ({
+  loadNativeAddon: vi.fn((): unknown => null),
+}));
+vi.mock("../native/nativeAddon", () => nativeAddonMock);
+
+import { ThumbnailCache, thumbnailWidthFor } from "./ThumbnailCache";
+import type { NativeResizeJob } from "../native/nativeAddon";
+
+const ARTWORK_DIR = path.join(TEST_DIR, "artwork");
+
+function writeSource(name: string, width: number, height: number, alpha = 255): string {
+  const filePath = path.join(ARTWORK_DIR, name);
+  // Content is what gets hashed, so identical dimensions share thumbnails.
+  fs.writeFileSync(filePath, `${width}x${height}:${alpha}`);
+  nativeImageMock.sources.set(filePath, { alpha, height, width });
+  return filePath;
+}
+
+beforeEach(() => {
+  fs.mkdirSync(ARTWORK_DIR, { recursive: true });
+});
+
+afterEach(() => {
+  vi.clearAllMocks();
+  nativeImageMock.sources.clear();
+  nativeAddonMock.loadNativeAddon.mockReturnValue(null);
+  fs.rmSync(TEST_DIR, { force: true, recursive: true });
+});
+
+describe("thumbnailWidthFor", () => {
+  it("rounds up to the next bucket and gives up past the largest", () => {
+    expect(thumbnailWidthFor(100)).toBe(256);
+    expect(thumbnailWidthFor(300)).toBe(512);
+    expect(thumbnailWidthFor(768)).toBe(768);
+    expect(thumbnailWidthFor(2000)).toBeNull();
+  });
+});
+
+describe("ThumbnailCache", () => {
+  it("resizes every smaller bucket natively from one decode", async () => {
+    const jobs: Array<NativeResizeJob> = [];
+    nativeAddonMock.loadNativeAddon.mockReturnValue({
+      resizeImages: vi.fn(async (batch: Array<NativeResizeJob>) => {
+        jobs.push(...batch);
+        return batch.map((job) => job.targets.map(() => Buffer.alloc(0)));
+      }),
+    });
+    const source = writeSource("a.png", 600, 900);
+    const cache = new ThumbnailCache(ARTWORK_DIR);
+
+    const served = await cache.resolve(source, 200);
+
+    expect(jobs).toHaveLength(1);
+    expect(jobs[0].targets).toEqual([
+      { height: 384, width: 256 },
+      { height: 768, width: 512 },
+    ]);
+    expect(path.dirname(served)).toBe(path.join(ARTWORK_DIR, "thumbs"));
+    expect(path.basename(served)).toMatch(/^[0-9a-f]{40}-256\.jpg$/);
+    expect(fs.readFileSync(served, "utf8")).toBe("jpeg 256x384");
+
+    // Already generated: no second decode, and wider sources fall back.
+    expect(await cache.resolve(source, 400)).toMatch(/-512\.jpg$/);
+    expect(await cache.resolve(source, 700)).toBe(source);
+    expect(nativeImageMock.createFromPath).toHaveBeenCalledTimes(1);
+  });
+
+  it("shares thumbnails between identical covers and dedupes concurrent requests", async () => {
+    const a = writeSource("a.png", 1000, 1000);
+    const b = writeSource("b.png", 1000, 1000);
+    const cache = new ThumbnailCache(ARTWORK_DIR);
+
+    const [first, second] = await Promise.all([cache.resolve(a, 256), cache.resolve(b, 256)]);
+
+    expect(first).toBe(second);
+    expect(nativeImageMock.createFromPath).toHaveBeenCalledTimes(1);
+  });
+
+  it("keeps transparency as PNG using the nativeImage fallback", async () => {
+    const source = writeSource("logo.png", 800, 400, 0);
+    const cache = new ThumbnailCache(ARTWORK_DIR);
+
+    const served = await cache.resolve(source, 256);
+
+    expect(served).toMatch(/-256\.png$/);
+    expect(fs.readFileSync(served, "utf8")).toBe("png 256x128");
+  });
+
+  it("serves the original when it is already small or unreadable", async () => {
+    const small = writeSource("small.png", 200, 300);
+    const cache = new ThumbnailCache(ARTWORK_DIR);
+
+    expect(await cache.resolve(small, 256)).toBe(small);
+    const missing = path.join(ARTWORK_DIR, "missing.png");
+    expect(await cache.resolve(missing, 256)).toBe(missing);
+  });
+});
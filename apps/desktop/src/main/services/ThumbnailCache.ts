@@ -0,0 +1,202 @@
+import { createHash } from "node:crypto";
+import { promises as fs } from "node:fs";
+import path from "node:path";
+import { nativeImage } from "electron";
+import { artworkLog } from "../logger";
+import { loadNativeAddon } from "../native/nativeAddon";
+
+/**
+ * Widths generated for every cover, smallest first. The library grid asks
+ * for one of these through `artwork://<file>?w=<width>` (see GameCard's
+ * srcset), so the renderer decodes a grid-sized image instead of the
+ * full-resolution original.
+ */
+export const THUMBNAIL_WIDTHS = [256, 512, 768] as const;
+
+/** Thumbnails generated at once. Each holds one decoded source in memory. */
+const MAX_CONCURRENT_GENERATIONS = 4;
+
+/** JPEG quality for opaque thumbnails. Covers with transparency stay PNG. */
+const JPEG_QUALITY = 85;
+
+/** Width bucket for a requested width, or null when only the original will do. */
+export function thumbnailWidthFor(requested: number): number | null {
+  return THUMBNAIL_WIDTHS.find((width) => width >= requested) ?? null;
+}
+
+/** True if any pixel of a 4-byte, alpha-last bitmap is not fully opaque. */
+function hasTransparency(bitmap: Buffer): boolean {
+  for (let i = 3; i < bitmap.length; i += 4) {
+    if (bitmap[i] !== 255) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Disk cache of downsized cover art under `artwork/thumbs/`.
+ *
+ * Files are named by the SHA-1 of the source image and the width bucket, so
+ * covers shared by several games (regional variants, discs) are resized once
+ * and a re-downloaded cover with new content never serves a stale thumbnail.
+ * Images are decoded with Electron's `nativeImage`; the resize itself runs on
+ * the native addon's thread pool, producing every width from one decode.
+ * Without the addon, `nativeImage.resize` is used instead.
+ */
+export class ThumbnailCache {
+  private readonly thumbDirectory: string;
+  /** Source hash, keyed by path + size + mtime so edits invalidate it. */
+  private readonly hashes = new Map<string, string>();
+  /** Decoded width by source hash, so narrow sources aren't decoded again. */
+  private readonly sourceWidths = new Map<string, number>();
+  /** In-flight generations by source hash. */
+  private readonly generating = new Map<string, Promise<Map<number, string> | null>>();
+  private readonly queue: Array<() => void> = [];
+  private active = 0;
+
+  constructor(artworkDirectory: string) {
+    this.thumbDirectory = path.join(artworkDirectory, "thumbs");
+  }
+
+  /**
+   * Path to serve for `sourcePath` displayed at `width` CSS pixels wide.
+   * Falls back to the source whenever a thumbnail can't be produced or
+   * wouldn't be smaller than the original.
+   */
+  async resolve(sourcePath: string, width: number): Promise<string> {
+    const bucket = thumbnailWidthFor(width);
+    if (bucket === null) {
+      return sourcePath;
+    }
+
+    try {
+      const hash = await this.hashSource(sourcePath);
+      if (bucket >= (this.sourceWidths.get(hash) ?? Infinity)) {
+        return sourcePath;
+      }
+      const existing = await this.findExisting(hash, bucket);
+      if (existing) {
+        return existing;
+      }
+
+      const generated = await this.generate(sourcePath, hash);
+      return generated?.get(bucket) ?? sourcePath;
+    } catch (error) {
+      artworkLog.warn(`Thumbnail unavailable for ${path.basename(sourcePath)}:`, error);
+      return sourcePath;
+    }
+  }
+
+  private async hashSource(sourcePath: string): Promise<string> {
+    const stats = await fs.stat(sourcePath);
+    const key = `${sourcePath}:${stats.size}:${stats.mtimeMs}`;
+    const cached = this.hashes.get(key);
+    if (cached) {
+      return cached;
+    }
+    const hash = createHash("sha1")
+      .update(await fs.readFile(sourcePath))
+      .digest("hex");
+    this.hashes.set(key, hash);
+    return hash;
+  }
+
+  private async findExisting(hash: string, width: number): Promise<string | null> {
+    for (const extension of [".jpg", ".png"]) {
+      const candidate = path.join(this.thumbDirectory, `${hash}-${width}${extension}`);
+      try {
+        await fs.access(candidate);
+        return candidate;
+      } catch {
+        // Not generated in this format.
+      }
+    }
+    return null;
+  }
+
+  private generate(sourcePath: string, hash: string): Promise<Map<number, string> | null> {
+    const inFlight = this.generating.get(hash);
+    if (inFlight) {
+      return inFlight;
+    }
+    const pending = this.withSlot(() => this.writeThumbnails(sourcePath, hash)).finally(() => {
+      this.generating.delete(hash);
+    });
+    this.generating.set(hash, pending);
+    return pending;
+  }
+
+  /** Run `task` once fewer than MAX_CONCURRENT_GENERATIONS are active. */
+  private async withSlot<T>(task: () => Promise<T>): Promise<T> {
+    if (this.active >= MAX_CONCURRENT_GENERATIONS) {
+      await new Promise<void>((resolve) => this.queue.push(resolve));
+    }
+    this.active++;
+    try {
+      return await task();
+    } finally {
+      this.active--;
+      this.queue.shift()?.();
+    }
+  }
+
+  /**
+   * Decode the source once and write every width bucket narrower than it.
+   * Resolves with bucket → file; buckets at or above the source width are
+   * left out so they fall through to the original.
+   */
+  private async writeThumbnails(
+    sourcePath: string,
+    hash: string,
+  ): Promise<Map<number, string> | null> {
+    const image = nativeImage.createFromPath(sourcePath);
+    if (image.isEmpty()) {
+      return null;
+    }
+    const { height, width } = image.getSize();
+    this.sourceWidths.set(hash, width);
+    const targets = THUMBNAIL_WIDTHS.filter((bucket) => bucket < width).map((bucket) => ({
+      height: Math.max(1, Math.round((height * bucket) / width)),
+      width: bucket,
+    }));
+    if (targets.length === 0) {
+      return new Map();
+    }
+
+    const bitmap = image.toBitmap();
+    const extension = hasTransparency(bitmap) ? ".png" : ".jpg";
+    const resized = await this.resize(image, bitmap, width, height, targets);
+
+    await fs.mkdir(this.thumbDirectory, { recursive: true });
+    const files = new Map<number, string>();
+    for (let i = 0; i < targets.length; i++) {
+      const target = targets[i];
+      const encoded = extension === ".png" ? resized[i].toPNG() : resized[i].toJPEG(JPEG_QUALITY);
+      const filePath = path.join(this.thumbDirectory, `${hash}-${target.width}${extension}`);
+      // Write-then-rename so a concurrent request never serves a partial file.
+      const tempPath = `${filePath}.tmp`;
+      await fs.writeFile(tempPath, encoded);
+      await fs.rename(tempPath, filePath);
+      files.set(target.width, filePath);
+    }
+    return files;
+  }
+
+  private async resize(
+    image: Electron.NativeImage,
+    bitmap: Buffer,
+    width: number,
+    height: number,
+    targets: Array<{ height: number; width: number }>,
+  ): Promise<Array<Electron.NativeImage>> {
+    const addon = loadNativeAddon();
+    if (typeof addon?.resizeImages === "function") {
+      const [outputs] = await addon.resizeImages([{ height, pixels: bitmap, targets, width }]);
+      return outputs.map((pixels, i) =>
+        nativeImage.createFromBitmap(pixels, { height: targets[i].height, width: targets[i].width }),
+      );
+    }
+    return targets.map((target) => image.resize({ ...target, quality: "best" }));
+  }
+}
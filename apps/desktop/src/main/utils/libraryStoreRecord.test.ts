@@ -0,0 +1,83 @@
+import { describe, it, expect } from "vitest";
+
+import { fromStoreRecord, toStoreRecord } from "./libraryStoreRecord";
+import type { Game } from "../../types/library";
+
+const HASHES = {
+  crc32: "0badf00d",
+  md5: "0123456789abcdef0123456789abcdef",
+  sha1: "0123456789abcdef0123456789abcdef01234567",
+};
+
+function makeGame(overrides: Partial<Game> = {}): Game {
+  return {
+    id: "game-1",
+    romHashes: HASHES,
+    romPath: "/roms/nes/Zelda.nes",
+    system: "Nintendo Entertainment System",
+    systemId: "nes",
+    title: "Zelda",
+    ...overrides,
+  };
+}
+
+describe("libraryStoreRecord", () => {
+  it("maps hot fields to fixed columns", () => {
+    const record = toStoreRecord(makeGame({ favorite: true, playTime: 42, romMtime: 1000.5 }));
+
+    expect(record).toEqual({
+      crc32: HASHES.crc32,
+      favorite: true,
+      id: "game-1",
+      md5: HASHES.md5,
+      playTime: 42,
+      romMtime: 1000.5,
+      romPath: "/roms/nes/Zelda.nes",
+      sha1: HASHES.sha1,
+      system: "Nintendo Entertainment System",
+      systemId: "nes",
+      title: "Zelda",
+    });
+  });
+
+  it("carries nested and unknown fields in extra", () => {
+    const game = makeGame({
+      metadata: { developer: "Nintendo", players: 1 },
+      romRegions: ["jp"],
+    });
+    (game as unknown as Record<string, unknown>).futureField = { nested: true };
+
+    const record = toStoreRecord(game);
+
+    expect(JSON.parse(record.extra ?? "{}")).toEqual({
+      futureField: { nested: true },
+      metadata: { developer: "Nintendo", players: 1 },
+      romRegions: ["jp"],
+    });
+    expect(fromStoreRecord(record)).toEqual(game);
+  });
+
+  it("keeps hashes that are not canonical hex in extra", () => {
+    const game = makeGame({ romHashes: { crc32: "ABC", md5: "", sha1: "" } });
+
+    const record = toStoreRecord(game);
+
+    expect(record.crc32).toBeUndefined();
+    expect(fromStoreRecord(record).romHashes).toEqual({ crc32: "ABC", md5: "", sha1: "" });
+  });
+
+  it("round-trips lastPlayed the same way library.json did", () => {
+    const lastPlayed = new Date("2024-05-01T12:00:00.000Z");
+    const restored = fromStoreRecord(toStoreRecord(makeGame({ lastPlayed })));
+
+    expect(restored.lastPlayed).toBe("2024-05-01T12:00:00.000Z");
+  });
+
+  it("omits undefined fields", () => {
+    const record = toStoreRecord(makeGame({ discGroup: undefined, m3uPath: undefined }));
+
+    expect(record).not.toHaveProperty("discGroup");
+    expect(record).not.toHaveProperty("m3uPath");
+    expect(record.extra).toBeUndefined();
+  });
+});
@@ -0,0 +1,85 @@
+import type { Game } from "../../types/library";
+import type { NativeStoreRecord } from "../native/nativeAddon";
+
+/** Game fields stored in fixed string columns of the native library store. */
+const STRING_COLUMNS = new Set([
+  "coverArt",
+  "discGroup",
+  "m3uPath",
+  "romPath",
+  "serial",
+  "sourceArchivePath",
+  "system",
+  "systemId",
+  "title",
+]);
+
+/** Game fields stored in fixed number columns of the native library store. */
+const NUMBER_COLUMNS = new Set([
+  "artworkNotFound",
+  "coverArtAspectRatio",
+  "discNumber",
+  "discTotal",
+  "playTime",
+  "romMtime",
+]);
+
+const HEX_LENGTHS = { crc32: 8, md5: 32, sha1: 40 } as const;
+
+function isPackableHashes(value: unknown): value is Game["romHashes"] {
+  if (typeof value !== "object" || value === null) {
+    return false;
+  }
+  const hashes = value as Record<string, unknown>;
+  return (Object.keys(HEX_LENGTHS) as Array<keyof typeof HEX_LENGTHS>).every((key) => {
+    const hash = hashes[key];
+    return (
+      typeof hash === "string" && hash.length === HEX_LENGTHS[key] && /^[0-9a-f]+$/.test(hash)
+    );
+  });
+}
+
+/**
+ * Flatten a game into the native store's record shape. Fields without a
+ * fixed column (metadata, romRegions, lastPlayed, anything added to `Game`
+ * later) are carried in `extra` as JSON, so nothing is lost in transit.
+ */
+export function toStoreRecord(game: Game): NativeStoreRecord {
+  const record: Record<string, unknown> = { id: game.id };
+  const extra: Record<string, unknown> = {};
+
+  for (const [key, value] of Object.entries(game)) {
+    if (key === "id" || value === undefined) {
+      continue;
+    }
+    if (STRING_COLUMNS.has(key) && typeof value === "string") {
+      record[key] = value;
+    } else if (NUMBER_COLUMNS.has(key) && typeof value === "number" && Number.isFinite(value)) {
+      record[key] = value;
+    } else if (key === "favorite" && typeof value === "boolean") {
+      record.favorite = value;
+    } else if (key === "romHashes" && isPackableHashes(value)) {
+      record.crc32 = value.crc32;
+      record.md5 = value.md5;
+      record.sha1 = value.sha1;
+    } else {
+      extra[key] = value;
+    }
+  }
+
+  if (Object.keys(extra).length > 0) {
+    record.extra = JSON.stringify(extra);
+  }
+  return record as unknown as NativeStoreRecord;
+}
+
+/** Inverse of `toStoreRecord`. */
+export function fromStoreRecord(record: NativeStoreRecord): Game {
+  const { crc32, extra, md5, sha1, ...columns } = record;
+  const game: Record<string, unknown> = extra ? JSON.parse(extra) : {};
+  Object.assign(game, columns);
+  if (crc32 !== undefined && md5 !== undefined && sha1 !== undefined) {
+    game.romHashes = { crc32, md5, sha1 };
+  }
+  return game as unknown as Game;
+}
@@ -8,6 +8,7 @@ import { Readable } from "node:stream";
 interface ZipEntry {
   compressedSize: number;
   compressionMethod: number;
+  crc32: number;
   fileName: string;
   localHeaderOffset: number;
   uncompressedSize: number;
@@ -43,6 +44,7 @@ function parseZipEntries(buf: Buffer): Array<ZipEntry> {
     }
 
     const compressionMethod = buf.readUInt16LE(offset + 10);
+    const crc32 = buf.readUInt32LE(offset + 16);
     const compressedSize = buf.readUInt32LE(offset + 20);
     const uncompressedSize = buf.readUInt32LE(offset + 24);
     const fileNameLength = buf.readUInt16LE(offset + 28);
@@ -54,6 +56,7 @@ function parseZipEntries(buf: Buffer): Array<ZipEntry> {
     entries.push({
       compressedSize,
       compressionMethod,
+      crc32,
       fileName,
       localHeaderOffset,
       uncompressedSize,
@@ -76,39 +79,80 @@ function getDataOffset(buf: Buffer, entry: ZipEntry): number {
   return offset + 30 + fileNameLength + extraFieldLength;
 }
 
+/** A file entry as listed in the central directory. */
+export interface ZipListingEntry {
+  /** CRC32 of the uncompressed data, 8 lowercase hex digits. */
+  crc32: string;
+  name: string;
+  /** Uncompressed size. */
+  size: number;
+}
+
+/** A ROM picked from an archive listing. */
+export interface ZipRomMatch {
+  /** Stored CRC32 of the entry — matches `romHashes.crc32` once extracted. */
+  crc32: string;
+  entryName: string;
+  extension: string;
+  size: number;
+}
+
+function isFileEntry(name: string): boolean {
+  return !name.endsWith("/") && !name.startsWith("__MACOSX/");
+}
+
+async function readZipListing(zipPath: string): Promise<Array<ZipListingEntry>> {
+  const buf = await fs.promises.readFile(zipPath);
+  return parseZipEntries(buf)
+    .filter((e) => isFileEntry(e.fileName))
+    .map((e) => ({
+      crc32: e.crc32.toString(16).padStart(8, "0"),
+      name: e.fileName,
+      size: e.uncompressedSize,
+    }));
+}
+
 /**
  * Lists all file entries inside a zip archive.
  * Filters out directory entries and macOS resource fork junk (`__MACOSX/`).
  */
 export async function listZipContents(zipPath: string): Promise<Array<string>> {
-  const buf = await fs.promises.readFile(zipPath);
-  const entries = parseZipEntries(buf);
-  return entries
-    .map((e) => e.fileName)
-    .filter((name) => !name.endsWith("/") && !name.startsWith("__MACOSX/"));
+  const entries = await readZipListing(zipPath);
+  return entries.map((e) => e.name);
 }
 
 /**
- * Finds the first file inside a zip whose extension matches one of the
- * provided native ROM extensions (e.g. `.gb`, `.nes`).
+ * Picks the first entry whose extension matches one of the provided native
+ * ROM extensions (e.g. `.gb`, `.nes`). Shared by the JS reader below and
+ * the native central-directory reader used during scans.
  */
-export async function findRomInZip(
-  zipPath: string,
+export function findRomEntry(
+  entries: Array<ZipListingEntry>,
   nativeExtensions: Array<string>,
-): Promise<{ entryName: string; extension: string } | null> {
-  const entries = await listZipContents(zipPath);
+): ZipRomMatch | null {
   const extensionSet = new Set(nativeExtensions.map((ext) => ext.toLowerCase()));
 
   for (const entry of entries) {
-    const ext = path.extname(entry).toLowerCase();
+    const ext = path.extname(entry.name).toLowerCase();
     if (extensionSet.has(ext)) {
-      return { entryName: entry, extension: ext };
+      return { crc32: entry.crc32, entryName: entry.name, extension: ext, size: entry.size };
     }
   }
 
   return null;
 }
 
+/**
+ * Finds the first file inside a zip whose extension matches one of the
+ * provided native ROM extensions (e.g. `.gb`, `.nes`).
+ */
+export async function findRomInZip(
+  zipPath: string,
+  nativeExtensions: Array<string>,
+): Promise<ZipRomMatch | null> {
+  return findRomEntry(await readZipListing(zipPath), nativeExtensions);
+}
+
 /**
  * Extracts a single file from a zip archive to a destination directory.
  * Returns the absolute path to the extracted file.
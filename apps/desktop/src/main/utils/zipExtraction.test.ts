@@ -1,5 +1,5 @@
 import { describe, it, expect, beforeAll, afterAll } from "vitest";
-import { listZipContents, findRomInZip, extractFileFromZip } from "./zipExtraction";
+import { listZipContents, findRomEntry, findRomInZip, extractFileFromZip } from "./zipExtraction";
 import fs from "node:fs";
 import path from "node:path";
 import os from "node:os";
@@ -212,6 +212,27 @@ describe("findRomInZip", () => {
     expect(assertDefined(result).entryName).toBe("subdir/nested.sfc");
     expect(assertDefined(result).extension).toBe(".sfc");
   });
+
+  it("reports the stored CRC32 and uncompressed size", async () => {
+    const data = Buffer.from("fake gb rom data");
+    const result = await findRomInZip(path.join(ZIPS_DIR, "single-gb.zip"), [".gb"]);
+    expect(assertDefined(result).crc32).toBe(crc32(data).toString(16).padStart(8, "0"));
+    expect(assertDefined(result).size).toBe(data.length);
+  });
+});
+
+describe("findRomEntry", () => {
+  it("picks the first matching entry from a listing", () => {
+    const result = findRomEntry(
+      [
+        { crc32: "00000001", name: "readme.txt", size: 10 },
+        { crc32: "0badf00d", name: "Game.SFC", size: 20 },
+        { crc32: "00000002", name: "other.sfc", size: 30 },
+      ],
+      [".sfc"],
+    );
+    expect(result).toEqual({ crc32: "0badf00d", entryName: "Game.SFC", extension: ".sfc", size: 20 });
+  });
 });
 
 describe("extractFileFromZip", () => {
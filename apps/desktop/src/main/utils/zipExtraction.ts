@@ -3,4 +3,5 @@
  * These functions work on all platforms (macOS, Windows, Linux)
  * using Node.js built-in zlib instead of the system `unzip` command.
  */
-export { extractFileFromZip, findRomInZip, listZipContents } from "./zip";
+export { extractFileFromZip, findRomEntry, findRomInZip, listZipContents } from "./zip";
+export type { ZipListingEntry, ZipRomMatch } from "./zip";
@@ -2,11 +2,14 @@ import { describe, it, expect } from "vitest";
 import {
   filterForwardableLogs,
   extractSerialFromLog,
+  formatStallReport,
+  invalidRunCondition,
   RETRO_LOG_DEBUG,
   RETRO_LOG_INFO,
   RETRO_LOG_WARN,
   RETRO_LOG_ERROR,
   MIN_FORWARD_LOG_LEVEL,
+  summarizeFrameTimes,
 } from "./core-worker-protocol";
 
 describe("filterForwardableLogs", () => {
@@ -113,3 +116,72 @@ describe("extractSerialFromLog", () => {
     );
   });
 });
+
+describe("formatStallReport", () => {
+  it("renders the stack, spans and I/O counters", () => {
+    const text = formatStallReport({
+      frame: 1234,
+      frameMs: 612.4,
+      io: {
+        involuntarySwitches: 1,
+        majorFaults: 3,
+        readBytes: 2_352_000,
+        voluntarySwitches: 40,
+        writeBytes: 0,
+      },
+      spans: [
+        { durationMs: 2.25, name: "video_convert", startMs: -14.5 },
+        { durationMs: null, name: "disc_swap", startMs: 0.2 },
+      ],
+      stack: ["libc.so.6!read+0x1e", "swanstation_libretro.so!CDImage::Read+0x88"],
+      stalledMs: 251,
+    });
+
+    expect(text.split("\n")).toEqual([
+      "Emulation stall: frame 1234 took 612 ms (stack captured at 251 ms)",
+      "    at libc.so.6!read+0x1e",
+      "    at swanstation_libretro.so!CDImage::Read+0x88",
+      "    span video_convert @ -14.5 ms (2.3 ms)",
+      "    span disc_swap @ 0.2 ms (open)",
+      "    io: 2352000 B read, 0 B written, 3 major faults, 40/1 context switches",
+    ]);
+  });
+});
+
+describe("invalidRunCondition", () => {
+  it("rejects runUntil with a negative address", () => {
+    expect(invalidRunCondition([{ address: -1, type: "memory" }])).toBe(
+      "Address must be a non-negative integer",
+    );
+  });
+
+  it("rejects fractional and unsafe addresses", () => {
+    expect(invalidRunCondition([{ address: 0.5, type: "memory" }])).not.toBeNull();
+    expect(invalidRunCondition([{ address: 2 ** 64, type: "memory" }])).not.toBeNull();
+  });
+
+  it("accepts in-range memory and non-memory conditions", () => {
+    expect(
+      invalidRunCondition([{ address: 0x1f, type: "memory" }, { type: "nonBlankFrame" }]),
+    ).toBeNull();
+  });
+});
+
+describe("summarizeFrameTimes", () => {
+  it("reports mean, deviation, 99th percentile and rate", () => {
+    // 99 frames at 2ms and one 12ms hitch.
+    const times = Array.from({ length: 100 }, (_, i) => (i === 50 ? 12 : 2));
+    const stats = summarizeFrameTimes(times);
+    expect(stats.meanMs).toBeCloseTo(2.1);
+    expect(stats.fps).toBeCloseTo(476.19);
+    expect(stats.stdDevMs).toBeCloseTo(0.995);
+    expect(stats.p99Ms).toBe(2);
+
+    times[10] = 8;
+    expect(summarizeFrameTimes(times).p99Ms).toBe(8);
+  });
+
+  it("is all zero for no frames", () => {
+    expect(summarizeFrameTimes([])).toEqual({ fps: 0, meanMs: 0, p99Ms: 0, stdDevMs: 0 });
+  });
+});
@@ -24,7 +24,13 @@ export interface NativeLibretroCore {
     blockExtract: boolean;
   } | null;
   getAVInfo(): AVInfo | null;
-  getVideoFrame(): { data: Uint8Array; width: number; height: number } | null;
+  /** `staticFrames`: identical frames in a row before this one. */
+  getVideoFrame(): {
+    data: Uint8Array;
+    width: number;
+    height: number;
+    staticFrames: number;
+  } | null;
   getAudioBuffer(): Int16Array | null;
   setInputState(port: number, id: number, value: number): void;
   setInputAnalog(port: number, index: number, id: number, value: number): void;
@@ -36,9 +42,15 @@ export interface NativeLibretroCore {
   isLoaded(): boolean;
   setSystemDirectory(dir: string): void;
   setSaveDirectory(dir: string): void;
+  /** Where read-only snapshots of writable ROMs are kept, so they can be mapped. */
+  setContentSnapshotDirectory(dir: string): void;
   getMemoryData(memType?: number): Uint8Array | null;
   getMemorySize(memType?: number): number;
   setMemoryData(data: Uint8Array, memType?: number): void;
+  /** Read a 1-4 byte little-endian value, or null when out of range. */
+  peekMemory(memType: number, address: number, size: number): number | null;
+  /** Write a 1-4 byte little-endian value; false when out of range. */
+  pokeMemory(memType: number, address: number, size: number, value: number): boolean;
   getLogMessages(): Array<{ level: number; message: string }>;
   getCoreOptions(): Record<string, string>;
   setCoreOption(key: string, value: string): boolean;
@@ -51,12 +63,346 @@ export interface NativeLibretroCore {
   getDiscLabel(index?: number): string | null;
   replaceDiscImage(index: number, path: string): boolean;
   addDiscImage(path: string): number;
+  /**
+   * Run frames back to back until a condition holds or `maxFrames` elapse.
+   * Conditions are checked natively after every frame; audio is discarded.
+   */
+  runUntil(conditions: Array<RunCondition>, maxFrames: number): RunUntilResult;
+  /**
+   * Start the native stall watchdog. Must be called from the emulation
+   * thread, since that is the stack it captures.
+   */
+  startWatchdog(thresholdMs?: number): void;
+  stopWatchdog(): void;
+  /** Stall reports whose frame has since finished. */
+  takeStallReports(): Array<StallReport>;
+  getMemoryStats(): MemoryStats;
+  /**
+   * Diff malloc's in-use bytes around every retro_run. Costs milliseconds
+   * per frame on glibc, so only enable it while investigating growth.
+   * Resets the accumulated growth.
+   */
+  trackCoreHeap(enabled: boolean): void;
+  /** Input queue counters. Reading resets `maxLatencyMs`. */
+  getInputStats(): InputStats;
+  /** Whether the core registered RETRO_ENVIRONMENT_SET_AUDIO_CALLBACK. */
+  hasAudioCallback(): boolean;
+  /**
+   * Invoke the core's audio callback once. Returns the Int16 samples it
+   * produced, collected by the next `getAudioBuffer()`.
+   */
+  pullAudio(): number;
+  /** Tell a pull-mode core whether audio output is running. */
+  setAudioState(enabled: boolean): void;
+  /**
+   * Compose SW frames into `layout` from the next frame on. Returns the
+   * output size for the current source, for the renderer's aspect ratio.
+   */
+  setScreenLayout(layout: ScreenLayout): { width: number; height: number };
+  /**
+   * Touch input, normalized (0..1) over the displayed frame. Mapped back
+   * through the screen layout into the core's pointer coordinates.
+   */
+  setPointerState(x: number, y: number, pressed: boolean): void;
+  /**
+   * Enable the performance HUD. Frame pacing and readback stalls are
+   * measured natively; the HUD is only drawn by drawPerfHud.
+   */
+  setPerfHud(enabled: boolean): void;
+  /** HUD figures only the worker knows; negative fill when unknown. */
+  setPerfHudInputs(audioFillMs: number, droppedFrames: number): void;
+  /**
+   * Blend the HUD into an RGBA frame about to be published or saved as a
+   * screenshot. Does nothing while the HUD is off. getVideoFrame never
+   * includes it, so save state thumbnails stay clean.
+   */
+  drawPerfHud(pixels: Uint8Array, width: number, height: number): void;
 }
 
 export interface NativeAddon {
   LibretroCore: new () => NativeLibretroCore;
 }
 
+// ---------------------------------------------------------------------------
+// Headless fast-run (runUntil)
+// ---------------------------------------------------------------------------
+
+/**
+ * A stop condition for `runUntil`. Any condition holding ends the run.
+ *
+ * - `memory`: compare a little-endian value (1, 2 or 4 bytes, masked) at
+ *   `address` in `memType` (defaults to RETRO_MEMORY_SYSTEM_RAM). `changed`
+ *   compares against the value when the run started.
+ * - `frameHash`: the frame's hash equals `hash` (as reported in `frameHash`).
+ * - `nonBlankFrame`: the frame contains more than one colour.
+ * - `inputPoll`: the core polled input during the frame.
+ */
+export type RunCondition =
+  | {
+      type: "memory";
+      address: number;
+      memType?: number;
+      size?: 1 | 2 | 4;
+      mask?: number;
+      op?: "eq" | "ne" | "lt" | "le" | "gt" | "ge" | "changed";
+      value?: number;
+    }
+  | { type: "frameHash"; hash: string }
+  | { type: "nonBlankFrame" }
+  | { type: "inputPoll" };
+
+/**
+ * Why `conditions` can't be handed to runUntil, or null when they can.
+ * Memory addresses must be non-negative integers; the addon checks them
+ * against the region size too, but rejecting bad input here keeps the
+ * error message in one place for both checks.
+ */
+export function invalidRunCondition(conditions: Array<RunCondition>): string | null {
+  for (const condition of conditions) {
+    if (
+      condition.type === "memory" &&
+      !(Number.isSafeInteger(condition.address) && condition.address >= 0)
+    ) {
+      return "Address must be a non-negative integer";
+    }
+  }
+  return null;
+}
+
+export interface RunUntilResult {
+  frames: number;
+  elapsedMs: number;
+  /** Index of the condition that stopped the run, or -1 if `maxFrames` did. */
+  matched: number;
+  /** Hash of the last frame, when video was rendered during the run. */
+  frameHash?: string;
+}
+
+// ---------------------------------------------------------------------------
+// Core benchmarking
+// ---------------------------------------------------------------------------
+
+/** Unpaced speed and save state cost of the loaded core and game. */
+export interface BenchmarkResult {
+  /** loadCore + loadGame inside the worker. */
+  loadMs: number;
+  /** Frame rate the core paces to, from its AV info. */
+  targetFps: number;
+  /** retro_run back to back, after the warmup frames. */
+  frames: number;
+  fps: number;
+  frameTimeMeanMs: number;
+  frameTimeStdDevMs: number;
+  frameTimeP99Ms: number;
+  /** Serialized state size; 0 when the core can't save states. */
+  stateSize: number;
+  /** Mean retro_serialize time, or null when the core can't save states. */
+  serializeMs: number | null;
+}
+
+/** Mean, standard deviation, 99th percentile and rate of per-frame times. */
+export function summarizeFrameTimes(times: ArrayLike<number>): {
+  fps: number;
+  meanMs: number;
+  p99Ms: number;
+  stdDevMs: number;
+} {
+  const count = times.length;
+  if (count === 0) {
+    return { fps: 0, meanMs: 0, p99Ms: 0, stdDevMs: 0 };
+  }
+  let sum = 0;
+  for (let i = 0; i < count; i++) {
+    sum += times[i];
+  }
+  const meanMs = sum / count;
+  let squares = 0;
+  for (let i = 0; i < count; i++) {
+    squares += (times[i] - meanMs) ** 2;
+  }
+  const sorted = Float64Array.from(times).sort();
+  return {
+    fps: meanMs > 0 ? 1000 / meanMs : 0,
+    meanMs,
+    p99Ms: sorted[Math.min(count - 1, Math.ceil(count * 0.99) - 1)],
+    stdDevMs: Math.sqrt(squares / count),
+  };
+}
+
+// ---------------------------------------------------------------------------
+// Stall watchdog
+// ---------------------------------------------------------------------------
+
+/** Frames running longer than this are reported by the stall watchdog. */
+export const STALL_THRESHOLD_MS = 250;
+
+/** One retro_run that exceeded the stall threshold. */
+export interface StallReport {
+  /** Heartbeat sequence number of the stalled frame. */
+  frame: number;
+  /** How long the frame had been running when its stack was captured. */
+  stalledMs: number;
+  /** Full duration of the frame. */
+  frameMs: number;
+  /** Emulation thread stack at capture, innermost first ("module!symbol+0xoff"). */
+  stack: Array<string>;
+  /**
+   * Recent native spans (serialize, HW readback, disc swap, …), times in ms
+   * relative to the frame start. `durationMs` is null for spans still open.
+   */
+  spans: Array<{ name: string; startMs: number; durationMs: number | null }>;
+  /** Process I/O between the last healthy watchdog poll and the capture. */
+  io: {
+    readBytes: number;
+    writeBytes: number;
+    majorFaults: number;
+    voluntarySwitches: number;
+    involuntarySwitches: number;
+  };
+}
+
+/** Multi-line, log-friendly rendering of a stall report. */
+export function formatStallReport(report: StallReport): string {
+  const lines = [
+    `Emulation stall: frame ${report.frame} took ${report.frameMs.toFixed(0)} ms ` +
+      `(stack captured at ${report.stalledMs.toFixed(0)} ms)`,
+  ];
+  for (const frame of report.stack) {
+    lines.push(`    at ${frame}`);
+  }
+  for (const span of report.spans) {
+    const duration = span.durationMs === null ? "open" : `${span.durationMs.toFixed(1)} ms`;
+    lines.push(`    span ${span.name} @ ${span.startMs.toFixed(1)} ms (${duration})`);
+  }
+  lines.push(
+    `    io: ${report.io.readBytes} B read, ${report.io.writeBytes} B written, ` +
+      `${report.io.majorFaults} major faults, ` +
+      `${report.io.voluntarySwitches}/${report.io.involuntarySwitches} context switches`,
+  );
+  return lines.join("\n");
+}
+
+// ---------------------------------------------------------------------------
+// Screen layout
+// ---------------------------------------------------------------------------
+
+/**
+ * How a core's stacked screens (DS-style: both in one buffer, top over
+ * bottom) are arranged in the output frame. `none` passes frames through.
+ */
+export type ScreenLayoutMode = "none" | "stacked" | "sideBySide" | "single" | "largeSmall";
+
+export interface ScreenLayout {
+  mode: ScreenLayoutMode;
+  /** Source pixels between the screens (max 64). */
+  gap?: number;
+  /** Screen shown first, large, or alone: 0 = top, 1 = bottom. */
+  primary?: number;
+  /** `largeSmall` scale of the primary screen (1-4, default 2). */
+  scale?: number;
+}
+
+// ---------------------------------------------------------------------------
+// Memory accounting
+// ---------------------------------------------------------------------------
+
+export type MemorySubsystem = "video" | "hwRender" | "audio" | "rom" | "state" | "log" | "caches";
+
+/**
+ * Emulation worker memory. `subsystems` covers the addon's own buffers;
+ * `highWater` keeps transient peaks such as a serialize buffer. `totalHighWater` sums per-subsystem peaks,
+ * so it is an upper bound on what was ever live at once.
+ */
+export interface MemoryStats {
+  subsystems: Record<MemorySubsystem, { bytes: number; highWater: number }>;
+  totalBytes: number;
+  totalHighWater: number;
+  process: {
+    rssBytes: number;
+    peakRssBytes: number;
+    /** Proportional set size on Linux, phys_footprint on macOS, else null. */
+    pssBytes: number | null;
+  };
+  /** Net malloc growth across retro_run while `trackCoreHeap(true)` is on. */
+  coreHeap: {
+    supported: boolean;
+    tracking: boolean;
+    netGrowthBytes: number;
+    framesSampled: number;
+  };
+  /**
+   * Process-wide content mappings shared by every core instance; `bytes`
+   * counts each distinct file once however many instances hold it.
+   */
+  contentCache: {
+    entries: number;
+    bytes: number;
+    hits: number;
+    misses: number;
+  };
+}
+
+/** Emulation loop power figures; rates cover the time since the last query. */
+export interface PowerStats {
+  /** Loop timer wakeups per second (zero while parked). */
+  wakeupsPerSecond: number;
+  /** Worker CPU time as a percentage of one core. */
+  cpuPercent: number;
+  /** Whole-package power from Linux RAPL, where readable; otherwise null. */
+  packageWatts: number | null;
+  /** Current busy-wait window before each frame deadline. */
+  spinWindowMs: number;
+  /** Identical frames in a row at the last frame. */
+  staticFrames: number;
+  /** Whether the loop is parked (paused, no timers scheduled). */
+  parked: boolean;
+}
+
+/**
+ * Frame script overhead. Times cover the script's pre- and post-`retro_run`
+ * hooks together, per frame.
+ */
+export interface ScriptStats {
+  loaded: boolean;
+  budgetMs: number;
+  lastFrameMs: number;
+  meanFrameMs: number;
+  maxFrameMs: number;
+  /** Frames whose hooks ran over budget. */
+  overruns: number;
+  hookCalls: number;
+  /** Why the script was switched off (trap or budget), or null while it runs. */
+  disabledReason: string | null;
+}
+
+/**
+ * Where a launch's time went, in milliseconds. `spawnMs` is zero for a
+ * prewarmed worker, whose spawn, addon require and core load already
+ * happened in the background — those fields then report the parked cost
+ * and are excluded from `totalMs`.
+ */
+export interface LaunchPhases {
+  prewarmed: boolean;
+  spawnMs: number;
+  addonMs: number;
+  coreLoadMs: number;
+  gameLoadMs: number;
+  /** From the end of `init` to the first frame the core produced. */
+  firstFrameMs: number;
+  /** From the launch request to the first frame. */
+  totalMs: number;
+}
+
+/**
+ * Sub-frame input queue counters. `maxLatencyMs` is the longest an input
+ * event waited for the core's next input poll since the previous read.
+ */
+export interface InputStats {
+  events: number;
+  overflows: number;
+  maxLatencyMs: number;
+}
+
 // ---------------------------------------------------------------------------
 // AV info (geometry + timing)
 // ---------------------------------------------------------------------------
@@ -110,17 +456,32 @@ export type WorkerCommand =
       /** Force-enable save states for HW-render cores (for testing). */
       forceHWSaveStates?: boolean;
     }
+  | {
+      /**
+       * Park the worker with the addon required and the core loaded, ahead
+       * of an `init` for a game on the same core.
+       */
+      action: "preload";
+      addonPath: string;
+      corePath: string;
+      systemDir: string;
+      saveDir: string;
+    }
   | { action: "pause" }
   | { action: "resume" }
   | { action: "reset" }
   | { action: "input"; port: number; id: number; pressed: boolean }
   | { action: "inputAnalog"; port: number; index: number; id: number; value: number }
+  | { action: "pointer"; x: number; y: number; pressed: boolean }
+  | { action: "setScreenLayout"; layout: ScreenLayout; requestId: string }
   | { action: "saveState"; slot: number; requestId: string }
   | { action: "loadState"; slot: number; requestId: string }
   | { action: "saveSram"; requestId: string }
   | { action: "screenshot"; requestId: string; outputPath?: string }
   | { action: "setSpeed"; multiplier: number }
   | { action: "setFastForwardAudio"; enabled: boolean }
+  | { action: "setStaticFrameThrottle"; enabled: boolean }
+  | { action: "setPerfHud"; enabled: boolean }
   | { action: "shutdown"; requestId: string }
   | {
       action: "setupSharedBuffers";
@@ -141,7 +502,21 @@ export type WorkerCommand =
   | { action: "getDiscInfo"; requestId: string }
   | { action: "replaceDiscImage"; index: number; path: string; requestId: string }
   | { action: "addDiscImage"; path: string; requestId: string }
-  | { action: "listSaveStates"; requestId: string };
+  | { action: "listSaveStates"; requestId: string }
+  | {
+      action: "runUntil";
+      conditions: Array<RunCondition>;
+      maxFrames: number;
+      requestId: string;
+    }
+  | { action: "getMemoryStats"; requestId: string }
+  | { action: "trackCoreHeap"; enabled: boolean; requestId: string }
+  | { action: "getInputStats"; requestId: string }
+  | { action: "getPowerStats"; requestId: string }
+  | { action: "benchmark"; frames: number; warmupFrames: number; requestId: string }
+  | { action: "loadScript"; path: string; budgetMs?: number; requestId: string }
+  | { action: "unloadScript"; requestId: string }
+  | { action: "getScriptStats"; requestId: string };
 
 // ---------------------------------------------------------------------------
 // Libretro log levels (from libretro.h RETRO_LOG_*)
@@ -214,4 +589,8 @@ export type WorkerEvent =
       error?: string;
       data?: unknown;
     }
-  | { type: "discChanged"; index: number; total: number };
+  | { type: "discChanged"; index: number; total: number }
+  | { type: "stall"; report: StallReport }
+  | { type: "scriptOverlay"; text: string }
+  | { type: "preloaded"; addonMs: number; coreLoadMs: number }
+  | { type: "launchPhases"; phases: Omit<LaunchPhases, "spawnMs" | "totalMs"> };
@@ -15,17 +15,32 @@ import type {
   WorkerCommand,
   WorkerEvent,
   AVInfo,
+  BenchmarkResult,
+  LaunchPhases,
   SaveStateMetadata,
 } from "./core-worker-protocol";
 import {
-  CTRL_ACTIVE_BUFFER,
-  CTRL_FRAME_SEQUENCE,
-  CTRL_FRAME_WIDTH,
-  CTRL_FRAME_HEIGHT,
   CTRL_AUDIO_WRITE_POS,
+  CTRL_AUDIO_READ_POS,
   CTRL_AUDIO_SAMPLE_RATE,
+  CTRL_AUDIO_FILL,
+  AUDIO_FILL_UNKNOWN,
+  audioRatePeriodScale,
+  hostNowMs,
+  topUpAudio,
+  VideoSlotProducer,
 } from "./shared-frame-protocol";
-import { filterForwardableLogs, extractSerialFromLog } from "./core-worker-protocol";
+import { PowerMeter, SpinWindow, shouldPresentFrame } from "./idle-power";
+import { encodeSaveState, makeThumbnail, stateDataOf } from "./save-state-container";
+import { ScriptHost } from "./script-host";
+import {
+  filterForwardableLogs,
+  extractSerialFromLog,
+  invalidRunCondition,
+  RETRO_LOG_INFO,
+  STALL_THRESHOLD_MS,
+  summarizeFrameTimes,
+} from "./core-worker-protocol";
 
 // ---------------------------------------------------------------------------
 // State
@@ -52,6 +67,34 @@ let speedMultiplier = 1;
 let sampleRate = 44_100;
 let fastForwardAudio = false;
 
+// Pull-mode audio: the core set an audio callback, and is asked for samples
+// whenever the output ring runs low rather than only after retro_run.
+let audioPull = false;
+let audioPullTimer: ReturnType<typeof setInterval> | null = null;
+/** How often the output ring's fill is checked between frames. */
+const AUDIO_PULL_INTERVAL_MS = 2;
+
+// Frame timeline published with each shared-buffer frame
+let coreFrameCount = 0;
+let lastRunStartedAt = 0;
+
+/** loadCore + loadGame time, reported by benchmark. */
+let contentLoadMs = 0;
+
+/** Core loaded by a `preload` command, waiting for its `init`. */
+let preloaded: {
+  core: NativeLibretroCore;
+  corePath: string;
+  addonMs: number;
+  coreLoadMs: number;
+} | null = null;
+
+/** Launch phases held back until the first frame is produced. */
+let pendingLaunch: {
+  phases: Omit<LaunchPhases, "firstFrameMs" | "spawnMs" | "totalMs">;
+  readyAt: number;
+} | null = null;
+
 // Error tracking
 let consecutiveErrors = 0;
 const MAX_CONSECUTIVE_ERRORS = 5;
@@ -61,11 +104,34 @@ let controlView: Int32Array | null = null;
 let videoView: Uint8Array | null = null;
 let audioView: Int16Array | null = null;
 let videoBufferSize = 0;
+let videoSlots: VideoSlotProducer | null = null;
 let useSharedBuffers = false;
 
-// Spin threshold: busy-wait the last N ms of each frame for precise timing
+// Spin threshold: busy-wait the last N ms of each frame for precise timing.
+// This is the starting point; spinWindow adapts it to measured timer slack.
 const SPIN_THRESHOLD_MS = 2;
 
+// Power: the loop parks (no timers at all) while paused, and can publish
+// static screens at a reduced rate while the core keeps running.
+const spinWindow = new SpinWindow(SPIN_THRESHOLD_MS);
+const powerMeter = new PowerMeter();
+let staticFrameThrottle = false;
+let lastStaticFrames = 0;
+
+// Performance HUD: the addon draws it into each published copy of a frame;
+// the worker feeds it the audio ring fill and the frames the renderer never
+// claimed. lastFrame (save state thumbnails) keeps the un-annotated frame.
+let perfHud = false;
+let droppedFrames = 0;
+
+/** Last frame published, kept for save state thumbnails. */
+let lastFrame: { data: Uint8Array; width: number; height: number } | null = null;
+let parked = false;
+let wakeLoop: (() => void) | null = null;
+
+/** Frame script hooked around retro_run, if one is loaded. */
+let script: ScriptHost | null = null;
+
 // ---------------------------------------------------------------------------
 // Messaging
 // ---------------------------------------------------------------------------
@@ -152,16 +218,28 @@ function saveState(slot: number): void {
     throw new Error("Failed to serialize state");
   }
 
+  const systemInfo = native.getSystemInfo();
+  const coreName = systemInfo?.libraryName ?? "Unknown";
+  const coreVersion = systemInfo?.libraryVersion ?? "Unknown";
+  const createdAt = new Date();
+  const thumbnail = lastFrame
+    ? makeThumbnail(lastFrame.data, lastFrame.width, lastFrame.height)
+    : null;
+  const file = encodeSaveState(
+    stateData,
+    { coreName, coreVersion, createdAtMs: createdAt.getTime() },
+    thumbnail,
+  );
+
   const statePath = getStatePath(slot);
   fs.mkdirSync(path.dirname(statePath), { recursive: true });
-  fs.writeFileSync(statePath, Buffer.from(stateData.buffer));
+  fs.writeFileSync(statePath, file);
 
-  const systemInfo = native.getSystemInfo();
   const metadata: SaveStateMetadata = {
     slot,
-    createdAt: new Date().toISOString(),
-    coreName: systemInfo?.libraryName ?? "Unknown",
-    coreVersion: systemInfo?.libraryVersion ?? "Unknown",
+    createdAt: createdAt.toISOString(),
+    coreName,
+    coreVersion,
     playTimeSeconds: null,
     romName: getRomName(),
     stateSize: stateData.byteLength,
@@ -181,7 +259,7 @@ function loadState(slot: number): void {
   }
 
   const data = fs.readFileSync(statePath);
-  const stateData = new Uint8Array(data.buffer, data.byteOffset, data.byteLength);
+  const stateData = stateDataOf(new Uint8Array(data.buffer, data.byteOffset, data.byteLength));
 
   if (!native.unserializeState(stateData)) {
     throw new Error("Failed to restore state");
@@ -245,6 +323,86 @@ function listSaveStates(): Array<SaveStateMetadata> {
   return states.sort((a, b) => a.slot - b.slot);
 }
 
+// ---------------------------------------------------------------------------
+// Frame scripts
+// ---------------------------------------------------------------------------
+
+/**
+ * Compile a frame script against the loaded core. Replaces any script
+ * already running.
+ */
+function loadScript(scriptPath: string, budgetMs?: number): ScriptHost {
+  const core = native;
+  if (!core) {
+    throw new Error("No core loaded");
+  }
+  return new ScriptHost(
+    fs.readFileSync(scriptPath),
+    {
+      log: (level, message) => send({ type: "log", level, message }),
+      peek: (memType, address, size) => core.peekMemory(memType, address, size),
+      poke: (memType, address, size, value) => core.pokeMemory(memType, address, size, value),
+      setInput: (port, id, value) => core.setInputState(port, id, value),
+    },
+    budgetMs,
+  );
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+/** retro_serialize calls timed per benchmark. */
+const SERIALIZE_RUNS = 5;
+
+/**
+ * Time retro_run back to back and retro_serialize for the core matrix.
+ * Blocks this process like runUntil; the frame loop resyncs afterwards.
+ */
+function runBenchmark(warmupFrames: number, frames: number): BenchmarkResult {
+  if (!native) {
+    throw new Error("No core loaded");
+  }
+
+  for (let i = 0; i < warmupFrames; i++) {
+    native.run();
+  }
+  const times = new Float64Array(frames);
+  for (let i = 0; i < frames; i++) {
+    const startedAt = performance.now();
+    native.run();
+    times[i] = performance.now() - startedAt;
+    // Drain as the loop would, so the ring never saturates mid-run.
+    native.getAudioBuffer();
+  }
+  coreFrameCount += warmupFrames + frames;
+
+  let stateSize = 0;
+  let serializeMs: number | null = null;
+  const serializeStartedAt = performance.now();
+  for (let i = 0; i < SERIALIZE_RUNS; i++) {
+    const state = native.serializeState();
+    if (!state) {
+      break;
+    }
+    stateSize = state.byteLength;
+    serializeMs = (performance.now() - serializeStartedAt) / (i + 1);
+  }
+
+  const stats = summarizeFrameTimes(times);
+  return {
+    fps: stats.fps,
+    frameTimeMeanMs: stats.meanMs,
+    frameTimeP99Ms: stats.p99Ms,
+    frameTimeStdDevMs: stats.stdDevMs,
+    frames,
+    loadMs: contentLoadMs,
+    serializeMs,
+    stateSize,
+    targetFps,
+  };
+}
+
 // ---------------------------------------------------------------------------
 // Screenshot
 // ---------------------------------------------------------------------------
@@ -258,6 +416,10 @@ function takeScreenshot(outputPath?: string): string {
   if (!frame) {
     throw new Error("No frame available");
   }
+  // A fresh copy, not lastFrame, so the HUD can go into it.
+  if (perfHud) {
+    native.drawPerfHud(frame.data, frame.width, frame.height);
+  }
 
   const dir = screenshotDir;
   fs.mkdirSync(dir, { recursive: true });
@@ -270,8 +432,37 @@ function takeScreenshot(outputPath?: string): string {
 // Initialization
 // ---------------------------------------------------------------------------
 
+/**
+ * Require the addon and load the core without any content. Split out of
+ * `initialize` so a spare worker can do this ahead of a launch.
+ */
+function loadCore(
+  addonPath: string,
+  corePath: string,
+  systemDir: string,
+  saveDir: string,
+): { core: NativeLibretroCore; addonMs: number; coreLoadMs: number } {
+  const addonStartedAt = performance.now();
+  // eslint-disable-next-line @typescript-eslint/no-var-requires -- native .node addons must be loaded via require() at runtime; see https://www.electronjs.org/docs/latest/tutorial/using-native-node-modules
+  const addon = require(addonPath) as NativeAddon;
+  const core = new addon.LibretroCore();
+  const addonMs = performance.now() - addonStartedAt;
+  // Started before loadGame so slow content loads are reported too.
+  core.startWatchdog(STALL_THRESHOLD_MS);
+
+  core.setSystemDirectory(systemDir);
+  core.setSaveDirectory(saveDir);
+
+  const coreStartedAt = performance.now();
+  if (!core.loadCore(corePath)) {
+    throw new Error(`Failed to load core: ${corePath}`);
+  }
+  return { addonMs, core, coreLoadMs: performance.now() - coreStartedAt };
+}
+
 function initialize(command: Extract<WorkerCommand, { action: "init" }>): void {
   const { addonPath, corePath, systemDir, saveDir } = command;
+  const prewarmed = preloaded !== null;
 
   // Store paths for later use
   romPath = command.romPath;
@@ -280,24 +471,37 @@ function initialize(command: Extract<WorkerCommand, { action: "init" }>): void {
   // Derive screenshot dir from saveStatesDir parent (userData)
   screenshotDir = path.join(path.dirname(saveStatesDir), "screenshots");
 
-  // Load the native addon
-  // eslint-disable-next-line @typescript-eslint/no-var-requires -- native .node addons must be loaded via require() at runtime; see https://www.electronjs.org/docs/latest/tutorial/using-native-node-modules
-  const addon = require(addonPath) as NativeAddon;
-  native = new addon.LibretroCore();
-
-  // Set directories
-  native.setSystemDirectory(systemDir);
-  native.setSaveDirectory(saveDir);
-
-  // Load core
-  if (!native.loadCore(corePath)) {
-    throw new Error(`Failed to load core: ${corePath}`);
+  // Reuse the core a `preload` already loaded; the client only sends
+  // `init` to a prewarmed worker for the same core.
+  let addonMs: number;
+  let coreLoadMs: number;
+  if (preloaded) {
+    if (preloaded.corePath !== corePath) {
+      throw new Error(`Worker was prewarmed for ${preloaded.corePath}, not ${corePath}`);
+    }
+    native = preloaded.core;
+    ({ addonMs, coreLoadMs } = preloaded);
+    preloaded = null;
+  } else {
+    const loaded = loadCore(addonPath, corePath, systemDir, saveDir);
+    native = loaded.core;
+    ({ addonMs, coreLoadMs } = loaded);
   }
 
-  // Load game
+  // Load game from a mapped snapshot, shared with other workers
+  native.setContentSnapshotDirectory(path.join(path.dirname(saveStatesDir), "content-snapshots"));
+  const gameStartedAt = performance.now();
   if (!native.loadGame(romPath)) {
     throw new Error(`Failed to load game: ${romPath}`);
   }
+  const gameLoadMs = performance.now() - gameStartedAt;
+  contentLoadMs = coreLoadMs + gameLoadMs;
+
+  // Cores register the audio callback while loading content.
+  audioPull = native.hasAudioCallback();
+  if (audioPull) {
+    send({ type: "log", level: RETRO_LOG_INFO, message: "Core uses pull-mode audio" });
+  }
 
   // Detect CD-ROM serial. Strategy (in priority order):
   // 1. Parse from post-load log messages (Beetle PSX / PCSX ReARMed)
@@ -352,11 +556,19 @@ function initialize(command: Extract<WorkerCommand, { action: "init" }>): void {
   isRunning = true;
   isPaused = false;
   consecutiveErrors = 0;
+  coreFrameCount = 0;
+  lastFrame = null;
+  script = null;
 
   const saveStatesSupported = true;
 
   send({ type: "ready", avInfo: avInfo as AVInfo, saveStatesSupported });
+  pendingLaunch = {
+    phases: { addonMs, coreLoadMs, gameLoadMs, prewarmed },
+    readyAt: performance.now(),
+  };
 
+  setAudioOutputActive(true);
   startEmulationLoop();
 }
 
@@ -364,31 +576,48 @@ function initialize(command: Extract<WorkerCommand, { action: "init" }>): void {
 // SharedArrayBuffer helpers
 // ---------------------------------------------------------------------------
 
-/** Write a video frame into the inactive double-buffer and swap the active flag. */
+/** Write a video frame into the producer's free slot and publish it. */
 function writeVideoToSAB(frame: { data: Uint8Array; width: number; height: number }): void {
-  if (!controlView || !videoView) {
+  if (!videoSlots || !videoView) {
     return;
   }
-  const ctrl = controlView;
-  const video = videoView;
-
-  // Write to the opposite buffer from the one the renderer is reading
-  const currentActive = Atomics.load(ctrl, CTRL_ACTIVE_BUFFER);
-  const writeBuffer = currentActive === 0 ? 1 : 0;
-  const offset = writeBuffer * videoBufferSize;
-
-  video.set(
+  const offset = videoSlots.writeSlot * videoBufferSize;
+  videoView.set(
     new Uint8Array(frame.data.buffer, frame.data.byteOffset, frame.data.byteLength),
     offset,
   );
+  if (perfHud && native) {
+    native.drawPerfHud(
+      videoView.subarray(offset, offset + frame.data.byteLength),
+      frame.width,
+      frame.height,
+    );
+  }
+  const dropped = videoSlots.publish(frame.width, frame.height, {
+    emulatedTimeMs: (coreFrameCount * 1000) / targetFps,
+    frameNumber: coreFrameCount,
+    runStartedAt: lastRunStartedAt,
+  });
+  if (dropped) {
+    droppedFrames++;
+  }
+}
 
-  // Update dimensions, then swap active buffer, then bump sequence.
-  // Order matters: the renderer reads sequence last, so dimensions
-  // and buffer swap are visible before it notices the new frame.
-  Atomics.store(ctrl, CTRL_FRAME_WIDTH, frame.width);
-  Atomics.store(ctrl, CTRL_FRAME_HEIGHT, frame.height);
-  Atomics.store(ctrl, CTRL_ACTIVE_BUFFER, writeBuffer);
-  Atomics.add(ctrl, CTRL_FRAME_SEQUENCE, 1);
+/** Push the worker-side HUD figures before the addon draws the next frame. */
+function feedPerfHud(): void {
+  if (!native || !perfHud) {
+    return;
+  }
+  let fillMs = -1;
+  if (controlView) {
+    const fill = Atomics.load(controlView, CTRL_AUDIO_FILL);
+    const rate = Atomics.load(controlView, CTRL_AUDIO_SAMPLE_RATE) || sampleRate;
+    if (fill !== AUDIO_FILL_UNKNOWN && rate > 0) {
+      // Fill counts interleaved stereo Int16 samples.
+      fillMs = (fill / 2 / rate) * 1000;
+    }
+  }
+  native.setPerfHudInputs(fillMs, droppedFrames);
 }
 
 /** Write audio samples into the SPSC ring buffer. */
@@ -411,13 +640,65 @@ function writeAudioToSAB(samples: Int16Array): void {
   Atomics.store(ctrl, CTRL_AUDIO_WRITE_POS, writePos);
 }
 
+// ---------------------------------------------------------------------------
+// Pull-mode audio
+// ---------------------------------------------------------------------------
+
+/**
+ * Start or stop pulling audio from a pull-mode core, and tell the core
+ * through its set_state callback. No-op for push-mode cores.
+ */
+function setAudioOutputActive(active: boolean): void {
+  if (!audioPull || !native) {
+    return;
+  }
+  native.setAudioState(active);
+  if (active && audioPullTimer === null) {
+    audioPullTimer = setInterval(pumpAudio, AUDIO_PULL_INTERVAL_MS);
+  } else if (!active && audioPullTimer !== null) {
+    clearInterval(audioPullTimer);
+    audioPullTimer = null;
+  }
+}
+
+/**
+ * Top up the shared audio ring from a pull-mode core's callback. Runs
+ * between frames on its own timer and after each frame, so the ring's fill
+ * — not the video frame rate — decides when the core makes audio. Without
+ * shared buffers there is no fill to watch; the frame loop pulls once per
+ * frame instead.
+ */
+function pumpAudio(): void {
+  const core = native;
+  const ctrl = controlView;
+  if (!audioPull || !core || !ctrl || isPaused) {
+    return;
+  }
+  topUpAudio(
+    () => (Atomics.load(ctrl, CTRL_AUDIO_WRITE_POS) - Atomics.load(ctrl, CTRL_AUDIO_READ_POS)) | 0,
+    () => {
+      core.pullAudio();
+      const audio = core.getAudioBuffer();
+      if (!audio || audio.length === 0) {
+        return 0;
+      }
+      writeAudioToSAB(audio);
+      return audio.length;
+    },
+  );
+}
+
 /** Send a video frame via copy-based IPC (fallback path). */
 function sendVideoFrame(frame: { data: Uint8Array; width: number; height: number }): void {
+  const data = Buffer.from(
+    frame.data.buffer.slice(frame.data.byteOffset, frame.data.byteOffset + frame.data.byteLength),
+  );
+  if (perfHud && native) {
+    native.drawPerfHud(data, frame.width, frame.height);
+  }
   send({
     type: "videoFrame",
-    data: Buffer.from(
-      frame.data.buffer.slice(frame.data.byteOffset, frame.data.byteOffset + frame.data.byteLength),
-    ),
+    data,
     width: frame.width,
     height: frame.height,
   });
@@ -446,6 +727,17 @@ function startEmulationLoop(): void {
   // buffer underruns periodically causing audible gaps.
   const basePeriod = 1000 / targetFps;
   let nextFrameTime = performance.now() + basePeriod;
+  parked = false;
+
+  /** Restart a loop parked by pause. */
+  wakeLoop = () => {
+    if (!parked) {
+      return;
+    }
+    parked = false;
+    nextFrameTime = performance.now() + basePeriod;
+    scheduleNext();
+  };
 
   /** Drain buffered log messages. Also checks for late serial detection
    *  (some cores like SwanStation log the disc serial during the first
@@ -464,12 +756,25 @@ function startEmulationLoop(): void {
       }
       send({ type: "log", level: entry.level, message: entry.message });
     }
+    for (const report of native.takeStallReports()) {
+      send({ type: "stall", report });
+    }
+    const overlay = script?.takeOverlay();
+    if (overlay != null) {
+      send({ type: "scriptOverlay", text: overlay });
+    }
   };
 
   const scheduleNext = () => {
     if (!isRunning) {
       return;
     }
+    if (isPaused) {
+      // Nothing to do until resume, which calls wakeLoop.
+      loopTimer = null;
+      parked = true;
+      return;
+    }
 
     if (speedMultiplier > 1) {
       // Fast-forward mode: run multiple core frames per tick on a relaxed
@@ -479,6 +784,7 @@ function startEmulationLoop(): void {
       // synchronously (native.run() takes longer than the deadline),
       // blocking the message handler indefinitely.
       loopTimer = setTimeout(() => {
+        powerMeter.wake();
         batchTick();
       }, 0);
       return;
@@ -487,18 +793,22 @@ function startEmulationLoop(): void {
     // Normal (1x) mode: precise hybrid sleep+spin timing
     const now = performance.now();
     const remaining = nextFrameTime - now;
+    const spinMs = spinWindow.ms;
 
     if (remaining <= 0) {
       // We're already past the deadline — run immediately
       singleTick();
-    } else if (remaining <= SPIN_THRESHOLD_MS) {
+    } else if (remaining <= spinMs) {
       // Close enough to deadline — spin-wait for precision
       spinUntil(nextFrameTime);
       singleTick();
     } else {
       // Sleep for most of the remaining time, then spin the rest
-      const sleepMs = Math.max(0, remaining - SPIN_THRESHOLD_MS);
+      const sleepMs = Math.max(0, remaining - spinMs);
+      const wakeTarget = now + sleepMs;
       loopTimer = setTimeout(() => {
+        powerMeter.wake();
+        spinWindow.recordSlack(performance.now() - wakeTarget);
         spinUntil(nextFrameTime);
         singleTick();
       }, sleepMs);
@@ -520,7 +830,7 @@ function startEmulationLoop(): void {
 
     for (let i = 0; i < framesToRun; i++) {
       try {
-        native.run();
+        runCoreFrame(native);
         consecutiveErrors = 0;
       } catch (error) {
         consecutiveErrors++;
@@ -543,17 +853,8 @@ function startEmulationLoop(): void {
       }
     }
 
-    // Send only the last frame from the batch
-    const frame = native.getVideoFrame();
-    if (frame) {
-      if (useSharedBuffers) {
-        writeVideoToSAB(frame);
-      } else {
-        sendVideoFrame(frame);
-      }
-    }
-
-    // Optionally send audio during fast-forward (plays at sped-up rate)
+    // Optionally send audio during fast-forward (plays at sped-up rate).
+    // Audio goes first so the frame's timeline covers it.
     if (fastForwardAudio) {
       const audio = native.getAudioBuffer();
       if (audio && audio.length > 0) {
@@ -565,6 +866,17 @@ function startEmulationLoop(): void {
       }
     }
 
+    // Send only the last frame from the batch
+    feedPerfHud();
+    const frame = native.getVideoFrame();
+    if (frame && presentFrame(frame)) {
+      if (useSharedBuffers) {
+        writeVideoToSAB(frame);
+      } else {
+        sendVideoFrame(frame);
+      }
+    }
+
     drainLogs();
 
     scheduleNext();
@@ -581,8 +893,16 @@ function startEmulationLoop(): void {
     // Advance the ideal next-frame time by exactly one frame period.
     // If we fell behind (e.g. GC pause), clamp to `now` to avoid a
     // burst of catch-up frames that would flood the IPC channel.
+    // With the audio worklet consuming the shared ring, nudge the period
+    // by up to ±0.5% to hold its fill near target instead of letting the
+    // core's and the sound card's clocks drift into underruns or latency.
+    // Pull-mode cores fill the ring on demand, so their video runs at the
+    // nominal rate.
     const now = performance.now();
-    nextFrameTime += basePeriod;
+    nextFrameTime +=
+      controlView !== null && !audioPull
+        ? basePeriod * audioRatePeriodScale(Atomics.load(controlView, CTRL_AUDIO_FILL))
+        : basePeriod;
     if (nextFrameTime < now - basePeriod) {
       // More than one full frame behind — reset to avoid catch-up burst
       nextFrameTime = now + basePeriod;
@@ -590,7 +910,7 @@ function startEmulationLoop(): void {
 
     if (!isPaused && native) {
       try {
-        native.run();
+        runCoreFrame(native);
         consecutiveErrors = 0;
       } catch (error) {
         consecutiveErrors++;
@@ -612,17 +932,11 @@ function startEmulationLoop(): void {
         }
       }
 
-      // Send video frame
-      const frame = native.getVideoFrame();
-      if (frame) {
-        if (useSharedBuffers) {
-          writeVideoToSAB(frame);
-        } else {
-          sendVideoFrame(frame);
-        }
+      // Send audio samples (only at 1x speed). Audio goes first so the
+      // frame's timeline covers it.
+      if (audioPull && !useSharedBuffers) {
+        native.pullAudio();
       }
-
-      // Send audio samples (only at 1x speed)
       const audio = native.getAudioBuffer();
       if (audio && audio.length > 0) {
         if (useSharedBuffers) {
@@ -632,6 +946,19 @@ function startEmulationLoop(): void {
         }
       }
 
+      pumpAudio();
+
+      // Send video frame
+      feedPerfHud();
+      const frame = native.getVideoFrame();
+      if (frame && presentFrame(frame)) {
+        if (useSharedBuffers) {
+          writeVideoToSAB(frame);
+        } else {
+          sendVideoFrame(frame);
+        }
+      }
+
       drainLogs();
     }
 
@@ -641,6 +968,32 @@ function startEmulationLoop(): void {
   scheduleNext();
 }
 
+/** One retro_run, between the frame script's hooks when one is loaded. */
+function runCoreFrame(core: NativeLibretroCore): void {
+  script?.preFrame(coreFrameCount);
+  lastRunStartedAt = hostNowMs();
+  core.run();
+  coreFrameCount++;
+  script?.postFrame(coreFrameCount);
+}
+
+/** Record a frame's static run and decide whether to publish it. */
+function presentFrame(frame: {
+  data: Uint8Array;
+  width: number;
+  height: number;
+  staticFrames: number;
+}): boolean {
+  lastFrame = frame;
+  lastStaticFrames = frame.staticFrames;
+  if (pendingLaunch) {
+    const firstFrameMs = performance.now() - pendingLaunch.readyAt;
+    send({ type: "launchPhases", phases: { ...pendingLaunch.phases, firstFrameMs } });
+    pendingLaunch = null;
+  }
+  return shouldPresentFrame(frame.staticFrames, staticFrameThrottle);
+}
+
 /**
  * Busy-wait until the target time. Used for the final sub-millisecond
  * portion of frame timing where setTimeout lacks precision.
@@ -652,7 +1005,9 @@ function spinUntil(targetTime: number): void {
 }
 
 function stopEmulationLoop(): void {
+  setAudioOutputActive(false);
   isRunning = false;
+  parked = false;
   if (loopTimer !== null) {
     clearTimeout(loopTimer);
     loopTimer = null;
@@ -677,12 +1032,36 @@ function handleMessage(command: WorkerCommand): void {
       }
       break;
 
+    case "preload":
+      try {
+        const { addonMs, core, coreLoadMs } = loadCore(
+          command.addonPath,
+          command.corePath,
+          command.systemDir,
+          command.saveDir,
+        );
+        // Also held in `native` so a shutdown while parked destroys it.
+        native = core;
+        preloaded = { addonMs, core, corePath: command.corePath, coreLoadMs };
+        send({ type: "preloaded", addonMs, coreLoadMs });
+      } catch (error) {
+        send({
+          type: "error",
+          message: error instanceof Error ? error.message : String(error),
+          fatal: true,
+        });
+      }
+      break;
+
     case "pause":
       isPaused = true;
+      setAudioOutputActive(false);
       break;
 
     case "resume":
       isPaused = false;
+      setAudioOutputActive(true);
+      wakeLoop?.();
       break;
 
     case "reset":
@@ -691,12 +1070,32 @@ function handleMessage(command: WorkerCommand): void {
 
     case "input":
       native?.setInputState(command.port, command.id, command.pressed ? 1 : 0);
+      script?.noteInput(command.port, command.id, command.pressed ? 1 : 0);
       break;
 
     case "inputAnalog":
       native?.setInputAnalog(command.port, command.index, command.id, command.value);
       break;
 
+    case "pointer":
+      native?.setPointerState(command.x, command.y, command.pressed);
+      break;
+
+    case "setScreenLayout":
+      try {
+        if (!native) {
+          throw new Error("No core loaded");
+        }
+        sendResponse(command.requestId, true, undefined, native.setScreenLayout(command.layout));
+      } catch (error) {
+        sendResponse(
+          command.requestId,
+          false,
+          error instanceof Error ? error.message : String(error),
+        );
+      }
+      break;
+
     case "setSpeed": {
       const newMultiplier = Math.max(0.25, Math.min(command.multiplier, 16));
       const wasRunning = isRunning;
@@ -721,6 +1120,16 @@ function handleMessage(command: WorkerCommand): void {
       fastForwardAudio = command.enabled;
       break;
 
+    case "setStaticFrameThrottle":
+      staticFrameThrottle = command.enabled;
+      break;
+
+    case "setPerfHud":
+      perfHud = command.enabled;
+      droppedFrames = 0;
+      native?.setPerfHud(command.enabled);
+      break;
+
     case "saveState":
       try {
         saveState(command.slot);
@@ -780,6 +1189,7 @@ function handleMessage(command: WorkerCommand): void {
       videoView = new Uint8Array(command.videoSAB);
       audioView = new Int16Array(command.audioSAB);
       videoBufferSize = command.videoBufferSize;
+      videoSlots = new VideoSlotProducer(controlView);
       useSharedBuffers = true;
       Atomics.store(controlView, CTRL_AUDIO_SAMPLE_RATE, sampleRate);
       break;
@@ -920,6 +1330,129 @@ function handleMessage(command: WorkerCommand): void {
       }
       break;
 
+    case "runUntil":
+      try {
+        if (!native) {
+          throw new Error("No core loaded");
+        }
+        const invalid = invalidRunCondition(command.conditions);
+        if (invalid) {
+          throw new Error(invalid);
+        }
+        // Blocks this process until done; the frame loop resyncs afterwards.
+        const result = native.runUntil(command.conditions, command.maxFrames);
+        coreFrameCount += result.frames;
+        sendResponse(command.requestId, true, undefined, result);
+      } catch (error) {
+        sendResponse(
+          command.requestId,
+          false,
+          error instanceof Error ? error.message : String(error),
+        );
+      }
+      break;
+
+    case "getMemoryStats":
+      try {
+        if (!native) {
+          throw new Error("No core loaded");
+        }
+        sendResponse(command.requestId, true, undefined, native.getMemoryStats());
+      } catch (error) {
+        sendResponse(
+          command.requestId,
+          false,
+          error instanceof Error ? error.message : String(error),
+        );
+      }
+      break;
+
+    case "trackCoreHeap":
+      try {
+        if (!native) {
+          throw new Error("No core loaded");
+        }
+        native.trackCoreHeap(command.enabled);
+        sendResponse(command.requestId, true);
+      } catch (error) {
+        sendResponse(
+          command.requestId,
+          false,
+          error instanceof Error ? error.message : String(error),
+        );
+      }
+      break;
+
+    case "benchmark":
+      try {
+        sendResponse(
+          command.requestId,
+          true,
+          undefined,
+          runBenchmark(command.warmupFrames, command.frames),
+        );
+      } catch (error) {
+        sendResponse(
+          command.requestId,
+          false,
+          error instanceof Error ? error.message : String(error),
+        );
+      }
+      break;
+
+    case "getPowerStats":
+      sendResponse(command.requestId, true, undefined, {
+        ...powerMeter.sample(),
+        parked,
+        spinWindowMs: spinWindow.ms,
+        staticFrames: lastStaticFrames,
+      });
+      break;
+
+    case "loadScript":
+      try {
+        const next = loadScript(command.path, command.budgetMs);
+        if (script) {
+          send({ type: "scriptOverlay", text: "" });
+        }
+        script = next;
+        sendResponse(command.requestId, true, undefined, script.stats);
+      } catch (error) {
+        sendResponse(
+          command.requestId,
+          false,
+          error instanceof Error ? error.message : String(error),
+        );
+      }
+      break;
+
+    case "unloadScript":
+      if (script) {
+        script = null;
+        send({ type: "scriptOverlay", text: "" });
+      }
+      sendResponse(command.requestId, true);
+      break;
+
+    case "getScriptStats":
+      sendResponse(command.requestId, true, undefined, script?.stats ?? null);
+      break;
+
+    case "getInputStats":
+      try {
+        if (!native) {
+          throw new Error("No core loaded");
+        }
+        sendResponse(command.requestId, true, undefined, native.getInputStats());
+      } catch (error) {
+        sendResponse(
+          command.requestId,
+          false,
+          error instanceof Error ? error.message : String(error),
+        );
+      }
+      break;
+
     case "shutdown":
       try {
         stopEmulationLoop();
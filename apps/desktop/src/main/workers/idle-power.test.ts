@@ -0,0 +1,93 @@
+import { describe, it, expect } from "vitest";
+import {
+  MAX_SPIN_MS,
+  MIN_SPIN_MS,
+  PowerMeter,
+  SpinWindow,
+  STATIC_FRAME_THRESHOLD,
+  STATIC_PRESENT_INTERVAL,
+  shouldPresentFrame,
+} from "./idle-power";
+
+describe("SpinWindow", () => {
+  it("keeps the initial window until it has enough samples", () => {
+    const spin = new SpinWindow(2);
+    for (let i = 0; i < 10; i++) {
+      spin.recordSlack(0.1);
+    }
+    expect(spin.ms).toBe(2);
+  });
+
+  it("shrinks to the floor on tight timers", () => {
+    const spin = new SpinWindow(2);
+    for (let i = 0; i < 100; i++) {
+      spin.recordSlack(0.05);
+    }
+    expect(spin.ms).toBe(MIN_SPIN_MS);
+  });
+
+  it("widens for jittery timers, up to the cap", () => {
+    const moderate = new SpinWindow(2);
+    for (let i = 0; i < 200; i++) {
+      moderate.recordSlack(i % 2 === 0 ? 0.5 : 1.5);
+    }
+    expect(moderate.ms).toBeGreaterThan(2);
+    expect(moderate.ms).toBeLessThan(MAX_SPIN_MS);
+
+    const noisy = new SpinWindow(2);
+    for (let i = 0; i < 200; i++) {
+      noisy.recordSlack(i % 2 === 0 ? 1 : 9);
+    }
+    expect(noisy.ms).toBe(MAX_SPIN_MS);
+  });
+});
+
+describe("shouldPresentFrame", () => {
+  it("presents every frame when throttling is off", () => {
+    expect(shouldPresentFrame(1000, false)).toBe(true);
+  });
+
+  it("presents every frame until the screen has been static long enough", () => {
+    for (let i = 0; i < STATIC_FRAME_THRESHOLD; i++) {
+      expect(shouldPresentFrame(i, true)).toBe(true);
+    }
+  });
+
+  it("presents one static frame per interval after that", () => {
+    let presented = 0;
+    for (let i = 0; i < STATIC_PRESENT_INTERVAL * 4; i++) {
+      if (shouldPresentFrame(STATIC_FRAME_THRESHOLD + i, true)) {
+        presented++;
+      }
+    }
+    expect(presented).toBe(4);
+  });
+});
+
+describe("PowerMeter", () => {
+  it("reports wakeups and package power per second", () => {
+    let energy = 1_000_000;
+    const meter = new PowerMeter(() => energy);
+    const start = meter.sample(0);
+    expect(start.wakeupsPerSecond).toBe(0);
+
+    for (let i = 0; i < 120; i++) {
+      meter.wake();
+    }
+    energy += 5_000_000; // 5 J
+    const sample = meter.sample(2000);
+    expect(sample.wakeupsPerSecond).toBe(60);
+    expect(sample.packageWatts).toBeCloseTo(2.5);
+  });
+
+  it("has no package power where RAPL is unreadable or wrapped", () => {
+    let energy: number | null = null;
+    const meter = new PowerMeter(() => energy);
+    expect(meter.sample(1000).packageWatts).toBe(null);
+
+    energy = 10;
+    meter.sample(2000);
+    energy = 5;
+    expect(meter.sample(3000).packageWatts).toBe(null);
+  });
+});
@@ -0,0 +1,128 @@
+/**
+ * Power-saving pieces of the emulation loop: a spin window sized from
+ * measured timer slack, static-frame presentation throttling, and a meter
+ * for loop wakeups, CPU time and (where the OS exposes it) package power.
+ */
+import * as fs from "node:fs";
+import { performance } from "node:perf_hooks";
+
+export const MIN_SPIN_MS = 0.25;
+export const MAX_SPIN_MS = 4;
+
+/** Timer samples before the measured window replaces the initial one. */
+const SPIN_WARMUP_SAMPLES = 30;
+const SLACK_EMA_ALPHA = 0.05;
+
+/**
+ * Sizes the busy-wait before each frame deadline from how late setTimeout
+ * actually fires: mean slack plus three mean deviations. On a quiet machine
+ * with tight timers that is well under the fixed 2ms the loop used to spin.
+ * A noisy one gets a wider window rather than late frames.
+ */
+export class SpinWindow {
+  private mean = 0;
+  private deviation = 0;
+  private samples = 0;
+
+  constructor(private readonly initialMs: number) {}
+
+  /** Record how many ms after its target a sleep timer fired. */
+  recordSlack(lateMs: number): void {
+    const slack = Math.max(0, lateMs);
+    if (this.samples === 0) {
+      this.mean = slack;
+      this.deviation = slack / 2;
+    } else {
+      this.mean += SLACK_EMA_ALPHA * (slack - this.mean);
+      this.deviation += SLACK_EMA_ALPHA * (Math.abs(slack - this.mean) - this.deviation);
+    }
+    this.samples++;
+  }
+
+  get ms(): number {
+    if (this.samples < SPIN_WARMUP_SAMPLES) {
+      return this.initialMs;
+    }
+    return Math.min(MAX_SPIN_MS, Math.max(MIN_SPIN_MS, this.mean + 3 * this.deviation));
+  }
+}
+
+/** Identical frames in a row before presentation is throttled (~0.5s at 60fps). */
+export const STATIC_FRAME_THRESHOLD = 30;
+
+/** While throttled, publish one frame in this many (~4Hz at 60fps). */
+export const STATIC_PRESENT_INTERVAL = 15;
+
+/**
+ * Whether to publish a frame, given how many frames before it were
+ * identical. Skipped frames are pixel-identical to the last published one,
+ * so throttling only saves the copy, the upload and the renderer's wakeup;
+ * the first changed frame is always published.
+ */
+export function shouldPresentFrame(staticFrames: number, throttle: boolean): boolean {
+  if (!throttle || staticFrames < STATIC_FRAME_THRESHOLD) {
+    return true;
+  }
+  return (staticFrames - STATIC_FRAME_THRESHOLD) % STATIC_PRESENT_INTERVAL === 0;
+}
+
+const RAPL_ENERGY_PATH = "/sys/class/powercap/intel-rapl:0/energy_uj";
+
+/**
+ * Cumulative CPU package energy in µJ from Linux RAPL. Whole-package, not
+ * per-process, and root-only on many distros; null when unreadable.
+ */
+export function readPackageEnergyUj(): number | null {
+  try {
+    const value = Number(fs.readFileSync(RAPL_ENERGY_PATH, "utf8"));
+    return Number.isFinite(value) ? value : null;
+  } catch {
+    return null;
+  }
+}
+
+export interface PowerSample {
+  wakeupsPerSecond: number;
+  /** Worker CPU time as a percentage of one core. */
+  cpuPercent: number;
+  packageWatts: number | null;
+}
+
+/** Rates since the previous `sample()`. */
+export class PowerMeter {
+  private wakeups = 0;
+  private lastAt = performance.now();
+  private lastCpu = process.cpuUsage();
+  private lastEnergyUj: number | null;
+
+  constructor(private readonly readEnergyUj: () => number | null = readPackageEnergyUj) {
+    this.lastEnergyUj = readEnergyUj();
+  }
+
+  /** Count one loop wakeup (a timer firing). */
+  wake(): void {
+    this.wakeups++;
+  }
+
+  sample(now: number = performance.now()): PowerSample {
+    const seconds = Math.max((now - this.lastAt) / 1000, 1e-3);
+    const cpu = process.cpuUsage(this.lastCpu);
+    const energy = this.readEnergyUj();
+    // The RAPL counter wraps; skip the interval it wrapped in.
+    const packageWatts =
+      energy !== null && this.lastEnergyUj !== null && energy >= this.lastEnergyUj
+        ? (energy - this.lastEnergyUj) / 1e6 / seconds
+        : null;
+
+    const result = {
+      cpuPercent: ((cpu.user + cpu.system) / 1e6 / seconds) * 100,
+      packageWatts,
+      wakeupsPerSecond: this.wakeups / seconds,
+    };
+    this.wakeups = 0;
+    this.lastAt = now;
+    this.lastCpu = process.cpuUsage();
+    this.lastEnergyUj = energy;
+    return result;
+  }
+}
@@ -0,0 +1,99 @@
+import { describe, it, expect } from "vitest";
+import {
+  encodeSaveState,
+  makeThumbnail,
+  parseStateHeader,
+  STATE_HEADER_SIZE,
+  stateDataOf,
+  THUMBNAIL_MAX_HEIGHT,
+  THUMBNAIL_MAX_WIDTH,
+} from "./save-state-container";
+
+const INFO = { coreName: "Snes9x", coreVersion: "1.62.3", createdAtMs: 1_700_000_000_000 };
+
+function solidFrame(width: number, height: number, rgba: Array<number>): Uint8Array {
+  const data = new Uint8Array(width * height * 4);
+  for (let i = 0; i < data.length; i += 4) {
+    data.set(rgba, i);
+  }
+  return data;
+}
+
+describe("makeThumbnail", () => {
+  it("fits large frames within the maximum size, keeping the aspect", () => {
+    const thumb = makeThumbnail(solidFrame(640, 480, [10, 20, 30, 255]), 640, 480);
+    expect(thumb.width).toBe(THUMBNAIL_MAX_WIDTH);
+    expect(thumb.height).toBe(THUMBNAIL_MAX_HEIGHT);
+    expect(Array.from(thumb.data.subarray(0, 4))).toEqual([10, 20, 30, 255]);
+
+    const wide = makeThumbnail(solidFrame(512, 224, [0, 0, 0, 255]), 512, 224);
+    expect(wide.width).toBe(THUMBNAIL_MAX_WIDTH);
+    expect(wide.height).toBe(70);
+  });
+
+  it("averages each block of source pixels", () => {
+    // 320x1 halves to 160x1: alternating black and white averages to grey.
+    const frame = new Uint8Array(320 * 4);
+    for (let x = 0; x < 320; x += 2) {
+      frame.set([255, 255, 255, 255], x * 4);
+    }
+    const thumb = makeThumbnail(frame, 320, 1);
+    expect(thumb.width).toBe(160);
+    expect(Array.from(thumb.data.subarray(0, 4))).toEqual([128, 128, 128, 128]);
+  });
+
+  it("copies frames that are already small enough", () => {
+    const frame = solidFrame(160, 144, [1, 2, 3, 4]);
+    const thumb = makeThumbnail(frame, 160, 144);
+    expect(thumb.width).toBe(133);
+    expect(thumb.height).toBe(120);
+
+    const tiny = makeThumbnail(solidFrame(64, 48, [1, 2, 3, 4]), 64, 48);
+    expect([tiny.width, tiny.height]).toEqual([64, 48]);
+  });
+});
+
+describe("save state container", () => {
+  it("round-trips the header, thumbnail and state", () => {
+    const state = new Uint8Array([1, 2, 3, 4, 5]);
+    const thumbnail = makeThumbnail(solidFrame(4, 2, [9, 8, 7, 6]), 4, 2);
+    const file = encodeSaveState(state, INFO, thumbnail);
+
+    const header = parseStateHeader(file, file.byteLength);
+    expect(header).toEqual({
+      coreName: "Snes9x",
+      coreVersion: "1.62.3",
+      createdAtMs: INFO.createdAtMs,
+      stateOffset: STATE_HEADER_SIZE + 4 * 2 * 4,
+      stateSize: 5,
+      thumbnailHeight: 2,
+      thumbnailWidth: 4,
+    });
+    expect(Array.from(file.subarray(STATE_HEADER_SIZE, STATE_HEADER_SIZE + 4))).toEqual([
+      9, 8, 7, 6,
+    ]);
+    expect(Array.from(stateDataOf(file))).toEqual([1, 2, 3, 4, 5]);
+  });
+
+  it("writes states without a thumbnail", () => {
+    const file = encodeSaveState(new Uint8Array([7]), INFO, null);
+    expect(parseStateHeader(file, file.byteLength)?.thumbnailWidth).toBe(0);
+    expect(Array.from(stateDataOf(file))).toEqual([7]);
+  });
+
+  it("truncates long core names without splitting characters", () => {
+    const file = encodeSaveState(new Uint8Array(0), { ...INFO, coreName: "é".repeat(40) }, null);
+    expect(parseStateHeader(file, file.byteLength)?.coreName).toBe("é".repeat(32));
+  });
+
+  it("passes legacy raw states through", () => {
+    const legacy = new Uint8Array(256).fill(0xab);
+    expect(parseStateHeader(legacy, legacy.byteLength)).toBe(null);
+    expect(stateDataOf(legacy)).toBe(legacy);
+  });
+
+  it("rejects headers that claim more data than the file holds", () => {
+    const file = encodeSaveState(new Uint8Array(100), INFO, null);
+    expect(parseStateHeader(file, file.byteLength - 1)).toBe(null);
+  });
+});
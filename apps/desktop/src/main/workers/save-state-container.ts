@@ -0,0 +1,194 @@
+/**
+ * On-disk save state container: a fixed header and a small RGBA thumbnail
+ * ahead of the core's serialized state, so slot previews can be read
+ * without touching (or mapping) the state itself. Must match
+ * native/src/state_summary.h.
+ *
+ * Layout (little-endian):
+ *   0   u32  magic "GLST"
+ *   4   u16  version
+ *   6   u16  thumbnail width (0 = no thumbnail)
+ *   8   u16  thumbnail height
+ *   12  u32  state offset
+ *   16  u32  state size
+ *   24  f64  created at (ms since epoch)
+ *   32  [64] core name, UTF-8, NUL-padded
+ *   96  [32] core version, UTF-8, NUL-padded
+ *   128      thumbnail, tightly packed RGBA8888 rows
+ *
+ * Files without the magic are legacy raw states and load unchanged.
+ */
+
+export const STATE_MAGIC = 0x5453_4c47; // "GLST"
+export const STATE_VERSION = 1;
+export const STATE_HEADER_SIZE = 128;
+
+const OFF_VERSION = 4;
+const OFF_THUMB_WIDTH = 6;
+const OFF_THUMB_HEIGHT = 8;
+const OFF_STATE_OFFSET = 12;
+const OFF_STATE_SIZE = 16;
+const OFF_CREATED_AT = 24;
+const OFF_CORE_NAME = 32;
+const CORE_NAME_BYTES = 64;
+const OFF_CORE_VERSION = 96;
+const CORE_VERSION_BYTES = 32;
+
+/** Thumbnails are box-filtered to fit within this size. */
+export const THUMBNAIL_MAX_WIDTH = 160;
+export const THUMBNAIL_MAX_HEIGHT = 120;
+
+/** Bytes that cover the header and the largest possible thumbnail. */
+export const STATE_SUMMARY_MAX_BYTES =
+  STATE_HEADER_SIZE + THUMBNAIL_MAX_WIDTH * THUMBNAIL_MAX_HEIGHT * 4;
+
+export interface Thumbnail {
+  width: number;
+  height: number;
+  /** Tightly packed RGBA8888. */
+  data: Uint8Array;
+}
+
+export interface StateHeader {
+  createdAtMs: number;
+  coreName: string;
+  coreVersion: string;
+  stateOffset: number;
+  stateSize: number;
+  thumbnailWidth: number;
+  thumbnailHeight: number;
+}
+
+/**
+ * Box-filter an RGBA frame down to fit THUMBNAIL_MAX_WIDTH x
+ * THUMBNAIL_MAX_HEIGHT, keeping its pixel aspect. Frames already small
+ * enough are copied, not enlarged.
+ */
+export function makeThumbnail(rgba: Uint8Array, width: number, height: number): Thumbnail {
+  const scale = Math.min(1, THUMBNAIL_MAX_WIDTH / width, THUMBNAIL_MAX_HEIGHT / height);
+  const dstWidth = Math.max(1, Math.round(width * scale));
+  const dstHeight = Math.max(1, Math.round(height * scale));
+  const data = new Uint8Array(dstWidth * dstHeight * 4);
+
+  for (let dy = 0; dy < dstHeight; dy++) {
+    const y0 = Math.floor((dy * height) / dstHeight);
+    const y1 = Math.max(y0 + 1, Math.floor(((dy + 1) * height) / dstHeight));
+    for (let dx = 0; dx < dstWidth; dx++) {
+      const x0 = Math.floor((dx * width) / dstWidth);
+      const x1 = Math.max(x0 + 1, Math.floor(((dx + 1) * width) / dstWidth));
+      let r = 0;
+      let g = 0;
+      let b = 0;
+      let a = 0;
+      for (let y = y0; y < y1; y++) {
+        let i = (y * width + x0) * 4;
+        for (let x = x0; x < x1; x++, i += 4) {
+          r += rgba[i];
+          g += rgba[i + 1];
+          b += rgba[i + 2];
+          a += rgba[i + 3];
+        }
+      }
+      const count = (y1 - y0) * (x1 - x0);
+      const o = (dy * dstWidth + dx) * 4;
+      data[o] = Math.round(r / count);
+      data[o + 1] = Math.round(g / count);
+      data[o + 2] = Math.round(b / count);
+      data[o + 3] = Math.round(a / count);
+    }
+  }
+  return { data, height: dstHeight, width: dstWidth };
+}
+
+function writeString(bytes: Uint8Array, offset: number, length: number, value: string): void {
+  // Truncate to the field, never splitting a UTF-8 sequence.
+  const encoded = new TextEncoder().encode(value);
+  let end = Math.min(encoded.length, length);
+  while (end > 0 && end < encoded.length && (encoded[end] & 0xc0) === 0x80) {
+    end--;
+  }
+  bytes.set(encoded.subarray(0, end), offset);
+}
+
+function readString(bytes: Uint8Array, offset: number, length: number): string {
+  const field = bytes.subarray(offset, offset + length);
+  const nul = field.indexOf(0);
+  return new TextDecoder().decode(nul === -1 ? field : field.subarray(0, nul));
+}
+
+/** Wrap a serialized state in the container. */
+export function encodeSaveState(
+  state: Uint8Array,
+  info: { coreName: string; coreVersion: string; createdAtMs: number },
+  thumbnail: Thumbnail | null,
+): Uint8Array {
+  const thumbBytes = thumbnail ? thumbnail.width * thumbnail.height * 4 : 0;
+  const stateOffset = STATE_HEADER_SIZE + thumbBytes;
+  const out = new Uint8Array(stateOffset + state.byteLength);
+  const view = new DataView(out.buffer);
+
+  view.setUint32(0, STATE_MAGIC, true);
+  view.setUint16(OFF_VERSION, STATE_VERSION, true);
+  view.setUint16(OFF_THUMB_WIDTH, thumbnail?.width ?? 0, true);
+  view.setUint16(OFF_THUMB_HEIGHT, thumbnail?.height ?? 0, true);
+  view.setUint32(OFF_STATE_OFFSET, stateOffset, true);
+  view.setUint32(OFF_STATE_SIZE, state.byteLength, true);
+  view.setFloat64(OFF_CREATED_AT, info.createdAtMs, true);
+  writeString(out, OFF_CORE_NAME, CORE_NAME_BYTES, info.coreName);
+  writeString(out, OFF_CORE_VERSION, CORE_VERSION_BYTES, info.coreVersion);
+
+  if (thumbnail) {
+    out.set(thumbnail.data.subarray(0, thumbBytes), STATE_HEADER_SIZE);
+  }
+  out.set(state, stateOffset);
+  return out;
+}
+
+/**
+ * Parse a container header from the first bytes of a file. Returns null for
+ * legacy raw states and for headers that don't fit `fileSize`.
+ */
+export function parseStateHeader(bytes: Uint8Array, fileSize: number): StateHeader | null {
+  if (bytes.byteLength < STATE_HEADER_SIZE) {
+    return null;
+  }
+  const view = new DataView(bytes.buffer, bytes.byteOffset, STATE_HEADER_SIZE);
+  if (
+    view.getUint32(0, true) !== STATE_MAGIC ||
+    view.getUint16(OFF_VERSION, true) !== STATE_VERSION
+  ) {
+    return null;
+  }
+
+  const thumbnailWidth = view.getUint16(OFF_THUMB_WIDTH, true);
+  const thumbnailHeight = view.getUint16(OFF_THUMB_HEIGHT, true);
+  const stateOffset = view.getUint32(OFF_STATE_OFFSET, true);
+  const stateSize = view.getUint32(OFF_STATE_SIZE, true);
+  if (
+    thumbnailWidth > THUMBNAIL_MAX_WIDTH ||
+    thumbnailHeight > THUMBNAIL_MAX_HEIGHT ||
+    stateOffset < STATE_HEADER_SIZE + thumbnailWidth * thumbnailHeight * 4 ||
+    stateOffset + stateSize > fileSize
+  ) {
+    return null;
+  }
+
+  return {
+    coreName: readString(bytes, OFF_CORE_NAME, CORE_NAME_BYTES),
+    coreVersion: readString(bytes, OFF_CORE_VERSION, CORE_VERSION_BYTES),
+    createdAtMs: view.getFloat64(OFF_CREATED_AT, true),
+    stateOffset,
+    stateSize,
+    thumbnailHeight,
+    thumbnailWidth,
+  };
+}
+
+/** The core's serialized state within a save state file. */
+export function stateDataOf(file: Uint8Array): Uint8Array {
+  const header = parseStateHeader(file, file.byteLength);
+  if (!header) {
+    return file;
+  }
+  return file.subarray(header.stateOffset, header.stateOffset + header.stateSize);
+}
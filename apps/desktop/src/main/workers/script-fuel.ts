@@ -0,0 +1,287 @@
+/**
+ * Fuel metering for frame scripts. `meterFuel` rewrites a WebAssembly
+ * module so every function entry and every loop iteration takes one unit
+ * from a mutable i32 global, exported as FUEL_EXPORT, and traps with
+ * `unreachable` when it reaches zero. The host refills the global before
+ * each hook, so a hook that loops forever traps instead of hanging the
+ * emulation thread; the wall-clock budget still handles everything short
+ * of that.
+ *
+ * The new global goes after every existing one, so no global index in the
+ * module changes; only function bodies grow. Modules using instructions
+ * the rewriter doesn't decode (SIMD, threads, GC) are rejected.
+ */
+
+export const FUEL_EXPORT = "__gamelord_fuel";
+
+// Section ids, and the order the spec requires them in.
+const SECTION_IMPORT = 2;
+const SECTION_GLOBAL = 6;
+const SECTION_EXPORT = 7;
+const SECTION_CODE = 10;
+const SECTION_ORDER = [1, 2, 3, 4, 5, 13, 6, 7, 8, 9, 12, 10, 11];
+
+const EXTERNAL_GLOBAL = 3;
+
+class Reader {
+  offset = 0;
+
+  constructor(private readonly bytes: Uint8Array) {}
+
+  get done(): boolean {
+    return this.offset >= this.bytes.length;
+  }
+
+  byte(): number {
+    if (this.offset >= this.bytes.length) {
+      throw new Error("Unexpected end of module");
+    }
+    return this.bytes[this.offset++];
+  }
+
+  u32(): number {
+    let result = 0;
+    let shift = 0;
+    let byte: number;
+    do {
+      byte = this.byte();
+      result += (byte & 0x7f) * 2 ** shift;
+      shift += 7;
+    } while (byte & 0x80);
+    return result;
+  }
+
+  /** Skip a LEB128 value of either signedness. */
+  skipLeb(): void {
+    while (this.byte() & 0x80) {
+      // continuation byte
+    }
+  }
+
+  skip(count: number): void {
+    this.offset += count;
+  }
+
+  slice(start: number, end: number): Uint8Array {
+    return this.bytes.subarray(start, end);
+  }
+}
+
+function u32Bytes(value: number): Array<number> {
+  const out: Array<number> = [];
+  do {
+    let byte = value & 0x7f;
+    value = Math.floor(value / 128);
+    if (value !== 0) {
+      byte |= 0x80;
+    }
+    out.push(byte);
+  } while (value !== 0);
+  return out;
+}
+
+function concat(parts: Array<Uint8Array | Array<number>>): Uint8Array {
+  const length = parts.reduce((sum, part) => sum + part.length, 0);
+  const out = new Uint8Array(length);
+  let offset = 0;
+  for (const part of parts) {
+    out.set(part, offset);
+    offset += part.length;
+  }
+  return out;
+}
+
+function section(id: number, payload: Uint8Array | Array<number>): Uint8Array {
+  return concat([[id, ...u32Bytes(payload.length)], payload]);
+}
+
+/** global.get; i32.const 1; i32.sub; global.set; global.get; i32.eqz; if unreachable end */
+function fuelCheck(global: number): Array<number> {
+  const index = u32Bytes(global);
+  return [
+    0x23, ...index, 0x41, 1, 0x6b, 0x24, ...index,
+    0x23, ...index, 0x45, 0x04, 0x40, 0x00, 0x0b,
+  ];
+}
+
+function skipLimits(reader: Reader): void {
+  const flags = reader.byte();
+  reader.skipLeb();
+  if (flags & 1) {
+    reader.skipLeb();
+  }
+}
+
+function countImportedGlobals(payload: Reader): number {
+  let globals = 0;
+  for (let count = payload.u32(); count > 0; count--) {
+    payload.skip(payload.u32());
+    payload.skip(payload.u32());
+    const kind = payload.byte();
+    if (kind === 0) {
+      payload.skipLeb();
+    } else if (kind === 1) {
+      payload.byte();
+      skipLimits(payload);
+    } else if (kind === 2) {
+      skipLimits(payload);
+    } else if (kind === EXTERNAL_GLOBAL) {
+      payload.skip(2);
+      globals++;
+    } else if (kind === 4) {
+      payload.byte();
+      payload.skipLeb();
+    } else {
+      throw new Error(`Unsupported import kind ${kind}`);
+    }
+  }
+  return globals;
+}
+
+/** Skip the immediates of the instruction whose opcode was just read. */
+function skipImmediates(opcode: number, reader: Reader): void {
+  if (opcode === 0x0e) {
+    // br_table: targets, then the default
+    for (let count = reader.u32(); count > 0; count--) {
+      reader.skipLeb();
+    }
+    reader.skipLeb();
+  } else if (opcode === 0x11 || opcode === 0x13) {
+    reader.skipLeb();
+    reader.skipLeb();
+  } else if (opcode === 0x1c) {
+    reader.skip(reader.u32());
+  } else if (opcode >= 0x28 && opcode <= 0x3e) {
+    // memarg; bit 6 of the alignment flags an explicit memory index
+    const align = reader.u32();
+    if (align & 0x40) {
+      reader.skipLeb();
+    }
+    reader.skipLeb();
+  } else if (opcode === 0x43) {
+    reader.skip(4);
+  } else if (opcode === 0x44) {
+    reader.skip(8);
+  } else if (
+    [0x02, 0x03, 0x04, 0x06].includes(opcode) || // block types
+    [0x07, 0x08, 0x09, 0x0c, 0x0d, 0x10, 0x12, 0x18].includes(opcode) ||
+    (opcode >= 0x20 && opcode <= 0x26) ||
+    [0x3f, 0x40, 0x41, 0x42, 0xd0, 0xd2].includes(opcode)
+  ) {
+    reader.skipLeb();
+  } else if (opcode === 0xfc) {
+    const sub = reader.u32();
+    if ([8, 10, 12, 14].includes(sub)) {
+      reader.skipLeb();
+      reader.skipLeb();
+    } else if (sub >= 9 && sub <= 17) {
+      reader.skipLeb();
+    } else if (sub > 7) {
+      throw new Error(`Unsupported instruction 0xfc ${sub}`);
+    }
+  } else if (
+    !(opcode <= 0x01 || opcode === 0x05 || opcode === 0x0b || opcode === 0x0f) &&
+    !(opcode === 0x19 || opcode === 0x1a || opcode === 0x1b || opcode === 0xd1) &&
+    !(opcode >= 0x45 && opcode <= 0xc4)
+  ) {
+    throw new Error(`Unsupported instruction 0x${opcode.toString(16)}`);
+  }
+}
+
+function meterBody(body: Uint8Array, global: number): Uint8Array {
+  const reader = new Reader(body);
+  for (let count = reader.u32(); count > 0; count--) {
+    reader.skipLeb();
+    reader.byte();
+  }
+  const check = fuelCheck(global);
+  const parts: Array<Uint8Array | Array<number>> = [reader.slice(0, reader.offset), check];
+  let copied = reader.offset;
+  while (!reader.done) {
+    const opcode = reader.byte();
+    skipImmediates(opcode, reader);
+    if (opcode === 0x03) {
+      parts.push(reader.slice(copied, reader.offset), check);
+      copied = reader.offset;
+    }
+  }
+  parts.push(reader.slice(copied, body.length));
+  return concat(parts);
+}
+
+function meterCode(payload: Reader, global: number): Uint8Array {
+  const parts: Array<Uint8Array | Array<number>> = [];
+  const count = payload.u32();
+  parts.push(u32Bytes(count));
+  for (let i = 0; i < count; i++) {
+    const size = payload.u32();
+    const start = payload.offset;
+    payload.skip(size);
+    const body = meterBody(payload.slice(start, start + size), global);
+    parts.push(u32Bytes(body.length), body);
+  }
+  return concat(parts);
+}
+
+/** Append one entry to a vector section's payload (or start the vector). */
+function appendEntry(payload: Uint8Array | null, entry: Array<number>): Uint8Array {
+  if (!payload) {
+    return concat([[1], entry]);
+  }
+  const reader = new Reader(payload);
+  const count = reader.u32();
+  return concat([u32Bytes(count + 1), payload.subarray(reader.offset), entry]);
+}
+
+/** Rewrite `bytes` with fuel checks; see the file comment. */
+export function meterFuel(bytes: Uint8Array): Uint8Array {
+  if (bytes.length < 8 || bytes[0] !== 0x00 || bytes[1] !== 0x61) {
+    throw new Error("Not a WebAssembly module");
+  }
+  const reader = new Reader(bytes);
+  reader.skip(8);
+
+  const sections: Array<{ id: number; payload: Uint8Array }> = [];
+  while (!reader.done) {
+    const id = reader.byte();
+    const size = reader.u32();
+    sections.push({ id, payload: reader.slice(reader.offset, reader.offset + size) });
+    reader.skip(size);
+  }
+
+  const payloadOf = (id: number) => sections.find((s) => s.id === id)?.payload ?? null;
+  const imports = payloadOf(SECTION_IMPORT);
+  const globals = payloadOf(SECTION_GLOBAL);
+  const fuelGlobal =
+    (imports ? countImportedGlobals(new Reader(imports)) : 0) +
+    (globals ? new Reader(globals).u32() : 0);
+
+  const replace = (id: number, payload: Uint8Array) => {
+    const existing = sections.find((s) => s.id === id);
+    if (existing) {
+      existing.payload = payload;
+      return;
+    }
+    const rank = SECTION_ORDER.indexOf(id);
+    const at = sections.findIndex((s) => s.id !== 0 && SECTION_ORDER.indexOf(s.id) > rank);
+    sections.splice(at < 0 ? sections.length : at, 0, { id, payload });
+  };
+
+  // (mut i32) initialised to 0: hooks only run after the host refills it.
+  replace(SECTION_GLOBAL, appendEntry(globals, [0x7f, 0x01, 0x41, 0x00, 0x0b]));
+  replace(
+    SECTION_EXPORT,
+    appendEntry(payloadOf(SECTION_EXPORT), [
+      ...u32Bytes(FUEL_EXPORT.length),
+      ...Buffer.from(FUEL_EXPORT),
+      EXTERNAL_GLOBAL,
+      ...u32Bytes(fuelGlobal),
+    ]),
+  );
+  const code = payloadOf(SECTION_CODE);
+  if (code) {
+    replace(SECTION_CODE, meterCode(new Reader(code), fuelGlobal));
+  }
+
+  return concat([bytes.subarray(0, 8), ...sections.map((s) => section(s.id, s.payload))]);
+}
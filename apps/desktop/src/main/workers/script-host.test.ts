@@ -0,0 +1,185 @@
+import { describe, it, expect, vi } from "vitest";
+import {
+  HARD_OVERRUN_FACTOR,
+  MAX_CONSECUTIVE_OVERRUNS,
+  ScriptHost,
+  type ScriptBindings,
+} from "./script-host";
+
+// Minimal WebAssembly assembler: every section and body here stays under
+// 128 bytes, so sizes and counts are single-byte LEB128.
+const I32 = 0x7f;
+
+function vec(items: Array<Array<number>>): Array<number> {
+  return [items.length, ...items.flat()];
+}
+
+function name(text: string): Array<number> {
+  return [text.length, ...Buffer.from(text)];
+}
+
+function section(id: number, bytes: Array<number>): Array<number> {
+  return [id, bytes.length, ...bytes];
+}
+
+/** Imports: 0 read_u8, 1 write_u8, 2 overlay. Functions from 3 on are `exports`. */
+function scriptModule(exports: Record<string, Array<number>>, data = "hi"): Uint8Array {
+  const types = [
+    [0x60, 2, I32, I32, 1, I32], // (memType, address) -> value
+    [0x60, 3, I32, I32, I32, 1, I32], // (memType, address, value) -> ok
+    [0x60, 2, I32, I32, 0], // (ptr, len)
+    [0x60, 1, I32, 0], // (frame)
+  ];
+  const imports = [
+    [...name("gamelord"), ...name("read_u8"), 0, 0],
+    [...name("gamelord"), ...name("write_u8"), 0, 1],
+    [...name("gamelord"), ...name("overlay"), 0, 2],
+  ];
+  const names = Object.keys(exports);
+  const bodies = names.map((key) => {
+    const body = [0, ...exports[key], 0x0b];
+    return [body.length, ...body];
+  });
+  return new Uint8Array([
+    0x00, 0x61, 0x73, 0x6d, 1, 0, 0, 0,
+    ...section(1, vec(types)),
+    ...section(2, vec(imports)),
+    ...section(3, vec(names.map(() => [3]))),
+    ...section(5, vec([[0x00, 1]])),
+    ...section(
+      7,
+      vec([[...name("memory"), 2, 0], ...names.map((key, i) => [...name(key), 0, 3 + i])]),
+    ),
+    ...section(10, vec(bodies)),
+    ...section(11, vec([[0, 0x41, 0, 0x0b, ...name(data)]])),
+  ]);
+}
+
+// ram[16] += 1
+const INCREMENT = [0x41, 2, 0x41, 16, 0x41, 2, 0x41, 16, 0x10, 0, 0x41, 1, 0x6a, 0x10, 1, 0x1a];
+// overlay(0, 2)
+const SHOW_TEXT = [0x41, 0, 0x41, 2, 0x10, 2];
+// ram[0] (advances the fake clock)
+const READ = [0x41, 2, 0x41, 0, 0x10, 0, 0x1a];
+const TRAP = [0x00];
+// loop br 0 end
+const SPIN = [0x03, 0x40, 0x0c, 0, 0x0b];
+// loop ram[16] += 1; br_if 0 (ram[16] < 5) end
+const COUNT_TO_5 = [
+  0x03, 0x40, ...INCREMENT, 0x41, 2, 0x41, 16, 0x10, 0, 0x41, 5, 0x49, 0x0d, 0, 0x0b,
+];
+
+function fakeCore(costMs = 0) {
+  const clock = { now: 0 };
+  const ram = new Uint8Array(32);
+  const bindings: ScriptBindings = {
+    log: vi.fn(),
+    peek: (_memType, address) => {
+      clock.now += costMs;
+      return address < ram.length ? ram[address] : null;
+    },
+    poke: (_memType, address, _size, value) => {
+      ram[address] = value;
+      return true;
+    },
+    setInput: vi.fn(),
+  };
+  return { bindings, clock, ram };
+}
+
+describe("ScriptHost", () => {
+  it("runs hooks around each frame with access to core memory", () => {
+    const { bindings, clock, ram } = fakeCore();
+    const host = new ScriptHost(
+      scriptModule({ post_frame: SHOW_TEXT, pre_frame: INCREMENT }),
+      bindings,
+      1,
+      () => clock.now,
+    );
+
+    for (let frame = 0; frame < 3; frame++) {
+      host.preFrame(frame);
+      host.postFrame(frame + 1);
+    }
+
+    expect(ram[16]).toBe(3);
+    expect(host.takeOverlay()).toBe("hi");
+    expect(host.takeOverlay()).toBe(null);
+    expect(host.stats).toMatchObject({ disabledReason: null, hookCalls: 6, overruns: 0 });
+  });
+
+  it("counts overruns and switches off a script that stays over budget", () => {
+    const { bindings, clock } = fakeCore(1.5);
+    const host = new ScriptHost(scriptModule({ pre_frame: READ }), bindings, 1, () => clock.now);
+
+    for (let frame = 0; frame < MAX_CONSECUTIVE_OVERRUNS - 1; frame++) {
+      host.preFrame(frame);
+      host.postFrame(frame + 1);
+    }
+    expect(host.active).toBe(true);
+    expect(host.stats.lastFrameMs).toBe(1.5);
+
+    host.preFrame(MAX_CONSECUTIVE_OVERRUNS);
+    host.postFrame(MAX_CONSECUTIVE_OVERRUNS + 1);
+    expect(host.active).toBe(false);
+    expect(host.stats.overruns).toBe(MAX_CONSECUTIVE_OVERRUNS);
+    expect(bindings.log).toHaveBeenCalledWith(2, expect.stringContaining("Script disabled"));
+
+    host.preFrame(0);
+    expect(host.stats.hookCalls).toBe(MAX_CONSECUTIVE_OVERRUNS);
+  });
+
+  it("switches off at once on a frame far over budget", () => {
+    const { bindings, clock } = fakeCore(HARD_OVERRUN_FACTOR + 1);
+    const host = new ScriptHost(scriptModule({ pre_frame: READ }), bindings, 1, () => clock.now);
+
+    host.preFrame(0);
+    host.postFrame(1);
+    expect(host.active).toBe(false);
+    expect(host.stats.maxFrameMs).toBe(HARD_OVERRUN_FACTOR + 1);
+  });
+
+  it("switches off on a trap and clears its overlay", () => {
+    const { bindings } = fakeCore();
+    const host = new ScriptHost(scriptModule({ post_frame: SHOW_TEXT, pre_frame: TRAP }), bindings);
+    // Show the overlay once by calling post_frame alone.
+    host.postFrame(0);
+    expect(host.takeOverlay()).toBe("hi");
+
+    host.preFrame(1);
+    expect(host.active).toBe(false);
+    expect(host.stats.disabledReason).toMatch(/^Trap in pre_frame/);
+    expect(host.takeOverlay()).toBe("");
+  });
+
+  it("stops a hook that loops forever", () => {
+    const { bindings, ram } = fakeCore();
+    const host = new ScriptHost(
+      scriptModule({ post_frame: INCREMENT, pre_frame: SPIN }),
+      bindings,
+      0.1,
+    );
+
+    host.preFrame(0);
+    expect(host.active).toBe(false);
+    expect(host.stats.disabledReason).toMatch(/pre_frame ran out of fuel/);
+
+    host.postFrame(1);
+    expect(ram[16]).toBe(0);
+  });
+
+  it("leaves bounded loops alone", () => {
+    const { bindings, ram } = fakeCore();
+    const host = new ScriptHost(scriptModule({ pre_frame: COUNT_TO_5 }), bindings);
+
+    host.preFrame(0);
+    host.postFrame(1);
+    expect(ram[16]).toBe(5);
+    expect(host.active).toBe(true);
+  });
+
+  it("rejects modules that are not WebAssembly", () => {
+    const { bindings } = fakeCore();
+    expect(() => new ScriptHost(new Uint8Array([1, 2, 3]), bindings)).toThrow();
+  });
+});
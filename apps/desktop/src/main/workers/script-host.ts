@@ -0,0 +1,234 @@
+/**
+ * Frame scripts: a WebAssembly module run on the emulation thread with
+ * hooks before and after each `retro_run`. Scripts read and write core
+ * memory and input through the `gamelord` import module:
+ *
+ *   read_u8/read_u16/read_u32(memType, address) -> i32
+ *   write_u8/write_u16/write_u32(memType, address, value) -> i32 (1 on success)
+ *   input_get(port, id) -> i32
+ *   input_set(port, id, value)
+ *   overlay(ptr, len)   UTF-8 text drawn over the game (len 0 clears it)
+ *   log(ptr, len)       UTF-8 line for the emulator log
+ *
+ * and may export `init()`, `pre_frame(frame)`, `post_frame(frame)` and the
+ * `memory` that overlay/log pointers refer to. `memType` is a libretro
+ * RETRO_MEMORY_* id; multi-byte values are little-endian.
+ */
+import { performance } from "node:perf_hooks";
+import type { ScriptStats } from "./core-worker-protocol";
+import { FUEL_EXPORT, meterFuel } from "./script-fuel";
+
+export const DEFAULT_SCRIPT_BUDGET_MS = 1;
+
+/** Frames in a row over budget before the script is switched off. */
+export const MAX_CONSECUTIVE_OVERRUNS = 30;
+
+/** A single frame this many times over budget switches the script off at once. */
+export const HARD_OVERRUN_FACTOR = 10;
+
+/**
+ * Fuel (function calls plus loop iterations, see script-fuel.ts) per
+ * millisecond of budget. Each hook gets enough for HARD_OVERRUN_FACTOR
+ * budgets of tight looping, so running out means the hook would have been
+ * switched off anyway; it just can't hang the emulation thread first.
+ */
+export const FUEL_PER_MS = 1_000_000;
+
+/** What the host needs from the core. */
+export interface ScriptBindings {
+  peek(memType: number, address: number, size: number): number | null;
+  poke(memType: number, address: number, size: number, value: number): boolean;
+  setInput(port: number, id: number, value: number): void;
+  log(level: number, message: string): void;
+}
+
+type FrameHook = (frame: number) => void;
+
+export class ScriptHost {
+  private readonly preHook: FrameHook | null;
+  private readonly postHook: FrameHook | null;
+  private readonly memory: WebAssembly.Memory | null;
+  private readonly fuel: WebAssembly.Global;
+  private readonly input = new Map<number, number>();
+  private readonly decoder = new TextDecoder();
+
+  private overlay: string | null = null;
+  private overlayChanged = false;
+  private frameMs = 0;
+  private consecutiveOverruns = 0;
+  private frames = 0;
+  private totalMs = 0;
+  private lastFrameMs = 0;
+  private maxFrameMs = 0;
+  private overruns = 0;
+  private hookCalls = 0;
+  private disabledReason: string | null = null;
+
+  /**
+   * Meter, compile and instantiate a script synchronously (we are already
+   * off the main process), then run its `init` export. Throws on invalid or
+   * unmeterable modules, missing imports, or a trap in `init`.
+   */
+  constructor(
+    bytes: Uint8Array,
+    private readonly bindings: ScriptBindings,
+    readonly budgetMs = DEFAULT_SCRIPT_BUDGET_MS,
+    private readonly now: () => number = () => performance.now(),
+  ) {
+    const module = new WebAssembly.Module(meterFuel(bytes));
+    const instance = new WebAssembly.Instance(module, { gamelord: this.imports() });
+    const exports = instance.exports;
+
+    this.fuel = exports[FUEL_EXPORT] as WebAssembly.Global;
+    this.memory = exports.memory instanceof WebAssembly.Memory ? exports.memory : null;
+    this.preHook =
+      typeof exports.pre_frame === "function" ? (exports.pre_frame as FrameHook) : null;
+    this.postHook =
+      typeof exports.post_frame === "function" ? (exports.post_frame as FrameHook) : null;
+
+    if (typeof exports.init === "function") {
+      this.refuel();
+      (exports.init as () => void)();
+    }
+  }
+
+  /** Whether hooks still run (false once the script has been switched off). */
+  get active(): boolean {
+    return this.disabledReason === null;
+  }
+
+  /** Run `pre_frame` just before `retro_run`. Starts the frame's budget. */
+  preFrame(frame: number): void {
+    this.frameMs = 0;
+    this.call("pre_frame", this.preHook, frame);
+  }
+
+  /** Run `post_frame` just after `retro_run`, then settle the frame's budget. */
+  postFrame(frame: number): void {
+    this.call("post_frame", this.postHook, frame);
+    if (!this.active || (this.preHook === null && this.postHook === null)) {
+      return;
+    }
+
+    this.frames++;
+    this.totalMs += this.frameMs;
+    this.lastFrameMs = this.frameMs;
+    this.maxFrameMs = Math.max(this.maxFrameMs, this.frameMs);
+
+    if (this.frameMs <= this.budgetMs) {
+      this.consecutiveOverruns = 0;
+      return;
+    }
+    this.overruns++;
+    this.consecutiveOverruns++;
+    if (this.frameMs > this.budgetMs * HARD_OVERRUN_FACTOR) {
+      this.disable(
+        `Frame hooks took ${this.frameMs.toFixed(2)}ms (budget ${this.budgetMs}ms)`,
+      );
+    } else if (this.consecutiveOverruns >= MAX_CONSECUTIVE_OVERRUNS) {
+      this.disable(`Over the ${this.budgetMs}ms budget for ${MAX_CONSECUTIVE_OVERRUNS} frames`);
+    }
+  }
+
+  /** Mirror a frontend input change so `input_get` sees it. */
+  noteInput(port: number, id: number, value: number): void {
+    this.input.set(inputKey(port, id), value);
+  }
+
+  /** The overlay text if it changed since the last call, else null. */
+  takeOverlay(): string | null {
+    if (!this.overlayChanged) {
+      return null;
+    }
+    this.overlayChanged = false;
+    return this.overlay ?? "";
+  }
+
+  get stats(): ScriptStats {
+    return {
+      budgetMs: this.budgetMs,
+      disabledReason: this.disabledReason,
+      hookCalls: this.hookCalls,
+      lastFrameMs: this.lastFrameMs,
+      loaded: true,
+      maxFrameMs: this.maxFrameMs,
+      meanFrameMs: this.frames > 0 ? this.totalMs / this.frames : 0,
+      overruns: this.overruns,
+    };
+  }
+
+  private call(name: string, hook: FrameHook | null, frame: number): void {
+    if (!hook || !this.active) {
+      return;
+    }
+    const startedAt = this.now();
+    this.refuel();
+    try {
+      hook(frame);
+    } catch (error) {
+      this.disable(
+        this.fuel.value === 0
+          ? `${name} ran out of fuel (looped far past its budget)`
+          : `Trap in ${name}: ${error instanceof Error ? error.message : String(error)}`,
+      );
+    } finally {
+      this.frameMs += this.now() - startedAt;
+      this.hookCalls++;
+    }
+  }
+
+  private refuel(): void {
+    this.fuel.value = Math.max(1, Math.round(this.budgetMs * HARD_OVERRUN_FACTOR * FUEL_PER_MS));
+  }
+
+  private disable(reason: string): void {
+    this.disabledReason = reason;
+    if (this.overlay) {
+      this.overlay = null;
+      this.overlayChanged = true;
+    }
+    this.bindings.log(2, `Script disabled: ${reason}`);
+  }
+
+  private text(ptr: number, len: number): string {
+    if (!this.memory || len <= 0) {
+      return "";
+    }
+    const bytes = new Uint8Array(this.memory.buffer);
+    const start = ptr >>> 0;
+    return this.decoder.decode(bytes.subarray(start, Math.min(start + (len >>> 0), bytes.length)));
+  }
+
+  private imports(): Record<string, (...args: Array<number>) => number | void> {
+    const read = (size: number) => (memType: number, address: number) =>
+      this.bindings.peek(memType, address >>> 0, size) ?? 0;
+    const write = (size: number) => (memType: number, address: number, value: number) =>
+      this.bindings.poke(memType, address >>> 0, size, value >>> 0) ? 1 : 0;
+
+    return {
+      input_get: (port, id) => this.input.get(inputKey(port, id)) ?? 0,
+      input_set: (port, id, value) => {
+        this.input.set(inputKey(port, id), value);
+        this.bindings.setInput(port, id, value);
+      },
+      log: (ptr, len) => this.bindings.log(1, `[script] ${this.text(ptr, len)}`),
+      overlay: (ptr, len) => {
+        const text = this.text(ptr, len);
+        if (text !== (this.overlay ?? "")) {
+          this.overlay = text;
+          this.overlayChanged = true;
+        }
+      },
+      read_u16: read(2),
+      read_u32: read(4),
+      read_u8: read(1),
+      write_u16: write(2),
+      write_u32: write(4),
+      write_u8: write(1),
+    };
+  }
+}
+
+function inputKey(port: number, id: number): number {
+  return port * 65_536 + id;
+}
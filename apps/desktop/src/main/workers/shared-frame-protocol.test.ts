@@ -2,47 +2,73 @@ import { describe, it, expect } from "vitest";
 import {
   computeVideoBufferSize,
   CTRL_SAB_BYTE_LENGTH,
-  CTRL_ACTIVE_BUFFER,
+  CTRL_VIDEO_LATEST,
   CTRL_FRAME_SEQUENCE,
   CTRL_FRAME_WIDTH,
   CTRL_FRAME_HEIGHT,
   CTRL_AUDIO_WRITE_POS,
   CTRL_AUDIO_READ_POS,
   CTRL_AUDIO_SAMPLE_RATE,
+  CTRL_AUDIO_FILL,
   AUDIO_RING_SAMPLES,
   AUDIO_RING_BYTE_LENGTH,
+  AUDIO_MAX_RATE_DELTA,
+  AUDIO_PULL_LOW_WATERMARK,
+  AUDIO_PULL_MAX_CALLS,
+  AUDIO_TARGET_FILL_SAMPLES,
+  audioRatePeriodScale,
+  topUpAudio,
+  CTRL_VIDEO_WRITER_SLOT,
+  CTRL_VIDEO_READER_SLOT,
+  CTRL_VIDEO_SLOT_DIMS,
+  VIDEO_SLOT_COUNT,
+  initVideoSlots,
+  VideoSlotProducer,
+  VideoSlotReader,
+  CTRL_TIMELINE_BYTE_OFFSET,
+  frameSyncStats,
 } from "./shared-frame-protocol";
 
 describe("shared-frame-protocol", () => {
   describe("control SAB layout", () => {
     it("has unique field indices", () => {
       const indices = [
-        CTRL_ACTIVE_BUFFER,
+        CTRL_VIDEO_LATEST,
         CTRL_FRAME_SEQUENCE,
         CTRL_FRAME_WIDTH,
         CTRL_FRAME_HEIGHT,
         CTRL_AUDIO_WRITE_POS,
         CTRL_AUDIO_READ_POS,
         CTRL_AUDIO_SAMPLE_RATE,
+        CTRL_AUDIO_FILL,
+        CTRL_VIDEO_WRITER_SLOT,
+        CTRL_VIDEO_READER_SLOT,
+        CTRL_VIDEO_SLOT_DIMS,
       ];
       expect(new Set(indices).size).toBe(indices.length);
     });
 
-    it("control SAB is 32 bytes (8 × Int32)", () => {
-      expect(CTRL_SAB_BYTE_LENGTH).toBe(32);
+    it("control SAB is 16 × Int32 followed by 3 timelines of 5 × Float64", () => {
+      expect(CTRL_TIMELINE_BYTE_OFFSET).toBe(64);
+      expect(CTRL_TIMELINE_BYTE_OFFSET % Float64Array.BYTES_PER_ELEMENT).toBe(0);
+      expect(CTRL_SAB_BYTE_LENGTH).toBe(64 + 3 * 5 * 8);
     });
 
     it("all indices fit within control SAB", () => {
       const maxIndex = Math.max(
-        CTRL_ACTIVE_BUFFER,
+        CTRL_VIDEO_LATEST,
         CTRL_FRAME_SEQUENCE,
         CTRL_FRAME_WIDTH,
         CTRL_FRAME_HEIGHT,
         CTRL_AUDIO_WRITE_POS,
         CTRL_AUDIO_READ_POS,
         CTRL_AUDIO_SAMPLE_RATE,
+        CTRL_AUDIO_FILL,
+        CTRL_VIDEO_WRITER_SLOT,
+        CTRL_VIDEO_READER_SLOT,
+        CTRL_VIDEO_SLOT_DIMS + VIDEO_SLOT_COUNT * 2 - 1,
       );
-      const elementCount = CTRL_SAB_BYTE_LENGTH / Int32Array.BYTES_PER_ELEMENT;
+      const elementCount = CTRL_TIMELINE_BYTE_OFFSET / Int32Array.BYTES_PER_ELEMENT;
       expect(maxIndex).toBeLessThan(elementCount);
     });
   });
@@ -57,6 +83,203 @@ describe("shared-frame-protocol", () => {
     });
   });
 
+  describe("audioRatePeriodScale", () => {
+    it("leaves the period alone without a reporting consumer", () => {
+      expect(audioRatePeriodScale(-1)).toBe(1);
+    });
+
+    it("is neutral at the target fill", () => {
+      expect(audioRatePeriodScale(AUDIO_TARGET_FILL_SAMPLES)).toBe(1);
+    });
+
+    it("shortens the period when the consumer runs dry", () => {
+      expect(audioRatePeriodScale(0)).toBeCloseTo(1 - AUDIO_MAX_RATE_DELTA);
+    });
+
+    it("lengthens the period for a backlog, saturating at the max delta", () => {
+      expect(audioRatePeriodScale(AUDIO_TARGET_FILL_SAMPLES * 1.5)).toBeCloseTo(
+        1 + AUDIO_MAX_RATE_DELTA / 2,
+      );
+      expect(audioRatePeriodScale(AUDIO_TARGET_FILL_SAMPLES * 10)).toBeCloseTo(
+        1 + AUDIO_MAX_RATE_DELTA,
+      );
+    });
+  });
+
+  describe("topUpAudio", () => {
+    /** A ring whose core produces `chunk` samples per callback. */
+    function fakeRing(fill: number, chunk: number) {
+      const ring = { calls: 0, fill };
+      const pull = () => {
+        ring.calls++;
+        ring.fill += chunk;
+        return chunk;
+      };
+      return { pending: () => ring.fill, pull, ring };
+    }
+
+    it("leaves the core alone above the low watermark", () => {
+      const { pending, pull, ring } = fakeRing(AUDIO_PULL_LOW_WATERMARK, 512);
+      expect(topUpAudio(pending, pull)).toBe(0);
+      expect(ring.calls).toBe(0);
+    });
+
+    it("pulls back up to the target fill once below the watermark", () => {
+      const { pending, pull, ring } = fakeRing(AUDIO_PULL_LOW_WATERMARK - 2, 512);
+      const pulled = topUpAudio(pending, pull);
+      expect(ring.fill).toBeGreaterThanOrEqual(AUDIO_TARGET_FILL_SAMPLES);
+      expect(ring.fill - 512).toBeLessThan(AUDIO_TARGET_FILL_SAMPLES);
+      expect(pulled).toBe(ring.calls * 512);
+    });
+
+    it("stops when the core produces nothing", () => {
+      const { pending, pull, ring } = fakeRing(0, 0);
+      expect(topUpAudio(pending, pull)).toBe(0);
+      expect(ring.calls).toBe(1);
+    });
+
+    it("caps the callbacks per top-up", () => {
+      const { pending, pull, ring } = fakeRing(0, 2);
+      topUpAudio(pending, pull);
+      expect(ring.calls).toBe(AUDIO_PULL_MAX_CALLS);
+    });
+  });
+
+  describe("frameSyncStats", () => {
+    it("measures latency from retro_run and audio still queued ahead of the frame", () => {
+      const ctrl = new Int32Array(new SharedArrayBuffer(CTRL_SAB_BYTE_LENGTH));
+      Atomics.store(ctrl, CTRL_AUDIO_SAMPLE_RATE, 48_000);
+      Atomics.store(ctrl, CTRL_AUDIO_READ_POS, 2_147_483_000);
+      const timeline = {
+        audioWritePos: (2_147_483_000 + 4800) | 0, // wrapped
+        emulatedTimeMs: 0,
+        frameNumber: 1,
+        publishedAt: 1010,
+        runStartedAt: 1000,
+      };
+      const stats = frameSyncStats(ctrl, timeline, 1025);
+      expect(stats.latencyMs).toBe(25);
+      expect(stats.avOffsetMs).toBeCloseTo(50);
+    });
+
+    it("reports no offset before the sample rate is known", () => {
+      const ctrl = new Int32Array(new SharedArrayBuffer(CTRL_SAB_BYTE_LENGTH));
+      const timeline = {
+        audioWritePos: 0,
+        emulatedTimeMs: 0,
+        frameNumber: 1,
+        publishedAt: 0,
+        runStartedAt: 0,
+      };
+      expect(frameSyncStats(ctrl, timeline, 0).avOffsetMs).toBe(null);
+    });
+  });
+
+  describe("video triple buffer", () => {
+    function setup() {
+      const ctrl = new Int32Array(new SharedArrayBuffer(CTRL_SAB_BYTE_LENGTH));
+      initVideoSlots(ctrl);
+      return { ctrl, producer: new VideoSlotProducer(ctrl), reader: new VideoSlotReader(ctrl) };
+    }
+
+    it("has nothing to claim before the first publish", () => {
+      const { reader } = setup();
+      expect(reader.acquire()).toBe(false);
+    });
+
+    it("hands the published slot and its dimensions to the reader", () => {
+      const { ctrl, producer, reader } = setup();
+      const written = producer.writeSlot;
+      producer.publish(256, 224);
+
+      expect(reader.acquire()).toBe(true);
+      expect(reader.slot).toBe(written);
+      expect(reader.width).toBe(256);
+      expect(reader.height).toBe(224);
+      expect(Atomics.load(ctrl, CTRL_FRAME_SEQUENCE)).toBe(1);
+      expect(reader.acquire()).toBe(false);
+    });
+
+    it("wakes a reader waiting on the frame sequence", async () => {
+      const { ctrl, producer } = setup();
+      const wait = Atomics.waitAsync(ctrl, CTRL_FRAME_SEQUENCE, 0, 1000);
+      expect(wait.async).toBe(true);
+      producer.publish(256, 224);
+      expect(await wait.value).toBe("ok");
+    });
+
+    it("reports a drop when replacing an unclaimed frame", () => {
+      const { producer, reader } = setup();
+      expect(producer.publish(256, 224)).toBe(false);
+      expect(producer.publish(256, 224)).toBe(true);
+      reader.acquire();
+      expect(producer.publish(256, 224)).toBe(false);
+    });
+
+    it("publishes each frame's timeline with its slot", () => {
+      const { ctrl, producer, reader } = setup();
+      Atomics.store(ctrl, CTRL_AUDIO_WRITE_POS, 1600);
+      producer.publish(256, 224, { emulatedTimeMs: 100, frameNumber: 6, runStartedAt: 5000 });
+      Atomics.store(ctrl, CTRL_AUDIO_WRITE_POS, 3200);
+      producer.publish(256, 224, { emulatedTimeMs: 116.5, frameNumber: 7, runStartedAt: 5016 });
+
+      reader.acquire();
+      const timeline = reader.timeline;
+      expect(timeline.frameNumber).toBe(7);
+      expect(timeline.emulatedTimeMs).toBe(116.5);
+      expect(timeline.runStartedAt).toBe(5016);
+      expect(timeline.audioWritePos).toBe(3200);
+      expect(timeline.publishedAt).toBeGreaterThan(timeline.runStartedAt);
+    });
+
+    it("never gives the producer the slot being read", () => {
+      const { producer, reader } = setup();
+      producer.publish(160, 144);
+      reader.acquire();
+      const reading = reader.slot;
+
+      // Several frames inside one reader tick.
+      for (let i = 0; i < 5; i++) {
+        expect(producer.writeSlot).not.toBe(reading);
+        producer.publish(160, 144);
+      }
+      expect(reader.slot).toBe(reading);
+    });
+
+    it("claims the newest of several unread frames", () => {
+      const { producer, reader } = setup();
+      producer.publish(320, 240);
+      const newest = producer.writeSlot;
+      producer.publish(640, 480);
+
+      expect(reader.acquire()).toBe(true);
+      expect(reader.slot).toBe(newest);
+      expect(reader.width).toBe(640);
+    });
+
+    it("keeps the three slots distinct across interleavings", () => {
+      const { ctrl, producer, reader } = setup();
+      for (let i = 0; i < 50; i++) {
+        if (i % 3 !== 2) {
+          producer.publish(i, i);
+        }
+        if (i % 2 === 0) {
+          reader.acquire();
+        }
+        const latest = Atomics.load(ctrl, CTRL_VIDEO_LATEST) & 3;
+        expect(new Set([producer.writeSlot, reader.slot, latest]).size).toBe(3);
+      }
+    });
+
+    it("resumes ownership from the control block in a new reader", () => {
+      const { ctrl, producer, reader } = setup();
+      producer.publish(100, 100);
+      reader.acquire();
+      const remounted = new VideoSlotReader(ctrl);
+      expect(remounted.slot).toBe(reader.slot);
+    });
+  });
+
   describe("computeVideoBufferSize", () => {
     it("uses max dimensions when available", () => {
       expect(computeVideoBufferSize(512, 480, 256, 240)).toBe(512 * 480 * 4);
@@ -1,28 +1,56 @@
 /**
  * Zero-copy frame/audio transfer protocol using SharedArrayBuffer.
  *
- * Control SAB layout (Int32Array view, 8 elements):
- *   [0] activeBuffer   — 0 or 1 (which video buffer the renderer should read)
+ * Control SAB layout (Int32Array view, first 16 elements):
+ *   [0] videoLatest    — slot holding the newest published frame, OR'd with
+ *                        VIDEO_SLOT_FRESH until the reader claims it
  *   [1] frameSequence  — monotonically increasing frame counter
- *   [2] frameWidth     — current frame width in pixels
- *   [3] frameHeight    — current frame height in pixels
+ *   [2] frameWidth     — width of the most recently published frame
+ *   [3] frameHeight    — height of the most recently published frame
  *   [4] audioWritePos  — ring buffer write position (monotonic Int16 sample count)
  *   [5] audioReadPos   — ring buffer read position (monotonic Int16 sample count)
  *   [6] audioSampleRate — sample rate reported by core (e.g. 44100, 48000)
- *   [7] reserved
+ *   [7] audioFill      — samples the consumer had buffered at its last read,
+ *                        or AUDIO_FILL_UNKNOWN when no consumer reports it
+ *   [8] videoWriterSlot — slot the producer is filling
+ *   [9] videoReaderSlot — slot the renderer is reading
+ *   [10..15] slot dimensions — width, height for slots 0, 1, 2
+ *
+ * Followed at CTRL_TIMELINE_BYTE_OFFSET by a Float64Array of per-slot frame
+ * timelines (TIMELINE_FIELDS each, see FrameTimeline). A slot's timeline is
+ * written and read by whichever side owns the slot, like its pixels.
  */
 
 /** Control SAB field indices (Int32Array). */
-export const CTRL_ACTIVE_BUFFER = 0;
+export const CTRL_VIDEO_LATEST = 0;
 export const CTRL_FRAME_SEQUENCE = 1;
 export const CTRL_FRAME_WIDTH = 2;
 export const CTRL_FRAME_HEIGHT = 3;
 export const CTRL_AUDIO_WRITE_POS = 4;
 export const CTRL_AUDIO_READ_POS = 5;
 export const CTRL_AUDIO_SAMPLE_RATE = 6;
+export const CTRL_AUDIO_FILL = 7;
+export const CTRL_VIDEO_WRITER_SLOT = 8;
+export const CTRL_VIDEO_READER_SLOT = 9;
+export const CTRL_VIDEO_SLOT_DIMS = 10;
+
+/** Video slots in the video SAB, each `videoBufferSize` bytes. */
+export const VIDEO_SLOT_COUNT = 3;
+
+/** Per-slot timeline fields (Float64Array, relative to the slot's record). */
+export const TL_FRAME_NUMBER = 0;
+export const TL_EMULATED_TIME_MS = 1;
+export const TL_RUN_STARTED_AT = 2;
+export const TL_PUBLISHED_AT = 3;
+export const TL_AUDIO_WRITE_POS = 4;
+export const TIMELINE_FIELDS = 5;
+
+/** Byte offset of the timeline records (after the 16 Int32 fields). */
+export const CTRL_TIMELINE_BYTE_OFFSET = 16 * Int32Array.BYTES_PER_ELEMENT;
 
-/** Control SAB byte length (8 × 4 bytes). */
-export const CTRL_SAB_BYTE_LENGTH = 8 * Int32Array.BYTES_PER_ELEMENT;
+/** Control SAB byte length (Int32 fields + one timeline record per video slot). */
+export const CTRL_SAB_BYTE_LENGTH =
+  CTRL_TIMELINE_BYTE_OFFSET + VIDEO_SLOT_COUNT * TIMELINE_FIELDS * Float64Array.BYTES_PER_ELEMENT;
 
 /**
  * Audio ring buffer capacity in Int16 samples.
@@ -32,6 +60,123 @@ export const CTRL_SAB_BYTE_LENGTH = 8 * Int32Array.BYTES_PER_ELEMENT;
 export const AUDIO_RING_SAMPLES = 32_768;
 export const AUDIO_RING_BYTE_LENGTH = AUDIO_RING_SAMPLES * Int16Array.BYTES_PER_ELEMENT;
 
+/** CTRL_AUDIO_FILL value while nothing is consuming the ring in real time. */
+export const AUDIO_FILL_UNKNOWN = -1;
+
+/**
+ * Ring fill (Int16 samples) the audio consumer primes to and the producer
+ * steers toward. 6144 samples ≈ 64ms of stereo audio at 48kHz.
+ */
+export const AUDIO_TARGET_FILL_SAMPLES = 6144;
+
+/**
+ * Largest frame-period change rate control may apply (±0.5%). The resulting
+ * pitch shift is below what listeners notice.
+ */
+export const AUDIO_MAX_RATE_DELTA = 0.005;
+
+/**
+ * Frame-period multiplier for dynamic rate control. A consumer that is
+ * running dry speeds the producer up slightly; one with a growing backlog
+ * slows it down. The correction is proportional to the distance from the
+ * target and saturates at ±AUDIO_MAX_RATE_DELTA.
+ */
+export function audioRatePeriodScale(
+  fill: number,
+  targetFill: number = AUDIO_TARGET_FILL_SAMPLES,
+): number {
+  if (fill < 0) {
+    return 1;
+  }
+  const error = Math.max(-1, Math.min(1, (fill - targetFill) / targetFill));
+  return 1 + error * AUDIO_MAX_RATE_DELTA;
+}
+
+/**
+ * Ring fill (Int16 samples) below which a pull-mode core — one that set
+ * RETRO_ENVIRONMENT_SET_AUDIO_CALLBACK — is asked for more audio.
+ */
+export const AUDIO_PULL_LOW_WATERMARK = AUDIO_TARGET_FILL_SAMPLES / 2;
+
+/** Most audio callback calls per top-up, in case the core stops producing. */
+export const AUDIO_PULL_MAX_CALLS = 32;
+
+/**
+ * Top a pull-mode core's output up to the target fill once the consumer has
+ * drained it below the low watermark. `pending` reads the ring's current
+ * backlog; `pull` calls the core's audio callback once, publishes what it
+ * produced and returns the sample count. Stops early when the core has
+ * nothing more to give. Returns the samples pulled.
+ */
+export function topUpAudio(
+  pending: () => number,
+  pull: () => number,
+  lowWatermark: number = AUDIO_PULL_LOW_WATERMARK,
+  targetFill: number = AUDIO_TARGET_FILL_SAMPLES,
+): number {
+  if (pending() >= lowWatermark) {
+    return 0;
+  }
+  let pulled = 0;
+  for (let calls = 0; calls < AUDIO_PULL_MAX_CALLS && pending() < targetFill; calls++) {
+    const samples = pull();
+    if (samples <= 0) {
+      break;
+    }
+    pulled += samples;
+  }
+  return pulled;
+}
+
+/**
+ * Wall-clock milliseconds from the high-resolution timer. Unlike bare
+ * `performance.now()`, comparable between the utility process, the
+ * renderer and its workers, which all have different time origins.
+ */
+export function hostNowMs(): number {
+  return performance.timeOrigin + performance.now();
+}
+
+/**
+ * Where a published frame sits on the emulated and host timelines, so
+ * consumers can pair it with its audio and measure latency.
+ */
+export interface FrameTimeline {
+  /** Core frames run since the game loaded, this one included. */
+  frameNumber: number;
+  /** `frameNumber` at the core's nominal frame rate. */
+  emulatedTimeMs: number;
+  /** hostNowMs() when the retro_run that produced the frame started. */
+  runStartedAt: number;
+  /** hostNowMs() when the frame was published. */
+  publishedAt: number;
+  /**
+   * CTRL_AUDIO_WRITE_POS at publish: the frame's audio ends here, so it is
+   * heard once the consumer's read position passes this point.
+   */
+  audioWritePos: number;
+}
+
+/**
+ * Presentation latency and A/V offset for a frame being shown at
+ * `presentedAt` (hostNowMs). `avOffsetMs` is how much of the ring the audio
+ * consumer still has to read before the frame's audio has been played out;
+ * positive means sound trails picture. It excludes the output device's own
+ * latency, and is null before the sample rate is known.
+ */
+export function frameSyncStats(
+  ctrl: Int32Array,
+  timeline: FrameTimeline,
+  presentedAt: number,
+): { latencyMs: number; avOffsetMs: number | null } {
+  const sampleRate = Atomics.load(ctrl, CTRL_AUDIO_SAMPLE_RATE);
+  const pending = (timeline.audioWritePos - Atomics.load(ctrl, CTRL_AUDIO_READ_POS)) | 0;
+  return {
+    avOffsetMs: sampleRate > 0 ? (pending / 2 / sampleRate) * 1000 : null,
+    latencyMs: presentedAt - timeline.runStartedAt,
+  };
+}
+
 /**
  * Compute the byte size for a single video buffer from AV info geometry.
  * Falls back to 1024×1024 when the core reports 0 for max dimensions.
@@ -46,3 +191,137 @@ export function computeVideoBufferSize(
   const h = maxHeight > 0 ? maxHeight : Math.max(baseHeight, 1024);
   return w * h * 4; // RGBA8888
 }
+
+// ---------------------------------------------------------------------------
+// Triple-buffered video slots
+// ---------------------------------------------------------------------------
+
+/** Set in CTRL_VIDEO_LATEST while the newest frame hasn't been claimed. */
+export const VIDEO_SLOT_FRESH = 4;
+
+const VIDEO_SLOT_MASK = 3;
+
+/*
+ * Lock-free triple buffer over the video SAB. Each of the three slots is
+ * owned by exactly one party at a time: the producer (the slot it's
+ * writing), the reader (the slot it's uploading), or CTRL_VIDEO_LATEST (the
+ * newest finished frame). Ownership only moves through `Atomics.exchange`
+ * on CTRL_VIDEO_LATEST, so neither side ever waits, the producer always
+ * has a free slot, and a slot is never overwritten while it's being read.
+ * Frames the reader never claims are simply recycled.
+ *
+ * Each side's owned slot lives in the control block rather than in the
+ * object, so a new producer or reader (renderer remount, worker restart)
+ * picks up where the previous one left off. A native producer can follow
+ * the same protocol with `std::atomic<int32_t>::exchange` on the same words.
+ */
+
+/** Initial slot ownership. Call once when allocating the control SAB. */
+export function initVideoSlots(ctrl: Int32Array): void {
+  Atomics.store(ctrl, CTRL_VIDEO_LATEST, 0);
+  Atomics.store(ctrl, CTRL_VIDEO_WRITER_SLOT, 1);
+  Atomics.store(ctrl, CTRL_VIDEO_READER_SLOT, 2);
+}
+
+function timelineView(ctrl: Int32Array): Float64Array {
+  return new Float64Array(
+    ctrl.buffer,
+    ctrl.byteOffset + CTRL_TIMELINE_BYTE_OFFSET,
+    VIDEO_SLOT_COUNT * TIMELINE_FIELDS,
+  );
+}
+
+/** Producer side of the video triple buffer. */
+export class VideoSlotProducer {
+  private readonly timelines: Float64Array;
+
+  constructor(private readonly ctrl: Int32Array) {
+    this.timelines = timelineView(ctrl);
+  }
+
+  /** Slot to write the next frame into; owned by the producer until publish. */
+  get writeSlot(): number {
+    return Atomics.load(this.ctrl, CTRL_VIDEO_WRITER_SLOT);
+  }
+
+  /**
+   * Hand the frame written into `writeSlot` to the reader, and wake any
+   * reader parked in `Atomics.waitAsync` on CTRL_FRAME_SEQUENCE. Publish
+   * after writing the frame's audio so `audioWritePos` covers it. Returns
+   * true when this replaced a frame the reader never claimed (a drop).
+   */
+  publish(
+    width: number,
+    height: number,
+    timing?: Pick<FrameTimeline, "frameNumber" | "emulatedTimeMs" | "runStartedAt">,
+  ): boolean {
+    const ctrl = this.ctrl;
+    const slot = Atomics.load(ctrl, CTRL_VIDEO_WRITER_SLOT);
+    // Plain stores are fine: the exchange below publishes them with the slot.
+    const record = slot * TIMELINE_FIELDS;
+    this.timelines[record + TL_FRAME_NUMBER] = timing?.frameNumber ?? 0;
+    this.timelines[record + TL_EMULATED_TIME_MS] = timing?.emulatedTimeMs ?? 0;
+    this.timelines[record + TL_RUN_STARTED_AT] = timing?.runStartedAt ?? 0;
+    this.timelines[record + TL_PUBLISHED_AT] = hostNowMs();
+    this.timelines[record + TL_AUDIO_WRITE_POS] = Atomics.load(ctrl, CTRL_AUDIO_WRITE_POS);
+    Atomics.store(ctrl, CTRL_VIDEO_SLOT_DIMS + slot * 2, width);
+    Atomics.store(ctrl, CTRL_VIDEO_SLOT_DIMS + slot * 2 + 1, height);
+    Atomics.store(ctrl, CTRL_FRAME_WIDTH, width);
+    Atomics.store(ctrl, CTRL_FRAME_HEIGHT, height);
+    const previous = Atomics.exchange(ctrl, CTRL_VIDEO_LATEST, slot | VIDEO_SLOT_FRESH);
+    Atomics.store(ctrl, CTRL_VIDEO_WRITER_SLOT, previous & VIDEO_SLOT_MASK);
+    Atomics.add(ctrl, CTRL_FRAME_SEQUENCE, 1);
+    Atomics.notify(ctrl, CTRL_FRAME_SEQUENCE);
+    return (previous & VIDEO_SLOT_FRESH) !== 0;
+  }
+}
+
+/** Reader side of the video triple buffer. */
+export class VideoSlotReader {
+  private readonly timelines: Float64Array;
+
+  constructor(private readonly ctrl: Int32Array) {
+    this.timelines = timelineView(ctrl);
+  }
+
+  /**
+   * Claim the newest frame if one was published since the last claim.
+   * On success `slot`, `width` and `height` describe it, and the slot stays
+   * safe to read until the next successful `acquire`.
+   */
+  acquire(): boolean {
+    const ctrl = this.ctrl;
+    if ((Atomics.load(ctrl, CTRL_VIDEO_LATEST) & VIDEO_SLOT_FRESH) === 0) {
+      return false;
+    }
+    const released = Atomics.load(ctrl, CTRL_VIDEO_READER_SLOT);
+    const claimed = Atomics.exchange(ctrl, CTRL_VIDEO_LATEST, released) & VIDEO_SLOT_MASK;
+    Atomics.store(ctrl, CTRL_VIDEO_READER_SLOT, claimed);
+    return true;
+  }
+
+  get slot(): number {
+    return Atomics.load(this.ctrl, CTRL_VIDEO_READER_SLOT);
+  }
+
+  get width(): number {
+    return Atomics.load(this.ctrl, CTRL_VIDEO_SLOT_DIMS + this.slot * 2);
+  }
+
+  get height(): number {
+    return Atomics.load(this.ctrl, CTRL_VIDEO_SLOT_DIMS + this.slot * 2 + 1);
+  }
+
+  /** Timeline of the claimed frame. */
+  get timeline(): FrameTimeline {
+    const record = this.slot * TIMELINE_FIELDS;
+    const timelines = this.timelines;
+    return {
+      audioWritePos: timelines[record + TL_AUDIO_WRITE_POS],
+      emulatedTimeMs: timelines[record + TL_EMULATED_TIME_MS],
+      frameNumber: timelines[record + TL_FRAME_NUMBER],
+      publishedAt: timelines[record + TL_PUBLISHED_AT],
+      runStartedAt: timelines[record + TL_RUN_STARTED_AT],
+    };
+  }
+}
@@ -1,4 +1,5 @@
 import { contextBridge, ipcRenderer } from "electron";
+import type { ScreenLayout } from "./main/workers/core-worker-protocol";
 
 // ---------------------------------------------------------------------------
 // SharedArrayBuffer MessagePort bridge
@@ -39,6 +40,9 @@ contextBridge.exposeInMainWorld("gamelord", {
       ipcRenderer.invoke("emulator:getCoresForSystem", systemId),
     downloadCore: (coreName: string, systemId: string) =>
       ipcRenderer.invoke("emulator:downloadCore", coreName, systemId),
+    benchmarkCores: (games: Array<{ romPath: string; systemId: string }>) =>
+      ipcRenderer.invoke("emulator:benchmarkCores", games),
+    verifyBios: () => ipcRenderer.invoke("emulator:verifyBios"),
   },
 
   // Emulation control
@@ -50,6 +54,7 @@ contextBridge.exposeInMainWorld("gamelord", {
     setSpeed: (multiplier: number) => ipcRenderer.invoke("emulation:setSpeed", multiplier),
     setFastForwardAudio: (enabled: boolean) =>
       ipcRenderer.invoke("emulation:setFastForwardAudio", enabled),
+    setPerfHud: (enabled: boolean) => ipcRenderer.invoke("emulation:setPerfHud", enabled),
     swapDisc: (index: number) => ipcRenderer.invoke("emulation:swapDisc", index),
     getDiscInfo: () =>
       ipcRenderer.invoke("emulation:getDiscInfo") as Promise<{
@@ -66,6 +71,15 @@ contextBridge.exposeInMainWorld("gamelord", {
         path?: string;
         error?: string;
       }>,
+    loadScript: (scriptPath?: string) => ipcRenderer.invoke("emulation:loadScript", scriptPath),
+    unloadScript: () => ipcRenderer.invoke("emulation:unloadScript"),
+    setScreenLayout: (layout: ScreenLayout) =>
+      ipcRenderer.invoke("emulation:setScreenLayout", layout) as Promise<{
+        success: boolean;
+        width?: number;
+        height?: number;
+        error?: string;
+      }>,
   },
 
   // Save states
@@ -73,6 +87,7 @@ contextBridge.exposeInMainWorld("gamelord", {
     save: (slot: number) => ipcRenderer.invoke("savestate:save", slot),
     load: (slot: number) => ipcRenderer.invoke("savestate:load", slot),
     list: () => ipcRenderer.invoke("savestate:list"),
+    summaries: (romPath: string) => ipcRenderer.invoke("savestate:summaries", romPath),
   },
 
   // Cheats
@@ -107,6 +122,8 @@ contextBridge.exposeInMainWorld("gamelord", {
     ipcRenderer.send("game:input", port, id, pressed),
   gameInputAnalog: (port: number, index: number, id: number, value: number) =>
     ipcRenderer.send("game:input-analog", port, index, id, value),
+  gamePointer: (x: number, y: number, pressed: boolean) =>
+    ipcRenderer.send("game:pointer", x, y, pressed),
 
   // Event listeners
   on: (channel: string, callback: (...args: Array<unknown>) => void) => {
@@ -122,6 +139,7 @@ contextBridge.exposeInMainWorld("gamelord", {
       "emulator:reset",
       "emulator:speedChanged",
       "emulator:discChanged",
+      "emulator:scriptOverlay",
       "emulator:terminated",
       "game:loaded",
       "game:mode",
@@ -135,6 +153,7 @@ contextBridge.exposeInMainWorld("gamelord", {
       "cheats:downloadProgress",
       "library:scanProgress",
       "library:scanAmbiguous",
+      "library:changed",
       "library:homebrewImported",
       "artwork:progress",
       "artwork:syncComplete",
@@ -188,6 +207,8 @@ contextBridge.exposeInMainWorld("gamelord", {
       ipcRenderer.invoke("library:updateSystemPath", systemId, romsPath),
 
     getGames: (systemId?: string) => ipcRenderer.invoke("library:getGames", systemId),
+    searchGames: (query: string, limit?: number) =>
+      ipcRenderer.invoke("library:searchGames", query, limit),
     addGame: (romPath: string, systemId: string) =>
       ipcRenderer.invoke("library:addGame", romPath, systemId),
     removeGame: (gameId: string) => ipcRenderer.invoke("library:removeGame", gameId),
@@ -42,18 +42,31 @@ import type { Game } from "../../types/library";
 import type { GamelordAPI, VideoFrame } from "../types/global";
 import type { AVInfo } from "../../main/workers/core-worker-protocol";
 import {
-  CTRL_ACTIVE_BUFFER,
-  CTRL_FRAME_SEQUENCE,
-  CTRL_FRAME_WIDTH,
-  CTRL_FRAME_HEIGHT,
   CTRL_AUDIO_WRITE_POS,
   CTRL_AUDIO_READ_POS,
   CTRL_AUDIO_SAMPLE_RATE,
+  CTRL_AUDIO_FILL,
+  AUDIO_FILL_UNKNOWN,
+  VIDEO_SLOT_COUNT,
+  VideoSlotReader,
 } from "../../main/workers/shared-frame-protocol";
+import type { AudioRingProcessorOptions } from "../lib/audio/audio-ring-processor";
+import audioRingProcessorUrl from "../lib/audio/audio-ring-processor?worker&url";
+import { FrameTimingTracker } from "../lib/webgl/FrameTimingTracker";
+import { OffscreenRenderer, supportsOffscreenRendering } from "../lib/webgl/OffscreenRenderer";
 import { DevBranchBadge } from "./DevBranchBadge";
 import { EmulationErrorDialog } from "./EmulationErrorDialog";
 import { PowerAnimation } from "./animations";
 import { getDisplayType } from "../../types/displayType";
+import {
+  SCREEN_LAYOUT_LABELS,
+  type ScreenLayoutPreset,
+  composedAspectRatio,
+  isDualScreenSystem,
+  nextScreenLayoutPreset,
+  parseScreenLayoutPreset,
+  screenLayoutFor,
+} from "../../types/screenLayout";
 import { useGamepad } from "../hooks/useGamepad";
 import { useSfx } from "../hooks/useSfx";
 
@@ -120,9 +133,15 @@ export const GameWindow: React.FC = () => {
   });
   const [showShaderMenu, setShowShaderMenu] = useState(false);
   const [showSettingsMenu, setShowSettingsMenu] = useState(false);
+  // Dual-screen systems only (saved per-system when a game is loaded)
+  const [screenLayoutPreset, setScreenLayoutPreset] = useState<ScreenLayoutPreset>("original");
+  const [coreGeometry, setCoreGeometry] = useState<AVInfo["geometry"] | null>(null);
   const [showFps, setShowFps] = useState(() => {
     return localStorage.getItem("gamelord:showFps") === "true";
   });
+  const [perfHud, setPerfHud] = useState(() => {
+    return localStorage.getItem("gamelord:perfHud") === "true";
+  });
   const [showAgentation, setShowAgentation] = useState(() => {
     return localStorage.getItem("gamelord:showAgentation") === "true";
   });
@@ -135,6 +154,7 @@ export const GameWindow: React.FC = () => {
   const [isPoweringOn, setIsPoweringOn] = useState(false);
   const [isPoweringOff, setIsPoweringOff] = useState(false);
   const [emulationError, setEmulationError] = useState<string | null>(null);
+  const [scriptOverlay, setScriptOverlay] = useState("");
   const [speedMultiplier, setSpeedMultiplier] = useState(1);
   const [showSpeedMenu, setShowSpeedMenu] = useState(false);
   // The last fast-forward speed the user explicitly chose (persisted).
@@ -325,10 +345,13 @@ export const GameWindow: React.FC = () => {
 
   const canvasRef = useRef<HTMLCanvasElement>(null);
   const containerRef = useRef<HTMLDivElement>(null);
-  const rendererRef = useRef<WebGLRenderer | null>(null);
+  /** OffscreenRenderer once the canvas has been handed to the render worker. */
+  const rendererRef = useRef<WebGLRenderer | OffscreenRenderer | null>(null);
   const audioContextRef = useRef<AudioContext | null>(null);
   const audioNextTimeRef = useRef(0);
   const gainNodeRef = useRef<GainNode | null>(null);
+  /** Worklet playing the shared audio ring; "failed" falls back to drainAudioRing. */
+  const audioWorkletRef = useRef<AudioWorkletNode | "pending" | "failed" | null>(null);
   const pendingFrameRef = useRef<VideoFrame | null>(null);
   /** Gate: don't render frames until the boot animation overlay is in place. */
   const bootReadyRef = useRef(false);
@@ -341,7 +364,9 @@ export const GameWindow: React.FC = () => {
   const videoViewRef = useRef<Uint8Array | null>(null);
   const audioViewRef = useRef<Int16Array | null>(null);
   const videoBufferSizeRef = useRef(0);
-  const lastRenderedSeqRef = useRef(0);
+  const videoSlotsRef = useRef<VideoSlotReader | null>(null);
+  /** Latency/A/V offset of slot frames drawn here (the worker keeps its own). */
+  const frameTimingRef = useRef(new FrameTimingTracker());
   const useSharedBuffersRef = useRef(false);
 
   const [gameAspectRatio, setGameAspectRatio] = useState<number | null>(null);
@@ -401,10 +426,14 @@ export const GameWindow: React.FC = () => {
     const bufferW = Math.round(canvasW * devicePixelRatio);
     const bufferH = Math.round(canvasH * devicePixelRatio);
 
-    if (canvas.width !== bufferW || canvas.height !== bufferH) {
+    const renderer = rendererRef.current;
+    if (renderer instanceof OffscreenRenderer) {
+      // The worker owns the canvas size now; setting it here would throw.
+      renderer.resize(bufferW, bufferH);
+    } else if (canvas.width !== bufferW || canvas.height !== bufferH) {
       canvas.width = bufferW;
       canvas.height = bufferH;
-      rendererRef.current?.resize(bufferW, bufferH);
+      renderer?.resize(bufferW, bufferH);
     }
   }, [gameAspectRatio]);
 
@@ -415,7 +444,7 @@ export const GameWindow: React.FC = () => {
    * Schedule a chunk of interleaved stereo Int16 audio for playback.
    * Shared between the IPC fallback path and the SAB ring buffer drain.
    */
-  const scheduleAudioChunk = useCallback((samples: Int16Array, sampleRate: number) => {
+  const ensureAudioContext = useCallback((sampleRate: number): AudioContext => {
     if (!audioContextRef.current) {
       audioContextRef.current = new AudioContext({ sampleRate });
       audioNextTimeRef.current = 0;
@@ -423,8 +452,11 @@ export const GameWindow: React.FC = () => {
       gainNodeRef.current.gain.value = isMuted ? 0 : volume;
       gainNodeRef.current.connect(audioContextRef.current.destination);
     }
+    return audioContextRef.current;
+  }, []);
 
-    const ctx = audioContextRef.current;
+  const scheduleAudioChunk = useCallback((samples: Int16Array, sampleRate: number) => {
+    const ctx = ensureAudioContext(sampleRate);
     const frames = samples.length / 2;
     if (frames <= 0) {
       return;
@@ -460,7 +492,7 @@ export const GameWindow: React.FC = () => {
     }
     source.start(audioNextTimeRef.current);
     audioNextTimeRef.current += buffer.duration;
-  }, []);
+  }, [ensureAudioContext]);
 
   /** Drain audio samples from the SharedArrayBuffer ring buffer. */
   const drainAudioRing = useCallback(() => {
@@ -493,6 +525,44 @@ export const GameWindow: React.FC = () => {
     scheduleAudioChunk(samples, sampleRate);
   }, [scheduleAudioChunk]);
 
+  /**
+   * Start the AudioWorklet that consumes the shared ring on the audio
+   * thread. Until it is running (and if it fails to load), the rAF loop
+   * keeps draining the ring itself.
+   */
+  const startAudioWorklet = useCallback(
+    (control: SharedArrayBuffer, audio: SharedArrayBuffer) => {
+      const sampleRate = Atomics.load(new Int32Array(control), CTRL_AUDIO_SAMPLE_RATE);
+      const ctx = ensureAudioContext(sampleRate);
+      audioWorkletRef.current = "pending";
+      ctx.audioWorklet
+        .addModule(audioRingProcessorUrl)
+        .then(() => {
+          // Torn down (or replaced) while the module was loading.
+          if (audioContextRef.current !== ctx || audioWorkletRef.current !== "pending") {
+            return;
+          }
+          const processorOptions: AudioRingProcessorOptions = { audio, control };
+          const node = new AudioWorkletNode(ctx, "audio-ring", {
+            numberOfInputs: 0,
+            numberOfOutputs: 1,
+            outputChannelCount: [2],
+            processorOptions,
+          });
+          const gainNode = gainNodeRef.current;
+          if (gainNode) {
+            node.connect(gainNode);
+          }
+          audioWorkletRef.current = node;
+        })
+        .catch((error: unknown) => {
+          console.warn("Audio worklet unavailable, draining audio on the main thread:", error);
+          audioWorkletRef.current = "failed";
+        });
+    },
+    [ensureAudioContext],
+  );
+
   useEffect(() => {
     // Remove any stale listeners BEFORE registering new ones. This is
     // critical because React Strict Mode (dev) double-mounts components,
@@ -512,8 +582,110 @@ export const GameWindow: React.FC = () => {
     api.removeAllListeners("game:ready-for-boot");
     api.removeAllListeners("emulator:speedChanged");
     api.removeAllListeners("emulator:discChanged");
+    api.removeAllListeners("emulator:scriptOverlay");
     api.removeAllListeners("game:disc-info");
     api.removeAllListeners("game:emulation-error");
+
+    /**
+     * Create the renderer and start the rAF loop, once the boot animation
+     * overlay is in place. With shared buffers the canvas is transferred to
+     * the render worker, which draws straight from the video slots; the rAF
+     * loop then only measures FPS and drains audio. Otherwise frames are
+     * drawn here, from the slots or from the IPC fallback.
+     */
+    const startRenderer = () => {
+      const canvas = canvasRef.current;
+      if (rendererRef.current || !canvas || !bootReadyRef.current) {
+        return;
+      }
+      try {
+        // Set initial canvas size based on container
+        updateCanvasSizeRef.current();
+
+        const hdrMode = localStorage.getItem("gamelord:hdrMode") ?? "auto";
+        const hdrEnabled = hdrMode === "on" || (hdrMode === "auto" && isHdrCapable());
+        const savedShader = (localStorage.getItem("gamelord:shader") as string) || "default";
+        const control = controlViewRef.current;
+        const video = videoViewRef.current;
+        if (useSharedBuffersRef.current && control && video && supportsOffscreenRendering(canvas)) {
+          rendererRef.current = new OffscreenRenderer(canvas, {
+            control: control.buffer as SharedArrayBuffer,
+            hdr: hdrEnabled,
+            shader: savedShader,
+            video: video.buffer as SharedArrayBuffer,
+          });
+        } else {
+          const renderer = new WebGLRenderer(canvas, { hdr: hdrEnabled });
+          renderer.initialize();
+          renderer.setShader(savedShader);
+          rendererRef.current = renderer;
+        }
+
+        // Ensure canvas is properly sized after renderer is ready
+        requestAnimationFrame(() => updateCanvasSizeRef.current());
+
+        // Start the rAF render loop — draws the latest buffered frame
+        // each display vsync instead of rendering directly from IPC events.
+        // Also measures FPS via exponential moving average of frame deltas.
+        const renderLoop = (timestamp: number) => {
+          if (lastFrameTimeRef.current > 0) {
+            const delta = timestamp - lastFrameTimeRef.current;
+            if (delta > 0) {
+              const instantFps = 1000 / delta;
+              fpsEmaRef.current =
+                fpsEmaRef.current === 0 ? instantFps : 0.9 * fpsEmaRef.current + 0.1 * instantFps;
+              rafFrameCountRef.current++;
+              // Update React state every 30 frames (~500ms) to avoid re-render overhead
+              if (rafFrameCountRef.current % 30 === 0) {
+                setFps(Math.round(fpsEmaRef.current));
+              }
+            }
+          }
+          lastFrameTimeRef.current = timestamp;
+
+          const renderer = rendererRef.current;
+          if (useSharedBuffersRef.current && videoSlotsRef.current && videoViewRef.current) {
+            // Zero-copy path: claim the newest slot. The producer can't
+            // touch it until the next claim, so the upload never tears.
+            // The render worker is the slots' reader when it owns the canvas.
+            const slots = videoSlotsRef.current;
+            if (renderer instanceof WebGLRenderer && slots.acquire()) {
+              const { width, height } = slots;
+              const offset = slots.slot * videoBufferSizeRef.current;
+
+              // Uint8Array view into the claimed slot (zero-copy)
+              const frameData = new Uint8Array(
+                videoViewRef.current.buffer,
+                offset,
+                width * height * 4,
+              );
+
+              renderer.renderFrame({ data: frameData, width, height });
+              if (controlViewRef.current) {
+                frameTimingRef.current.record(controlViewRef.current, slots.timeline);
+              }
+            }
+
+            // The worklet reads the ring on the audio thread once running
+            if (!(audioWorkletRef.current instanceof AudioWorkletNode)) {
+              drainAudioRing();
+            }
+          } else {
+            // Fallback: render from IPC-buffered frame
+            const frame = pendingFrameRef.current;
+            if (frame && renderer instanceof WebGLRenderer) {
+              pendingFrameRef.current = null;
+              renderer.renderFrame(frame);
+            }
+          }
+          rafIdRef.current = requestAnimationFrame(renderLoop);
+        };
+        rafIdRef.current = requestAnimationFrame(renderLoop);
+      } catch (error) {
+        console.error("Failed to initialize WebGL renderer:", error);
+      }
+    };
+
     // Register for SharedArrayBuffer delivery via MessagePort bridge.
     // The main process sends SABs through a MessagePort because contextBridge
     // cannot transfer SharedArrayBuffer directly.
@@ -528,9 +700,12 @@ export const GameWindow: React.FC = () => {
         controlViewRef.current = new Int32Array(msg.control);
         videoViewRef.current = new Uint8Array(msg.video);
         audioViewRef.current = new Int16Array(msg.audio);
-        videoBufferSizeRef.current = msg.video.byteLength / 2; // each buffer is half
-        lastRenderedSeqRef.current = 0;
+        videoBufferSizeRef.current = msg.video.byteLength / VIDEO_SLOT_COUNT;
+        videoSlotsRef.current = new VideoSlotReader(controlViewRef.current);
         useSharedBuffersRef.current = true;
+        startAudioWorklet(msg.control, msg.audio);
+        // Shared-buffer frames never arrive over IPC, so nothing else starts it.
+        startRenderer();
       }
     });
 
@@ -543,18 +718,29 @@ export const GameWindow: React.FC = () => {
       if (systemShader) {
         setShader(systemShader);
       }
+      if (isDualScreenSystem(gameData.systemId)) {
+        setScreenLayoutPreset(
+          parseScreenLayoutPreset(
+            localStorage.getItem(`gamelord:screenLayout:${gameData.systemId}`),
+          ),
+        );
+      }
 
       // Send initial fast-forward audio preference to the worker.
       // Fire-and-forget — the worker may not be ready yet, in which case
       // EmulatorManager silently ignores the call.
       const ffAudio = localStorage.getItem("gamelord:fastForwardAudio") === "true";
       void api.emulation.setFastForwardAudio(ffAudio);
+      void api.emulation.setPerfHud(localStorage.getItem("gamelord:perfHud") === "true");
     });
 
     // Sent by the main process after the hero transition animation completes
     // (or immediately if there is no hero transition).
     api.on("game:ready-for-boot", () => {
       bootReadyRef.current = true;
+      if (useSharedBuffersRef.current) {
+        startRenderer();
+      }
       setIsPoweringOn(true);
       playSfxRef.current("powerOn");
     });
@@ -590,6 +776,8 @@ export const GameWindow: React.FC = () => {
       setShowDiscSwapOverlay(false);
     });
 
+    api.on("emulator:scriptOverlay", (text: unknown) => setScriptOverlay(text as string));
+
     api.on("game:disc-info", (raw: unknown) => {
       const data = raw as {
         total: number;
@@ -620,7 +808,7 @@ export const GameWindow: React.FC = () => {
     api.on("game:av-info", (raw: unknown) => {
       const avInfo = raw as AVInfo;
       const canvas = canvasRef.current;
-      if (canvas) {
+      if (canvas && !(rendererRef.current instanceof OffscreenRenderer)) {
         canvas.width = avInfo.geometry.baseWidth;
         canvas.height = avInfo.geometry.baseHeight;
       }
@@ -632,6 +820,7 @@ export const GameWindow: React.FC = () => {
           ? 4 / 3
           : avInfo.geometry.baseWidth / avInfo.geometry.baseHeight;
       setGameAspectRatio(coreAR > 0 ? coreAR : fallbackAR);
+      setCoreGeometry(avInfo.geometry);
     });
 
     api.on("game:video-frame", (raw: unknown) => {
@@ -642,93 +831,7 @@ export const GameWindow: React.FC = () => {
       // before the CRT/LCD power-on animation starts.
       pendingFrameRef.current = frameData;
 
-      const canvas = canvasRef.current;
-      if (!canvas || !bootReadyRef.current) {
-        return;
-      }
-
-      // Initialize WebGL renderer on first frame after boot is ready
-      if (!rendererRef.current) {
-        try {
-          // Set initial canvas size based on container
-          updateCanvasSizeRef.current();
-
-          const hdrMode = localStorage.getItem("gamelord:hdrMode") ?? "auto";
-          const hdrEnabled = hdrMode === "on" || (hdrMode === "auto" && isHdrCapable());
-          const renderer = new WebGLRenderer(canvas, { hdr: hdrEnabled });
-          renderer.initialize();
-          const savedShader = (localStorage.getItem("gamelord:shader") as string) || "default";
-          renderer.setShader(savedShader);
-          rendererRef.current = renderer;
-
-          // Ensure canvas is properly sized after renderer is ready
-          requestAnimationFrame(() => updateCanvasSizeRef.current());
-
-          // Start the rAF render loop — draws the latest buffered frame
-          // each display vsync instead of rendering directly from IPC events.
-          // Also measures FPS via exponential moving average of frame deltas.
-          const renderLoop = (timestamp: number) => {
-            if (lastFrameTimeRef.current > 0) {
-              const delta = timestamp - lastFrameTimeRef.current;
-              if (delta > 0) {
-                const instantFps = 1000 / delta;
-                fpsEmaRef.current =
-                  fpsEmaRef.current === 0 ? instantFps : 0.9 * fpsEmaRef.current + 0.1 * instantFps;
-                rafFrameCountRef.current++;
-                // Update React state every 30 frames (~500ms) to avoid re-render overhead
-                if (rafFrameCountRef.current % 30 === 0) {
-                  setFps(Math.round(fpsEmaRef.current));
-                }
-              }
-            }
-            lastFrameTimeRef.current = timestamp;
-
-            if (
-              useSharedBuffersRef.current &&
-              controlViewRef.current &&
-              videoViewRef.current &&
-              rendererRef.current
-            ) {
-              // Zero-copy path: read directly from SharedArrayBuffer
-              const ctrl = controlViewRef.current;
-              const seq = Atomics.load(ctrl, CTRL_FRAME_SEQUENCE);
-
-              if (seq !== lastRenderedSeqRef.current) {
-                lastRenderedSeqRef.current = seq;
-                const activeBuffer = Atomics.load(ctrl, CTRL_ACTIVE_BUFFER);
-                const width = Atomics.load(ctrl, CTRL_FRAME_WIDTH);
-                const height = Atomics.load(ctrl, CTRL_FRAME_HEIGHT);
-                const bufSize = videoBufferSizeRef.current;
-                const offset = activeBuffer * bufSize;
-
-                // Uint8Array view into the active buffer region (zero-copy)
-                const frameData = new Uint8Array(
-                  videoViewRef.current.buffer,
-                  offset,
-                  width * height * 4,
-                );
-
-                rendererRef.current.renderFrame({ data: frameData, width, height });
-              }
-
-              // Drain audio from the ring buffer
-              drainAudioRing();
-            } else {
-              // Fallback: render from IPC-buffered frame
-              const frame = pendingFrameRef.current;
-              if (frame && rendererRef.current) {
-                pendingFrameRef.current = null;
-                rendererRef.current.renderFrame(frame);
-              }
-            }
-            rafIdRef.current = requestAnimationFrame(renderLoop);
-          };
-          rafIdRef.current = requestAnimationFrame(renderLoop);
-        } catch (error) {
-          console.error("Failed to initialize WebGL renderer:", error);
-          return;
-        }
-      }
+      startRenderer();
     });
 
     // IPC fallback audio path — used when SharedArrayBuffer is unavailable.
@@ -765,13 +868,21 @@ export const GameWindow: React.FC = () => {
       pendingFrameRef.current = null;
       bootReadyRef.current = false;
 
-      // Reset SAB state so a fresh init can re-establish the connection
+      // Reset SAB state so a fresh init can re-establish the connection.
+      // The worker stops rate control once nothing reports the fill.
+      if (audioWorkletRef.current instanceof AudioWorkletNode) {
+        audioWorkletRef.current.disconnect();
+      }
+      audioWorkletRef.current = null;
+      if (controlViewRef.current) {
+        Atomics.store(controlViewRef.current, CTRL_AUDIO_FILL, AUDIO_FILL_UNKNOWN);
+      }
       useSharedBuffersRef.current = false;
       controlViewRef.current = null;
       videoViewRef.current = null;
       audioViewRef.current = null;
       videoBufferSizeRef.current = 0;
-      lastRenderedSeqRef.current = 0;
+      videoSlotsRef.current = null;
 
       rendererRef.current?.destroy();
       rendererRef.current = null;
@@ -824,6 +935,51 @@ export const GameWindow: React.FC = () => {
     }
   }, [shader, game]);
 
+  // Apply the screen layout for dual-screen systems. The addon composes it
+  // into each frame; the canvas only needs the composed aspect ratio.
+  useEffect(() => {
+    if (!game || !coreGeometry || !isDualScreenSystem(game.systemId)) {
+      return;
+    }
+    localStorage.setItem(`gamelord:screenLayout:${game.systemId}`, screenLayoutPreset);
+    let cancelled = false;
+    api.emulation
+      .setScreenLayout(screenLayoutFor(screenLayoutPreset))
+      .then((result) => {
+        if (!cancelled && result.success && result.width && result.height) {
+          setGameAspectRatio(composedAspectRatio(result.width, result.height, coreGeometry));
+        }
+      })
+      .catch(console.error);
+    return () => {
+      cancelled = true;
+    };
+  }, [api, game, coreGeometry, screenLayoutPreset]);
+
+  // Touch input for dual-screen systems, normalized over the canvas (which
+  // is sized to the frame's aspect ratio, so there is no letterboxing).
+  const handleCanvasPointer = useCallback(
+    (event: React.PointerEvent<HTMLCanvasElement>) => {
+      if (!game || !isDualScreenSystem(game.systemId)) {
+        return;
+      }
+      const pressed = (event.buttons & 1) !== 0;
+      if (event.type === "pointermove" && !pressed) {
+        return;
+      }
+      if (event.type === "pointerdown") {
+        event.currentTarget.setPointerCapture(event.pointerId);
+      }
+      const rect = event.currentTarget.getBoundingClientRect();
+      api.gamePointer(
+        (event.clientX - rect.left) / rect.width,
+        (event.clientY - rect.top) / rect.height,
+        pressed,
+      );
+    },
+    [api, game],
+  );
+
   // Sync gain node with volume/mute state and persist.
   // During fast-forward, multiple frames' audio samples overlap additively —
   // divide gain by the speed multiplier to normalize perceived volume.
@@ -841,6 +997,12 @@ export const GameWindow: React.FC = () => {
     localStorage.setItem("gamelord:showFps", String(showFps));
   }, [showFps]);
 
+  // Persist and apply the native performance HUD (drawn into the frames)
+  useEffect(() => {
+    localStorage.setItem("gamelord:perfHud", String(perfHud));
+    void api.emulation.setPerfHud(perfHud);
+  }, [api, perfHud]);
+
   // Toggle Agentation toolbar visibility via body class (portal renders to body)
   useEffect(() => {
     localStorage.setItem("gamelord:showAgentation", String(showAgentation));
@@ -1223,6 +1385,10 @@ export const GameWindow: React.FC = () => {
         <div ref={containerRef} className="absolute inset-0 flex items-center justify-center">
           <canvas
             ref={canvasRef}
+            onPointerDown={handleCanvasPointer}
+            onPointerMove={handleCanvasPointer}
+            onPointerUp={handleCanvasPointer}
+            onPointerCancel={handleCanvasPointer}
             style={{
               imageRendering: shader === "default" ? "pixelated" : "auto",
             }}
@@ -1239,6 +1405,13 @@ export const GameWindow: React.FC = () => {
         </div>
       )}
 
+      {/* Text drawn by a frame script */}
+      {isNative && scriptOverlay && (
+        <div className="absolute bottom-2 left-2 z-40 px-2 py-1 bg-black/60 rounded text-xs font-mono text-white whitespace-pre pointer-events-none select-none">
+          {scriptOverlay}
+        </div>
+      )}
+
       {/* HDR toggle flash */}
       {hdrFlash && (
         <div className="absolute top-1/2 left-1/2 -translate-x-1/2 -translate-y-1/2 z-50 px-4 py-2 bg-black/80 rounded-lg text-sm font-medium text-white pointer-events-none select-none animate-overlay-fade-in">
@@ -1603,6 +1776,20 @@ export const GameWindow: React.FC = () => {
                       <span className="text-xs text-white/30">F6</span>
                     </button>
                   )}
+                  {game && isDualScreenSystem(game.systemId) && (
+                    <button
+                      onClick={() => {
+                        playSfx("click");
+                        setScreenLayoutPreset(nextScreenLayoutPreset);
+                      }}
+                      className="w-full flex items-center justify-between px-4 py-2 text-sm text-white/80 hover:bg-white/10 transition-colors"
+                    >
+                      <span>Screen Layout</span>
+                      <span className="ml-3 text-xs font-medium text-white/40">
+                        {SCREEN_LAYOUT_LABELS[screenLayoutPreset]}
+                      </span>
+                    </button>
+                  )}
                   <div className="border-t border-white/10 my-1" />
                   <button
                     onClick={() => {
@@ -1618,14 +1805,35 @@ export const GameWindow: React.FC = () => {
                       {showFps ? "ON" : "OFF"}
                     </span>
                   </button>
+                  <button
+                    onClick={() => {
+                      playSfx(perfHud ? "toggleOff" : "toggleOn");
+                      setPerfHud((v) => !v);
+                    }}
+                    className="w-full flex items-center justify-between px-4 py-2 text-sm text-white/80 hover:bg-white/10 transition-colors"
+                  >
+                    <span>Performance HUD</span>
+                    <span
+                      className={`ml-3 text-xs font-medium ${perfHud ? "text-green-400" : "text-white/40"}`}
+                    >
+                      {perfHud ? "ON" : "OFF"}
+                    </span>
+                  </button>
                   <button
                     onClick={() => {
                       const next = !hdrEnabled;
                       playSfx(next ? "toggleOn" : "toggleOff");
                       setHdrEnabled(next);
                       localStorage.setItem("gamelord:hdrMode", next ? "on" : "off");
+                      // Show brief status flash confirming actual HDR state
+                      const flashHdr = (active: boolean) => {
+                        setHdrFlash(active ? "HDR Active" : next ? "HDR Unavailable" : "HDR Off");
+                        setTimeout(() => setHdrFlash(null), 1500);
+                      };
                       // Recreate the renderer with the new HDR setting
-                      if (rendererRef.current) {
+                      if (rendererRef.current instanceof OffscreenRenderer) {
+                        void rendererRef.current.setHdr(next).then(flashHdr);
+                      } else if (rendererRef.current) {
                         const currentShader = rendererRef.current.getShader();
                         rendererRef.current.destroy();
                         rendererRef.current = null;
@@ -1635,10 +1843,7 @@ export const GameWindow: React.FC = () => {
                           renderer.initialize();
                           renderer.setShader(currentShader);
                           rendererRef.current = renderer;
-                          // Show brief status flash confirming actual HDR state
-                          const active = renderer.isHdrActive;
-                          setHdrFlash(active ? "HDR Active" : next ? "HDR Unavailable" : "HDR Off");
-                          setTimeout(() => setHdrFlash(null), 1500);
+                          flashHdr(renderer.isHdrActive);
                         }
                       }
                     }}
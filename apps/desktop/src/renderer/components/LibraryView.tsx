@@ -110,6 +110,9 @@ export const LibraryView: React.FC<{
     return () => window.removeEventListener("keydown", handleKeyDown);
   }, [commandPaletteOpen]);
 
+  // Title search runs against the main process's native index when available.
+  const searchGames = useCallback((query: string) => api.library.searchGames(query), [api]);
+
   const handleCommandPaletteOpenChange = useCallback((open: boolean) => {
     playSfxRef.current(open ? "dialogOpen" : "dialogClose");
     setCommandPaletteOpen(open);
@@ -187,6 +190,11 @@ export const LibraryView: React.FC<{
       loadLibrary();
     });
 
+    // ROM folders changed on disk (library watcher) — pick up adds/removals
+    api.on("library:changed", () => {
+      loadLibrary();
+    });
+
     api.on("library:scanProgress", (raw: unknown) => {
       const progress = raw as {
         game: AppGame;
@@ -355,6 +363,7 @@ export const LibraryView: React.FC<{
 
     return () => {
       api.removeAllListeners("library:scanProgress");
+      api.removeAllListeners("library:changed");
       api.removeAllListeners("library:homebrewImported");
       api.removeAllListeners("core:downloadProgress");
       api.removeAllListeners("artwork:progress");
@@ -941,6 +950,7 @@ export const LibraryView: React.FC<{
             artworkSyncStore={artworkSyncStore}
             launchingGameId={launchingGameId}
             scrollContainerRef={scrollContainerRef}
+            searchGames={searchGames}
             onReady={handleGridReady}
             isRevealing={isRevealing}
           />
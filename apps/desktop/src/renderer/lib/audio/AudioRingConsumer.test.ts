@@ -0,0 +1,88 @@
+import { describe, it, expect, beforeEach } from "vitest";
+import { AudioRingConsumer } from "./AudioRingConsumer";
+import {
+  CTRL_AUDIO_FILL,
+  CTRL_AUDIO_READ_POS,
+  CTRL_AUDIO_WRITE_POS,
+  CTRL_SAB_BYTE_LENGTH,
+} from "../../../main/workers/shared-frame-protocol";
+
+const RING_SAMPLES = 1024;
+const TARGET_FILL = 256;
+const QUANTUM = 128;
+
+let ctrl: Int32Array;
+let ring: Int16Array;
+let consumer: AudioRingConsumer;
+
+/** Append `frames` stereo frames of a constant value, like core-worker does. */
+function produce(frames: number, value = 16_384): void {
+  let writePos = Atomics.load(ctrl, CTRL_AUDIO_WRITE_POS);
+  for (let i = 0; i < frames * 2; i++) {
+    ring[writePos & (RING_SAMPLES - 1)] = value;
+    writePos++;
+  }
+  Atomics.store(ctrl, CTRL_AUDIO_WRITE_POS, writePos);
+}
+
+function consume(): { left: Float32Array; right: Float32Array } {
+  const left = new Float32Array(QUANTUM);
+  const right = new Float32Array(QUANTUM);
+  consumer.read(left, right);
+  return { left, right };
+}
+
+describe("AudioRingConsumer", () => {
+  beforeEach(() => {
+    ctrl = new Int32Array(new SharedArrayBuffer(CTRL_SAB_BYTE_LENGTH));
+    ring = new Int16Array(new SharedArrayBuffer(RING_SAMPLES * 2));
+    consumer = new AudioRingConsumer(ctrl, ring, TARGET_FILL);
+  });
+
+  it("stays silent until the ring is primed to the target fill", () => {
+    produce(TARGET_FILL / 2 - 1);
+    const { left } = consume();
+    expect(left.every((sample) => sample === 0)).toBe(true);
+    expect(Atomics.load(ctrl, CTRL_AUDIO_READ_POS)).toBe(0);
+  });
+
+  it("plays primed audio, fading in, and publishes the remaining fill", () => {
+    produce(TARGET_FILL);
+    const { left, right } = consume();
+    expect(left[0]).toBeGreaterThan(0);
+    expect(left[0]).toBeLessThan(0.5);
+    expect(left[QUANTUM - 1]).toBeCloseTo(0.5);
+    expect(right[QUANTUM - 1]).toBeCloseTo(0.5);
+    expect(Atomics.load(ctrl, CTRL_AUDIO_READ_POS)).toBe(QUANTUM * 2);
+    expect(Atomics.load(ctrl, CTRL_AUDIO_FILL)).toBe(TARGET_FILL * 2 - QUANTUM * 2);
+  });
+
+  it("conceals an underrun by fading out the last sample", () => {
+    produce(TARGET_FILL);
+    consume();
+    consume();
+    const { left } = consume(); // ring is empty now
+    expect(consumer.underruns).toBe(1);
+    expect(left[0]).toBeGreaterThan(0);
+    expect(left[0]).toBeLessThan(0.5);
+    expect(left[QUANTUM - 1]).toBe(0);
+    expect(Atomics.load(ctrl, CTRL_AUDIO_FILL)).toBe(0);
+  });
+
+  it("drops the oldest audio when the backlog grows too large", () => {
+    produce(RING_SAMPLES / 2 - 1);
+    consume();
+    const fill = Atomics.load(ctrl, CTRL_AUDIO_FILL);
+    expect(fill).toBe(TARGET_FILL - QUANTUM * 2);
+  });
+
+  it("handles Int32 position wrap-around", () => {
+    const start = 2_147_483_647 - 100;
+    Atomics.store(ctrl, CTRL_AUDIO_WRITE_POS, start);
+    Atomics.store(ctrl, CTRL_AUDIO_READ_POS, start);
+    produce(TARGET_FILL);
+    const { left } = consume();
+    expect(left[QUANTUM - 1]).toBeCloseTo(0.5);
+    expect(Atomics.load(ctrl, CTRL_AUDIO_FILL)).toBe(TARGET_FILL * 2 - QUANTUM * 2);
+  });
+});
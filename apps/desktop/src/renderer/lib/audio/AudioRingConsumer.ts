@@ -0,0 +1,96 @@
+import {
+  AUDIO_TARGET_FILL_SAMPLES,
+  CTRL_AUDIO_FILL,
+  CTRL_AUDIO_READ_POS,
+  CTRL_AUDIO_WRITE_POS,
+} from "../../../main/workers/shared-frame-protocol";
+
+/** Frames over which playback fades out on an underrun and back in after. */
+const FADE_FRAMES = 64;
+
+/**
+ * Backlog, in multiples of the target fill, beyond which the oldest audio
+ * is dropped (fast-forward bursts, a producer that briefly outran us).
+ */
+const MAX_BACKLOG_FACTOR = 3;
+
+/**
+ * Reads interleaved stereo Int16 audio out of the shared SPSC ring (see
+ * shared-frame-protocol) one render quantum at a time.
+ *
+ * Playback starts once the ring holds `targetFill` samples. On an underrun
+ * the last sample is faded out instead of cutting to silence, then playback
+ * re-primes to half the target and fades back in, which hides short gaps
+ * without clicks. After every read the remaining fill is published to
+ * CTRL_AUDIO_FILL for the producer's rate control.
+ *
+ * Kept free of AudioWorklet globals so it can be tested directly; the
+ * worklet wrapper is audio-ring-processor.ts.
+ */
+export class AudioRingConsumer {
+  /** Underruns since construction. */
+  underruns = 0;
+
+  private primed = false;
+  private primeThreshold: number;
+  private envelope = 0;
+  private lastLeft = 0;
+  private lastRight = 0;
+
+  constructor(
+    private readonly control: Int32Array,
+    private readonly ring: Int16Array,
+    private readonly targetFill: number = AUDIO_TARGET_FILL_SAMPLES,
+  ) {
+    this.primeThreshold = targetFill;
+  }
+
+  /** Fill both channels (equal length) from the ring. */
+  read(left: Float32Array, right: Float32Array): void {
+    const ctrl = this.control;
+    const ring = this.ring;
+    const mask = ring.length - 1; // AUDIO_RING_SAMPLES is a power of 2
+
+    const writePos = Atomics.load(ctrl, CTRL_AUDIO_WRITE_POS);
+    let readPos = Atomics.load(ctrl, CTRL_AUDIO_READ_POS);
+    // Positions are Int32 and wrap after a few hours; `| 0` keeps the
+    // difference correct across the wrap, and `& mask` indexes correctly.
+    let available = (writePos - readPos) | 0;
+
+    if (available < 0 || available > Math.min(ring.length, this.targetFill * MAX_BACKLOG_FACTOR)) {
+      readPos = (writePos - this.targetFill) | 0;
+      available = this.targetFill;
+    }
+
+    if (!this.primed && available >= this.primeThreshold) {
+      this.primed = true;
+    }
+
+    const frames = left.length;
+    const playable = this.primed ? Math.min(frames, available >> 1) : 0;
+    for (let i = 0; i < playable; i++) {
+      this.envelope = Math.min(1, this.envelope + 1 / FADE_FRAMES);
+      this.lastLeft = ring[readPos & mask] / 32_768;
+      this.lastRight = ring[(readPos + 1) & mask] / 32_768;
+      readPos = (readPos + 2) | 0;
+      left[i] = this.lastLeft * this.envelope;
+      right[i] = this.lastRight * this.envelope;
+    }
+
+    if (playable < frames) {
+      if (this.primed) {
+        this.underruns++;
+        this.primed = false;
+        this.primeThreshold = this.targetFill >> 1;
+      }
+      for (let i = playable; i < frames; i++) {
+        this.envelope = Math.max(0, this.envelope - 1 / FADE_FRAMES);
+        left[i] = this.lastLeft * this.envelope;
+        right[i] = this.lastRight * this.envelope;
+      }
+    }
+
+    Atomics.store(ctrl, CTRL_AUDIO_READ_POS, readPos);
+    Atomics.store(ctrl, CTRL_AUDIO_FILL, (writePos - readPos) | 0);
+  }
+}
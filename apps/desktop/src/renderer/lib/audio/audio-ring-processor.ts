@@ -0,0 +1,38 @@
+/**
+ * AudioWorklet processor that plays the emulator's shared audio ring on the
+ * audio rendering thread, so main-thread hitches (React renders, GC) no
+ * longer turn into gaps. GameWindow loads it via `?worker&url`.
+ */
+import { AudioRingConsumer } from "./AudioRingConsumer";
+
+// AudioWorkletGlobalScope is not part of the DOM lib.
+declare class AudioWorkletProcessor {
+  readonly port: MessagePort;
+}
+declare function registerProcessor(
+  name: string,
+  processor: new (options: AudioWorkletNodeOptions) => AudioWorkletProcessor,
+): void;
+
+export interface AudioRingProcessorOptions {
+  control: SharedArrayBuffer;
+  audio: SharedArrayBuffer;
+}
+
+class AudioRingProcessor extends AudioWorkletProcessor {
+  private readonly consumer: AudioRingConsumer;
+
+  constructor(options: AudioWorkletNodeOptions) {
+    super();
+    const { audio, control } = options.processorOptions as AudioRingProcessorOptions;
+    this.consumer = new AudioRingConsumer(new Int32Array(control), new Int16Array(audio));
+  }
+
+  process(_inputs: Array<Array<Float32Array>>, outputs: Array<Array<Float32Array>>): boolean {
+    const [left, right] = outputs[0];
+    this.consumer.read(left, right);
+    return true;
+  }
+}
+
+registerProcessor("audio-ring", AudioRingProcessor);
@@ -0,0 +1,51 @@
+import { describe, it, expect, beforeEach } from "vitest";
+import { FrameTimingTracker } from "./FrameTimingTracker";
+import {
+  CTRL_AUDIO_READ_POS,
+  CTRL_AUDIO_SAMPLE_RATE,
+  CTRL_SAB_BYTE_LENGTH,
+} from "../../../main/workers/shared-frame-protocol";
+
+function timeline(frameNumber: number, runStartedAt: number, audioWritePos: number) {
+  return {
+    audioWritePos,
+    emulatedTimeMs: (frameNumber * 1000) / 60,
+    frameNumber,
+    publishedAt: runStartedAt + 2,
+    runStartedAt,
+  };
+}
+
+describe("FrameTimingTracker", () => {
+  let ctrl: Int32Array;
+  let tracker: FrameTimingTracker;
+
+  beforeEach(() => {
+    ctrl = new Int32Array(new SharedArrayBuffer(CTRL_SAB_BYTE_LENGTH));
+    tracker = new FrameTimingTracker();
+  });
+
+  it("starts from the first sample", () => {
+    Atomics.store(ctrl, CTRL_AUDIO_SAMPLE_RATE, 48_000);
+    tracker.record(ctrl, timeline(1, 1000, 9600), 1020);
+    expect(tracker.summary).toEqual({ avOffsetMs: 100, frameNumber: 1, latencyMs: 20 });
+  });
+
+  it("smooths later samples", () => {
+    Atomics.store(ctrl, CTRL_AUDIO_SAMPLE_RATE, 48_000);
+    tracker.record(ctrl, timeline(1, 1000, 9600), 1020);
+    Atomics.store(ctrl, CTRL_AUDIO_READ_POS, 9600);
+    tracker.record(ctrl, timeline(2, 1016, 9600), 1046);
+
+    const { avOffsetMs, frameNumber, latencyMs } = tracker.summary;
+    expect(latencyMs).toBeCloseTo(21);
+    expect(avOffsetMs).toBeCloseTo(90);
+    expect(frameNumber).toBe(2);
+    expect(tracker.count).toBe(2);
+  });
+
+  it("has no A/V offset until the sample rate is known", () => {
+    tracker.record(ctrl, timeline(1, 1000, 0), 1010);
+    expect(tracker.summary.avOffsetMs).toBe(null);
+  });
+});
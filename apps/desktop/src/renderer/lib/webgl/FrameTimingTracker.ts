@@ -0,0 +1,60 @@
+import {
+  frameSyncStats,
+  hostNowMs,
+  type FrameTimeline,
+} from "../../../main/workers/shared-frame-protocol";
+
+/** Smoothing factor for the moving averages (matches the FPS counter). */
+const EMA_ALPHA = 0.1;
+
+export interface FrameTimingSummary {
+  /** Smoothed time from retro_run starting to the frame being drawn. */
+  latencyMs: number;
+  /** Smoothed A/V offset; positive means sound trails picture. */
+  avOffsetMs: number | null;
+  /** Core frame number of the last frame drawn. */
+  frameNumber: number;
+}
+
+/**
+ * Folds the timelines of presented frames into smoothed presentation
+ * latency and A/V offset (see frameSyncStats). Fed by whichever side draws
+ * the shared video slots.
+ */
+export class FrameTimingTracker {
+  private latencyMs = 0;
+  private avOffsetMs: number | null = null;
+  private frameNumber = 0;
+  private samples = 0;
+
+  record(ctrl: Int32Array, timeline: FrameTimeline, presentedAt: number = hostNowMs()): void {
+    const stats = frameSyncStats(ctrl, timeline, presentedAt);
+    const first = this.samples === 0;
+    this.latencyMs = first
+      ? stats.latencyMs
+      : this.latencyMs + EMA_ALPHA * (stats.latencyMs - this.latencyMs);
+    if (stats.avOffsetMs === null) {
+      this.avOffsetMs = null;
+    } else {
+      this.avOffsetMs =
+        this.avOffsetMs === null
+          ? stats.avOffsetMs
+          : this.avOffsetMs + EMA_ALPHA * (stats.avOffsetMs - this.avOffsetMs);
+    }
+    this.frameNumber = timeline.frameNumber;
+    this.samples++;
+  }
+
+  /** Frames recorded so far. */
+  get count(): number {
+    return this.samples;
+  }
+
+  get summary(): FrameTimingSummary {
+    return {
+      avOffsetMs: this.avOffsetMs,
+      frameNumber: this.frameNumber,
+      latencyMs: this.latencyMs,
+    };
+  }
+}
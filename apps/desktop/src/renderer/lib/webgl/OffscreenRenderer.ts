@@ -0,0 +1,116 @@
+import type { FrameTimingSummary } from "./FrameTimingTracker";
+import type { RenderWorkerCommand, RenderWorkerEvent } from "./render-worker";
+import RenderWorker from "./render-worker?worker";
+
+export interface OffscreenRendererOptions {
+  control: SharedArrayBuffer;
+  video: SharedArrayBuffer;
+  hdr: boolean;
+  shader: string;
+}
+
+/** Whether this canvas can be handed to the render worker. */
+export function supportsOffscreenRendering(canvas: HTMLCanvasElement): boolean {
+  return (
+    typeof canvas.transferControlToOffscreen === "function" &&
+    typeof Atomics.waitAsync === "function"
+  );
+}
+
+/**
+ * Main-thread handle to render-worker.ts, with the subset of WebGLRenderer's
+ * surface GameWindow uses. The canvas is transferred to the worker on
+ * construction, after which its size can only be changed through `resize`.
+ */
+export class OffscreenRenderer {
+  private worker: Worker;
+  private shader: string;
+  private width: number;
+  private height: number;
+  private hdrActive = false;
+  private lastTiming: FrameTimingSummary | null = null;
+  private pendingHdr: Array<(active: boolean) => void> = [];
+
+  constructor(canvas: HTMLCanvasElement, options: OffscreenRendererOptions) {
+    this.shader = options.shader;
+    this.width = canvas.width;
+    this.height = canvas.height;
+
+    const offscreen = canvas.transferControlToOffscreen();
+    this.worker = new RenderWorker({ name: "render" });
+    this.worker.onmessage = (event: MessageEvent<RenderWorkerEvent>) => {
+      const msg = event.data;
+      if (msg.type === "error") {
+        console.error("Render worker failed:", msg.message);
+        return;
+      }
+      if (msg.type === "timing") {
+        this.lastTiming = msg.timing;
+        return;
+      }
+      this.hdrActive = msg.hdrActive;
+      if (msg.type === "hdr") {
+        this.pendingHdr.shift()?.(msg.hdrActive);
+      }
+    };
+    this.post(
+      {
+        canvas: offscreen,
+        control: options.control,
+        hdr: options.hdr,
+        shader: options.shader,
+        type: "init",
+        video: options.video,
+      },
+      [offscreen],
+    );
+  }
+
+  resize(width: number, height: number): void {
+    if (width === this.width && height === this.height) {
+      return;
+    }
+    this.width = width;
+    this.height = height;
+    this.post({ height, type: "resize", width });
+  }
+
+  setShader(shader: string): void {
+    this.shader = shader;
+    this.post({ shader, type: "setShader" });
+  }
+
+  getShader(): string {
+    return this.shader;
+  }
+
+  /** Rebuild the worker's renderer with HDR on or off; resolves to whether HDR took. */
+  setHdr(enabled: boolean): Promise<boolean> {
+    return new Promise((resolve) => {
+      this.pendingHdr.push(resolve);
+      this.post({ enabled, type: "setHdr" });
+    });
+  }
+
+  /** Presentation latency and A/V offset last reported by the worker. */
+  get timing(): FrameTimingSummary | null {
+    return this.lastTiming;
+  }
+
+  /** HDR state last reported by the worker. */
+  get isHdrActive(): boolean {
+    return this.hdrActive;
+  }
+
+  destroy(): void {
+    this.post({ type: "destroy" });
+    for (const resolve of this.pendingHdr) {
+      resolve(false);
+    }
+    this.pendingHdr = [];
+  }
+
+  private post(command: RenderWorkerCommand, transfer: Array<Transferable> = []): void {
+    this.worker.postMessage(command, transfer);
+  }
+}
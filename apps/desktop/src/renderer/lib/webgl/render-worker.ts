@@ -0,0 +1,143 @@
+/**
+ * Dedicated worker that owns the game canvas (transferred as an
+ * OffscreenCanvas) and its WebGL2 context, and draws frames straight out of
+ * the shared video slots. It parks in `Atomics.waitAsync` on the frame
+ * sequence between frames, so uploads and shader passes happen as soon as
+ * the emulator publishes, independent of main-thread React work.
+ * GameWindow drives it through OffscreenRenderer.
+ */
+import { WebGLRenderer } from "@gamelord/ui/webgl/WebGLRenderer";
+import {
+  CTRL_FRAME_SEQUENCE,
+  VIDEO_SLOT_COUNT,
+  VideoSlotReader,
+} from "../../../main/workers/shared-frame-protocol";
+import { FrameTimingTracker, type FrameTimingSummary } from "./FrameTimingTracker";
+
+/** Frames between timing reports to the main thread (~0.5s at 60fps). */
+const TIMING_REPORT_INTERVAL = 30;
+
+export type RenderWorkerCommand =
+  | {
+      type: "init";
+      canvas: OffscreenCanvas;
+      control: SharedArrayBuffer;
+      video: SharedArrayBuffer;
+      hdr: boolean;
+      shader: string;
+    }
+  | { type: "resize"; width: number; height: number }
+  | { type: "setShader"; shader: string }
+  | { type: "setHdr"; enabled: boolean }
+  | { type: "destroy" };
+
+export type RenderWorkerEvent =
+  | { type: "ready"; hdrActive: boolean }
+  | { type: "hdr"; hdrActive: boolean }
+  | { type: "timing"; timing: FrameTimingSummary }
+  | { type: "error"; message: string };
+
+let canvas: OffscreenCanvas | null = null;
+let renderer: WebGLRenderer | null = null;
+let control: Int32Array | null = null;
+let video: Uint8Array | null = null;
+let slotSize = 0;
+let slots: VideoSlotReader | null = null;
+let running = false;
+const timing = new FrameTimingTracker();
+
+function send(event: RenderWorkerEvent): void {
+  self.postMessage(event);
+}
+
+function createRenderer(hdr: boolean, shader: string): WebGLRenderer {
+  const next = new WebGLRenderer(canvas!, { hdr });
+  next.initialize();
+  next.setShader(shader);
+  return next;
+}
+
+/** Resolves on the worker's next animation frame, or immediately without one. */
+function nextAnimationFrame(): Promise<void> {
+  if (typeof requestAnimationFrame === "undefined") {
+    return Promise.resolve();
+  }
+  return new Promise((resolve) => requestAnimationFrame(() => resolve()));
+}
+
+/**
+ * Draw every newly published frame. Reading the sequence before `acquire`
+ * means a publish that lands after the claim changes the word, so the wait
+ * returns at once instead of sleeping through it. Waiting for an animation
+ * frame after each draw caps drawing at the display rate during
+ * fast-forward.
+ */
+async function renderLoop(): Promise<void> {
+  while (running && control && slots && video) {
+    const sequence = Atomics.load(control, CTRL_FRAME_SEQUENCE);
+    if (renderer && slots.acquire()) {
+      const { height, width } = slots;
+      renderer.renderFrame({
+        data: new Uint8Array(video.buffer, slots.slot * slotSize, width * height * 4),
+        height,
+        width,
+      });
+      timing.record(control, slots.timeline);
+      if (timing.count % TIMING_REPORT_INTERVAL === 0) {
+        send({ timing: timing.summary, type: "timing" });
+      }
+      await nextAnimationFrame();
+      continue;
+    }
+    const wait = Atomics.waitAsync(control, CTRL_FRAME_SEQUENCE, sequence);
+    if (wait.async) {
+      await wait.value;
+    }
+  }
+}
+
+self.onmessage = (event: MessageEvent<RenderWorkerCommand>) => {
+  const msg = event.data;
+  switch (msg.type) {
+    case "init":
+      try {
+        canvas = msg.canvas;
+        control = new Int32Array(msg.control);
+        video = new Uint8Array(msg.video);
+        slotSize = msg.video.byteLength / VIDEO_SLOT_COUNT;
+        slots = new VideoSlotReader(control);
+        renderer = createRenderer(msg.hdr, msg.shader);
+        send({ hdrActive: renderer.isHdrActive, type: "ready" });
+        running = true;
+        void renderLoop();
+      } catch (error) {
+        send({ message: error instanceof Error ? error.message : String(error), type: "error" });
+      }
+      break;
+
+    case "resize":
+      renderer?.resize(msg.width, msg.height);
+      break;
+
+    case "setShader":
+      renderer?.setShader(msg.shader);
+      break;
+
+    case "setHdr":
+      // HDR is configured when the renderer initializes, so rebuild it.
+      if (renderer) {
+        const shader = renderer.getShader();
+        renderer.destroy();
+        renderer = createRenderer(msg.enabled, shader);
+        send({ hdrActive: renderer.isHdrActive, type: "hdr" });
+      }
+      break;
+
+    case "destroy":
+      running = false;
+      renderer?.destroy();
+      renderer = null;
+      self.close();
+      break;
+  }
+};
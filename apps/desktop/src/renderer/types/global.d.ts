@@ -5,6 +5,7 @@ import type {
   CheatEntry,
   GameCheatState,
 } from "../../types/library";
+import type { ScreenLayout } from "../../main/workers/core-worker-protocol";
 
 export interface SaveStateMetadata {
   slot: number;
@@ -16,6 +17,64 @@ export interface SaveStateMetadata {
   stateSize: number;
 }
 
+export interface SaveStateSummary {
+  slot: number;
+  file: string;
+  /** Save time in ms since the epoch. */
+  createdAt: number;
+  /** Null for states saved before thumbnails were embedded. */
+  coreName: string | null;
+  coreVersion: string | null;
+  stateSize: number;
+  thumbnail: { width: number; height: number; offset: number } | null;
+}
+
+export interface CoreMatrixEntry {
+  romPath: string;
+  systemId: string;
+  coreName: string;
+  bootMs: number | null;
+  result: {
+    loadMs: number;
+    targetFps: number;
+    frames: number;
+    fps: number;
+    frameTimeMeanMs: number;
+    frameTimeStdDevMs: number;
+    frameTimeP99Ms: number;
+    stateSize: number;
+    serializeMs: number | null;
+  } | null;
+  error: string | null;
+}
+
+/** Frame script overhead; times cover both hooks per frame. */
+export interface ScriptStats {
+  loaded: boolean;
+  budgetMs: number;
+  lastFrameMs: number;
+  meanFrameMs: number;
+  maxFrameMs: number;
+  overruns: number;
+  hookCalls: number;
+  disabledReason: string | null;
+}
+
+export interface BiosReport {
+  biosDir: string;
+  systemName: string;
+  valid: boolean;
+  missingFiles: Array<string>;
+  badFiles: Array<string>;
+  files: Array<{
+    file: string;
+    status: "verified" | "missing" | "bad";
+    size: number;
+    md5: string | null;
+    cached: boolean;
+  }>;
+}
+
 export interface CoreInfo {
   name: string;
   displayName: string;
@@ -41,6 +100,21 @@ export interface GamelordAPI {
       coreName: string,
       systemId: string,
     ) => Promise<{ success: boolean; corePath?: string; error?: string }>;
+    /**
+     * Benchmark every installed core against each game and use the results
+     * to pick default cores. Runs for minutes; one entry per (game, core).
+     */
+    benchmarkCores: (games: Array<{ romPath: string; systemId: string }>) => Promise<{
+      success: boolean;
+      entries: Array<CoreMatrixEntry>;
+      error?: string;
+    }>;
+    /** Hash check of every system's BIOS files against known-good dumps. */
+    verifyBios: () => Promise<{
+      success: boolean;
+      systems?: Record<string, BiosReport>;
+      error?: string;
+    }>;
   };
   emulation: {
     pause: () => Promise<{ success: boolean }>;
@@ -51,6 +125,7 @@ export interface GamelordAPI {
     ) => Promise<{ success: boolean; path?: string; error?: string }>;
     setSpeed: (multiplier: number) => Promise<{ success: boolean; error?: string }>;
     setFastForwardAudio: (enabled: boolean) => Promise<{ success: boolean; error?: string }>;
+    setPerfHud: (enabled: boolean) => Promise<{ success: boolean; error?: string }>;
     swapDisc: (index: number) => Promise<{ success: boolean; error?: string }>;
     getDiscInfo: () => Promise<{
       success: boolean;
@@ -65,6 +140,22 @@ export interface GamelordAPI {
       path?: string;
       error?: string;
     }>;
+    /** Load a WebAssembly frame script; prompts for a file when no path is given. */
+    loadScript: (scriptPath?: string) => Promise<{
+      success: boolean;
+      canceled?: boolean;
+      path?: string;
+      stats?: ScriptStats;
+      error?: string;
+    }>;
+    unloadScript: () => Promise<{ success: boolean; error?: string }>;
+    /** Resolves with the composed frame size once the layout is set. */
+    setScreenLayout: (layout: ScreenLayout) => Promise<{
+      success: boolean;
+      width?: number;
+      height?: number;
+      error?: string;
+    }>;
   };
   saveState: {
     save: (slot: number) => Promise<{ success: boolean; error?: string }>;
@@ -78,6 +169,14 @@ export interface GamelordAPI {
       states: Array<SaveStateMetadata>;
       error?: string;
     }>;
+    /** Every slot's header and thumbnail for a ROM, without a running core. */
+    summaries: (romPath: string) => Promise<{
+      success: boolean;
+      states: Array<SaveStateSummary>;
+      /** Every thumbnail (RGBA8888), back to back; see SaveStateSummary.thumbnail. */
+      pixels: Uint8Array;
+      error?: string;
+    }>;
   };
   cheats: {
     listForGame: (
@@ -123,6 +222,8 @@ export interface GamelordAPI {
     updateSystemPath: (systemId: string, romsPath: string) => Promise<{ success: boolean }>;
 
     getGames: (systemId?: string) => Promise<Array<Game>>;
+    /** Matching game IDs, best first, or null when the native index is unavailable. */
+    searchGames: (query: string, limit?: number) => Promise<Array<string> | null>;
     addGame: (romPath: string, systemId: string) => Promise<Game | null>;
     removeGame: (gameId: string) => Promise<{ success: boolean }>;
     updateGame: (gameId: string, updates: Partial<Game>) => Promise<{ success: boolean }>;
@@ -191,6 +292,8 @@ export interface GamelordAPI {
   // Game input (native mode)
   gameInput: (port: number, id: number, pressed: boolean) => void;
   gameInputAnalog: (port: number, index: number, id: number, value: number) => void;
+  /** Touch input, normalized (0..1) over the displayed frame. */
+  gamePointer: (x: number, y: number, pressed: boolean) => void;
 
   // SharedArrayBuffer delivery via MessagePort bridge
   framePort: {
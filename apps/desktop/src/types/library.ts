@@ -78,6 +78,11 @@ export interface Game {
    * regional system display name (e.g. "Super Famicom" for JP SNES ROMs).
    */
   romRegions?: Array<string>;
+  /**
+   * Set when the ROM's hash matched an entry in an installed No-Intro / Redump
+   * DAT: the DAT header name and the canonical game name.
+   */
+  datVerified?: { dat: string; name: string };
 
   // ── Multi-disc grouping ──────────────────────────────────────────────
 
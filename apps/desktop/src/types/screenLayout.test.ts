@@ -0,0 +1,56 @@
+import { describe, it, expect } from "vitest";
+import {
+  SCREEN_LAYOUT_PRESETS,
+  composedAspectRatio,
+  isDualScreenSystem,
+  nextScreenLayoutPreset,
+  parseScreenLayoutPreset,
+  screenLayoutFor,
+} from "./screenLayout";
+
+describe("screen layout presets", () => {
+  it("only applies to dual-screen systems", () => {
+    expect(isDualScreenSystem("nds")).toBe(true);
+    expect(isDualScreenSystem("gba")).toBe(false);
+  });
+
+  it("maps original to a pass-through layout", () => {
+    expect(screenLayoutFor("original")).toEqual({ mode: "none" });
+    expect(screenLayoutFor("bottom")).toEqual({ mode: "single", primary: 1 });
+  });
+
+  it("parses stored presets and falls back to original", () => {
+    expect(parseScreenLayoutPreset("sideBySide")).toBe("sideBySide");
+    expect(parseScreenLayoutPreset("bogus")).toBe("original");
+    expect(parseScreenLayoutPreset(null)).toBe("original");
+  });
+
+  it("cycles through every preset and wraps", () => {
+    let preset = SCREEN_LAYOUT_PRESETS[0];
+    const seen = [preset];
+    for (let i = 1; i < SCREEN_LAYOUT_PRESETS.length; i++) {
+      preset = nextScreenLayoutPreset(preset);
+      seen.push(preset);
+    }
+    expect(seen).toEqual(SCREEN_LAYOUT_PRESETS);
+    expect(nextScreenLayoutPreset(preset)).toBe(SCREEN_LAYOUT_PRESETS[0]);
+  });
+});
+
+describe("composedAspectRatio", () => {
+  it("uses the composed size for square pixels", () => {
+    const geometry = { aspectRatio: 256 / 384, baseHeight: 384, baseWidth: 256 };
+    expect(composedAspectRatio(520, 192, geometry)).toBeCloseTo(520 / 192);
+  });
+
+  it("keeps a non-square pixel aspect", () => {
+    const geometry = { aspectRatio: 4 / 3, baseHeight: 240, baseWidth: 256 };
+    expect(composedAspectRatio(256, 240, geometry)).toBeCloseTo(4 / 3);
+    expect(composedAspectRatio(512, 240, geometry)).toBeCloseTo(8 / 3);
+  });
+
+  it("treats an unreported ratio as square pixels", () => {
+    const geometry = { aspectRatio: 0, baseHeight: 384, baseWidth: 256 };
+    expect(composedAspectRatio(256, 192, geometry)).toBeCloseTo(256 / 192);
+  });
+});
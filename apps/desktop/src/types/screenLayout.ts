@@ -0,0 +1,83 @@
+import type { ScreenLayout } from "../main/workers/core-worker-protocol";
+
+/**
+ * Screen layout presets for systems whose cores deliver two screens stacked
+ * in one frame. The addon composes the chosen layout while converting each
+ * frame, so switching presets costs nothing at runtime.
+ */
+export type ScreenLayoutPreset =
+  | "original"
+  | "stackedGap"
+  | "sideBySide"
+  | "top"
+  | "bottom"
+  | "largeTop"
+  | "largeBottom";
+
+export const SCREEN_LAYOUT_PRESETS: ReadonlyArray<ScreenLayoutPreset> = [
+  "original",
+  "stackedGap",
+  "sideBySide",
+  "top",
+  "bottom",
+  "largeTop",
+  "largeBottom",
+];
+
+export const SCREEN_LAYOUT_LABELS: Record<ScreenLayoutPreset, string> = {
+  bottom: "Bottom Only",
+  largeBottom: "Large Bottom",
+  largeTop: "Large Top",
+  original: "Original",
+  sideBySide: "Side by Side",
+  stackedGap: "Stacked + Gap",
+  top: "Top Only",
+};
+
+const PRESET_LAYOUTS: Record<ScreenLayoutPreset, ScreenLayout> = {
+  bottom: { mode: "single", primary: 1 },
+  largeBottom: { gap: 8, mode: "largeSmall", primary: 1, scale: 2 },
+  largeTop: { gap: 8, mode: "largeSmall", primary: 0, scale: 2 },
+  original: { mode: "none" },
+  sideBySide: { gap: 8, mode: "sideBySide" },
+  stackedGap: { gap: 16, mode: "stacked" },
+  top: { mode: "single", primary: 0 },
+};
+
+/** Systems whose cores stack two screens in one frame. */
+const DUAL_SCREEN_SYSTEMS = new Set(["nds"]);
+
+export function isDualScreenSystem(systemId: string): boolean {
+  return DUAL_SCREEN_SYSTEMS.has(systemId);
+}
+
+export function screenLayoutFor(preset: ScreenLayoutPreset): ScreenLayout {
+  return PRESET_LAYOUTS[preset];
+}
+
+/** Parse a stored preset name, falling back to `original`. */
+export function parseScreenLayoutPreset(value: string | null): ScreenLayoutPreset {
+  return SCREEN_LAYOUT_PRESETS.find((preset) => preset === value) ?? "original";
+}
+
+/** The preset after `preset`, wrapping around. */
+export function nextScreenLayoutPreset(preset: ScreenLayoutPreset): ScreenLayoutPreset {
+  const index = SCREEN_LAYOUT_PRESETS.indexOf(preset);
+  return SCREEN_LAYOUT_PRESETS[(index + 1) % SCREEN_LAYOUT_PRESETS.length];
+}
+
+/**
+ * Display aspect ratio of a composed `width` x `height` frame, keeping the
+ * core's pixel aspect (its reported ratio over its base dimensions).
+ */
+export function composedAspectRatio(
+  width: number,
+  height: number,
+  geometry: { aspectRatio: number; baseWidth: number; baseHeight: number },
+): number {
+  const pixelAspect =
+    geometry.aspectRatio > 0 && geometry.baseWidth > 0 && geometry.baseHeight > 0
+      ? geometry.aspectRatio / (geometry.baseWidth / geometry.baseHeight)
+      : 1;
+  return (width / height) * pixelAspect;
+}
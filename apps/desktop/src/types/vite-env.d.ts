@@ -1,3 +1,13 @@
 /// <reference types="electron-vite/node" />
 
 declare module "*.css" {}
+
+declare module "*?worker&url" {
+  const url: string;
+  export default url;
+}
+
+declare module "*?worker" {
+  const WorkerConstructor: new (options?: { name?: string }) => Worker;
+  export default WorkerConstructor;
+}
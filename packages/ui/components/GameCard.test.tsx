@@ -239,6 +239,30 @@ describe("GameCard", () => {
       expect(img).not.toBeNull();
       expect(img!.className).not.toContain("animate-artwork-dissolve-in");
     });
+
+    it("requests grid-sized thumbnails for cached artwork", () => {
+      const onPlay = vi.fn();
+      const gameWithArt = { ...mockGame, coverArt: "artwork://test.png" };
+      const { container, rerender } = render(
+        <GameCard game={gameWithArt} onPlay={onPlay} style={{ width: 200 }} />,
+      );
+
+      const img = container.querySelector("img")!;
+      expect(img.getAttribute("src")).toBe("artwork://test.png");
+      expect(img.getAttribute("srcset")).toBe(
+        "artwork://test.png?w=256 256w, artwork://test.png?w=512 512w, artwork://test.png?w=768 768w",
+      );
+      expect(img.getAttribute("sizes")).toBe("230px");
+
+      rerender(
+        <GameCard
+          game={{ ...mockGame, coverArt: "https://example.com/a.png" }}
+          onPlay={onPlay}
+          style={{ width: 200 }}
+        />,
+      );
+      expect(img.hasAttribute("srcset")).toBe(false);
+    });
   });
 
   describe("favorite heart", () => {
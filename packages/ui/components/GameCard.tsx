@@ -68,6 +68,33 @@ export interface GameCardProps {
   style?: React.CSSProperties;
 }
 
+/**
+ * Thumbnail widths the main process serves for `artwork://` URLs via `?w=`
+ * (mirrors THUMBNAIL_WIDTHS in the desktop app's ThumbnailCache).
+ */
+const COVER_THUMBNAIL_WIDTHS = [256, 512, 768];
+
+/** Hover/launch scale applied to the card; the cover is sized for it. */
+const HOVER_SCALE = 1.15;
+
+/**
+ * srcset/sizes for cached cover art so the grid decodes an image close to
+ * its on-screen size rather than the full-resolution original. Only
+ * `artwork://` URLs have thumbnails, and `sizes` needs the card's pixel width.
+ */
+function coverSources(
+  coverArt: string | undefined,
+  width: React.CSSProperties["width"],
+): { sizes?: string; srcSet?: string } {
+  if (!coverArt?.startsWith("artwork://") || typeof width !== "number") {
+    return {};
+  }
+  return {
+    sizes: `${Math.ceil(width * HOVER_SCALE)}px`,
+    srcSet: COVER_THUMBNAIL_WIDTHS.map((w) => `${coverArt}?w=${w} ${w}w`).join(", "),
+  };
+}
+
 export const GameCard: React.FC<GameCardProps> = React.memo(
   function GameCard({
     artworkSyncStore,
@@ -149,7 +176,7 @@ export const GameCard: React.FC<GameCardProps> = React.memo(
     const { edgeTranslate, onPointerEnter, onPointerLeave } = useEdgeAwareHover({
       disabled,
       locked: isLaunching,
-      scaleFactor: 1.15,
+      scaleFactor: HOVER_SCALE,
     });
 
     // Merge edge-aware translate into existing style prop
@@ -212,8 +239,10 @@ export const GameCard: React.FC<GameCardProps> = React.memo(
                 // Steady state: visible when coverArt exists.
                 game.coverArt && (isDone ? crossFadeReady : true) ? "opacity-100" : "opacity-0",
               )}
+              decoding="async"
               ref={imgRef}
               src={game.coverArt ?? undefined}
+              {...coverSources(game.coverArt, style?.width)}
             />
 
             {/*
@@ -68,6 +68,11 @@ export interface GameLibraryProps {
   onToggleFavorite?: (game: Game) => void;
   /** Ref to the scrollable container (for virtualization). */
   scrollContainerRef?: React.RefObject<HTMLElement | null>;
+  /**
+   * Host-side title search (e.g. a native index). Resolves to the matching
+   * game IDs, or null to fall back to the built-in substring filter.
+   */
+  searchGames?: (query: string) => Promise<Array<string> | null>;
   /**
    * Called once after the grid has measured its container and computed
    * layout positions for the first time. The host can use this to defer
@@ -116,10 +121,13 @@ export const GameLibrary: React.FC<GameLibraryProps> = ({
   onPlayGame,
   onToggleFavorite,
   scrollContainerRef,
+  searchGames,
   onReady,
   isRevealing,
 }) => {
   const [searchQuery, setSearchQuery] = useState("");
+  /** IDs matching `searchQuery` from `searchGames`, or null to filter locally. */
+  const [searchMatches, setSearchMatches] = useState<Set<string> | null>(null);
   const [selectedPlatform, setSelectedPlatform] = useState<string>("all");
   const [sortBy, setSortBy] = useState<SortBy>("title");
   const [showFavoritesOnly, setShowFavoritesOnly] = useState(false);
@@ -134,12 +142,38 @@ export const GameLibrary: React.FC<GameLibraryProps> = ({
     return Array.from(platformSet).sort();
   }, [games]);
 
+  // Ask the host for matches; `games` is a dependency so a library reload
+  // re-runs the query against the updated index.
+  useEffect(() => {
+    if (!searchGames || !searchQuery) {
+      setSearchMatches(null);
+      return;
+    }
+    let cancelled = false;
+    searchGames(searchQuery)
+      .then((ids) => {
+        if (!cancelled) {
+          setSearchMatches(ids ? new Set(ids) : null);
+        }
+      })
+      .catch(() => {
+        if (!cancelled) {
+          setSearchMatches(null);
+        }
+      });
+    return () => {
+      cancelled = true;
+    };
+  }, [searchGames, searchQuery, games]);
+
   // Filter and sort games
   const filteredGames = useMemo(() => {
     let filtered = games;
 
     // Search filter
-    if (searchQuery) {
+    if (searchQuery && searchMatches) {
+      filtered = filtered.filter((game) => searchMatches.has(game.id));
+    } else if (searchQuery) {
       filtered = filtered.filter((game) =>
         game.title.toLowerCase().includes(searchQuery.toLowerCase()),
       );
@@ -203,7 +237,7 @@ export const GameLibrary: React.FC<GameLibraryProps> = ({
     }
 
     return filtered;
-  }, [games, searchQuery, selectedPlatform, sortBy, showFavoritesOnly]);
+  }, [games, searchQuery, searchMatches, selectedPlatform, sortBy, showFavoritesOnly]);
 
   // Build display items: real games interspersed with placeholder cards for missing discs.
   // Placeholders are purely UI — they don't affect filteredGames (used for FLIP/virtualization keys).
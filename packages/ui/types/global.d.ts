@@ -37,6 +37,7 @@ export interface GamelordAPI {
     removeSystem: (systemId: string) => Promise<any>;
     updateSystemPath: (systemId: string, romsPath: string) => Promise<any>;
     getGames: (systemId?: string) => Promise<Array<any>>;
+    searchGames: (query: string, limit?: number) => Promise<Array<string> | null>;
     addGame: (romPath: string, systemId: string) => Promise<any>;
     removeGame: (gameId: string) => Promise<any>;
     updateGame: (gameId: string, updates: any) => Promise<any>;
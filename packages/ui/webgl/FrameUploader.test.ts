@@ -0,0 +1,90 @@
+import { FrameUploader } from "./FrameUploader";
+
+function createMockGL() {
+  const buffers: Array<WebGLBuffer> = [];
+  return {
+    buffers,
+    gl: {
+      TEXTURE_2D: 3553,
+      RGBA: 6408,
+      RGBA8: 32_856,
+      UNSIGNED_BYTE: 5121,
+      PIXEL_UNPACK_BUFFER: 35_052,
+      STREAM_DRAW: 35_040,
+      bindTexture: vi.fn(),
+      texImage2D: vi.fn(),
+      texSubImage2D: vi.fn(),
+      createBuffer: vi.fn(() => {
+        const buffer = { id: buffers.length } as unknown as WebGLBuffer;
+        buffers.push(buffer);
+        return buffer;
+      }),
+      bindBuffer: vi.fn(),
+      bufferData: vi.fn(),
+      bufferSubData: vi.fn(),
+      deleteBuffer: vi.fn(),
+    } as unknown as WebGL2RenderingContext,
+  };
+}
+
+/** 2×4 frame whose rows are filled with their row index. */
+function frame(): Uint8Array {
+  const data = new Uint8Array(2 * 4 * 4);
+  for (let y = 0; y < 4; y++) {
+    data.fill(y, y * 8, (y + 1) * 8);
+  }
+  return data;
+}
+
+describe("FrameUploader", () => {
+  const texture = {} as WebGLTexture;
+  let gl: WebGL2RenderingContext;
+  let buffers: Array<WebGLBuffer>;
+  let uploader: FrameUploader;
+
+  beforeEach(() => {
+    ({ buffers, gl } = createMockGL());
+    uploader = new FrameUploader(gl);
+  });
+
+  it("allocates the texture only when the frame size changes", () => {
+    uploader.upload(texture, frame(), 2, 4);
+    uploader.upload(texture, frame(), 2, 4);
+    expect(gl.texImage2D).toHaveBeenCalledTimes(1);
+    expect(gl.texSubImage2D).toHaveBeenCalledTimes(2);
+
+    uploader.upload(texture, new Uint8Array(3 * 4 * 4), 3, 4);
+    expect(gl.texImage2D).toHaveBeenCalledTimes(2);
+  });
+
+  it("copies the whole frame in one call and uploads from the bound buffer", () => {
+    const data = frame();
+    uploader.upload(texture, data, 2, 4);
+
+    expect(gl.bufferSubData).toHaveBeenCalledTimes(1);
+    expect(gl.bufferSubData).toHaveBeenCalledWith(gl.PIXEL_UNPACK_BUFFER, 0, data, 0, 32);
+    expect(gl.texSubImage2D).toHaveBeenCalledWith(
+      gl.TEXTURE_2D,
+      0,
+      0,
+      0,
+      2,
+      4,
+      gl.RGBA,
+      gl.UNSIGNED_BYTE,
+      0,
+    );
+  });
+
+  it("cycles through a ring of unpack buffers", () => {
+    for (let i = 0; i < 4; i++) {
+      uploader.upload(texture, frame(), 2, 4);
+    }
+    const bound = vi
+      .mocked(gl.bindBuffer)
+      .mock.calls.filter((call) => call[1] !== null)
+      .map((call) => call[1]);
+    expect(buffers).toHaveLength(3);
+    expect(bound).toEqual([buffers[0], buffers[1], buffers[2], buffers[0]]);
+  });
+});
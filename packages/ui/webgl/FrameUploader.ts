@@ -0,0 +1,66 @@
+/** Unpack buffers cycled through, so a frame never waits on the GPU reading the last one. */
+const RING_SIZE = 3;
+
+/**
+ * Streams emulator frames into a texture through a ring of
+ * PIXEL_UNPACK_BUFFERs and `texSubImage2D`, instead of re-specifying the
+ * texture with `texImage2D` every frame. The texture is only reallocated
+ * when the frame size changes.
+ *
+ * Frames are copied into the buffer in one call and stay top-down in the
+ * texture; WebGLRenderer flips them with texture coordinates when drawing
+ * to the screen.
+ */
+export class FrameUploader {
+  private gl: WebGL2RenderingContext;
+  private buffers: Array<WebGLBuffer> = [];
+  private capacities: Array<number> = [];
+  private next = 0;
+  private width = 0;
+  private height = 0;
+
+  constructor(gl: WebGL2RenderingContext) {
+    this.gl = gl;
+  }
+
+  /** Upload a top-down RGBA8 frame into `texture`. */
+  upload(texture: WebGLTexture, data: Uint8Array, width: number, height: number): void {
+    const gl = this.gl;
+    gl.bindTexture(gl.TEXTURE_2D, texture);
+
+    if (width !== this.width || height !== this.height) {
+      gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA8, width, height, 0, gl.RGBA, gl.UNSIGNED_BYTE, null);
+      this.width = width;
+      this.height = height;
+    }
+
+    if (this.buffers.length === 0) {
+      for (let i = 0; i < RING_SIZE; i++) {
+        this.buffers.push(gl.createBuffer()!);
+        this.capacities.push(0);
+      }
+    }
+    const index = this.next;
+    this.next = (this.next + 1) % RING_SIZE;
+
+    const frameBytes = width * height * 4;
+    gl.bindBuffer(gl.PIXEL_UNPACK_BUFFER, this.buffers[index]);
+    if (this.capacities[index] < frameBytes) {
+      gl.bufferData(gl.PIXEL_UNPACK_BUFFER, frameBytes, gl.STREAM_DRAW);
+      this.capacities[index] = frameBytes;
+    }
+    gl.bufferSubData(gl.PIXEL_UNPACK_BUFFER, 0, data, 0, frameBytes);
+    gl.texSubImage2D(gl.TEXTURE_2D, 0, 0, 0, width, height, gl.RGBA, gl.UNSIGNED_BYTE, 0);
+    gl.bindBuffer(gl.PIXEL_UNPACK_BUFFER, null);
+  }
+
+  destroy(): void {
+    for (const buffer of this.buffers) {
+      this.gl.deleteBuffer(buffer);
+    }
+    this.buffers = [];
+    this.capacities = [];
+    this.width = 0;
+    this.height = 0;
+  }
+}
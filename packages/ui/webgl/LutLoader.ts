@@ -7,7 +7,8 @@ interface LutEntry {
 
 /**
  * Loads PNG look-up table textures for shader presets.
- * Textures are decoded via the Image API and uploaded to WebGL.
+ * Textures are decoded via the Image API (or createImageBitmap in workers)
+ * and uploaded to WebGL.
  */
 export class LutLoader {
   private gl: WebGL2RenderingContext;
@@ -25,6 +26,7 @@ export class LutLoader {
 
     const texture = gl.createTexture()!;
     gl.bindTexture(gl.TEXTURE_2D, texture);
+    // Top-down like the frame texture, so v = 0 is the top row in shaders.
     gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, gl.RGBA, gl.UNSIGNED_BYTE, image);
 
     gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, this.getFilter(definition.filter));
@@ -54,7 +56,15 @@ export class LutLoader {
     this.luts.clear();
   }
 
-  private loadImage(url: string): Promise<HTMLImageElement> {
+  private async loadImage(url: string): Promise<TexImageSource> {
+    // Workers rendering to an OffscreenCanvas have no Image element.
+    if (typeof Image === "undefined") {
+      const response = await fetch(url);
+      if (!response.ok) {
+        throw new Error(`Failed to load LUT image: ${url}`);
+      }
+      return createImageBitmap(await response.blob());
+    }
     return new Promise((resolve, reject) => {
       const img = new Image();
       img.crossOrigin = "anonymous";
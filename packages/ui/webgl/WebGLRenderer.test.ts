@@ -237,3 +237,21 @@ describe("WebGLRenderer — HDR", () => {
     });
   });
 });
+
+describe("WebGLRenderer — quads", () => {
+  it("flips v only in the quad used for screen draws", () => {
+    const { canvas, gl } = createCanvasWithMockGL();
+    const renderer = new WebGLRenderer(canvas);
+    renderer.initialize();
+
+    const quads = vi
+      .mocked(gl.bufferData)
+      .mock.calls.map((call) => Array.from(call[1] as unknown as Float32Array));
+    // position (x, y) + texCoord (u, v) per vertex; v = 0 is the top row of
+    // every (top-down) texture, and the screen's top row is y = 1.
+    expect(quads).toEqual([
+      [-1, -1, 0, 0, 1, -1, 1, 0, -1, 1, 0, 1, 1, 1, 1, 1],
+      [-1, -1, 0, 1, 1, -1, 1, 1, -1, 1, 0, 0, 1, 1, 1, 0],
+    ]);
+  });
+});
@@ -1,6 +1,7 @@
 import { VideoFrame } from "../types/global";
 import { ShaderManager } from "./ShaderManager";
 import { FramebufferManager } from "./FramebufferManager";
+import { FrameUploader } from "./FrameUploader";
 import { LutLoader } from "./LutLoader";
 import { defaultVertexShader, hdrOutputFragmentShader } from "./shaders";
 import { PRESET_LIST, PRESET_MAP } from "./presets";
@@ -34,14 +35,19 @@ export interface WebGLRendererOptions {
   hdr?: boolean;
 }
 
+/** A DOM canvas, or one transferred to a worker with `transferControlToOffscreen`. */
+export type RenderCanvas = HTMLCanvasElement | OffscreenCanvas;
+
 export class WebGLRenderer {
-  private canvas: HTMLCanvasElement;
+  private canvas: RenderCanvas;
   private gl: WebGL2RenderingContext | null = null;
   private shaderManager: ShaderManager | null = null;
   private framebufferManager: FramebufferManager | null = null;
   private lutLoader: LutLoader | null = null;
+  private frameUploader: FrameUploader | null = null;
   private originalTexture: WebGLTexture | null = null;
   private vertexBuffer: WebGLBuffer | null = null;
+  private screenVertexBuffer: WebGLBuffer | null = null;
   private currentPresetId = "default";
   private currentPreset: ShaderPresetDefinition | null = null;
   private compiledPasses: Array<CompiledPass> = [];
@@ -51,13 +57,14 @@ export class WebGLRenderer {
   private hdrRequested: boolean;
   private hdrActive = false;
 
-  constructor(canvas: HTMLCanvasElement, options?: WebGLRendererOptions) {
+  constructor(canvas: RenderCanvas, options?: WebGLRendererOptions) {
     this.canvas = canvas;
     this.hdrRequested = options?.hdr ?? false;
   }
 
   initialize(): void {
-    const gl = this.canvas.getContext("webgl2", {
+    // OffscreenCanvas.getContext takes the same arguments.
+    const gl = (this.canvas as HTMLCanvasElement).getContext("webgl2", {
       alpha: false,
       antialias: false,
       depth: false,
@@ -73,6 +80,7 @@ export class WebGLRenderer {
     this.shaderManager = new ShaderManager(gl);
     this.framebufferManager = new FramebufferManager(gl);
     this.lutLoader = new LutLoader(gl);
+    this.frameUploader = new FrameUploader(gl);
 
     // Enable float texture rendering if available
     gl.getExtension("EXT_color_buffer_float");
@@ -92,25 +100,29 @@ export class WebGLRenderer {
       );
     }
 
-    // Full-screen quad: position (x,y) + texCoord (u,v)
-    // Standard OpenGL tex coords: (0,0) at bottom-left, (1,1) at top-right.
-    // Source textures are uploaded with UNPACK_FLIP_Y_WEBGL=true so they match
-    // OpenGL's bottom-up convention, making coords consistent across all passes.
+    // Full-screen quads: position (x,y) + texCoord (u,v).
+    // Every texture is stored top-down, as uploaded (frames, LUTs, and pass
+    // outputs alike), so v = 0 is the top of the image in every pass. Drawing
+    // into a framebuffer keeps that order: row 0 of the target is written
+    // from v = 0. The default framebuffer is bottom-up, so draws to the
+    // screen use the same quad with v flipped.
     const vertices = new Float32Array([-1, -1, 0, 0, 1, -1, 1, 0, -1, 1, 0, 1, 1, 1, 1, 1]);
+    const screenVertices = new Float32Array([-1, -1, 0, 1, 1, -1, 1, 1, -1, 1, 0, 0, 1, 1, 1, 0]);
 
     this.vertexBuffer = gl.createBuffer();
     gl.bindBuffer(gl.ARRAY_BUFFER, this.vertexBuffer);
     gl.bufferData(gl.ARRAY_BUFFER, vertices, gl.STATIC_DRAW);
 
+    this.screenVertexBuffer = gl.createBuffer();
+    gl.bindBuffer(gl.ARRAY_BUFFER, this.screenVertexBuffer);
+    gl.bufferData(gl.ARRAY_BUFFER, screenVertices, gl.STATIC_DRAW);
+
     this.originalTexture = gl.createTexture();
     gl.bindTexture(gl.TEXTURE_2D, this.originalTexture);
     gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, gl.NEAREST);
     gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MAG_FILTER, gl.NEAREST);
     gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_S, gl.CLAMP_TO_EDGE);
     gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_T, gl.CLAMP_TO_EDGE);
-    // Flip Y on upload so the texture matches OpenGL's bottom-up convention.
-    // This lets all passes use the same non-flipped tex coords consistently.
-    gl.pixelStorei(gl.UNPACK_FLIP_Y_WEBGL, true);
 
     gl.viewport(0, 0, this.canvas.width, this.canvas.height);
     gl.clearColor(0, 0, 0, 1);
@@ -120,7 +132,15 @@ export class WebGLRenderer {
   }
 
   renderFrame(frame: VideoFrame): void {
-    if (!this.gl || !this.originalTexture || !this.shaderManager || !this.framebufferManager) {
+    if (
+      !this.gl ||
+      !this.originalTexture ||
+      !this.shaderManager ||
+      !this.framebufferManager ||
+      !this.frameUploader ||
+      !this.vertexBuffer ||
+      !this.screenVertexBuffer
+    ) {
       return;
     }
 
@@ -136,18 +156,7 @@ export class WebGLRenderer {
     // into a SharedArrayBuffer (zero-copy SAB path).
     const data =
       frame.data instanceof Uint8Array ? frame.data : new Uint8Array(frame.data as ArrayBuffer);
-    gl.bindTexture(gl.TEXTURE_2D, this.originalTexture);
-    gl.texImage2D(
-      gl.TEXTURE_2D,
-      0,
-      gl.RGBA,
-      this.frameWidth,
-      this.frameHeight,
-      0,
-      gl.RGBA,
-      gl.UNSIGNED_BYTE,
-      data,
-    );
+    this.frameUploader.upload(this.originalTexture, data, this.frameWidth, this.frameHeight);
 
     const passes = this.compiledPasses;
     const passCount = passes.length;
@@ -206,7 +215,7 @@ export class WebGLRenderer {
 
       // First draw target: feedback FBO if feedback pass, else FBO or screen
       if (hasFeedback) {
-        // Render to feedback FBO using FBO vertex buffer (no Y-flip) so that
+        // Render to feedback FBO using the framebuffer quad (no Y-flip) so
         // the feedback texture can be sampled with the same coords next frame.
         gl.bindFramebuffer(gl.FRAMEBUFFER, feedbackPair!.current.framebuffer);
         gl.viewport(0, 0, outputWidth, outputHeight);
@@ -235,17 +244,8 @@ export class WebGLRenderer {
         continue;
       }
 
-      gl.bindBuffer(gl.ARRAY_BUFFER, this.vertexBuffer);
-
-      // Attributes
-      const positionLoc = gl.getAttribLocation(program, "a_position");
-      const texCoordLoc = gl.getAttribLocation(program, "a_texCoord");
-
-      gl.enableVertexAttribArray(positionLoc);
-      gl.vertexAttribPointer(positionLoc, 2, gl.FLOAT, false, 16, 0);
-
-      gl.enableVertexAttribArray(texCoordLoc);
-      gl.vertexAttribPointer(texCoordLoc, 2, gl.FLOAT, false, 16, 8);
+      const drawsToScreen = isLastPass && !hasFeedback;
+      this.bindQuad(program, drawsToScreen ? this.screenVertexBuffer : this.vertexBuffer);
 
       // Bind textures
       let textureUnit = 0;
@@ -345,11 +345,12 @@ export class WebGLRenderer {
       gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4);
 
       // For feedback passes that are also the last pass, re-draw to screen.
-      // All state (program, uniforms, textures, vertex buffer) is still bound.
+      // Program, uniforms, and textures are still bound; only the quad changes.
       if (hasFeedback && isLastPass) {
         gl.bindFramebuffer(gl.FRAMEBUFFER, null);
         gl.viewport(0, 0, this.canvas.width, this.canvas.height);
         gl.clear(gl.COLOR_BUFFER_BIT);
+        this.bindQuad(program, this.screenVertexBuffer);
         gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4);
       }
 
@@ -396,14 +397,7 @@ export class WebGLRenderer {
       this.shaderManager.useShader(HDR_OUTPUT_PASS_KEY);
       const hdrProgram = this.shaderManager.getCurrentShader();
       if (hdrProgram) {
-        gl.bindBuffer(gl.ARRAY_BUFFER, this.vertexBuffer);
-
-        const posLoc = gl.getAttribLocation(hdrProgram, "a_position");
-        const texLoc = gl.getAttribLocation(hdrProgram, "a_texCoord");
-        gl.enableVertexAttribArray(posLoc);
-        gl.vertexAttribPointer(posLoc, 2, gl.FLOAT, false, 16, 0);
-        gl.enableVertexAttribArray(texLoc);
-        gl.vertexAttribPointer(texLoc, 2, gl.FLOAT, false, 16, 8);
+        this.bindQuad(hdrProgram, this.screenVertexBuffer);
 
         // Bind the last shader pass's output
         const lastPassTexture = this.framebufferManager.getTexture(`pass_${passCount - 1}`);
@@ -467,13 +461,32 @@ export class WebGLRenderer {
     if (this.vertexBuffer) {
       gl.deleteBuffer(this.vertexBuffer);
     }
+    if (this.screenVertexBuffer) {
+      gl.deleteBuffer(this.screenVertexBuffer);
+    }
 
     this.framebufferManager?.destroy();
+    this.frameUploader?.destroy();
     this.lutLoader?.destroy();
     this.shaderManager?.destroy();
     this.gl = null;
   }
 
+  /** Point the program's position and texCoord attributes at `buffer`. */
+  private bindQuad(program: WebGLProgram, buffer: WebGLBuffer): void {
+    const gl = this.gl!;
+    gl.bindBuffer(gl.ARRAY_BUFFER, buffer);
+
+    const positionLoc = gl.getAttribLocation(program, "a_position");
+    const texCoordLoc = gl.getAttribLocation(program, "a_texCoord");
+
+    gl.enableVertexAttribArray(positionLoc);
+    gl.vertexAttribPointer(positionLoc, 2, gl.FLOAT, false, 16, 0);
+
+    gl.enableVertexAttribArray(texCoordLoc);
+    gl.vertexAttribPointer(texCoordLoc, 2, gl.FLOAT, false, 16, 8);
+  }
+
   /**
    * Configure the WebGL2 context for HDR output: Display P3 color space,
    * float16 backbuffer, and extended tone mapping (EDR) when available.